@@ -0,0 +1,87 @@
+#include "CompressBench.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include "CompressedFile.h"
+#include "DuckyScriptParser.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+#include "PayloadCompressor.h"
+
+#define DECODE_MIN_RUN_NS 100000000ULL  // Decode each payload for at least this long
+#define DECODE_READ_SIZE  128           // ScriptLineReader reads about this much at a time
+#define DSZ_PATH          "/bench.dsz"
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Decodes the whole payload, returns the bytes decoded
+static size_t decodeOnce() {
+    File file = CompressedFile::open(LittleFS.open(DSZ_PATH, FILE_READ));
+    uint8_t buffer[DECODE_READ_SIZE];
+    size_t total = 0;
+    size_t bytes;
+    while ((bytes = file.read(buffer, sizeof(buffer))) > 0) {
+        total += bytes;
+    }
+    file.close();
+    return total;
+}
+
+// Simulated USB typing time of the payload run from the .dsz
+static uint64_t typingUs(MockHIDDevice& device) {
+    device.reset();
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&device);
+    parser.execute(CompressedFile::open(LittleFS.open(DSZ_PATH, FILE_READ)));
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+    return device.getDurationUs();
+}
+
+void benchCompression(const std::vector<std::string>& names) {
+    UsbTimingModel usb(1000);
+    MockHIDDevice device(&usb, false, false);
+    uint64_t totalBytes = 0;
+    uint64_t totalPacked = 0;
+    
+    printf("\n%-20s %7s %7s %6s %11s %9s %12s %9s %5s\n", "compressed (.dsz)", "bytes", "dsz", "ratio", "decode",
+           "heap", "typed at", "headroom", "ok");
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string script = LittleFSStorage->content(("/" + names[i]).c_str());
+        std::string packed = compressPayload(script);
+        LittleFSStorage->addFile(DSZ_PATH, packed);
+        totalBytes += script.size();
+        totalPacked += packed.size();
+        
+        HeapStats::resetPeak();
+        size_t before = HeapStats::get().current;
+        bool ok = decodeOnce() == script.size();
+        size_t heap = HeapStats::get().peak - before;
+        
+        uint64_t elapsed = 0;
+        uint32_t runs = 0;
+        while (elapsed < DECODE_MIN_RUN_NS) {
+            uint64_t start = wallNow();
+            decodeOnce();
+            elapsed += wallNow() - start;
+            runs++;
+        }
+        double decodeRate = (double)script.size() * runs / (elapsed / 1e9);
+        
+        // Script bytes the typing uses up per second, against the decoder
+        uint64_t typedUs = typingUs(device);
+        double typedRate = typedUs > 0 ? script.size() / (typedUs / 1e6) : 0;
+        printf("%-20s %7u %7u %5.1f%% %6.1f MB/s %9u %7.0f B/s %8.0fx %5s\n", names[i].c_str(),
+               (unsigned)script.size(), (unsigned)packed.size(), 100.0 * packed.size() / script.size(),
+               decodeRate / 1e6, (unsigned)heap, typedRate, typedRate > 0 ? decodeRate / typedRate : 0,
+               ok ? "yes" : "NO");
+    }
+    printf("%-20s %7u %7u %5.1f%%\n", "corpus", (unsigned)totalBytes, (unsigned)totalPacked,
+           totalBytes ? 100.0 * totalPacked / totalBytes : 0);
+    LittleFS.remove(DSZ_PATH);
+}
\ No newline at end of file
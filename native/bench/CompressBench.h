@@ -0,0 +1,13 @@
+#ifndef BENCH_COMPRESS_BENCH_H
+#define BENCH_COMPRESS_BENCH_H
+
+#include <string>
+#include <vector>
+
+// Every corpus payload compressed to .dsz: the compression ratio, how
+// fast CompressedFile decodes it on this machine, and how much faster
+// that is than the script is used up while it types on the USB model.
+// The payloads are expected in LittleFS under "/" + name.
+void benchCompression(const std::vector<std::string>& names);
+
+#endif // BENCH_COMPRESS_BENCH_H
\ No newline at end of file
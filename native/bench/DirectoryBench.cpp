@@ -0,0 +1,138 @@
+#include "DirectoryBench.h"
+#include <Arduino.h>
+#include <SD.h>
+#include <chrono>
+#include <vector>
+#include "DirectoryIndex.h"
+#include "PayloadCache.h"
+#include "MemoryFS.h"
+
+// Rough SPI SD card at 20 MHz behind FATFS
+#define SD_OPEN_US      1500
+#define SD_READ_US      300
+#define SD_READ_BYTE_NS 500
+#define SD_LIST_US      150
+
+#define BENCH_DIR       "/payloads"
+#define OLD_MAX_FILES   100  // PayloadManager::MAX_FILES before the index
+#define OLD_ENTRY_DELAY 10   // ms, delay() per listed entry
+#define PAGE_RECORDS    16   // FileList window
+
+struct OpenResult {
+    uint64_t cardUs;  // Simulated time, card access included
+    uint64_t wallUs;  // Host CPU time
+    uint32_t opens;   // Files opened on the card
+};
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void startMeasure(OpenResult& result, uint64_t& clockStart, uint64_t& wallStart) {
+    memset(&result, 0, sizeof(result));
+    SDStorage->resetStats();
+    clockStart = HostClock::now();
+    wallStart = wallNow();
+}
+
+static void endMeasure(OpenResult& result, uint64_t clockStart, uint64_t wallStart) {
+    result.wallUs = wallNow() - wallStart;
+    result.cardUs = HostClock::now() - clockStart;
+    result.opens = SDStorage->stats.opens;
+}
+
+// The listing PayloadManager::scanDirectory() did before the index
+static uint32_t oldScan(fs::FS& fs) {
+    struct OldEntry {
+        String name;
+        bool isDir;
+    };
+    std::vector<OldEntry> entries;
+    uint32_t listed = 0;
+    File root = fs.open(BENCH_DIR);
+    File file = root.openNextFile();
+    while (file) {
+        delay(OLD_ENTRY_DELAY);
+        if (listed >= OLD_MAX_FILES) {
+            file.close();
+            break;
+        }
+        OldEntry entry;
+        entry.name = file.name();
+        entry.isDir = file.isDirectory();
+        entries.push_back(entry);
+        listed++;
+        file.close();
+        file = root.openNextFile();
+    }
+    return listed;
+}
+
+static OpenResult openIndex(DirectoryIndex& index, const String& cachePath) {
+    OpenResult result;
+    uint64_t clockStart, wallStart;
+    startMeasure(result, clockStart, wallStart);
+    index.open(SD, BENCH_DIR, cachePath);
+    endMeasure(result, clockStart, wallStart);
+    return result;
+}
+
+static void printOpen(const char* name, const OpenResult& result) {
+    printf("  %-22s %10.1f ms %8.1f ms %8u\n", name, result.cardUs / 1e3, result.wallUs / 1e3, result.opens);
+}
+
+void benchDirectories() {
+    static const uint32_t sizes[] = { 100, 1000, 10000 };
+    bool wasVirtual = HostClock::isVirtual();
+    HostClock::useVirtual(true);
+    
+    printf("\n%-24s %13s %11s %8s\n", "directory open", "card time", "cpu time", "opens");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        SDStorage->clear();
+        memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+        SDStorage->mkdir(CACHE_DIR);
+        char path[64];
+        for (uint32_t n = 0; n < sizes[i]; n++) {
+            snprintf(path, sizeof(path), BENCH_DIR "/payload_%05u.txt", (unsigned)((n * 7919) % sizes[i]));
+            SDStorage->addFile(path, std::string(100 + n % 900, 'x'));
+        }
+        SDStorage->delays.openUs = SD_OPEN_US;
+        SDStorage->delays.readUs = SD_READ_US;
+        SDStorage->delays.readByteNs = SD_READ_BYTE_NS;
+        SDStorage->delays.listUs = SD_LIST_US;
+        printf("%u files\n", sizes[i]);
+        
+        OpenResult old;
+        uint64_t clockStart, wallStart;
+        startMeasure(old, clockStart, wallStart);
+        uint32_t listed = oldScan(SD);
+        endMeasure(old, clockStart, wallStart);
+        printf("  %-22s %10.1f ms %8.1f ms %8u  (%u files shown)\n", "old capped scan", old.cardUs / 1e3,
+               old.wallUs / 1e3, old.opens, listed);
+        
+        String cachePath = DirectoryIndex::cachePath(CACHE_DIR, BENCH_DIR);
+        DirectoryIndex index;
+        printOpen("index build", openIndex(index, cachePath));
+        if (index.getCount() != sizes[i]) printf("  index has %u entries\n", (unsigned)index.getCount());
+        index.close();
+        printOpen("index unchanged", openIndex(index, cachePath));
+        index.close();
+        SDStorage->delays.openUs = 0;
+        SDStorage->addFile(BENCH_DIR "/added.txt", "STRING new\n");
+        SDStorage->delays.openUs = SD_OPEN_US;
+        printOpen("index, one file added", openIndex(index, cachePath));
+        
+        OpenResult page;
+        startMeasure(page, clockStart, wallStart);
+        DirectoryRecord records[PAGE_RECORDS];
+        index.read(index.getCount() / 2, records, PAGE_RECORDS);
+        endMeasure(page, clockStart, wallStart);
+        printOpen("page of 16 from index", page);
+        index.close();
+    }
+    
+    SDStorage->clear();
+    memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+    HostClock::useVirtual(wasVirtual);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef BENCH_DIRECTORY_BENCH_H
+#define BENCH_DIRECTORY_BENCH_H
+
+// Directory open time on a simulated SD card for 100, 1k and 10k files:
+// the capped listing with a 10 ms delay per entry that PayloadManager
+// used to do, building the on-card index, opening it again unchanged and
+// after one file was added, and reading the first menu page from it.
+void benchDirectories();
+
+#endif // BENCH_DIRECTORY_BENCH_H
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "DispatchBench.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <map>
+#include "DuckyScriptParser.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+
+#define DISPATCH_MIN_RUN_NS 200000000ULL  // Run each path for at least this long
+
+struct DispatchResult {
+    uint64_t compileNs;    // Splitting lines, or compiling to ops
+    uint64_t totalNs;
+    uint64_t allocations;
+};
+
+// Drops what the parser sends, delays included
+class NullDevice : public HIDDevice {
+public:
+    void sendKey(uint8_t key, uint8_t modifiers = 0) override {}
+    void sendString(const String& text) override {}
+    void sendText(const char* text, size_t length) override {}
+    void sendKeySequence(const char* keys, size_t length) override {}
+    void sendMediaKey(uint8_t mediaKey) override {}
+    void sendReport(const HIDKeyReport& report) override {}
+    void delay(uint32_t ms) override {}
+    bool isConnected() override { return true; }
+    bool isRealtime() override { return false; }
+};
+
+// The parser before DuckyOp, as executeLine() ran it. The Serial output
+// of every command is left out, LogBench.cpp times that on its own.
+class LineParser {
+private:
+    HIDDevice* hidDevice;
+    bool executionComplete;
+    unsigned long commandDelay;
+    std::map<String, uint8_t> specialKeys;
+    std::map<String, uint8_t> modifiers;
+    std::vector<String> lines;
+    size_t currentLine;
+    bool inCommentBlock;
+    
+    static bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+    
+    static String trim(const String& str) {
+        int start = 0;
+        int end = str.length() - 1;
+        
+        while (start <= end && isWhitespace(str[start])) start++;
+        while (end >= start && isWhitespace(str[end])) end--;
+        
+        return str.substring(start, end + 1);
+    }
+    
+    static std::vector<String> splitByWhitespace(const String& str) {
+        std::vector<String> result;
+        int length = str.length();
+        int start = 0;
+        bool inWord = false;
+        
+        for (int i = 0; i < length; i++) {
+            if (isWhitespace(str[i])) {
+                if (inWord) {
+                    result.push_back(str.substring(start, i));
+                    inWord = false;
+                }
+            } else if (!inWord) {
+                start = i;
+                inWord = true;
+            }
+        }
+        if (inWord) {
+            result.push_back(str.substring(start));
+        }
+        return result;
+    }
+    
+    void handleKEY(const String& line) {
+        std::vector<String> keyParts = splitByWhitespace(line);
+        uint8_t key = 0;
+        uint8_t keyMods = 0;
+        
+        for (const String& part : keyParts) {
+            if (modifiers.find(part.c_str()) != modifiers.end()) {
+                keyMods |= modifiers[part.c_str()];
+            } else if (specialKeys.find(part.c_str()) != specialKeys.end()) {
+                key = specialKeys[part.c_str()];
+            } else if (part.length() == 1) {
+                key = part[0];
+            }
+        }
+        hidDevice->sendKey(key, keyMods);
+    }
+    
+public:
+    LineParser(HIDDevice* device) : hidDevice(device), executionComplete(true), commandDelay(100),
+                                    currentLine(0), inCommentBlock(false) {
+        specialKeys["ENTER"] = DuckyScriptParser::DUCKY_ENTER;
+        specialKeys["ESC"] = DuckyScriptParser::DUCKY_ESC;
+        specialKeys["BACKSPACE"] = DuckyScriptParser::DUCKY_BACKSPACE;
+        specialKeys["TAB"] = DuckyScriptParser::DUCKY_TAB;
+        specialKeys["SPACE"] = DuckyScriptParser::DUCKY_SPACE;
+        specialKeys["DELETE"] = DuckyScriptParser::DUCKY_DELETE;
+        specialKeys["UP"] = DuckyScriptParser::DUCKY_UP;
+        specialKeys["DOWN"] = DuckyScriptParser::DUCKY_DOWN;
+        specialKeys["LEFT"] = DuckyScriptParser::DUCKY_LEFT;
+        specialKeys["RIGHT"] = DuckyScriptParser::DUCKY_RIGHT;
+        for (uint8_t i = 0; i < 12; i++) {
+            specialKeys["F" + String(i + 1)] = 0x3A + i;
+        }
+        
+        modifiers["CTRL"] = DuckyScriptParser::MOD_CTRL_LEFT;
+        modifiers["SHIFT"] = DuckyScriptParser::MOD_SHIFT_LEFT;
+        modifiers["ALT"] = DuckyScriptParser::MOD_ALT_LEFT;
+        modifiers["GUI"] = DuckyScriptParser::MOD_GUI_LEFT;
+        modifiers["WINDOWS"] = DuckyScriptParser::MOD_GUI_LEFT;
+        modifiers["COMMAND"] = DuckyScriptParser::MOD_GUI_LEFT;
+        modifiers["CTRL-LEFT"] = DuckyScriptParser::MOD_CTRL_LEFT;
+        modifiers["CTRL-RIGHT"] = DuckyScriptParser::MOD_CTRL_RIGHT;
+        modifiers["SHIFT-LEFT"] = DuckyScriptParser::MOD_SHIFT_LEFT;
+        modifiers["SHIFT-RIGHT"] = DuckyScriptParser::MOD_SHIFT_RIGHT;
+        modifiers["ALT-LEFT"] = DuckyScriptParser::MOD_ALT_LEFT;
+        modifiers["ALT-RIGHT"] = DuckyScriptParser::MOD_ALT_RIGHT;
+        modifiers["GUI-LEFT"] = DuckyScriptParser::MOD_GUI_LEFT;
+        modifiers["GUI-RIGHT"] = DuckyScriptParser::MOD_GUI_RIGHT;
+    }
+    
+    void execute(const String& script) {
+        executionComplete = false;
+        currentLine = 0;
+        inCommentBlock = false;
+        lines.clear();
+        
+        int start = 0;
+        int end = script.indexOf('\n');
+        while (end != -1) {
+            lines.push_back(script.substring(start, end));
+            start = end + 1;
+            end = script.indexOf('\n', start);
+        }
+        if (start < (int)script.length()) {
+            lines.push_back(script.substring(start));
+        }
+    }
+    
+    bool isExecutionComplete() { return executionComplete; }
+    
+    void process() {
+        if (currentLine < lines.size()) {
+            executeLine(lines[currentLine]);
+            currentLine++;
+        } else {
+            executionComplete = true;
+        }
+    }
+    
+    void executeLine(const String& line) {
+        String trimmedLine = trim(line);
+        if (trimmedLine.length() == 0) return;
+        
+        if (inCommentBlock) {
+            if (trimmedLine.startsWith("REM_BLOCK") && trimmedLine.indexOf("END") != -1) {
+                inCommentBlock = false;
+            }
+            return;
+        }
+        if (trimmedLine.startsWith("REM")) return;
+        
+        int spaceIndex = trimmedLine.indexOf(' ');
+        String command = (spaceIndex != -1) ? trimmedLine.substring(0, spaceIndex) : trimmedLine;
+        String parameters = (spaceIndex != -1) ? trimmedLine.substring(spaceIndex + 1) : "";
+        parameters = trim(parameters);
+        
+        if (command == "DELAY") {
+            int delayMs = parameters.toInt();
+            if (delayMs > 0) hidDevice->delay(delayMs);
+        } else if (command == "STRING") {
+            hidDevice->sendString(parameters);
+        } else if (command == "STRINGLN") {
+            hidDevice->sendString(parameters);
+            hidDevice->sendKey(DuckyScriptParser::DUCKY_ENTER);
+        } else if (command == "KEY") {
+            handleKEY(parameters);
+        } else if (command == "KEYS") {
+            hidDevice->sendKeySequence(parameters.c_str(), parameters.length());
+        } else if (command == "DEFAULTDELAY") {
+            int delayMs = parameters.toInt();
+            if (delayMs > 0) commandDelay = delayMs;
+        } else if (command == "REM_BLOCK") {
+            if (parameters.indexOf("END") == -1) inCommentBlock = true;
+        } else if (command == "GUI" || command == "WINDOWS" || command == "COMMAND") {
+            handleKEY(parameters.length() > 0 ? "GUI " + parameters : String("GUI"));
+        } else if (command == "ENTER") {
+            handleKEY("ENTER");
+        } else if (specialKeys.find(command.c_str()) != specialKeys.end() ||
+                   modifiers.find(command.c_str()) != modifiers.end()) {
+            handleKEY(line);
+        }
+        
+        if (commandDelay > 0) {
+            hidDevice->delay(commandDelay);
+        }
+    }
+};
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One run from the loaded text, copying it the way each parser takes it
+static DispatchResult runOnce(const std::string& text, bool compiled, NullDevice& device) {
+    DispatchResult result;
+    HeapStats::Snapshot before = HeapStats::get();
+    uint64_t start = wallNow();
+    
+    if (compiled) {
+        DuckyScriptParser parser;
+        parser.setHIDDevice(&device);
+        char* buffer = (char*)malloc(text.size() + 1);
+        memcpy(buffer, text.c_str(), text.size() + 1);
+        parser.execute(buffer, text.size());
+        result.compileNs = wallNow() - start;
+        while (!parser.isExecutionComplete()) {
+            parser.process();
+        }
+    } else {
+        LineParser parser(&device);
+        parser.execute(String(text.c_str()));
+        result.compileNs = wallNow() - start;
+        while (!parser.isExecutionComplete()) {
+            parser.process();
+        }
+    }
+    
+    result.totalNs = wallNow() - start;
+    result.allocations = HeapStats::get().allocations - before.allocations;
+    return result;
+}
+
+// Repeats a path until the timing is stable, returns the mean run
+static DispatchResult runStable(const std::string& text, bool compiled, NullDevice& device) {
+    DispatchResult result = runOnce(text, compiled, device);
+    uint64_t compileNs = 0;
+    uint64_t totalNs = 0;
+    uint32_t runs = 0;
+    while (totalNs < DISPATCH_MIN_RUN_NS) {
+        DispatchResult next = runOnce(text, compiled, device);
+        compileNs += next.compileNs;
+        totalNs += next.totalNs;
+        runs++;
+    }
+    result.compileNs = compileNs / runs;
+    result.totalNs = totalNs / runs;
+    return result;
+}
+
+void benchDispatch(const std::vector<std::string>& names) {
+    NullDevice device;
+    
+    printf("\n%-20s %6s %29s %29s %8s\n", "dispatch", "lines", "per line (split, total, allocs)",
+           "ops (compile, total, allocs)", "speedup");
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string text = LittleFSStorage->content(("/" + names[i]).c_str());
+        uint32_t lines = 0;
+        for (size_t j = 0; j < text.size(); j++) {
+            if (text[j] == '\n') lines++;
+        }
+        
+        DispatchResult line = runStable(text, false, device);
+        DispatchResult ops = runStable(text, true, device);
+        printf("%-20s %6u %8.1f us %8.1f us %7u %8.1f us %8.1f us %7u %7.1fx\n", names[i].c_str(), lines,
+               line.compileNs / 1e3, line.totalNs / 1e3, (unsigned)line.allocations, ops.compileNs / 1e3,
+               ops.totalNs / 1e3, (unsigned)ops.allocations, (double)line.totalNs / ops.totalNs);
+    }
+}
\ No newline at end of file
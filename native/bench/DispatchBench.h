@@ -0,0 +1,15 @@
+#ifndef BENCH_DISPATCH_BENCH_H
+#define BENCH_DISPATCH_BENCH_H
+
+#include <string>
+#include <vector>
+
+// Parser dispatch for every corpus payload: the per-line path the parser
+// had before DuckyOp, with lines split into Strings and every line
+// trimmed, split and matched against std::map key tables as it runs,
+// next to compiling the payload to ops and running them. Both send to a
+// device that drops the output, so only the parser is timed. The
+// payloads are expected in LittleFS under "/" + name.
+void benchDispatch(const std::vector<std::string>& names);
+
+#endif // BENCH_DISPATCH_BENCH_H
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "FileListBench.h"
+#include <Arduino.h>
+#include <SD.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "DirectoryIndex.h"
+#include "FileList.h"
+#include "PayloadCache.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+
+#define BENCH_DIR       "/payloads"
+#define MENU_ROWS       5     // maxItems in showMainMenu()
+#define SD_READ_US      300   // Same card as DirectoryBench.cpp
+#define SD_READ_BYTE_NS 500
+
+// Entry of the list PayloadManager kept before FileList
+struct FileEntry {
+    String name;
+    bool isDir;
+};
+
+// Stands in for the display, the rows are printed as the menu does
+class NullDisplay : public Print {
+public:
+    size_t written;
+    NullDisplay() : written(0) {}
+    size_t write(uint8_t c) override { written++; return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { written += size; return size; }
+};
+
+struct KeyResult {
+    double meanNs;
+    uint64_t maxNs;
+    double allocations;  // Per keypress
+    double reads;        // Card reads per keypress
+    double cardUs;       // Simulated card time per keypress
+};
+
+static NullDisplay display;
+static std::vector<FileEntry> oldFiles;
+static FileList list;
+static int selectedIndex;
+static int scrollOffset;
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::vector<FileEntry> getFileList() {
+    return oldFiles;
+}
+
+static void scrollTo(int count) {
+    if (selectedIndex < scrollOffset) scrollOffset = selectedIndex;
+    if (selectedIndex >= scrollOffset + MENU_ROWS) scrollOffset = selectedIndex - MENU_ROWS + 1;
+    if (scrollOffset >= count) scrollOffset = count - 1;
+}
+
+// moveSelectionDown() and showMainMenu() before FileList
+static void oldKeypress() {
+    std::vector<FileEntry> files = getFileList();
+    selectedIndex++;
+    if (selectedIndex >= (int)files.size()) selectedIndex = 0;
+    
+    std::vector<FileEntry> shown = getFileList();
+    scrollTo(shown.size());
+    for (int i = scrollOffset; i < (int)shown.size() && i < scrollOffset + MENU_ROWS; i++) {
+        display.print(i == selectedIndex ? "> " : "  ");
+        display.print(shown[i].isDir ? "[D] " : "    ");
+        display.println(shown[i].name);
+    }
+}
+
+// The same with the FileList window
+static void newKeypress() {
+    int count = list.size();
+    selectedIndex++;
+    if (selectedIndex >= count) selectedIndex = 0;
+    
+    scrollTo(count);
+    FileView entry;
+    for (int i = scrollOffset; i < count && i < scrollOffset + MENU_ROWS; i++) {
+        if (!list.get(i, entry)) break;
+        display.print(i == selectedIndex ? "> " : "  ");
+        display.print(entry.isDir ? "[D] " : "    ");
+        display.println(entry.name);
+    }
+}
+
+// Walks the selection through the whole list twice
+static KeyResult measure(void (*keypress)(), uint32_t count) {
+    KeyResult result;
+    memset(&result, 0, sizeof(result));
+    selectedIndex = 0;
+    scrollOffset = 0;
+    keypress();  // Warm up
+    
+    uint32_t presses = 2 * count;
+    SDStorage->resetStats();
+    uint64_t allocations = HeapStats::get().allocations;
+    uint64_t clockStart = HostClock::now();
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < presses; i++) {
+        uint64_t start = wallNow();
+        keypress();
+        uint64_t elapsed = wallNow() - start;
+        total += elapsed;
+        result.maxNs = std::max(result.maxNs, elapsed);
+    }
+    result.meanNs = (double)total / presses;
+    result.allocations = (double)(HeapStats::get().allocations - allocations) / presses;
+    result.reads = (double)SDStorage->stats.reads / presses;
+    result.cardUs = (double)(HostClock::now() - clockStart) / presses;
+    return result;
+}
+
+static void printRow(const char* name, uint32_t count, const KeyResult& result) {
+    printf("%-20s %7u %9.2f us %9.1f us %8.1f %8.3f %9.1f us\n", name, count, result.meanNs / 1e3,
+           result.maxNs / 1e3, result.allocations, result.reads, result.cardUs);
+}
+
+void benchFileList() {
+    static const uint32_t sizes[] = { 100, 1000, 10000 };
+    bool wasVirtual = HostClock::isVirtual();
+    HostClock::useVirtual(true);
+    
+    printf("\n%-20s %7s %12s %12s %8s %8s %12s\n", "keypress", "files", "mean", "max", "allocs", "reads",
+           "card time");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        SDStorage->clear();
+        memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+        SDStorage->mkdir(CACHE_DIR);
+        oldFiles.clear();
+        char path[64];
+        for (uint32_t n = 0; n < sizes[i]; n++) {
+            snprintf(path, sizeof(path), BENCH_DIR "/payload_%05u.txt", (unsigned)n);
+            SDStorage->addFile(path, "STRING hello\n");
+            FileEntry entry;
+            entry.name = path + sizeof(BENCH_DIR);
+            entry.isDir = false;
+            oldFiles.push_back(entry);
+        }
+        
+        DirectoryIndex index;
+        index.open(SD, BENCH_DIR, DirectoryIndex::cachePath(CACHE_DIR, BENCH_DIR));
+        list.attach(&index);
+        SDStorage->delays.readUs = SD_READ_US;
+        SDStorage->delays.readByteNs = SD_READ_BYTE_NS;
+        
+        printRow("vector copy", sizes[i], measure(oldKeypress, sizes[i]));
+        printRow("FileList window", sizes[i], measure(newKeypress, sizes[i]));
+        
+        list.clear();
+        index.close();
+    }
+    
+    oldFiles.clear();
+    SDStorage->clear();
+    memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+    HostClock::useVirtual(wasVirtual);
+}
\ No newline at end of file
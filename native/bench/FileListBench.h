@@ -0,0 +1,10 @@
+#ifndef BENCH_FILE_LIST_BENCH_H
+#define BENCH_FILE_LIST_BENCH_H
+
+// Cost of one selection keypress in the menu: the std::vector<FileEntry>
+// that getFileList() returned by value and moveSelectionDown() and
+// showMainMenu() each copied, against the FileList window over the
+// directory index. Time, heap allocations and card reads per keypress.
+void benchFileList();
+
+#endif // BENCH_FILE_LIST_BENCH_H
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "KeyNameBench.h"
+#include <Arduino.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "DuckyScriptParser.h"
+#include "HeapStats.h"
+
+#define KEY_BENCH_MIN_RUN_NS 200000000ULL  // Run each lookup for at least this long
+
+struct OldKeyName {
+    const char* name;
+    uint8_t value;
+    bool modifier;
+};
+
+// The names the map tables held, in their insertion order
+static const OldKeyName OLD_KEYS[] = {
+    { "ENTER", DuckyScriptParser::DUCKY_ENTER, false },
+    { "ESC", DuckyScriptParser::DUCKY_ESC, false },
+    { "BACKSPACE", DuckyScriptParser::DUCKY_BACKSPACE, false },
+    { "TAB", DuckyScriptParser::DUCKY_TAB, false },
+    { "SPACE", DuckyScriptParser::DUCKY_SPACE, false },
+    { "DELETE", DuckyScriptParser::DUCKY_DELETE, false },
+    { "UP", DuckyScriptParser::DUCKY_UP, false },
+    { "DOWN", DuckyScriptParser::DUCKY_DOWN, false },
+    { "LEFT", DuckyScriptParser::DUCKY_LEFT, false },
+    { "RIGHT", DuckyScriptParser::DUCKY_RIGHT, false },
+    { "F1", DuckyScriptParser::DUCKY_F1, false },
+    { "F2", DuckyScriptParser::DUCKY_F1 + 1, false },
+    { "F3", DuckyScriptParser::DUCKY_F1 + 2, false },
+    { "F4", DuckyScriptParser::DUCKY_F1 + 3, false },
+    { "F5", DuckyScriptParser::DUCKY_F1 + 4, false },
+    { "F6", DuckyScriptParser::DUCKY_F1 + 5, false },
+    { "F7", DuckyScriptParser::DUCKY_F1 + 6, false },
+    { "F8", DuckyScriptParser::DUCKY_F1 + 7, false },
+    { "F9", DuckyScriptParser::DUCKY_F1 + 8, false },
+    { "F10", DuckyScriptParser::DUCKY_F1 + 9, false },
+    { "F11", DuckyScriptParser::DUCKY_F1 + 10, false },
+    { "F12", DuckyScriptParser::DUCKY_F1 + 11, false },
+    { "CTRL", DuckyScriptParser::MOD_CTRL_LEFT, true },
+    { "SHIFT", DuckyScriptParser::MOD_SHIFT_LEFT, true },
+    { "ALT", DuckyScriptParser::MOD_ALT_LEFT, true },
+    { "GUI", DuckyScriptParser::MOD_GUI_LEFT, true },
+    { "WINDOWS", DuckyScriptParser::MOD_GUI_LEFT, true },
+    { "COMMAND", DuckyScriptParser::MOD_GUI_LEFT, true },
+    { "CTRL-LEFT", DuckyScriptParser::MOD_CTRL_LEFT, true },
+    { "CTRL-RIGHT", DuckyScriptParser::MOD_CTRL_RIGHT, true },
+    { "SHIFT-LEFT", DuckyScriptParser::MOD_SHIFT_LEFT, true },
+    { "SHIFT-RIGHT", DuckyScriptParser::MOD_SHIFT_RIGHT, true },
+    { "ALT-LEFT", DuckyScriptParser::MOD_ALT_LEFT, true },
+    { "ALT-RIGHT", DuckyScriptParser::MOD_ALT_RIGHT, true },
+    { "GUI-LEFT", DuckyScriptParser::MOD_GUI_LEFT, true },
+    { "GUI-RIGHT", DuckyScriptParser::MOD_GUI_RIGHT, true },
+};
+
+// Tokens of typical KEY lines and key commands ("GUI r", "CTRL ALT
+// DELETE", "ALT F4"), single characters included. Only names the old
+// tables knew, so every lookup finds the same key.
+static const char* TOKENS[] = {
+    "GUI", "r", "CTRL", "ALT", "DELETE", "ENTER", "CTRL", "c", "CTRL", "v", "ALT", "F4", "SHIFT", "TAB",
+    "ESC", "UP", "DOWN", "LEFT", "RIGHT", "WINDOWS", "d", "CTRL-LEFT", "SHIFT", "F10", "SPACE", "BACKSPACE",
+    "ENTER", "GUI-RIGHT", "x", "F12"
+};
+
+#define KEY_BENCH_TOKENS (sizeof(TOKENS) / sizeof(TOKENS[0]))
+#define OLD_KEY_COUNT    (sizeof(OLD_KEYS) / sizeof(OLD_KEYS[0]))
+
+enum KeyLookup {
+    LOOKUP_MAP,
+    LOOKUP_LINEAR,
+    LOOKUP_SORTED
+};
+
+struct TokenSpan {
+    uint32_t start;
+    uint32_t end;
+};
+
+static std::map<String, uint8_t> specialKeys;
+static std::map<String, uint8_t> modifiers;
+static std::vector<String> tokenStrings;
+static std::string line;
+static std::vector<TokenSpan> spans;
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// handleKEY() per token: the token was already a String from the split
+static uint8_t lookupMap(const String& part, uint8_t& mods) {
+    if (modifiers.find(part.c_str()) != modifiers.end()) {
+        mods |= modifiers[part.c_str()];
+        return 0;
+    }
+    if (specialKeys.find(part.c_str()) != specialKeys.end()) return specialKeys[part.c_str()];
+    return part.length() == 1 ? part[0] : 0;
+}
+
+static uint8_t lookupLinear(const char* text, uint32_t start, uint32_t end, uint8_t& mods) {
+    uint32_t length = end - start;
+    for (size_t i = 0; i < OLD_KEY_COUNT; i++) {
+        const char* name = OLD_KEYS[i].name;
+        if (strncmp(text + start, name, length) != 0 || name[length] != '\0') continue;
+        if (!OLD_KEYS[i].modifier) return OLD_KEYS[i].value;
+        mods |= OLD_KEYS[i].value;
+        return 0;
+    }
+    return length == 1 ? text[start] : 0;
+}
+
+static uint8_t lookupSorted(const char* text, uint32_t start, uint32_t end, uint8_t& mods) {
+    uint8_t value;
+    DuckyScriptParser::KeyKind kind = DuckyScriptParser::findKey(text, start, end, value);
+    if (kind == DuckyScriptParser::KEY_MODIFIER) {
+        mods |= value;
+        return 0;
+    }
+    if (kind != DuckyScriptParser::KEY_NONE) return value;
+    return end - start == 1 ? text[start] : 0;
+}
+
+// One pass over the tokens, returns a checksum so the loop is not dropped
+static uint32_t lookupAll(KeyLookup lookup) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < KEY_BENCH_TOKENS; i++) {
+        uint8_t mods = 0;
+        uint8_t key;
+        if (lookup == LOOKUP_MAP) {
+            key = lookupMap(tokenStrings[i], mods);
+        } else if (lookup == LOOKUP_LINEAR) {
+            key = lookupLinear(line.c_str(), spans[i].start, spans[i].end, mods);
+        } else {
+            key = lookupSorted(line.c_str(), spans[i].start, spans[i].end, mods);
+        }
+        sum += key + mods;
+    }
+    return sum;
+}
+
+void benchKeyNames() {
+    for (size_t i = 0; i < OLD_KEY_COUNT; i++) {
+        (OLD_KEYS[i].modifier ? modifiers : specialKeys)[OLD_KEYS[i].name] = OLD_KEYS[i].value;
+    }
+    for (size_t i = 0; i < KEY_BENCH_TOKENS; i++) {
+        TokenSpan span;
+        span.start = line.size();
+        line += TOKENS[i];
+        span.end = line.size();
+        line += ' ';
+        spans.push_back(span);
+        tokenStrings.push_back(TOKENS[i]);
+    }
+    
+    static const char* labels[] = { "std::map<String>", "linear, in place", "findKey()" };
+    uint32_t expected = lookupAll(LOOKUP_MAP);
+    
+    printf("\n%-20s %14s %11s %9s\n", "key name lookup", "tokens/s", "ns/token", "allocs");
+    for (int lookup = LOOKUP_MAP; lookup <= LOOKUP_SORTED; lookup++) {
+        HeapStats::Snapshot before = HeapStats::get();
+        uint32_t sum = lookupAll((KeyLookup)lookup);
+        uint64_t allocations = HeapStats::get().allocations - before.allocations;
+        
+        uint64_t tokens = 0;
+        uint64_t start = wallNow();
+        uint64_t elapsedNs = 0;
+        while (elapsedNs < KEY_BENCH_MIN_RUN_NS) {
+            sum += lookupAll((KeyLookup)lookup);
+            tokens += KEY_BENCH_TOKENS;
+            elapsedNs = wallNow() - start;
+        }
+        
+        if (sum != expected * (tokens / KEY_BENCH_TOKENS + 1)) printf("%s: keys differ\n", labels[lookup]);
+        printf("%-20s %14.0f %11.1f %9.2f\n", labels[lookup], tokens * 1e9 / elapsedNs,
+               (double)elapsedNs / tokens, (double)allocations / KEY_BENCH_TOKENS);
+    }
+    
+    specialKeys.clear();
+    modifiers.clear();
+    tokenStrings.clear();
+    spans.clear();
+    line.clear();
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef BENCH_KEY_NAME_BENCH_H
+#define BENCH_KEY_NAME_BENCH_H
+
+// Key name lookups per second for the tokens of KEY lines: the std::map
+// tables keyed by String the parser had before, a linear scan of the
+// same names in place, and DuckyScriptParser::findKey() on the sorted
+// tables it uses now. Allocations per token for each.
+void benchKeyNames();
+
+#endif // BENCH_KEY_NAME_BENCH_H
\ No newline at end of file
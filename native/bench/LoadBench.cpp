@@ -0,0 +1,140 @@
+#include "LoadBench.h"
+#include <Arduino.h>
+#include <SD.h>
+#include <chrono>
+#include "PayloadManager.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+
+// Same card as DirectoryBench.cpp
+#define SD_OPEN_US      1500
+#define SD_READ_US      300
+#define SD_READ_BYTE_NS 500
+
+#define LOAD_PATH       "/payload.txt"
+#define LOAD_MIN_RUN_NS 100000000ULL  // Load each size for at least this long
+
+enum LoadPath {
+    LOAD_BYTE_LOOP,
+    LOAD_READ_BUFFER,
+    LOAD_READ_FILE
+};
+
+struct LoadResult {
+    uint64_t ns;           // Per load, from open to the loaded buffer
+    uint64_t reads;        // read() calls that reached the file
+    uint64_t allocations;
+    size_t length;
+};
+
+static PayloadManager manager;
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// loadFile() before readBuffer()
+static String byteLoop(File& file) {
+    String content = "";
+    while (file.available()) {
+        content += (char)file.read();
+    }
+    return content;
+}
+
+static LoadResult loadOnce(LoadPath path, uint64_t (*now)()) {
+    LoadResult result;
+    SDStorage->resetStats();
+    HeapStats::Snapshot before = HeapStats::get();
+    uint64_t start = now();
+    
+    File file = SD.open(LOAD_PATH, FILE_READ);
+    if (path == LOAD_BYTE_LOOP) {
+        result.length = byteLoop(file).length();
+    } else if (path == LOAD_READ_FILE) {
+        result.length = manager.readFile(file).length();
+    } else {
+        uint32_t length = 0;
+        free(manager.readBuffer(file, length));
+        result.length = length;
+    }
+    file.close();
+    
+    result.ns = now() - start;
+    result.reads = SDStorage->stats.reads;
+    result.allocations = HeapStats::get().allocations - before.allocations;
+    return result;
+}
+
+// Mean of repeated loads on the host CPU
+static LoadResult loadHost(LoadPath path) {
+    loadOnce(path, wallNow);  // Warm up
+    LoadResult result = loadOnce(path, wallNow);
+    uint64_t total = result.ns;
+    uint32_t runs = 1;
+    while (total < LOAD_MIN_RUN_NS) {
+        total += loadOnce(path, wallNow).ns;
+        runs++;
+    }
+    result.ns = total / runs;
+    return result;
+}
+
+static uint64_t virtualNowNs() {
+    return HostClock::now() * 1000;
+}
+
+static double kbPerSecond(size_t bytes, uint64_t ns) {
+    return ns > 0 ? bytes / 1024.0 / (ns / 1e9) : 0;
+}
+
+void benchLoading() {
+    static const size_t sizes[] = { 1024, 4096, 16384, 65536, 262144, 1048576 };
+    bool wasVirtual = HostClock::isVirtual();
+    
+    printf("\n%-12s %14s %9s %8s %14s %9s %8s %14s %14s %7s\n", "load", "byte loop", "reads", "allocs",
+           "readBuffer", "reads", "allocs", "readFile", "card", "ok");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        std::string content;
+        while (content.size() < sizes[i]) {
+            content += "STRING the quick brown fox jumps over the lazy dog\nENTER\n";
+        }
+        content.resize(sizes[i]);
+        SDStorage->clear();
+        memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+        SDStorage->addFile(LOAD_PATH, content);
+        
+        // Host CPU only, no card delays
+        HostClock::useVirtual(true);
+        LoadResult loop = loadHost(LOAD_BYTE_LOOP);
+        LoadResult buffer = loadHost(LOAD_READ_BUFFER);
+        // readFile() refuses what is streamed instead
+        char string[24] = "-";
+        LoadResult copied;
+        copied.length = sizes[i];
+        if (sizes[i] <= PayloadManager::MAX_LOAD_SIZE) {
+            copied = loadHost(LOAD_READ_FILE);
+            snprintf(string, sizeof(string), "%9.0f KB/s", kbPerSecond(sizes[i], copied.ns));
+        }
+        
+        // readBuffer() on the simulated card
+        SDStorage->delays.openUs = SD_OPEN_US;
+        SDStorage->delays.readUs = SD_READ_US;
+        SDStorage->delays.readByteNs = SD_READ_BYTE_NS;
+        LoadResult card = loadOnce(LOAD_READ_BUFFER, virtualNowNs);
+        
+        bool ok = loop.length == sizes[i] && buffer.length == sizes[i] && copied.length == sizes[i] &&
+                  card.length == sizes[i];
+        char label[16];
+        snprintf(label, sizeof(label), "%u KB", (unsigned)(sizes[i] / 1024));
+        printf("%-12s %9.0f KB/s %9u %8u %9.0f KB/s %9u %8u %14s %9.0f KB/s %7s\n", label,
+               kbPerSecond(sizes[i], loop.ns), (unsigned)loop.reads, (unsigned)loop.allocations,
+               kbPerSecond(sizes[i], buffer.ns), (unsigned)buffer.reads, (unsigned)buffer.allocations, string,
+               kbPerSecond(sizes[i], card.ns), ok ? "yes" : "NO");
+    }
+    
+    SDStorage->clear();
+    memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+    HostClock::useVirtual(wasVirtual);
+}
\ No newline at end of file
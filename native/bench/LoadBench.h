@@ -0,0 +1,10 @@
+#ifndef BENCH_LOAD_BENCH_H
+#define BENCH_LOAD_BENCH_H
+
+// Payload load throughput for files of 1 KB to 1 MB on SD: the byte at a
+// time String loop loadFile() used to run, readBuffer() and readFile() on
+// the host CPU, and readBuffer() on a simulated card, with read calls and
+// heap allocations per load.
+void benchLoading();
+
+#endif // BENCH_LOAD_BENCH_H
\ No newline at end of file
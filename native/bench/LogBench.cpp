@@ -0,0 +1,98 @@
+// Built at DEBUG level whatever the env sets, so LOG_DEBUG() here is the
+// enabled path and the compiled out one is timed without it
+#undef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "LogBench.h"
+#include <Arduino.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include "Log.h"
+#include "HeapStats.h"
+#include "MockHIDDevice.h"
+
+#define LOG_BENCH_KEYS  200000
+#define LOG_BENCH_BATCH 32      // Records per drain, half the ring
+#define SERIAL_BAUD     115200
+#define SERIAL_BITS     10      // Start, 8 data and stop bit per byte
+
+enum LogMode {
+    LOG_OFF,
+    LOG_RING,
+    LOG_SERIAL
+};
+
+struct LogResult {
+    uint64_t keyNs;       // Spent on the keys, logging included
+    uint64_t drainNs;     // Spent formatting and printing ring records
+    uint64_t allocations;
+    uint64_t serialBytes;
+};
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs with stdout sent to /dev/null so printing costs what the formatting
+// and write calls cost, not what the terminal does with the text
+static LogResult runKeys(MockHIDDevice& device, LogMode mode) {
+    LogResult result;
+    memset(&result, 0, sizeof(result));
+    device.reset();
+    
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    
+    HeapStats::Snapshot before = HeapStats::get();
+    for (uint32_t i = 0; i < LOG_BENCH_KEYS; i += LOG_BENCH_BATCH) {
+        uint64_t start = wallNow();
+        for (uint32_t j = 0; j < LOG_BENCH_BATCH; j++) {
+            uint8_t key = 0x04 + (i + j) % 26;
+            uint8_t modifiers = (j & 1) ? 0x02 : 0;
+            if (mode == LOG_RING) {
+                LOG_DEBUG("USB sendKey key=%x mods=%x", key, modifiers);
+            } else if (mode == LOG_SERIAL) {
+                result.serialBytes += Serial.println("DEBUG: USB sendKey key=" + String(key, HEX) + " mods=" +
+                                                     String(modifiers, HEX));
+            }
+            device.sendKey(key, modifiers);
+        }
+        result.keyNs += wallNow() - start;
+        
+        start = wallNow();
+        Log.flush();
+        result.drainNs += wallNow() - start;
+    }
+    result.allocations = HeapStats::get().allocations - before.allocations;
+    
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return result;
+}
+
+static void printRow(const char* name, const LogResult& result) {
+    double wireUs = result.serialBytes * SERIAL_BITS * 1e6 / SERIAL_BAUD / LOG_BENCH_KEYS;
+    printf("%-24s %9.0f %9.0f %9.2f %9.1f\n", name, (double)result.keyNs / LOG_BENCH_KEYS,
+           (double)result.drainNs / LOG_BENCH_KEYS, (double)result.allocations / LOG_BENCH_KEYS, wireUs);
+}
+
+void benchLogging() {
+    UsbTimingModel usb(1000);
+    MockHIDDevice device(&usb, false, false);
+    device.setConnected(true);
+    Log.flush();
+    
+    // Warm up the allocator and caches
+    runKeys(device, LOG_RING);
+    
+    printf("\n%-24s %9s %9s %9s %9s\n", "logging per key", "key ns", "drain ns", "allocs", "wire us");
+    printRow("compiled out", runKeys(device, LOG_OFF));
+    printRow("LOG_DEBUG ring buffer", runKeys(device, LOG_RING));
+    printRow("Serial.println(String)", runKeys(device, LOG_SERIAL));
+}
\ No newline at end of file
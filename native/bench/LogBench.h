@@ -0,0 +1,9 @@
+#ifndef BENCH_LOG_BENCH_H
+#define BENCH_LOG_BENCH_H
+
+// Per-key cost of logging: the USB sendKey DEBUG message compiled out,
+// written to the ring buffer, and printed the way it was before Log.h,
+// with a String built per key and sent to a 115200 baud serial port.
+void benchLogging();
+
+#endif // BENCH_LOG_BENCH_H
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "OutputBench.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+#include "HIDOutputTask.h"
+
+#define QUEUE_ENTRIES   2000000
+#define LATENCY_SAMPLES 2000
+#define WAKE_SAMPLES    500
+#define WAKE_SPACING_MS 2  // Output task goes back to sleep between samples
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void printPercentiles(const char* name, std::vector<uint64_t>& samples) {
+    std::sort(samples.begin(), samples.end());
+    printf("%-28s %9.1f %9.1f %9.1f us\n", name, samples[samples.size() / 2] / 1e3,
+           samples[samples.size() * 99 / 100] / 1e3, samples.back() / 1e3);
+}
+
+// Entries of the output task's size through the queue, both sides
+// yielding when it is full or empty like the firmware's producer
+static void benchQueueThroughput() {
+    static SpscQueue<HIDOutputEntry, 128> queue;
+    HIDOutputEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    
+    uint64_t start = wallNow();
+    std::thread consumer([]() {
+        HIDOutputEntry received;
+        uint32_t count = 0;
+        while (count < QUEUE_ENTRIES) {
+            if (queue.pop(received)) count++;
+            else std::this_thread::yield();
+        }
+    });
+    for (uint32_t i = 0; i < QUEUE_ENTRIES; i++) {
+        entry.value = i;
+        while (!queue.push(entry)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    double seconds = (wallNow() - start) / 1e9;
+    printf("%-28s %9.1f M entries/s (%u bytes each)\n", "spsc queue", QUEUE_ENTRIES / seconds / 1e6,
+           (unsigned)sizeof(HIDOutputEntry));
+}
+
+// Push to pop with the consumer spinning, one entry in flight at a time
+static void benchQueueLatency() {
+    static SpscQueue<uint64_t, 128> requests;
+    static std::atomic<uint32_t> received(0);
+    std::vector<uint64_t> samples;
+    
+    std::thread consumer([&samples]() {
+        uint64_t sent;
+        while (received < LATENCY_SAMPLES) {
+            if (!requests.pop(sent)) {
+                std::this_thread::yield();
+                continue;
+            }
+            samples.push_back(wallNow() - sent);
+            received++;
+        }
+    });
+    for (uint32_t i = 0; i < LATENCY_SAMPLES; i++) {
+        requests.push(wallNow());
+        while (received <= i) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    printPercentiles("spsc push to pop", samples);
+}
+
+// Records when the output task wrote each report
+class TimingSink : public HIDReportSink {
+public:
+    std::atomic<uint64_t> writtenAt;
+    
+    TimingSink() : writtenAt(0) {}
+    void writeReport(const HIDKeyReport& report) override { writtenAt = wallNow(); }
+    void writeMediaKey(uint8_t mediaKey) override {}
+};
+
+// Push of a report to an idle output task until its write, and the
+// spacing of reports behind a DELAY compared with the requested one
+static void benchOutputTask() {
+    TimingSink sink;
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    std::vector<uint64_t> wake;
+    std::vector<uint64_t> lateness;
+    
+    for (uint32_t i = 0; i < WAKE_SAMPLES; i++) {
+        delay(WAKE_SPACING_MS);
+        sink.writtenAt = 0;
+        uint64_t pushed = wallNow();
+        HIDOutput.pushReport(&sink, report);
+        while (sink.writtenAt == 0) {
+            std::this_thread::yield();
+        }
+        wake.push_back(sink.writtenAt - pushed);
+    }
+    printPercentiles("idle task push to write", wake);
+    
+    for (uint32_t i = 0; i < WAKE_SAMPLES / 10; i++) {
+        HIDOutput.pushReport(&sink, report);
+        while (!HIDOutput.isIdle()) {
+            std::this_thread::yield();
+        }
+        uint64_t first = sink.writtenAt;
+        HIDOutput.pushDelay(WAKE_SPACING_MS);
+        HIDOutput.pushReport(&sink, report);
+        while (!HIDOutput.isIdle()) {
+            std::this_thread::yield();
+        }
+        uint64_t spacing = sink.writtenAt - first;
+        uint64_t requested = WAKE_SPACING_MS * 1000000ULL;
+        lateness.push_back(spacing > requested ? spacing - requested : 0);
+    }
+    printPercentiles("DELAY overshoot", lateness);
+}
+
+void benchOutputPath() {
+    HostClock::useVirtual(false);
+    HIDOutput.begin();
+    
+    printf("\n");
+    benchQueueThroughput();
+    printf("%-28s %9s %9s %9s\n", "output path", "p50", "p99", "max");
+    benchQueueLatency();
+    benchOutputTask();
+}
\ No newline at end of file
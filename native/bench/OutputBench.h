@@ -0,0 +1,10 @@
+#ifndef BENCH_OUTPUT_BENCH_H
+#define BENCH_OUTPUT_BENCH_H
+
+// Throughput and latency of the HID output path on Linux threads: the
+// SPSC queue between two threads, and from a push to the output task's
+// write. Starts the output task and switches to the real clock, so it
+// runs after everything that needs inline output or virtual time.
+void benchOutputPath();
+
+#endif // BENCH_OUTPUT_BENCH_H
\ No newline at end of file
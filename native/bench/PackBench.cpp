@@ -0,0 +1,196 @@
+#include "PackBench.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <chrono>
+#include "PackArchive.h"
+#include "PayloadManager.h"
+#include "MemoryFS.h"
+
+// Rough LittleFS on the Cardputer's SPI flash: an open walks the metadata
+// pairs of the path, reads go through the flash cache
+#define FLASH_OPEN_US      1000
+#define FLASH_READ_US      60
+#define FLASH_READ_BYTE_NS 25
+#define FLASH_LIST_US      200
+
+#define PACK_DIR  "/pack"
+#define PACK_PATH "/payloads.pak"
+
+struct PackPayload {
+    std::string name;
+    std::string content;
+};
+
+struct StepResult {
+    uint64_t flashUs;  // Simulated time, flash access included
+    uint64_t wallNs;   // Host CPU time
+    uint32_t opens;
+    uint32_t reads;
+};
+
+static PayloadManager manager;
+static PackArchive archive;
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool packOrder(const PackPayload& a, const PackPayload& b) {
+    int result = strcasecmp(a.name.c_str(), b.name.c_str());
+    return result != 0 ? result < 0 : strcmp(a.name.c_str(), b.name.c_str()) < 0;
+}
+
+// What tools/pack_payloads.py writes
+static std::string pack(std::vector<PackPayload> payloads) {
+    std::sort(payloads.begin(), payloads.end(), packOrder);
+    PackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+    header.version = PACK_VERSION;
+    header.count = payloads.size();
+    header.dataOffset = sizeof(header) + payloads.size() * sizeof(PackEntry);
+    
+    std::string table;
+    std::string data;
+    for (size_t i = 0; i < payloads.size(); i++) {
+        PackEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.offset = header.dataOffset + data.size();
+        entry.size = payloads[i].content.size();
+        strncpy(entry.name, payloads[i].name.c_str(), PACK_NAME_SIZE - 1);
+        table.append((const char*)&entry, sizeof(entry));
+        data += payloads[i].content;
+    }
+    return std::string((const char*)&header, sizeof(header)) + table + data;
+}
+
+static void startStep(uint64_t& clockStart, uint64_t& wallStart) {
+    LittleFSStorage->resetStats();
+    clockStart = HostClock::now();
+    wallStart = wallNow();
+}
+
+static StepResult endStep(uint64_t clockStart, uint64_t wallStart, uint32_t runs) {
+    StepResult result;
+    result.wallNs = (wallNow() - wallStart) / runs;
+    result.flashUs = (HostClock::now() - clockStart) / runs;
+    result.opens = LittleFSStorage->stats.opens + LittleFSStorage->stats.dirOpens;
+    result.reads = LittleFSStorage->stats.reads;
+    return result;
+}
+
+static uint32_t listLoose() {
+    uint32_t count = 0;
+    File dir = LittleFS.open(PACK_DIR);
+    while (dir.getNextFileName().length() > 0) {
+        count++;
+    }
+    dir.close();
+    return count;
+}
+
+static File openLoose(const std::string& name) {
+    return LittleFS.open((PACK_DIR "/" + name).c_str(), FILE_READ);
+}
+
+static File openPacked(const std::string& name) {
+    return archive.openEntry(name.c_str());
+}
+
+// Opens every payload, and with load reads it into a buffer as a run does
+static StepResult openAll(const std::vector<PackPayload>& payloads, File (*open)(const std::string&), bool load,
+                          bool& same) {
+    uint64_t clockStart, wallStart;
+    startStep(clockStart, wallStart);
+    for (size_t i = 0; i < payloads.size(); i++) {
+        File file = open(payloads[i].name);
+        if (load) {
+            uint32_t length = 0;
+            char* buffer = manager.readBuffer(file, length);
+            if (!buffer || payloads[i].content.compare(0, std::string::npos, buffer, length) != 0) same = false;
+            free(buffer);
+        }
+        if (!file) same = false;
+        file.close();
+    }
+    return endStep(clockStart, wallStart, payloads.size());
+}
+
+static void printStep(const char* name, const StepResult& loose, const StepResult& packed) {
+    char opens[24];
+    char reads[24];
+    snprintf(opens, sizeof(opens), "%u/%u", loose.opens, packed.opens);
+    snprintf(reads, sizeof(reads), "%u/%u", loose.reads, packed.reads);
+    printf("  %-10s %9.0f us %9.0f us %8.1f us %8.1f us %9s %9s\n", name, (double)loose.flashUs,
+           (double)packed.flashUs, loose.wallNs / 1e3, packed.wallNs / 1e3, opens, reads);
+}
+
+void benchPacking(const std::vector<std::string>& names) {
+    static const uint32_t sizes[] = { 16, 64, PackArchive::MAX_ENTRIES };
+    bool wasVirtual = HostClock::isVirtual();
+    HostClock::useVirtual(true);
+    
+    printf("\n%-12s %12s %12s %11s %11s %9s %9s\n", "loose, .pak", "flash loose", "flash pak", "cpu loose",
+           "cpu pak", "opens", "reads");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        std::vector<PackPayload> payloads;
+        for (uint32_t n = 0; n < sizes[i]; n++) {
+            PackPayload payload;
+            if (n < names.size()) {
+                payload.name = names[n];
+                payload.content = LittleFSStorage->content(("/" + names[n]).c_str());
+            } else {
+                char name[32];
+                snprintf(name, sizeof(name), "payload_%03u.txt", (unsigned)n);
+                payload.name = name;
+                payload.content = "REM generated\nGUI r\nDELAY 300\nSTRING notepad\nENTER\nDELAY 500\n";
+                payload.content += "STRING " + std::string(100 + (n * 37) % 1500, 'x') + "\nENTER\n";
+            }
+            payloads.push_back(payload);
+        }
+        
+        memset(&LittleFSStorage->delays, 0, sizeof(LittleFSStorage->delays));
+        LittleFSStorage->mkdir(PACK_DIR);
+        for (size_t n = 0; n < payloads.size(); n++) {
+            LittleFSStorage->addFile((PACK_DIR "/" + payloads[n].name).c_str(), payloads[n].content);
+        }
+        std::string packed = pack(payloads);
+        LittleFSStorage->addFile(PACK_PATH, packed);
+        LittleFSStorage->delays.openUs = FLASH_OPEN_US;
+        LittleFSStorage->delays.readUs = FLASH_READ_US;
+        LittleFSStorage->delays.readByteNs = FLASH_READ_BYTE_NS;
+        LittleFSStorage->delays.listUs = FLASH_LIST_US;
+        
+        // Listing the folder against mounting the archive
+        uint64_t clockStart, wallStart;
+        startStep(clockStart, wallStart);
+        bool same = listLoose() == payloads.size();
+        StepResult looseList = endStep(clockStart, wallStart, 1);
+        startStep(clockStart, wallStart);
+        same = archive.open(LittleFS, PACK_PATH) && archive.getCount() == payloads.size() && same;
+        StepResult packedList = endStep(clockStart, wallStart, 1);
+        
+        StepResult looseOpen = openAll(payloads, openLoose, false, same);
+        StepResult packedOpen = openAll(payloads, openPacked, false, same);
+        StepResult looseLoad = openAll(payloads, openLoose, true, same);
+        StepResult packedLoad = openAll(payloads, openPacked, true, same);
+        archive.close();
+        
+        printf("%u payloads, %u KB archive, same contents: %s\n", sizes[i], (unsigned)(packed.size() / 1024),
+               same ? "yes" : "NO");
+        printStep("list", looseList, packedList);
+        printStep("open", looseOpen, packedOpen);
+        printStep("load", looseLoad, packedLoad);
+        
+        memset(&LittleFSStorage->delays, 0, sizeof(LittleFSStorage->delays));
+        for (size_t n = 0; n < payloads.size(); n++) {
+            LittleFS.remove((PACK_DIR "/" + payloads[n].name).c_str());
+        }
+        LittleFS.rmdir(PACK_DIR);
+        LittleFS.remove(PACK_PATH);
+    }
+    
+    HostClock::useVirtual(wasVirtual);
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef BENCH_PACK_BENCH_H
+#define BENCH_PACK_BENCH_H
+
+#include <string>
+#include <vector>
+
+// Internal storage as loose files and as one .pak archive of the same
+// payloads, for 16, 64 and 256 payloads on simulated flash: listing the
+// folder or mounting the archive, and opening and loading every payload.
+// The corpus payloads (in LittleFS under "/" + name) are packed first,
+// generated ones fill up the rest.
+void benchPacking(const std::vector<std::string>& names);
+
+#endif // BENCH_PACK_BENCH_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "PlaybackBench.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include "DuckyScriptParser.h"
+#include "PayloadManager.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+#include "ScriptCompiler.h"
+
+#define PLAYBACK_MIN_RUN_NS 200000000ULL  // Run each path for at least this long
+
+struct PathResult {
+    uint64_t firstNs;      // execute() or play() and the first process()
+    uint64_t totalNs;
+    uint64_t allocations;
+    uint64_t bytesRead;
+};
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One run from opening the file, as loop() starts a payload
+static PathResult runOnce(const std::string& path, bool report, MockHIDDevice& device) {
+    static PayloadManager manager;
+    PathResult result;
+    device.reset();
+    LittleFSStorage->resetStats();
+    HeapStats::Snapshot before = HeapStats::get();
+    uint64_t start = wallNow();
+    
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&device);
+    File file = LittleFS.open(path.c_str(), FILE_READ);
+    if (report) {
+        parser.play(file);
+    } else if (file.size() > PayloadManager::MAX_LOAD_SIZE) {
+        parser.execute(file);
+    } else {
+        uint32_t length = 0;
+        char* buffer = manager.readBuffer(file, length);
+        file.close();
+        parser.execute(buffer, length);
+    }
+    parser.process();
+    result.firstNs = wallNow() - start;
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+    
+    result.totalNs = wallNow() - start;
+    result.allocations = HeapStats::get().allocations - before.allocations;
+    result.bytesRead = LittleFSStorage->stats.bytesRead;
+    return result;
+}
+
+// Repeats a path until the timing is stable, returns the mean run
+static PathResult runPath(const std::string& path, bool report, MockHIDDevice& device) {
+    runOnce(path, report, device);  // Warm up
+    PathResult total;
+    memset(&total, 0, sizeof(total));
+    uint32_t runs = 0;
+    while (total.totalNs < PLAYBACK_MIN_RUN_NS) {
+        PathResult run = runOnce(path, report, device);
+        total.firstNs += run.firstNs;
+        total.totalNs += run.totalNs;
+        total.allocations = run.allocations;
+        total.bytesRead = run.bytesRead;
+        runs++;
+    }
+    total.firstNs /= runs;
+    total.totalNs /= runs;
+    return total;
+}
+
+static bool sameReports(MockHIDDevice& text, MockHIDDevice& report) {
+    const std::vector<MockReport>& a = text.getReports();
+    const std::vector<MockReport>& b = report.getReports();
+    if (a.size() != b.size() || text.getDurationUs() != report.getDurationUs()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].timeUs != b[i].timeUs || a[i].media != b[i].media || a[i].mediaKey != b[i].mediaKey ||
+            memcmp(&a[i].report, &b[i].report, sizeof(a[i].report)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void benchPlayback(const std::vector<std::string>& names) {
+    UsbTimingModel usb(1000);
+    MockHIDDevice timed(&usb, false, false);
+    MockHIDDevice textDevice(&usb, true, false);
+    MockHIDDevice reportDevice(&usb, true, false);
+    
+    printf("\n%-20s %9s %10s %10s %10s %10s %9s %9s %9s %9s %5s\n", "text vs .hidr", "hidr size", "first txt",
+           "first hidr", "total txt", "total hidr", "alloc txt", "alloc hidr", "read txt", "read hidr", "same");
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string script = "/" + names[i];
+        std::string report = PayloadManager::reportFileName(String(script.c_str())).c_str();
+        File source = LittleFS.open(script.c_str(), FILE_READ);
+        File output = LittleFS.open(report.c_str(), FILE_WRITE);
+        uint32_t records = compileScript(source, output);
+        source.close();
+        output.close();
+        if (records == 0) continue;
+        
+        PathResult text = runPath(script, false, timed);
+        PathResult played = runPath(report, true, timed);
+        runOnce(script, false, textDevice);
+        runOnce(report, true, reportDevice);
+        
+        printf("%-20s %9u %7.1f us %7.1f us %7.0f us %7.0f us %9u %9u %9u %9u %5s\n", names[i].c_str(),
+               (unsigned)LittleFSStorage->content(report.c_str()).size(), text.firstNs / 1e3, played.firstNs / 1e3,
+               text.totalNs / 1e3, played.totalNs / 1e3, (unsigned)text.allocations, (unsigned)played.allocations,
+               (unsigned)text.bytesRead, (unsigned)played.bytesRead, sameReports(textDevice, reportDevice) ? "yes" : "NO");
+    }
+}
\ No newline at end of file
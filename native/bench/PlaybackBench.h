@@ -0,0 +1,13 @@
+#ifndef BENCH_PLAYBACK_BENCH_H
+#define BENCH_PLAYBACK_BENCH_H
+
+#include <string>
+#include <vector>
+
+// Every corpus payload run as text and as the .hidr stream compiled from
+// it: time to the first report, total time, heap allocations and bytes
+// read, and whether both send the same reports on the same timeline.
+// The payloads are expected in LittleFS under "/" + name.
+void benchPlayback(const std::vector<std::string>& names);
+
+#endif // BENCH_PLAYBACK_BENCH_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "SearchBench.h"
+#include <Arduino.h>
+#include <SD.h>
+#include <algorithm>
+#include <chrono>
+#include "DirectoryIndex.h"
+#include "PayloadCache.h"
+#include "SearchIndex.h"
+#include "MemoryFS.h"
+
+// Same card as DirectoryBench.cpp
+#define SD_OPEN_US      1500
+#define SD_READ_US      300
+#define SD_READ_BYTE_NS 500
+#define SD_LIST_US      150
+
+#define BENCH_DIR       "/payloads"
+#define BENCH_FOLDERS   10
+#define SEARCH_ROWS     5      // maxItems in showSearchScreen()
+#define SCAN_BATCH      16     // Records read at once by the folder scan
+#define BENCH_QUERY     "reverse"
+
+static const char* FIRST_WORDS[] = {
+    "reverse", "wifi", "browser", "network", "system", "keyboard", "notepad", "admin",
+    "download", "update", "screen", "defender", "terminal", "powershell", "registry", "user"
+};
+static const char* SECOND_WORDS[] = {
+    "shell", "grabber", "dump", "info", "test", "prank", "setup", "check",
+    "backup", "install", "logger", "open", "close", "disable", "enable", "report"
+};
+
+#define WORD_COUNT 16
+
+struct SearchResult {
+    double meanUs;
+    double maxUs;
+    double reads;   // Card reads per operation
+    double cardUs;  // Simulated time per operation, card access included
+    size_t found;   // Results of the full query
+};
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Has a word of name (after '_', ' ', '-' or '.') that starts with query
+static bool matchesWord(const char* name, const char* query, size_t length) {
+    for (const char* word = name; *word;) {
+        if (strncasecmp(word, query, length) == 0) return true;
+        while (*word && !strchr("_ -.", *word)) word++;
+        while (*word && strchr("_ -.", *word)) word++;
+    }
+    return false;
+}
+
+// A keystroke without the search index: every folder index read whole
+static size_t scanKeystroke(const char* query) {
+    size_t length = strlen(query);
+    size_t found = 0;
+    DirectoryIndex index;
+    DirectoryRecord records[SCAN_BATCH];
+    for (uint32_t folder = 0; folder < BENCH_FOLDERS; folder++) {
+        char path[32];
+        snprintf(path, sizeof(path), BENCH_DIR "/%02u", (unsigned)folder);
+        if (!index.openCached(SD, path, DirectoryIndex::cachePath(CACHE_DIR, path))) continue;
+        
+        size_t count = index.getCount();
+        for (size_t first = 0; first < count && found < SearchIndex::MAX_RESULTS;) {
+            size_t read = index.read(first, records, SCAN_BATCH);
+            if (read == 0) break;
+            first += read;
+            for (size_t i = 0; i < read && found < SearchIndex::MAX_RESULTS; i++) {
+                if (matchesWord(records[i].name, query, length)) found++;
+            }
+        }
+        index.close();
+    }
+    return found;
+}
+
+// A keystroke with the index: setQuery() and the rows the screen shows
+static size_t indexKeystroke(SearchIndex& search, const char* query) {
+    search.setQuery(query);
+    SearchEntry entry;
+    String directory;
+    for (size_t i = 0; i < SEARCH_ROWS; i++) {
+        if (!search.getResult(i, entry, directory)) break;
+    }
+    return search.getResultCount();
+}
+
+// Types the query one character at a time, then deletes it again
+static SearchResult typeQuery(SearchIndex* search, bool deleting) {
+    SearchResult result;
+    memset(&result, 0, sizeof(result));
+    size_t length = strlen(BENCH_QUERY);
+    char query[SEARCH_KEY_SIZE];
+    
+    if (deleting && search) indexKeystroke(*search, BENCH_QUERY);
+    SDStorage->resetStats();
+    uint64_t clockStart = HostClock::now();
+    uint64_t total = 0;
+    uint64_t maxNs = 0;
+    for (size_t i = 0; i < length; i++) {
+        size_t typed = deleting ? length - 1 - i : i + 1;
+        memcpy(query, BENCH_QUERY, typed);
+        query[typed] = '\0';
+        
+        uint64_t start = wallNow();
+        size_t found = search ? indexKeystroke(*search, query) : scanKeystroke(query);
+        uint64_t elapsed = wallNow() - start;
+        total += elapsed;
+        maxNs = std::max(maxNs, elapsed);
+        if (typed == length) result.found = found;
+    }
+    result.meanUs = total / 1e3 / length;
+    result.maxUs = maxNs / 1e3;
+    result.reads = (double)SDStorage->stats.reads / length;
+    result.cardUs = (double)(HostClock::now() - clockStart) / length;
+    return result;
+}
+
+static void printRow(const char* name, uint32_t count, const SearchResult& result) {
+    printf("%-20s %7u %9.1f us %9.1f us %8.1f %9.1f us", name, count, result.meanUs, result.maxUs, result.reads,
+           result.cardUs);
+    if (result.found) printf(" %8u", (unsigned)result.found);
+    printf("\n");
+}
+
+static void printOpen(const char* name, uint32_t count, uint64_t wallNs, uint64_t cardUs) {
+    printf("%-20s %7u %9.1f ms %12s %8u %9.1f ms\n", name, count, wallNs / 1e6, "",
+           (unsigned)SDStorage->stats.reads, cardUs / 1e3);
+}
+
+static void openSearch(SearchIndex& search, const char* name, uint32_t count) {
+    SDStorage->resetStats();
+    uint64_t clockStart = HostClock::now();
+    uint64_t start = wallNow();
+    search.open(SD, CACHE_DIR);
+    printOpen(name, count, wallNow() - start, HostClock::now() - clockStart);
+}
+
+void benchSearch() {
+    static const uint32_t sizes[] = { 100, 1000, 10000 };
+    bool wasVirtual = HostClock::isVirtual();
+    HostClock::useVirtual(true);
+    
+    printf("\n%-20s %7s %12s %12s %8s %12s %8s\n", "search \"" BENCH_QUERY "\"", "files", "mean", "max", "reads",
+           "card time", "found");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        SDStorage->clear();
+        memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+        SDStorage->mkdir(CACHE_DIR);
+        char path[96];
+        for (uint32_t n = 0; n < sizes[i]; n++) {
+            snprintf(path, sizeof(path), BENCH_DIR "/%02u/%s_%s_%05u.txt", (unsigned)(n % BENCH_FOLDERS),
+                     FIRST_WORDS[n % WORD_COUNT], SECOND_WORDS[n / WORD_COUNT % WORD_COUNT], (unsigned)n);
+            SDStorage->addFile(path, "STRING hello\n");
+        }
+        SDStorage->delays.openUs = SD_OPEN_US;
+        SDStorage->delays.readUs = SD_READ_US;
+        SDStorage->delays.readByteNs = SD_READ_BYTE_NS;
+        SDStorage->delays.listUs = SD_LIST_US;
+        
+        SearchIndex search;
+        openSearch(search, "open, build", sizes[i]);
+        search.close();
+        openSearch(search, "open, unchanged", sizes[i]);
+        printRow("keystroke", sizes[i], typeQuery(&search, false));
+        printRow("backspace", sizes[i], typeQuery(&search, true));
+        printRow("folder scan", sizes[i], typeQuery(nullptr, false));
+        search.close();
+    }
+    
+    SDStorage->clear();
+    memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+    HostClock::useVirtual(wasVirtual);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef BENCH_SEARCH_BENCH_H
+#define BENCH_SEARCH_BENCH_H
+
+// Type-to-find on a simulated SD card with 100, 1k and 10k files in ten
+// folders: building the search index, opening it unchanged, and each
+// keystroke of a query typed and deleted again, with the first screen of
+// results read as the search screen shows them. A keystroke is also timed
+// as a scan of every folder index would do it without the search index.
+// Time, card reads and card time for each.
+void benchSearch();
+
+#endif // BENCH_SEARCH_BENCH_H
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include "WarmStartBench.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <SD.h>
+#include <chrono>
+#include "DuckyScriptParser.h"
+#include "PayloadCache.h"
+#include "PayloadManager.h"
+#include "PayloadRamCache.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+
+// Same card as DirectoryBench.cpp
+#define SD_OPEN_US      1500
+#define SD_READ_US      300
+#define SD_READ_BYTE_NS 500
+
+enum StartSource {
+    START_PARSED,
+    START_CACHED,
+    START_RAM
+};
+
+struct StartResult {
+    StartSource source;
+    uint64_t cardUs;    // Simulated time to the first report, card access included, DELAYs not
+    uint64_t wallUs;    // Host CPU time to the first report
+    uint32_t opens;
+    uint64_t bytesRead;
+};
+
+static PayloadManager manager;
+static PayloadCache payloadCache;
+static PayloadRamCache ramCache;
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One process() as loop() runs it. A recording run paces itself on
+// millis(), so the clock is moved over the wait instead of sleeping, and
+// the time waited is returned.
+static uint64_t step(DuckyScriptParser& parser) {
+    unsigned long wakeAt = parser.process();
+    if ((long)(wakeAt - millis()) <= 0) return 0;
+    
+    uint64_t before = HostClock::now();
+    HostClock::advanceTo((uint64_t)wakeAt * 1000);
+    return HostClock::now() - before;
+}
+
+// loadScript(): large payloads stream, the rest is read into one buffer
+static void loadScript(DuckyScriptParser& parser, File& file) {
+    if (file.size() > PayloadManager::MAX_LOAD_SIZE) {
+        parser.execute(file);
+    } else {
+        uint32_t length = 0;
+        char* script = manager.readBuffer(file, length);
+        file.close();
+        if (script) parser.execute(script, length);
+    }
+}
+
+// One run from ENTER: openPayload(), startPayload() and process() until
+// the first report, then on to the end and keepPayload()
+static StartResult runPayload(const String& path, MockHIDDevice& device) {
+    StartResult result;
+    device.reset();
+    SDStorage->resetStats();
+    uint64_t clockStart = HostClock::now();
+    uint64_t wallStart = wallNow();
+    
+    DuckyScriptParser parser;
+    bool compiled = false;
+    File file = SD.open(path, FILE_READ);
+    uint32_t modified = (uint32_t)file.getLastWrite();
+    File cached = ramCache.lookup(&SD, path, modified, compiled);
+    HIDRSource source;
+    memset(&source, 0, sizeof(source));
+    if (cached) {
+        file.close();
+        result.source = START_RAM;
+        parser.setHIDDevice(&device);
+        if (compiled) {
+            parser.play(cached);
+        } else {
+            loadScript(parser, cached);
+        }
+    } else {
+        source = payloadCache.sourceKey(file);
+        File recording = payloadCache.lookup(SD, path, source);
+        if (recording) {
+            file.close();
+            result.source = START_CACHED;
+            parser.setHIDDevice(&device);
+            parser.play(recording);
+        } else {
+            result.source = START_PARSED;
+            parser.setHIDDevice(payloadCache.record(SD, path, source, &device));
+            loadScript(parser, file);
+        }
+    }
+    uint64_t waited = 0;
+    while (device.getReportCount() == 0 && !parser.isExecutionComplete()) {
+        waited += step(parser);
+    }
+    result.cardUs = HostClock::now() - clockStart - waited;
+    result.wallUs = wallNow() - wallStart;
+    result.opens = SDStorage->stats.opens;
+    result.bytesRead = SDStorage->stats.bytesRead;
+    
+    while (!parser.isExecutionComplete()) {
+        step(parser);
+    }
+    if (result.source == START_PARSED) payloadCache.finish(true);
+    
+    // keepPayload(): the recording when it fits, else the file as stored
+    if (result.source != START_RAM) {
+        File kept = payloadCache.lookup(SD, path, source);
+        bool keptCompiled = kept && kept.size() <= PayloadRamCache::MAX_ENTRY_SIZE;
+        if (kept && !keptCompiled) kept.close();
+        if (!keptCompiled) kept = SD.open(path, FILE_READ);
+        if (kept && kept.size() <= PayloadRamCache::MAX_ENTRY_SIZE) {
+            uint32_t length = 0;
+            char* data = manager.readBuffer(kept, length);
+            if (data) ramCache.insert(&SD, path, modified, data, length, keptCompiled);
+        }
+        if (kept) kept.close();
+    }
+    return result;
+}
+
+// One boot with autorun, .txt payloads only: bootAutorun() preloads the
+// payload while the host enumerates, serviceAutorun() fires it on mount
+// and process() runs to the first report. The run then goes on to the end,
+// recording it for the next boot. Returns how the payload was fired.
+static const char* runAutorun(const String& path, MockHIDDevice& device, StartResult& boot, StartResult& mount) {
+    device.reset();
+    ramCache = PayloadRamCache();  // RAM does not survive the reboot
+    SDStorage->resetStats();
+    uint64_t clockStart = HostClock::now();
+    uint64_t wallStart = wallNow();
+    
+    DuckyScriptParser parser;
+    const char* mode;
+    File autorunFile;
+    File file = SD.open(path, FILE_READ);
+    HIDRSource source = payloadCache.sourceKey(file);
+    File recorded = payloadCache.lookup(SD, path, source);
+    bool recording = !recorded;
+    if (recorded && recorded.size() > PayloadRamCache::MAX_ENTRY_SIZE &&
+        file.size() <= PayloadManager::MAX_LOAD_SIZE) {
+        recorded.close();  // Prepared instead, see bootAutorun()
+    }
+    if (recorded) {
+        file.close();
+        parser.setHIDDevice(&device);
+        mode = "cached";
+        autorunFile = recorded;
+        if (recorded.size() <= PayloadRamCache::MAX_ENTRY_SIZE) {
+            uint32_t length = 0;
+            char* data = manager.readBuffer(recorded, length);
+            recorded.close();
+            bool stored = false;
+            if (data && ramCache.insert(&SD, path, source.modified, data, length, true)) {
+                autorunFile = ramCache.lookup(&SD, path, source.modified, stored);
+                mode = "ram";
+            } else {
+                autorunFile = payloadCache.lookup(SD, path, source);
+            }
+        }
+    } else {
+        parser.setHIDDevice(recording ? payloadCache.record(SD, path, source, &device) : &device);
+        if (file.size() > PayloadManager::MAX_LOAD_SIZE) {
+            autorunFile = file;
+            mode = "streamed";
+        } else {
+            uint32_t length = 0;
+            char* script = manager.readBuffer(file, length);
+            file.close();
+            parser.prepare(script, length);
+            mode = "prepared";
+        }
+    }
+    boot.cardUs = HostClock::now() - clockStart;
+    boot.wallUs = wallNow() - wallStart;
+    boot.opens = SDStorage->stats.opens;
+    boot.bytesRead = SDStorage->stats.bytesRead;
+    
+    // Mount
+    SDStorage->resetStats();
+    clockStart = HostClock::now();
+    wallStart = wallNow();
+    if (strcmp(mode, "streamed") == 0) {
+        parser.execute(autorunFile);
+    } else if (strcmp(mode, "prepared") == 0) {
+        parser.start();
+    } else {
+        parser.play(autorunFile);
+    }
+    autorunFile = File();
+    uint64_t waited = 0;
+    while (device.getReportCount() == 0 && !parser.isExecutionComplete()) {
+        waited += step(parser);
+    }
+    mount.cardUs = HostClock::now() - clockStart - waited;
+    mount.wallUs = wallNow() - wallStart;
+    mount.opens = SDStorage->stats.opens;
+    mount.bytesRead = SDStorage->stats.bytesRead;
+    
+    while (!parser.isExecutionComplete()) {
+        step(parser);
+    }
+    if (recording) payloadCache.finish(true);
+    return mode;
+}
+
+static void printStart(const StartResult& result) {
+    printf(" %8.1f ms %6.0f us %3u %7u", result.cardUs / 1e3, (double)result.wallUs, result.opens,
+           (unsigned)result.bytesRead);
+}
+
+void benchWarmStart(const std::vector<std::string>& names) {
+    UsbTimingModel usb(1000);
+    MockHIDDevice device(&usb, false, false);
+    bool wasVirtual = HostClock::isVirtual();
+    HostClock::useVirtual(true);
+    SDStorage->clear();
+    SDStorage->mkdir(CACHE_DIR);
+    
+    printf("\n%-20s %34s %34s %34s\n", "ENTER to 1st report", "parsed (card, cpu, opens, read)",
+           "card cache", "RAM cache");
+    for (size_t i = 0; i < names.size(); i++) {
+        String path = String("/") + names[i].c_str();
+        memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+        SDStorage->addFile(path.c_str(), LittleFSStorage->content(path.c_str()));
+        SDStorage->delays.openUs = SD_OPEN_US;
+        SDStorage->delays.readUs = SD_READ_US;
+        SDStorage->delays.readByteNs = SD_READ_BYTE_NS;
+        
+        printf("%-20s", names[i].c_str());
+        for (int run = START_PARSED; run <= START_RAM; run++) {
+            // The first run leaves the payload in RAM, a restart empties it
+            if (run == START_CACHED) ramCache = PayloadRamCache();
+            StartResult result = runPayload(path, device);
+            if (result.source == run) {
+                printStart(result);
+            } else {
+                printf(" %34s", "not cached");
+            }
+        }
+        printf("\n");
+    }
+    
+    // Autorun on a card without the payload cache, then the next boot
+    SDStorage->clear();
+    SDStorage->mkdir(CACHE_DIR);
+    printf("\n%-20s %9s %9s %34s %9s %9s %34s\n", "mount to 1st report", "1st boot", "preload",
+           "mount (card, cpu, opens, read)", "next boot", "preload", "mount");
+    for (size_t i = 0; i < names.size(); i++) {
+        String path = String("/") + names[i].c_str();
+        memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+        SDStorage->addFile(path.c_str(), LittleFSStorage->content(path.c_str()));
+        SDStorage->delays.openUs = SD_OPEN_US;
+        SDStorage->delays.readUs = SD_READ_US;
+        SDStorage->delays.readByteNs = SD_READ_BYTE_NS;
+        
+        printf("%-20s", names[i].c_str());
+        for (int boot = 0; boot < 2; boot++) {
+            StartResult preload;
+            StartResult mount;
+            const char* mode = runAutorun(path, device, preload, mount);
+            printf(" %9s %6.1f ms", mode, preload.cardUs / 1e3);
+            printStart(mount);
+        }
+        printf("\n");
+    }
+    
+    SDStorage->clear();
+    memset(&SDStorage->delays, 0, sizeof(SDStorage->delays));
+    HostClock::useVirtual(wasVirtual);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef BENCH_WARM_START_BENCH_H
+#define BENCH_WARM_START_BENCH_H
+
+#include <string>
+#include <vector>
+
+// ENTER to first report for every corpus payload on a simulated SD card,
+// following openPayload() and startPayload(): the first run parses the
+// script and records it, the second plays the recording from the card's
+// payload cache after a restart, and the third plays it from the RAM
+// cache. Scripts under PayloadCache::MIN_SCRIPT_SIZE are not recorded
+// and show "not cached" for the card cache. Then mount to first report
+// in autorun mode, following bootAutorun() and serviceAutorun(), on the
+// first boot and on the next one with the recording of the first. Card
+// time, CPU time, opens and bytes read for each, and the time the boot
+// spent preloading. The payloads are expected in LittleFS under
+// "/" + name and are copied to the card.
+void benchWarmStart(const std::vector<std::string>& names);
+
+#endif // BENCH_WARM_START_BENCH_H
\ No newline at end of file
@@ -0,0 +1,268 @@
+// Host benchmark over the payload corpus in native/corpus.
+//
+//   pio run -e native_bench -t exec            (or .pio/build/native_bench/program [corpus dir])
+//
+// For every payload it reports how fast the parser gets through it on
+// this machine, how many heap allocations that costs per source line, and
+// how long the payload takes to type on the simulated USB and BLE links,
+// next to the estimate shown on the execution screen. A second table has
+// the typing statistics of the report decoder, which release firmware no
+// longer computes on the output task. DispatchBench.cpp compares running
+// compiled ops with the old per-line parser and KeyNameBench.cpp its key
+// name lookups with the old tables, PlaybackBench.cpp compiles each
+// payload to a .hidr stream and compares playing it with running the
+// text, and WarmStartBench.cpp times ENTER to the first report when the
+// payload is parsed, comes from the card's payload cache or from the RAM
+// cache, and mount to the first report in autorun mode. The next table runs the BLE backend itself over the simulated link
+// for a range of connection intervals and notifications per event, next
+// to the BleTimingModel used above. DirectoryBench.cpp times opening
+// folders of 100 to 10k files on a simulated SD card, FileListBench.cpp
+// a menu keypress in them, SearchBench.cpp type-to-find over as many
+// files and LoadBench.cpp loading payloads of 1 KB to 1 MB. PackBench.cpp compares loose payloads on internal storage with a
+// .pak archive of them, and CompressBench.cpp compresses the corpus to
+// .dsz and times decoding it. The output path timings from OutputBench.cpp
+// follow, and LogBench.cpp ends with the per-key cost of logging.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <dirent.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DuckyScriptParser.h"
+#include "PayloadManager.h"
+#include "Log.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+#include "BluetoothHIDDevice.h"
+#include "BleLink.h"
+#include "OutputBench.h"
+#include "LogBench.h"
+#include "PlaybackBench.h"
+#include "DirectoryBench.h"
+#include "FileListBench.h"
+#include "SearchBench.h"
+#include "LoadBench.h"
+#include "PackBench.h"
+#include "CompressBench.h"
+#include "WarmStartBench.h"
+#include "DispatchBench.h"
+#include "KeyNameBench.h"
+
+#define BENCH_DEFAULT_CORPUS "native/corpus"
+#define BENCH_MIN_RUN_US     200000  // Parse each payload for at least this long
+#define BENCH_USB_GAP_US     1000    // usb_report_gap_us default
+#define BENCH_BLE_FAST_US    15000   // Fast connection interval maximum
+#define BENCH_BLE_PER_EVENT  4       // Default notifications per event
+#define BENCH_LINK_TEXT      "The quick brown fox jumps over the lazy dog. "
+#define BENCH_LINK_REPEAT    20
+
+struct RunResult {
+    uint64_t wallUs;       // Real time spent in the parser
+    uint64_t allocations;
+    uint32_t estimateMs;   // 0 when streamed
+    uint64_t durationUs;   // Simulated time to type it
+    uint32_t reports;
+};
+
+static PayloadManager manager;
+
+static uint64_t wallNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t countLines(const std::string& text) {
+    uint32_t lines = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '\n') lines++;
+    }
+    if (!text.empty() && text[text.size() - 1] != '\n') lines++;
+    return lines;
+}
+
+// One run the way the firmware starts a payload: small files are read
+// into one buffer and compiled, large ones are streamed from the file
+static RunResult run(const char* path, MockHIDDevice& device) {
+    RunResult result;
+    memset(&result, 0, sizeof(result));
+    device.reset();
+    
+    HeapStats::Snapshot before = HeapStats::get();
+    uint64_t start = wallNow();
+    
+    // A new parser for each run, DEFAULTDELAY carries over between payloads
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&device);
+    
+    File file = LittleFS.open(path, FILE_READ);
+    if (file.size() > PayloadManager::MAX_LOAD_SIZE) {
+        parser.execute(file);
+    } else {
+        uint32_t length = 0;
+        char* buffer = manager.readBuffer(file, length);
+        file.close();
+        parser.execute(buffer, length);
+        result.estimateMs = parser.estimateDuration();
+    }
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+    
+    result.wallUs = wallNow() - start;
+    result.allocations = HeapStats::get().allocations - before.allocations;
+    result.durationUs = device.getDurationUs();
+    result.reports = device.getReportCount();
+    return result;
+}
+
+static bool loadCorpus(const char* dir, std::vector<std::string>& names) {
+    DIR* handle = opendir(dir);
+    if (!handle) return false;
+    
+    struct dirent* entry;
+    while ((entry = readdir(handle)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() < 5 || name.compare(name.size() - 4, 4, ".txt") != 0) continue;
+        
+        std::ifstream input((std::string(dir) + "/" + name).c_str(), std::ios::binary);
+        std::stringstream content;
+        content << input.rdbuf();
+        LittleFSStorage->addFile(("/" + name).c_str(), content.str());
+        names.push_back(name);
+    }
+    closedir(handle);
+    std::sort(names.begin(), names.end());
+    return !names.empty();
+}
+
+// Types the same text through BluetoothHIDDevice on links the central
+// runs at different intervals and per-event budgets
+static void benchBleLink() {
+    static const uint16_t intervals[] = { 6, 12, 24 };  // 7.5, 15, 30 ms
+    static const uint8_t budgets[] = { 1, 2, 4, 6 };
+    static BluetoothHIDDevice device;
+    device.begin("Bench");
+    
+    String text;
+    for (uint8_t i = 0; i < BENCH_LINK_REPEAT; i++) {
+        text += BENCH_LINK_TEXT;
+    }
+    
+    printf("\n%-12s %9s %9s %9s %9s\n", "ble link", "per event", "ch/s", "model", "refused");
+    for (size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++) {
+        for (size_t j = 0; j < sizeof(budgets); j++) {
+            BleLink::reset(budgets[j]);
+            BleLink::setCentralMinInterval(intervals[i]);
+            HostClock::advance(5000000);  // Past the backend's settling period
+            BleLink::connect(intervals[i]);
+            HostClock::advance(200000);
+            
+            uint64_t start = HostClock::now();
+            device.setExecuting(true);
+            device.sendString(text);
+            device.setExecuting(false);
+            uint64_t linkUs = BleLink::drain() - start;
+            BleLink::disconnect();
+            
+            // The backend sends at most its own budget per event
+            BleTimingModel model(intervals[i] * 1250, std::min(budgets[j], (uint8_t)BENCH_BLE_PER_EVENT));
+            MockHIDDevice mock(&model, false, false);
+            mock.setConnected(true);
+            mock.sendString(text);
+            
+            printf("%9.1f ms %9u %9u %9u %9u\n", intervals[i] * 1.25, budgets[j],
+                   (unsigned)(text.length() * 1000000ULL / linkUs),
+                   (unsigned)(text.length() * 1000000ULL / mock.getDurationUs()), BleLink::getRejected());
+        }
+    }
+}
+
+static void printDuration(uint64_t us) {
+    if (us >= 10000000) printf(" %8.1f s ", us / 1e6);
+    else printf(" %8.1f ms", us / 1e3);
+}
+
+int main(int argc, char** argv) {
+    const char* corpus = argc > 1 ? argv[1] : BENCH_DEFAULT_CORPUS;
+    std::vector<std::string> names;
+    if (!loadCorpus(corpus, names)) {
+        fprintf(stderr, "No .txt payloads in %s\n", corpus);
+        return 1;
+    }
+    
+    // Parsing never waits with a simulated device, the virtual clock only
+    // keeps the firmware's own millis() timings out of the results
+    HostClock::useVirtual(true);
+    
+    UsbTimingModel usb(BENCH_USB_GAP_US);
+    BleTimingModel ble(BENCH_BLE_FAST_US, BENCH_BLE_PER_EVENT);
+    MockHIDDevice timedDevice(&usb, false, false);  // Parse timing without the decoder
+    MockHIDDevice usbDevice(&usb, false);
+    MockHIDDevice bleDevice(&ble, false);
+    std::vector<HIDReportDecoder> usbStats;
+    std::vector<HIDReportDecoder> bleStats;
+    
+    printf("%-20s %7s %6s %12s %11s %9s %11s %11s %11s %11s\n", "payload", "bytes", "lines", "lines/s", "MB/s",
+           "allocs/ln", "usb", "usb est", "ble", "ble est");
+    
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string path = "/" + names[i];
+        std::string content = LittleFSStorage->content(path.c_str());
+        uint32_t lines = countLines(content);
+        
+        // Warm up once, then repeat until the timing is stable
+        RunResult usbRun = run(path.c_str(), timedDevice);
+        uint64_t wallUs = 0;
+        uint32_t runs = 0;
+        while (wallUs < BENCH_MIN_RUN_US) {
+            wallUs += run(path.c_str(), timedDevice).wallUs;
+            runs++;
+        }
+        run(path.c_str(), usbDevice);
+        usbStats.push_back(usbDevice.getDecoder());
+        RunResult bleRun = run(path.c_str(), bleDevice);
+        bleStats.push_back(bleDevice.getDecoder());
+        
+        double seconds = wallUs / 1e6;
+        printf("%-20s %7u %6u %12.0f %11.1f %9.2f", names[i].c_str(), (unsigned)content.size(), lines,
+               lines * runs / seconds, content.size() * runs / seconds / 1e6, (double)usbRun.allocations / lines);
+        printDuration(usbRun.durationUs);
+        if (usbRun.estimateMs) printDuration((uint64_t)usbRun.estimateMs * 1000);
+        else printf(" %11s", "streamed");
+        printDuration(bleRun.durationUs);
+        if (bleRun.estimateMs) printDuration((uint64_t)bleRun.estimateMs * 1000);
+        else printf(" %11s", "streamed");
+        printf("\n");
+    }
+    
+    printf("\n%-20s %7s %7s %9s %9s %6s  %s\n", "payload", "chars", "keys", "usb ch/s", "ble ch/s", "repeat",
+           "usb report gaps <1/<2/<5/<10/<20/longer ms");
+    for (size_t i = 0; i < names.size(); i++) {
+        HIDReportDecoder& usbDecoder = usbStats[i];
+        const uint32_t* gaps = usbDecoder.getGapHistogram();
+        printf("%-20s %7u %7u %9u %9u %6u  %u/%u/%u/%u/%u/%u\n", names[i].c_str(), usbDecoder.getChars(),
+               usbDecoder.getKeyEvents(), usbDecoder.getCharsPerSecond(), bleStats[i].getCharsPerSecond(),
+               bleStats[i].getRepeatRisks(), gaps[0], gaps[1], gaps[2], gaps[3], gaps[4], gaps[5]);
+    }
+    
+    benchDispatch(names);
+    benchKeyNames();
+    benchPlayback(names);
+    benchWarmStart(names);
+    benchBleLink();
+    benchDirectories();
+    benchFileList();
+    benchSearch();
+    benchLoading();
+    benchPacking(names);
+    benchCompression(names);
+    benchOutputPath();
+    benchLogging();
+    
+    Log.flush();
+    return 0;
+}
\ No newline at end of file
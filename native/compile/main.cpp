@@ -0,0 +1,91 @@
+// Offline payload compiler: turns a DuckyScript payload into a .hidr
+// report stream with the firmware's own parser, encoder and layouts, so
+// a card can be filled with payloads that play back without parsing.
+//
+//   pio run -e native_compile
+//   .pio/build/native_compile/program [-l LAYOUT] payload.txt [payload.hidr]
+//
+// LAYOUT is a keyboard_layout name from config.json (US by default). The
+// output defaults to the payload name with a .hidr extension. .dsz
+// payloads are decompressed as they are compiled.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "HIDReportEncoder.h"
+#include "PayloadManager.h"
+#include "Log.h"
+#include "MemoryFS.h"
+#include "ScriptCompiler.h"
+
+#define OUTPUT_PATH "/output.hidr"
+
+static int usage() {
+    fprintf(stderr, "usage: program [-l LAYOUT] payload.txt [payload.hidr]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    const char* layoutName = "US";
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "-l") == 0) {
+        layoutName = argv[arg + 1];
+        arg += 2;
+    }
+    if (arg >= argc || argc - arg > 2) return usage();
+    
+    const KeyboardLayout* layout = findKeyboardLayout(layoutName);
+    if (!layout) {
+        fprintf(stderr, "Unknown layout %s\n", layoutName);
+        return 2;
+    }
+    HIDReportEncoder::setLayout(layout);
+    
+    std::string inputPath = argv[arg];
+    size_t slash = inputPath.rfind('/');
+    std::string name = "/" + (slash == std::string::npos ? inputPath : inputPath.substr(slash + 1));
+    std::string outputPath = argc - arg == 2 ? std::string(argv[arg + 1]) :
+        inputPath.substr(0, inputPath.size() - (name.size() - 1)) +
+        PayloadManager::reportFileName(String(name.c_str() + 1)).c_str();
+    
+    std::ifstream input(inputPath.c_str(), std::ios::binary);
+    if (!input) {
+        fprintf(stderr, "Cannot read %s\n", inputPath.c_str());
+        return 1;
+    }
+    std::stringstream content;
+    content << input.rdbuf();
+    
+    // The payload goes through fs::File like on the device, with the write
+    // time of the original in the stream's source key
+    HostClock::useVirtual(true);
+    LittleFSStorage->addFile(name.c_str(), content.str());
+    struct stat info;
+    if (stat(inputPath.c_str(), &info) == 0) LittleFSStorage->setLastWrite(name.c_str(), info.st_mtime);
+    
+    File script = LittleFS.open(name.c_str(), FILE_READ);
+    File output = LittleFS.open(OUTPUT_PATH, FILE_WRITE);
+    uint32_t records = compileScript(script, output);
+    script.close();
+    output.close();
+    Log.flush();
+    if (records == 0) {
+        fprintf(stderr, "Nothing compiled from %s\n", inputPath.c_str());
+        return 1;
+    }
+    
+    std::string stream = LittleFSStorage->content(OUTPUT_PATH);
+    std::ofstream result(outputPath.c_str(), std::ios::binary);
+    result.write(stream.data(), stream.size());
+    result.close();
+    if (!result) {
+        fprintf(stderr, "Cannot write %s\n", outputPath.c_str());
+        return 1;
+    }
+    
+    printf("%s: %u records, %u bytes, %s layout\n", outputPath.c_str(), records, (unsigned)stream.size(), layout->name);
+    return 0;
+}
\ No newline at end of file
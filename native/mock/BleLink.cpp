@@ -0,0 +1,197 @@
+#include "BleLink.h"
+#include <Arduino.h>
+#include <deque>
+#include <mutex>
+
+#define BLE_LINK_CONN_HANDLE 0
+#define INTERVAL_UNIT_US     1250
+
+static std::recursive_mutex lock;
+static ble_gap_event_listener* listeners = nullptr;
+static bool connected = false;
+static uint16_t interval = 24;
+static uint8_t perEvent = 4;
+static uint8_t bufferSize = 8;
+static uint16_t centralMinInterval = 6;
+static uint8_t updateDelay = 6;
+static bool stalled = false;
+static uint64_t nextEventUs = 0;
+static uint16_t pendingInterval = 0;  // Granted, not in effect yet
+static uint64_t pendingAtUs = 0;
+static uint32_t updates = 0;
+static uint32_t rejected = 0;
+static std::deque<BleLinkReport> buffer;
+static std::vector<BleLinkReport> reports;
+
+static void postEvent(uint8_t type) {
+    ble_gap_event event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    // connect, disconnect and conn_update share the handle field layout
+    event.connect.conn_handle = BLE_LINK_CONN_HANDLE;
+    for (ble_gap_event_listener* listener = listeners; listener; listener = listener->next) {
+        listener->fn(&event, listener->arg);
+    }
+}
+
+// Runs every connection event up to the current time
+static void runEvents() {
+    uint64_t now = HostClock::now();
+    while (connected && nextEventUs <= now) {
+        for (uint8_t i = 0; i < perEvent && !buffer.empty() && !stalled; i++) {
+            BleLinkReport sent = buffer.front();
+            buffer.pop_front();
+            sent.timeUs = nextEventUs;
+            reports.push_back(sent);
+        }
+        
+        bool updated = pendingInterval != 0 && nextEventUs >= pendingAtUs;
+        if (updated) {
+            interval = pendingInterval;
+            pendingInterval = 0;
+        }
+        nextEventUs += (uint64_t)interval * INTERVAL_UNIT_US;
+        if (updated) postEvent(BLE_GAP_EVENT_CONN_UPDATE);
+    }
+}
+
+void BleLink::reset(uint8_t notificationsPerEvent, uint8_t controllerBuffers) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    connected = false;
+    interval = 24;
+    perEvent = notificationsPerEvent > 0 ? notificationsPerEvent : 1;
+    bufferSize = controllerBuffers > 0 ? controllerBuffers : 1;
+    centralMinInterval = 6;
+    updateDelay = 6;
+    stalled = false;
+    pendingInterval = 0;
+    updates = 0;
+    rejected = 0;
+    buffer.clear();
+    reports.clear();
+}
+
+void BleLink::connect(uint16_t connInterval) {
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        connected = true;
+        interval = connInterval > 0 ? connInterval : 1;
+        pendingInterval = 0;
+        nextEventUs = HostClock::now() + (uint64_t)interval * INTERVAL_UNIT_US;
+    }
+    postEvent(BLE_GAP_EVENT_CONNECT);
+}
+
+void BleLink::disconnect() {
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        runEvents();
+        connected = false;
+        buffer.clear();
+    }
+    postEvent(BLE_GAP_EVENT_DISCONNECT);
+}
+
+void BleLink::setCentralMinInterval(uint16_t connInterval) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    centralMinInterval = connInterval;
+}
+
+void BleLink::setUpdateDelay(uint8_t events) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    updateDelay = events;
+}
+
+void BleLink::stall(bool stall) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    stalled = stall;
+}
+
+uint64_t BleLink::drain() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    while (connected && !buffer.empty()) {
+        HostClock::advanceTo(nextEventUs);
+        runEvents();
+    }
+    return reports.empty() ? 0 : reports.back().timeUs;
+}
+
+uint16_t BleLink::getInterval() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    return interval;
+}
+
+uint32_t BleLink::getUpdates() {
+    return updates;
+}
+
+uint32_t BleLink::getRejected() {
+    return rejected;
+}
+
+const std::vector<BleLinkReport>& BleLink::getReports() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    return reports;
+}
+
+extern "C" int ble_gap_event_listener_register(struct ble_gap_event_listener* listener, ble_gap_event_fn* fn,
+                                               void* arg) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    for (ble_gap_event_listener* registered = listeners; registered; registered = registered->next) {
+        if (registered == listener) return BLE_HS_EALREADY;
+    }
+    listener->fn = fn;
+    listener->arg = arg;
+    listener->next = listeners;
+    listeners = listener;
+    return 0;
+}
+
+extern "C" int ble_gap_conn_find(uint16_t handle, struct ble_gap_conn_desc* out_desc) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    if (!connected || handle != BLE_LINK_CONN_HANDLE) return BLE_HS_ENOTCONN;
+    if (out_desc) {
+        memset(out_desc, 0, sizeof(*out_desc));
+        out_desc->conn_handle = BLE_LINK_CONN_HANDLE;
+        out_desc->conn_itvl = interval;
+        out_desc->supervision_timeout = 400;
+    }
+    return 0;
+}
+
+extern "C" int ble_gap_update_params(uint16_t conn_handle, const struct ble_gap_upd_params* params) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    if (!connected || conn_handle != BLE_LINK_CONN_HANDLE) return BLE_HS_ENOTCONN;
+    
+    // The central grants the shortest interval asked for that it accepts
+    uint16_t granted = params->itvl_min;
+    if (granted < centralMinInterval) granted = centralMinInterval;
+    pendingInterval = granted;
+    pendingAtUs = nextEventUs + (uint64_t)updateDelay * interval * INTERVAL_UNIT_US;
+    updates++;
+    return 0;
+}
+
+extern "C" int ble_gattc_notify_custom(uint16_t conn_handle, uint16_t att_handle, const void* data, uint16_t len) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    runEvents();
+    if (!connected || conn_handle != BLE_LINK_CONN_HANDLE) return BLE_HS_ENOTCONN;
+    if (buffer.size() >= bufferSize) {
+        rejected++;
+        return BLE_HS_ENOMEM;
+    }
+    
+    BleLinkReport queued;
+    memset(&queued, 0, sizeof(queued));
+    queued.attHandle = att_handle;
+    queued.length = len < sizeof(queued.data) ? len : sizeof(queued.data);
+    memcpy(queued.data, data, queued.length);
+    buffer.push_back(queued);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef MOCK_BLE_LINK_H
+#define MOCK_BLE_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <NimBLEDevice.h>
+
+struct BleLinkReport {
+    uint64_t timeUs;     // Connection event that carried it
+    uint16_t attHandle;
+    uint8_t length;
+    uint8_t data[8];
+};
+
+// Simulated BLE connection behind the NimBLE shim, on the host clock.
+// Connection events fall every interval. Each one sends up to a budget of
+// queued notifications, and the controller holds a fixed number of them,
+// so notify fails while its buffers are full. A connection parameter
+// request is granted by the central, no shorter than the interval it
+// accepts, and takes effect some events later with a connection update
+// event to the GAP listeners.
+namespace BleLink {
+    // Disconnected, nothing recorded
+    void reset(uint8_t notificationsPerEvent = 4, uint8_t controllerBuffers = 8);
+    void connect(uint16_t interval);         // 1.25 ms units
+    void disconnect();
+    void setCentralMinInterval(uint16_t interval);
+    void setUpdateDelay(uint8_t events);
+    void stall(bool stalled);                // Events send nothing, the buffers stay full
+
+    uint64_t drain();                        // Runs events until every queued notification is sent
+    uint16_t getInterval();
+    uint32_t getUpdates();                   // Connection parameter requests
+    uint32_t getRejected();                  // Notifications refused with full buffers
+    const std::vector<BleLinkReport>& getReports();
+}
+
+#endif // MOCK_BLE_LINK_H
\ No newline at end of file
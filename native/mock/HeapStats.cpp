@@ -0,0 +1,91 @@
+#include "HeapStats.h"
+#include <atomic>
+#include <malloc.h>
+#include <string.h>
+
+// glibc's own entry points, wrapped below
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+static std::atomic<uint64_t> allocations(0);
+static std::atomic<uint64_t> frees(0);
+static std::atomic<size_t> current(0);
+static std::atomic<size_t> peak(0);
+
+static void counted(void* ptr) {
+    if (!ptr) return;
+    allocations++;
+    size_t now = current += malloc_usable_size(ptr);
+    size_t high = peak;
+    while (now > high && !peak.compare_exchange_weak(high, now)) {}
+}
+
+static void released(void* ptr) {
+    if (!ptr) return;
+    frees++;
+    current -= malloc_usable_size(ptr);
+}
+
+extern "C" void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    counted(ptr);
+    return ptr;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    counted(ptr);
+    return ptr;
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    released(ptr);
+    void* result = __libc_realloc(ptr, size);
+    if (result) {
+        counted(result);
+    } else if (ptr && size > 0) {
+        counted(ptr);  // Failed, the old block is still in use
+        frees--;
+        allocations--;
+    }
+    return result;
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    counted(ptr);
+    return ptr;
+}
+
+extern "C" int posix_memalign(void** result, size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) return 12;  // ENOMEM
+    counted(ptr);
+    *result = ptr;
+    return 0;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+extern "C" void free(void* ptr) {
+    released(ptr);
+    __libc_free(ptr);
+}
+
+HeapStats::Snapshot HeapStats::get() {
+    Snapshot snapshot;
+    snapshot.allocations = allocations;
+    snapshot.frees = frees;
+    snapshot.current = current;
+    snapshot.peak = peak;
+    return snapshot;
+}
+
+void HeapStats::resetPeak() {
+    peak = current.load();
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef MOCK_HEAP_STATS_H
+#define MOCK_HEAP_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Heap use of the host process. malloc() and friends are wrapped (and
+// operator new goes through malloc), so every allocation the code under
+// test makes is counted, including those inside String and std::vector.
+// Sizes are usable sizes as the allocator reports them.
+namespace HeapStats {
+    struct Snapshot {
+        uint64_t allocations;  // Calls that returned a new block, realloc included
+        uint64_t frees;
+        size_t current;        // Bytes in use
+        size_t peak;           // High-water mark since the last resetPeak()
+    };
+    
+    Snapshot get();
+    void resetPeak();          // Peak restarts from the current use
+}
+
+#endif // MOCK_HEAP_STATS_H
\ No newline at end of file
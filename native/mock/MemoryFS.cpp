@@ -0,0 +1,346 @@
+#include "MemoryFS.h"
+#include <algorithm>
+
+#define FIRST_WRITE_TIME 1700000000  // Write time of the first file
+
+// An open file. It holds its own reference to the content, so like an
+// open handle on a real file system it stays readable after a remove.
+class MemoryFileImpl : public fs::FileImpl {
+private:
+    MemoryFS* owner;
+    std::shared_ptr<MemoryFS::FileData> file;
+    std::string filePath;
+    size_t pos;
+    bool writable;
+    bool dirty;
+    bool open;
+    
+public:
+    MemoryFileImpl(MemoryFS* fs, const std::shared_ptr<MemoryFS::FileData>& data, const std::string& path,
+                   bool write, bool append)
+        : owner(fs), file(data), filePath(path), pos(append ? data->bytes.size() : 0), writable(write),
+          dirty(false), open(true) {}
+    
+    ~MemoryFileImpl() { close(); }
+    
+    size_t write(const uint8_t* buf, size_t size) override {
+        if (!open || !writable) return 0;
+        std::lock_guard<std::recursive_mutex> guard(owner->lock);
+        std::string& bytes = file->bytes;
+        if (pos > bytes.size()) bytes.resize(pos);
+        bytes.replace(pos, std::min(size, bytes.size() - pos), (const char*)buf, size);
+        pos += size;
+        dirty = true;
+        owner->countWrite(size);
+        return size;
+    }
+    
+    size_t read(uint8_t* buf, size_t size) override {
+        if (!open) return 0;
+        std::lock_guard<std::recursive_mutex> guard(owner->lock);
+        const std::string& bytes = file->bytes;
+        if (pos >= bytes.size()) return 0;
+        if (size > bytes.size() - pos) size = bytes.size() - pos;
+        size = owner->readable(size);
+        if (size == 0) return 0;
+        memcpy(buf, bytes.data() + pos, size);
+        pos += size;
+        owner->countRead(size);
+        return size;
+    }
+    
+    void flush() override {}
+    
+    bool seek(uint32_t position, fs::SeekMode mode) override {
+        int64_t target = position;
+        if (mode == fs::SeekCur) target += pos;
+        if (mode == fs::SeekEnd) target += file->bytes.size();
+        if (target < 0) return false;
+        pos = target;
+        return true;
+    }
+    
+    size_t position() const override { return pos; }
+    size_t size() const override { return file->bytes.size(); }
+    bool setBufferSize(size_t size) override { return true; }
+    
+    void close() override {
+        if (!open) return;
+        open = false;
+        if (dirty) {
+            std::lock_guard<std::recursive_mutex> guard(owner->lock);
+            file->modified = owner->touch();
+        }
+    }
+    
+    time_t getLastWrite() override { return file->modified; }
+    const char* path() const override { return filePath.c_str(); }
+    const char* name() const override { return strrchr(filePath.c_str(), '/') + 1; }
+    bool isDirectory(void) override { return false; }
+    fs::FileImplPtr openNextFile(const char* mode) override { return fs::FileImplPtr(); }
+    bool seekDir(long position) override { return false; }
+    String getNextFileName(void) override { return String(); }
+    String getNextFileName(bool* isDir) override { return String(); }
+    void rewindDirectory(void) override {}
+    operator bool() override { return open; }
+};
+
+// An open directory, listing a snapshot of its entries taken at open
+class MemoryDirImpl : public fs::FileImpl {
+private:
+    MemoryFS* owner;
+    std::string dirPath;
+    std::vector<std::pair<std::string, bool> > entries;
+    size_t next;
+    bool open;
+    
+    std::string childPath(size_t index) {
+        return (dirPath == "/" ? "" : dirPath) + "/" + entries[index].first;
+    }
+    
+public:
+    MemoryDirImpl(MemoryFS* fs, const std::string& path, const std::vector<std::pair<std::string, bool> >& listing)
+        : owner(fs), dirPath(path), entries(listing), next(0), open(true) {}
+    
+    size_t write(const uint8_t* buf, size_t size) override { return 0; }
+    size_t read(uint8_t* buf, size_t size) override { return 0; }
+    void flush() override {}
+    bool seek(uint32_t position, fs::SeekMode mode) override { return false; }
+    size_t position() const override { return 0; }
+    size_t size() const override { return 0; }
+    bool setBufferSize(size_t size) override { return false; }
+    void close() override { open = false; }
+    time_t getLastWrite() override { return 0; }
+    const char* path() const override { return dirPath.c_str(); }
+    const char* name() const override { return dirPath == "/" ? dirPath.c_str() : strrchr(dirPath.c_str(), '/') + 1; }
+    bool isDirectory(void) override { return true; }
+    
+    fs::FileImplPtr openNextFile(const char* mode) override {
+        if (!open || next >= entries.size()) return fs::FileImplPtr();
+        owner->countListed();
+        std::string path = childPath(next++);
+        return owner->open(path.c_str(), mode, false);
+    }
+    
+    bool seekDir(long position) override {
+        if (position < 0 || (size_t)position > entries.size()) return false;
+        next = position;
+        return true;
+    }
+    
+    String getNextFileName(void) override {
+        return getNextFileName(nullptr);
+    }
+    
+    String getNextFileName(bool* isDir) override {
+        if (!open || next >= entries.size()) return String();
+        owner->countListed();
+        if (isDir) *isDir = entries[next].second;
+        std::string path = childPath(next++);
+        return String(path);
+    }
+    
+    void rewindDirectory(void) override { next = 0; }
+    operator bool() override { return open; }
+};
+
+MemoryFS::MemoryFS() {
+    clear();
+}
+
+void MemoryFS::clear() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    nodes.clear();
+    Node root;
+    root.directory = true;
+    nodes["/"] = root;
+    clock = FIRST_WRITE_TIME;
+    memset(&delays, 0, sizeof(delays));
+    readLimit = 0;
+    resetStats();
+}
+
+void MemoryFS::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+std::string MemoryFS::normalize(const char* path) {
+    std::string result = path;
+    if (result.empty() || result[0] != '/') result = "/" + result;
+    while (result.size() > 1 && result[result.size() - 1] == '/') result.erase(result.size() - 1);
+    return result;
+}
+
+std::string MemoryFS::parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+std::string MemoryFS::nameOf(const std::string& path) {
+    return path.substr(path.rfind('/') + 1);
+}
+
+MemoryFS::Node* MemoryFS::find(const std::string& path) {
+    std::map<std::string, Node>::iterator it = nodes.find(path);
+    return it == nodes.end() ? nullptr : &it->second;
+}
+
+bool MemoryFS::create(const std::string& path, bool directory, bool makeParents) {
+    if (path == "/") return false;
+    std::string parentPath = parentOf(path);
+    Node* parent = find(parentPath);
+    if (!parent) {
+        if (!makeParents || !create(parentPath, true, true)) return false;
+        parent = find(parentPath);
+    }
+    if (!parent->directory) return false;
+    
+    Node node;
+    node.directory = directory;
+    if (!directory) {
+        node.file = std::make_shared<FileData>();
+        node.file->modified = touch();
+    }
+    nodes[path] = node;
+    parent->children.push_back(nameOf(path));
+    return true;
+}
+
+time_t MemoryFS::touch() {
+    return clock++;
+}
+
+size_t MemoryFS::readable(size_t bytes) {
+    if (readLimit == 0) return bytes;
+    if (stats.bytesRead >= readLimit) return 0;
+    return std::min<uint64_t>(bytes, readLimit - stats.bytesRead);
+}
+
+void MemoryFS::countRead(size_t bytes) {
+    stats.reads++;
+    stats.bytesRead += bytes;
+    uint64_t delayUs = delays.readUs + (uint64_t)delays.readByteNs * bytes / 1000;
+    if (delayUs > 0) HostClock::sleep(delayUs);
+}
+
+void MemoryFS::countWrite(size_t bytes) {
+    stats.writes++;
+    stats.bytesWritten += bytes;
+}
+
+void MemoryFS::countListed() {
+    stats.listed++;
+    if (delays.listUs > 0) HostClock::sleep(delays.listUs);
+}
+
+fs::FileImplPtr MemoryFS::open(const char* path, const char* mode, const bool create) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    std::string key = normalize(path);
+    bool write = mode[0] == 'w' || mode[0] == 'a' || strchr(mode, '+') != nullptr;
+    Node* node = find(key);
+    
+    if (node && node->directory) {
+        stats.dirOpens++;
+        if (delays.openUs > 0) HostClock::sleep(delays.openUs);
+        std::vector<std::pair<std::string, bool> > listing;
+        for (size_t i = 0; i < node->children.size(); i++) {
+            Node* child = find((key == "/" ? "" : key) + "/" + node->children[i]);
+            listing.push_back(std::make_pair(node->children[i], child && child->directory));
+        }
+        return fs::FileImplPtr(new MemoryDirImpl(this, key, listing));
+    }
+    
+    stats.opens++;
+    if (delays.openUs > 0) HostClock::sleep(delays.openUs);
+    if (!node) {
+        if (!write || !this->create(key, false, create)) return fs::FileImplPtr();
+        node = find(key);
+    } else if (mode[0] == 'w') {
+        node->file->bytes.clear();
+        node->file->modified = touch();
+    }
+    return fs::FileImplPtr(new MemoryFileImpl(this, node->file, key, write, mode[0] == 'a'));
+}
+
+bool MemoryFS::exists(const char* path) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    return find(normalize(path)) != nullptr;
+}
+
+bool MemoryFS::rename(const char* pathFrom, const char* pathTo) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    std::string from = normalize(pathFrom);
+    std::string to = normalize(pathTo);
+    Node* node = find(from);
+    if (!node || node->directory || find(to) || !find(parentOf(to))) return false;
+    
+    Node moved = *node;
+    if (!remove(from.c_str())) return false;
+    if (!create(to, false, false)) return false;
+    nodes[to] = moved;
+    return true;
+}
+
+bool MemoryFS::remove(const char* path) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    std::string key = normalize(path);
+    Node* node = find(key);
+    if (!node || node->directory) return false;
+    
+    std::vector<std::string>& siblings = find(parentOf(key))->children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), nameOf(key)));
+    nodes.erase(key);
+    return true;
+}
+
+bool MemoryFS::mkdir(const char* path) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    std::string key = normalize(path);
+    if (find(key)) return false;
+    return create(key, true, false);
+}
+
+bool MemoryFS::rmdir(const char* path) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    std::string key = normalize(path);
+    Node* node = find(key);
+    if (!node || !node->directory || !node->children.empty() || key == "/") return false;
+    
+    std::vector<std::string>& siblings = find(parentOf(key))->children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), nameOf(key)));
+    nodes.erase(key);
+    return true;
+}
+
+bool MemoryFS::addFile(const char* path, const std::string& content) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    std::string key = normalize(path);
+    Node* node = find(key);
+    if (!node) {
+        if (!create(key, false, true)) return false;
+        node = find(key);
+    }
+    if (node->directory) return false;
+    node->file->bytes = content;
+    node->file->modified = touch();
+    return true;
+}
+
+bool MemoryFS::addFile(const char* path, const void* data, size_t size) {
+    return addFile(path, std::string((const char*)data, size));
+}
+
+bool MemoryFS::setLastWrite(const char* path, time_t modified) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    Node* node = find(normalize(path));
+    if (!node) return false;
+    if (node->directory) return false;
+    node->file->modified = modified;
+    return true;
+}
+
+std::string MemoryFS::content(const char* path) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    Node* node = find(normalize(path));
+    return node && !node->directory ? node->file->bytes : std::string();
+}
\ No newline at end of file
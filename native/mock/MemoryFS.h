@@ -0,0 +1,91 @@
+#ifndef MOCK_MEMORY_FS_H
+#define MOCK_MEMORY_FS_H
+
+#include <FSImpl.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// In-memory file system behind fs::FS on the host. Directories list their
+// entries in creation order like FAT, the write time of a file is a
+// counter that moves on every write, and rename fails when the target
+// exists as it does on FAT. Counters record what the code under test
+// asked of storage, and per-operation delays on the host clock stand in
+// for a slow SD card.
+class MemoryFS : public fs::FSImpl {
+public:
+    struct FileData {
+        std::string bytes;
+        time_t modified;
+    };
+    
+    struct Node {
+        bool directory;
+        std::shared_ptr<FileData> file;     // Shared with open handles
+        std::vector<std::string> children;  // Names, in creation order
+    };
+    
+    struct Stats {
+        uint32_t opens;      // Files opened, directories not included
+        uint32_t dirOpens;
+        uint32_t reads;      // read() calls that reached a file
+        uint64_t bytesRead;
+        uint32_t writes;
+        uint64_t bytesWritten;
+        uint32_t listed;     // Directory entries returned
+    };
+    
+    struct Delays {
+        uint32_t openUs;
+        uint32_t readUs;     // Per read() call
+        uint32_t readByteNs; // Per byte read
+        uint32_t listUs;     // Per directory entry returned
+    };
+    
+    MemoryFS();
+    
+    // fs::FSImpl
+    fs::FileImplPtr open(const char* path, const char* mode, const bool create) override;
+    bool exists(const char* path) override;
+    bool rename(const char* pathFrom, const char* pathTo) override;
+    bool remove(const char* path) override;
+    bool mkdir(const char* path) override;
+    bool rmdir(const char* path) override;
+    
+    // Test setup
+    bool addFile(const char* path, const std::string& content);  // Creates parent directories
+    bool addFile(const char* path, const void* data, size_t size);
+    bool setLastWrite(const char* path, time_t modified);
+    std::string content(const char* path);  // Empty if missing
+    void clear();
+    
+    Stats stats;
+    Delays delays;
+    uint64_t readLimit;  // Reads fail past this many bytes since resetStats(), 0 for none
+    void resetStats();
+    
+    // Used by the open file and directory handles
+    std::recursive_mutex lock;
+    size_t readable(size_t bytes);
+    void countRead(size_t bytes);
+    void countWrite(size_t bytes);
+    void countListed();
+    time_t touch();
+    
+private:
+    std::map<std::string, Node> nodes;
+    time_t clock;
+    
+    static std::string normalize(const char* path);
+    static std::string parentOf(const std::string& path);
+    static std::string nameOf(const std::string& path);
+    Node* find(const std::string& path);
+    bool create(const std::string& path, bool directory, bool makeParents);
+};
+
+// Storage behind the SD and LittleFS globals
+extern std::shared_ptr<MemoryFS> SDStorage;
+extern std::shared_ptr<MemoryFS> LittleFSStorage;
+
+#endif // MOCK_MEMORY_FS_H
\ No newline at end of file
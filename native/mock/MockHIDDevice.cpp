@@ -0,0 +1,100 @@
+#include "MockHIDDevice.h"
+
+MockHIDDevice::MockHIDDevice(TransportModel* transport, bool recordReports, bool decode) {
+    model = transport;
+    keepReports = recordReports;
+    decodeReports = decode;
+    connected = true;
+    reset();
+}
+
+void MockHIDDevice::reset() {
+    model->reset();
+    decoder.reset();
+    reports.clear();
+    nowUs = 0;
+    reportCount = 0;
+    delayCount = 0;
+}
+
+void MockHIDDevice::deliver(const HIDKeyReport& report) {
+    nowUs = model->send(nowUs);
+    reportCount++;
+    if (decodeReports) decoder.feed(report, nowUs);
+    if (!keepReports) return;
+    
+    MockReport entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.timeUs = nowUs;
+    entry.media = false;
+    entry.report = report;
+    reports.push_back(entry);
+}
+
+void MockHIDDevice::deliverMedia(uint8_t mediaKey) {
+    nowUs = model->send(nowUs);
+    reportCount++;
+    if (!keepReports) return;
+    
+    MockReport entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.timeUs = nowUs;
+    entry.media = true;
+    entry.mediaKey = mediaKey;
+    reports.push_back(entry);
+}
+
+void MockHIDDevice::sendKey(uint8_t key, uint8_t modifiers) {
+    if (!connected) return;
+    
+    // Same press, hold, release sequence as the live backends
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    report.modifiers = modifiers;
+    
+    uint8_t usage = 0;
+    if (key != 0 && HIDReportEncoder::keyToUsage(key, usage, report.modifiers)) {
+        report.keys[0] = usage;
+    }
+    deliver(report);
+    sendHold();
+    
+    memset(&report, 0, sizeof(report));
+    deliver(report);
+}
+
+void MockHIDDevice::sendString(const String& text) {
+    sendText(text.c_str(), text.length());
+}
+
+void MockHIDDevice::sendText(const char* text, size_t length) {
+    if (!connected) return;
+    
+    HIDKeyReport report;
+    encoder.begin(text, length);
+    while (encoder.next(report)) {
+        deliver(report);
+    }
+}
+
+void MockHIDDevice::sendMediaKey(uint8_t mediaKey) {
+    if (!connected || mediaKey >= MEDIA_KEY_COUNT) return;
+    deliverMedia(mediaKey);
+    if (model->holdsMediaKeys()) nowUs = model->hold(nowUs);
+    deliverMedia(MEDIA_KEY_COUNT);
+}
+
+void MockHIDDevice::sendReport(const HIDKeyReport& report) {
+    if (!connected) return;
+    deliver(report);
+}
+
+void MockHIDDevice::sendHold() {
+    if (!connected) return;
+    nowUs = model->hold(nowUs);
+}
+
+void MockHIDDevice::delay(uint32_t ms) {
+    nowUs += (uint64_t)ms * 1000;
+    delayCount++;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef MOCK_HID_DEVICE_H
+#define MOCK_HID_DEVICE_H
+
+#include <vector>
+#include "DuckyScriptParser.h"
+#include "HIDReportEncoder.h"
+#include "HIDReportDecoder.h"
+#include "TransportModel.h"
+
+struct MockReport {
+    uint64_t timeUs;      // When the host received it
+    bool media;
+    uint8_t mediaKey;     // Pressed media key, MEDIA_KEY_COUNT for a release
+    HIDKeyReport report;
+};
+
+// HIDDevice for host runs. It encodes like the live backends and plays
+// the output task: every report is given the time a transport model says
+// it reaches the host, and DELAY moves the simulated timeline on. Nothing
+// is waited for (isRealtime() is false), so a payload runs as fast as it
+// parses and the timeline gives how long it would take on the device.
+// The typing statistics the firmware only keeps in DEBUG builds come from
+// the decoder here, fed with the simulated times.
+class MockHIDDevice : public HIDDevice {
+private:
+    TransportModel* model;
+    HIDReportEncoder encoder;
+    HIDReportDecoder decoder;
+    std::vector<MockReport> reports;
+    bool keepReports;
+    bool decodeReports;
+    bool connected;
+    uint64_t nowUs;       // Where the output task is on the timeline
+    uint32_t reportCount;
+    uint32_t delayCount;
+    
+    void deliver(const HIDKeyReport& report);
+    void deliverMedia(uint8_t mediaKey);
+    
+public:
+    MockHIDDevice(TransportModel* transport, bool recordReports = true, bool decode = true);
+    
+    void reset();
+    void setConnected(bool state) { connected = state; }
+    
+    uint64_t getDurationUs() { return nowUs; }
+    uint32_t getReportCount() { return reportCount; }
+    uint32_t getDelayCount() { return delayCount; }
+    const std::vector<MockReport>& getReports() { return reports; }
+    HIDReportDecoder& getDecoder() { return decoder; }
+    
+    // HIDDevice interface implementation
+    void sendKey(uint8_t key, uint8_t modifiers = 0) override;
+    void sendString(const String& text) override;
+    void sendText(const char* text, size_t length) override;
+    void sendKeySequence(const char* keys, size_t length) override {}
+    void sendMediaKey(uint8_t mediaKey) override;
+    void sendReport(const HIDKeyReport& report) override;
+    void sendHold() override;
+    void delay(uint32_t ms) override;
+    bool isConnected() override { return connected; }
+    bool isRealtime() override { return false; }
+    uint32_t reportTimeUs() override { return model->reportTimeUs(); }
+    uint32_t keyTimeUs() override { return model->keyTimeUs(); }
+};
+
+#endif // MOCK_HID_DEVICE_H
\ No newline at end of file
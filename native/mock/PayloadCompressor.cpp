@@ -0,0 +1,102 @@
+#include "PayloadCompressor.h"
+#include <map>
+#include <vector>
+#include <string.h>
+#include "CompressedFile.h"
+
+#define WINDOW    (1 << LZ_WINDOW_BITS)
+#define MAX_MATCH (LZ_MIN_MATCH + (1 << LZ_LENGTH_BITS) - 1)
+#define MAX_CHAIN 256  // Candidates tried per position
+
+typedef std::map<std::string, std::vector<size_t> > Chains;
+
+struct Match {
+    size_t length;
+    size_t distance;
+};
+
+static std::string key(const std::string& data, size_t pos) {
+    return data.substr(pos, LZ_MIN_MATCH);
+}
+
+static Match findMatch(const std::string& data, size_t pos, Chains& chains) {
+    Match best = { 0, 0 };
+    Chains::iterator found = chains.find(key(data, pos));
+    if (found == chains.end()) return best;
+    
+    size_t end = std::min(data.size(), pos + MAX_MATCH);
+    const std::vector<size_t>& starts = found->second;
+    size_t first = starts.size() > MAX_CHAIN ? starts.size() - MAX_CHAIN : 0;
+    for (size_t i = starts.size(); i-- > first;) {
+        size_t distance = pos - starts[i];
+        if (distance > WINDOW) break;
+        size_t length = 0;
+        while (pos + length < end && data[starts[i] + length] == data[pos + length]) {
+            length++;
+        }
+        if (length > best.length) {
+            best.length = length;
+            best.distance = distance;
+            if (length == MAX_MATCH) break;
+        }
+    }
+    return best;
+}
+
+std::string compressPayload(const std::string& data) {
+    Chains chains;
+    std::vector<int> items;  // A literal byte, or -1 - the match value
+    size_t pos = 0;
+    while (pos < data.size()) {
+        Match match = findMatch(data, pos, chains);
+        if (match.length >= LZ_MIN_MATCH && pos + 1 < data.size()) {
+            // Lazy matching: emit a literal if the next position matches longer
+            chains[key(data, pos)].push_back(pos);
+            if (findMatch(data, pos + 1, chains).length > match.length) {
+                items.push_back((uint8_t)data[pos]);
+                pos++;
+                continue;
+            }
+            chains[key(data, pos)].pop_back();
+        }
+        if (match.length >= LZ_MIN_MATCH) {
+            int value = (int)(((match.distance - 1) << LZ_LENGTH_BITS) | (match.length - LZ_MIN_MATCH));
+            items.push_back(-1 - value);
+            for (size_t i = 0; i < match.length; i++) {
+                chains[key(data, pos + i)].push_back(pos + i);
+            }
+            pos += match.length;
+        } else {
+            items.push_back((uint8_t)data[pos]);
+            chains[key(data, pos)].push_back(pos);
+            pos++;
+        }
+    }
+    
+    LZHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LZ_MAGIC, sizeof(header.magic));
+    header.version = LZ_VERSION;
+    header.windowBits = LZ_WINDOW_BITS;
+    header.lengthBits = LZ_LENGTH_BITS;
+    header.size = data.size();
+    std::string out((const char*)&header, sizeof(header));
+    for (size_t group = 0; group < items.size(); group += 8) {
+        uint8_t flags = 0;
+        std::string body;
+        for (size_t bit = 0; bit < 8 && group + bit < items.size(); bit++) {
+            int item = items[group + bit];
+            if (item >= 0) {
+                flags |= 1 << bit;
+                body += (char)item;
+            } else {
+                int value = -1 - item;
+                body += (char)(value & 0xFF);
+                body += (char)(value >> 8);
+            }
+        }
+        out += (char)flags;
+        out += body;
+    }
+    return out;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef MOCK_PAYLOAD_COMPRESSOR_H
+#define MOCK_PAYLOAD_COMPRESSOR_H
+
+#include <string>
+
+// The .dsz encoder of tools/compress_payload.py on the host, so tests and
+// the benchmark can make compressed payloads without Python: the same
+// hash chains, candidate limit and lazy matching, and the same bytes.
+std::string compressPayload(const std::string& data);
+
+#endif // MOCK_PAYLOAD_COMPRESSOR_H
\ No newline at end of file
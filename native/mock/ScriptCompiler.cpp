@@ -0,0 +1,32 @@
+#include "ScriptCompiler.h"
+#include "CompressedFile.h"
+#include "DuckyScriptParser.h"
+#include "HIDRecorder.h"
+#include "PayloadCache.h"
+#include "PayloadManager.h"
+
+uint32_t compileScript(fs::File& script, fs::File& output) {
+    if (!script || script.size() == 0 || !output) return 0;
+    
+    static PayloadCache cache;
+    HIDRecorder recorder;
+    if (!recorder.begin(output, cache.sourceKey(script))) return 0;
+    
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&recorder);
+    if (script.size() > PayloadManager::MAX_LOAD_SIZE || CompressedFile::isCompressed(script.name())) {
+        parser.execute(CompressedFile::isCompressed(script.name()) ? CompressedFile::open(script) : script);
+    } else {
+        static PayloadManager manager;
+        uint32_t length = 0;
+        char* buffer = manager.readBuffer(script, length);
+        if (buffer) parser.execute(buffer, length);
+    }
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+    parser.setHIDDevice(nullptr);
+    
+    uint32_t records = recorder.getRecordCount();
+    return recorder.end() ? records : 0;
+}
\ No newline at end of file
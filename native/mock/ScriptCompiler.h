@@ -0,0 +1,14 @@
+#ifndef MOCK_SCRIPT_COMPILER_H
+#define MOCK_SCRIPT_COMPILER_H
+
+#include <FS.h>
+
+// Compiles a DuckyScript payload into a .hidr report stream on the host,
+// as the C key does on the device: the script is loaded like a payload
+// about to run (read into one buffer, or streamed when large or .dsz) and
+// run into a HIDRecorder with the active keyboard layout. Delays are
+// recorded, not waited for. Returns the number of records written, 0 if
+// the script was empty or the stream could not be written.
+uint32_t compileScript(fs::File& script, fs::File& output);
+
+#endif // MOCK_SCRIPT_COMPILER_H
\ No newline at end of file
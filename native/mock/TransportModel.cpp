@@ -0,0 +1,65 @@
+#include "TransportModel.h"
+
+UsbTimingModel::UsbTimingModel(uint32_t minReportGapUs, uint32_t pollIntervalUs) {
+    gapUs = minReportGapUs;
+    pollUs = pollIntervalUs > 0 ? pollIntervalUs : 1;
+    reset();
+}
+
+void UsbTimingModel::reset() {
+    lastUs = 0;
+    sent = false;
+}
+
+uint64_t UsbTimingModel::send(uint64_t readyUs) {
+    uint64_t at = readyUs;
+    if (sent && at < lastUs + gapUs) at = lastUs + gapUs;
+    at = (at + pollUs - 1) / pollUs * pollUs;
+    lastUs = at;
+    sent = true;
+    return at;
+}
+
+uint32_t UsbTimingModel::reportTimeUs() {
+    return gapUs > pollUs ? gapUs : pollUs;
+}
+
+BleTimingModel::BleTimingModel(uint32_t connectionIntervalUs, uint8_t notificationsPerEvent) {
+    intervalUs = connectionIntervalUs > 0 ? connectionIntervalUs : 1;
+    perEvent = notificationsPerEvent > 0 ? notificationsPerEvent : 1;
+    reset();
+}
+
+void BleTimingModel::reset() {
+    eventUs = 0;
+    eventSent = 0;
+}
+
+uint64_t BleTimingModel::eventAtOrAfter(uint64_t us) {
+    return (us + intervalUs - 1) / intervalUs * intervalUs;
+}
+
+uint64_t BleTimingModel::send(uint64_t readyUs) {
+    if (readyUs > eventUs) {
+        // Idle link: the next event after the report is queued
+        uint64_t next = eventAtOrAfter(readyUs);
+        if (next != eventUs) {
+            eventUs = next;
+            eventSent = 0;
+        }
+    }
+    if (eventSent == perEvent) {
+        eventUs += intervalUs;
+        eventSent = 0;
+    }
+    eventSent++;
+    return eventUs;
+}
+
+uint64_t BleTimingModel::hold(uint64_t readyUs) {
+    uint64_t next = eventUs + intervalUs;
+    if (readyUs > next) next = eventAtOrAfter(readyUs);
+    eventUs = next;
+    eventSent = 0;
+    return eventUs;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef MOCK_TRANSPORT_MODEL_H
+#define MOCK_TRANSPORT_MODEL_H
+
+#include <stdint.h>
+
+// When a report reaches the host, for a report the output task hands to
+// the backend at a given time. Times are microseconds on the simulated
+// timeline of a MockHIDDevice.
+class TransportModel {
+public:
+    virtual ~TransportModel() {}
+    
+    virtual const char* name() = 0;
+    virtual void reset() = 0;
+    virtual uint64_t send(uint64_t readyUs) = 0;                // Returns when the host has the report
+    virtual uint64_t hold(uint64_t readyUs) { return readyUs; } // Keep keys down for one report slot
+    virtual bool holdsMediaKeys() { return false; }             // Media release waits for hold()
+    
+    // What the backend reports to the duration estimate
+    virtual uint32_t reportTimeUs() = 0;
+    virtual uint32_t keyTimeUs() { return 2 * reportTimeUs(); }
+};
+
+// Full speed USB as MeowUSBDevice drives it: a report is written no sooner
+// than the minimum gap after the previous one and goes out on the next
+// interrupt IN poll of the host.
+class UsbTimingModel : public TransportModel {
+private:
+    uint32_t gapUs;
+    uint32_t pollUs;
+    uint64_t lastUs;
+    bool sent;
+    
+public:
+    UsbTimingModel(uint32_t minReportGapUs = 1000, uint32_t pollIntervalUs = 1000);
+    
+    const char* name() override { return "usb"; }
+    void reset() override;
+    uint64_t send(uint64_t readyUs) override;
+    uint32_t reportTimeUs() override;
+};
+
+// BLE as BluetoothHIDDevice drives it: connection events every interval,
+// up to a budget of notifications per event, and a hold moves on to the
+// next event.
+class BleTimingModel : public TransportModel {
+private:
+    uint32_t intervalUs;
+    uint8_t perEvent;
+    uint64_t eventUs;   // Start of the current connection event
+    uint8_t eventSent;
+    
+    uint64_t eventAtOrAfter(uint64_t us);
+    
+public:
+    BleTimingModel(uint32_t connectionIntervalUs = 15000, uint8_t notificationsPerEvent = 4);
+    
+    const char* name() override { return "ble"; }
+    void reset() override;
+    uint64_t send(uint64_t readyUs) override;
+    uint64_t hold(uint64_t readyUs) override;
+    bool holdsMediaKeys() override { return true; }
+    uint32_t reportTimeUs() override { return intervalUs / perEvent; }
+    uint32_t keyTimeUs() override { return intervalUs + reportTimeUs(); }
+};
+
+#endif // MOCK_TRANSPORT_MODEL_H
\ No newline at end of file
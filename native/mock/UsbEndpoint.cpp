@@ -0,0 +1,106 @@
+#include "UsbEndpoint.h"
+#include <Arduino.h>
+#include <USB.h>
+#include <mutex>
+
+static std::recursive_mutex lock;
+static bool mounted = true;
+static uint32_t pollUs = 1000;
+static uint64_t pausedUntil = 0;
+static bool inFlight = false;
+static uint64_t completeUs = 0;  // Poll that takes the report in flight
+static uint32_t busyPolls = 0;
+static std::vector<UsbEndpointReport> reports;
+
+static uint64_t nextPoll(uint64_t us) {
+    uint64_t poll = (us / pollUs + 1) * pollUs;
+    if (poll < pausedUntil) poll = (pausedUntil + pollUs - 1) / pollUs * pollUs;
+    return poll;
+}
+
+void UsbEndpoint::reset(uint32_t pollIntervalUs) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    mounted = true;
+    pollUs = pollIntervalUs > 0 ? pollIntervalUs : 1;
+    pausedUntil = 0;
+    inFlight = false;
+    completeUs = 0;
+    busyPolls = 0;
+    reports.clear();
+}
+
+void UsbEndpoint::setMounted(bool value) {
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        mounted = value;
+        inFlight = false;
+    }
+    USB.postEvent(value ? ARDUINO_USB_STARTED_EVENT : ARDUINO_USB_STOPPED_EVENT);
+}
+
+void UsbEndpoint::setPollInterval(uint32_t us) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    pollUs = us > 0 ? us : 1;
+}
+
+void UsbEndpoint::pauseUntil(uint64_t us) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    pausedUntil = us;
+    if (inFlight && completeUs < us) completeUs = nextPoll(completeUs - 1);
+}
+
+bool UsbEndpoint::waitComplete(uint32_t timeoutMs) {
+    uint64_t at;
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        if (!inFlight) return true;
+        at = completeUs;
+    }
+    uint64_t now = HostClock::now();
+    uint64_t timeout = (uint64_t)timeoutMs * 1000;
+    if (at > now + timeout) {
+        // Still queued, the host takes it later
+        HostClock::sleep(timeout);
+        return false;
+    }
+    if (at > now) HostClock::sleep(at - now);
+    return true;
+}
+
+const std::vector<UsbEndpointReport>& UsbEndpoint::getReports() {
+    return reports;
+}
+
+uint32_t UsbEndpoint::getBusyPolls() {
+    return busyPolls;
+}
+
+extern "C" bool tud_mounted(void) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    return mounted;
+}
+
+extern "C" bool tud_hid_n_ready(uint8_t instance) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (!mounted) return false;
+    if (inFlight && HostClock::now() >= completeUs) inFlight = false;
+    if (inFlight) busyPolls++;
+    return !inFlight;
+}
+
+extern "C" bool tud_hid_n_report(uint8_t instance, uint8_t report_id, const void* report, uint16_t len) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (!tud_hid_n_ready(instance) || len > sizeof(UsbEndpointReport::data)) return false;
+    
+    inFlight = true;
+    completeUs = nextPoll(HostClock::now());
+    
+    UsbEndpointReport sent;
+    memset(&sent, 0, sizeof(sent));
+    sent.timeUs = completeUs;
+    sent.reportId = report_id;
+    sent.length = len;
+    memcpy(sent.data, report, len);
+    reports.push_back(sent);
+    return true;
+}
\ No newline at end of file
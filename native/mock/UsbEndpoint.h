@@ -0,0 +1,37 @@
+#ifndef MOCK_USB_ENDPOINT_H
+#define MOCK_USB_ENDPOINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+extern "C" bool tud_mounted(void);
+extern "C" bool tud_hid_n_ready(uint8_t instance);
+extern "C" bool tud_hid_n_report(uint8_t instance, uint8_t report_id, const void* report, uint16_t len);
+
+struct UsbEndpointReport {
+    uint64_t timeUs;    // When the host polled it
+    uint8_t reportId;
+    uint8_t length;
+    uint8_t data[8];
+};
+
+// Simulated TinyUSB HID IN endpoint and the host polling it, on the host
+// clock. A queued report goes out on the first poll after it was queued
+// (polls fall on multiples of the interval), and the endpoint is busy
+// until then. A paused host NAKs every poll, like a busy or suspended
+// host, so reports wait in the endpoint.
+namespace UsbEndpoint {
+    void reset(uint32_t pollIntervalUs = 1000);  // Mounted, idle, nothing recorded
+    void setMounted(bool mounted);               // Posts the USB start or stop event
+    void setPollInterval(uint32_t us);
+    void pauseUntil(uint64_t us);
+
+    // Called by the shim's USBHID::SendReport after queueing a report
+    bool waitComplete(uint32_t timeoutMs);
+
+    const std::vector<UsbEndpointReport>& getReports();
+    uint32_t getBusyPolls();  // tud_hid_n_ready() calls that found a report in flight
+}
+
+#endif // MOCK_USB_ENDPOINT_H
\ No newline at end of file
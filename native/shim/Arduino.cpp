@@ -0,0 +1,63 @@
+#include "Arduino.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<bool> virtualMode(false);
+static std::atomic<uint64_t> virtualNow(0);
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+void HostClock::useVirtual(bool enabled) {
+    virtualMode = enabled;
+}
+
+bool HostClock::isVirtual() {
+    return virtualMode;
+}
+
+uint64_t HostClock::now() {
+    if (virtualMode) return virtualNow;
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void HostClock::set(uint64_t us) {
+    virtualNow = us;
+}
+
+void HostClock::advance(uint64_t us) {
+    virtualNow += us;
+}
+
+void HostClock::advanceTo(uint64_t us) {
+    uint64_t current = virtualNow;
+    while (current < us && !virtualNow.compare_exchange_weak(current, us)) {}
+}
+
+void HostClock::sleep(uint64_t us) {
+    if (virtualMode) {
+        advanceTo(virtualNow + us);
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+unsigned long millis() {
+    return (unsigned long)(HostClock::now() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)HostClock::now();
+}
+
+void delay(uint32_t ms) {
+    HostClock::sleep((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    HostClock::sleep(us);
+}
+
+void yield() {
+    std::this_thread::yield();
+}
\ No newline at end of file
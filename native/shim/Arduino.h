@@ -0,0 +1,54 @@
+#ifndef SHIM_ARDUINO_H
+#define SHIM_ARDUINO_H
+
+// Host build of the parts of the Arduino core the firmware uses, enough
+// to compile everything in src/ except the hardware backends and run it
+// on Linux under the native PlatformIO environment.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_event.h"
+
+#define PROGMEM
+#define IRAM_ATTR
+#define F(text) (text)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// Clock behind millis() and micros(). Real time by default. In virtual
+// mode time only moves when a test sets or advances it, or when a task
+// sleeps or a blocking wait times out, which moves it to the end of that
+// wait without sleeping. Runs with a simulated device then take as long
+// as the work they do, and timing results do not depend on the machine.
+namespace HostClock {
+    void useVirtual(bool enabled);
+    bool isVirtual();
+    uint64_t now();                  // Microseconds
+    void set(uint64_t us);
+    void advance(uint64_t us);
+    void advanceTo(uint64_t us);     // Never moves back
+    void sleep(uint64_t us);         // Real sleep or virtual advance
+}
+
+#endif // SHIM_ARDUINO_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef SHIM_BLE_KEYBOARD_H
+#define SHIM_BLE_KEYBOARD_H
+
+#include <Arduino.h>
+#include "NimBLEDevice.h"
+
+typedef uint8_t MediaKeyReport[2];
+
+typedef struct {
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[6];
+} KeyReport;
+
+// ESP32-BLE-Keyboard built with USE_NIMBLE: a HID service whose first
+// input report characteristic is the keyboard and second the media keys
+class BleKeyboard {
+private:
+    std::string deviceName;
+    NimBLECharacteristic* inputKeyboard;
+    NimBLECharacteristic* inputMediaKeys;
+    MediaKeyReport mediaKeyReport;
+    uint32_t delayMs;
+    
+public:
+    BleKeyboard(std::string name = "ESP32 Keyboard", std::string manufacturer = "Espressif", uint8_t batteryLevel = 100);
+    
+    void begin();
+    void end() {}
+    bool isConnected();
+    void setDelay(uint32_t ms) { delayMs = ms; }
+    
+    void sendReport(KeyReport* keys);
+    void sendReport(MediaKeyReport* keys);
+    size_t press(const MediaKeyReport k);
+    size_t release(const MediaKeyReport k);
+};
+
+#endif // SHIM_BLE_KEYBOARD_H
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "FSImpl.h"
+
+using namespace fs;
+
+size_t File::write(uint8_t c) {
+    if (!*this) return 0;
+    return _p->write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!*this) return 0;
+    return _p->write(buf, size);
+}
+
+int File::available() {
+    if (!*this) return 0;
+    return _p->size() - _p->position();
+}
+
+int File::read() {
+    if (!*this) return -1;
+    uint8_t c;
+    if (_p->read(&c, 1) != 1) return -1;
+    return c;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!*this) return 0;
+    return _p->read(buf, size);
+}
+
+int File::peek() {
+    if (!*this) return -1;
+    size_t current = _p->position();
+    int c = read();
+    _p->seek(current, SeekSet);
+    return c;
+}
+
+void File::flush() {
+    if (!*this) return;
+    _p->flush();
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!*this) return false;
+    return _p->seek(pos, mode);
+}
+
+size_t File::position() const {
+    if (!*this) return 0;
+    return _p->position();
+}
+
+size_t File::size() const {
+    if (!*this) return 0;
+    return _p->size();
+}
+
+bool File::setBufferSize(size_t size) {
+    if (!*this) return false;
+    return _p->setBufferSize(size);
+}
+
+void File::close() {
+    if (_p) {
+        _p->close();
+        _p = nullptr;
+    }
+}
+
+File::operator bool() const {
+    return _p != nullptr && (bool)*_p;
+}
+
+time_t File::getLastWrite() {
+    if (!*this) return 0;
+    return _p->getLastWrite();
+}
+
+const char* File::path() const {
+    if (!*this) return nullptr;
+    return _p->path();
+}
+
+const char* File::name() const {
+    if (!*this) return nullptr;
+    return _p->name();
+}
+
+bool File::isDirectory(void) {
+    if (!*this) return false;
+    return _p->isDirectory();
+}
+
+bool File::seekDir(long position) {
+    if (!_p) return false;
+    return _p->seekDir(position);
+}
+
+File File::openNextFile(const char* mode) {
+    if (!*this) return File();
+    return _p->openNextFile(mode);
+}
+
+String File::getNextFileName(void) {
+    if (!_p) return String();
+    return _p->getNextFileName();
+}
+
+String File::getNextFileName(bool* isDir) {
+    if (!_p) return String();
+    return _p->getNextFileName(isDir);
+}
+
+void File::rewindDirectory(void) {
+    if (!*this) return;
+    _p->rewindDirectory();
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+    if (!_impl || !path) return File();
+    return File(_impl->open(path, mode, create));
+}
+
+bool FS::exists(const char* path) {
+    if (!_impl || !path) return false;
+    return _impl->exists(path);
+}
+
+bool FS::remove(const char* path) {
+    if (!_impl || !path) return false;
+    return _impl->remove(path);
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    if (!_impl || !pathFrom || !pathTo) return false;
+    return _impl->rename(pathFrom, pathTo);
+}
+
+bool FS::mkdir(const char* path) {
+    if (!_impl || !path) return false;
+    return _impl->mkdir(path);
+}
+
+bool FS::rmdir(const char* path) {
+    if (!_impl || !path) return false;
+    return _impl->rmdir(path);
+}
\ No newline at end of file
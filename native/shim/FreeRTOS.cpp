@@ -0,0 +1,217 @@
+#include <Arduino.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define VIRTUAL_WAIT_US 200  // Real time a virtual clock wait gives other threads
+
+struct HostTask {
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint32_t notifications;
+    const char* name;
+    
+    HostTask(const char* taskName) : notifications(0), name(taskName) {}
+};
+
+struct HostSemaphore {
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint32_t count;
+    
+    HostSemaphore(uint32_t initial) : count(initial) {}
+};
+
+struct HostEventGroup {
+    std::mutex mutex;
+    std::condition_variable wake;
+    EventBits_t bits;
+    
+    HostEventGroup() : bits(0) {}
+};
+
+// Thrown by vTaskDelete(nullptr) to unwind the task's thread
+struct HostTaskDeleted {};
+
+static thread_local HostTask* currentTask = nullptr;
+static thread_local uint32_t threadId = 0;
+static std::atomic<uint32_t> nextThreadId(1);
+
+static HostTask* self() {
+    // Threads not created by xTaskCreate (main) get a handle on first use
+    if (!currentTask) currentTask = new HostTask("main");
+    return currentTask;
+}
+
+// Block until ready() or the timeout. With the virtual clock the real wait
+// is short and a timeout moves the clock to where the wait would have ended.
+template <typename Ready>
+static bool waitFor(std::unique_lock<std::mutex>& lock, std::condition_variable& wake, TickType_t ticks, Ready ready) {
+    if (ticks == portMAX_DELAY) {
+        wake.wait(lock, ready);
+        return true;
+    }
+    if (!HostClock::isVirtual()) {
+        return wake.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+    }
+    
+    uint64_t deadline = HostClock::now() + (uint64_t)ticks * 1000;
+    if (ready()) return true;
+    if (ticks == 0) return false;
+    if (wake.wait_for(lock, std::chrono::microseconds(VIRTUAL_WAIT_US), ready)) return true;
+    HostClock::advanceTo(deadline);
+    return ready();
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    if (threadId == 0) threadId = nextThreadId++;
+    if (mux->owner == threadId) {
+        mux->count++;
+        return;
+    }
+    uint32_t expected = portMUX_FREE_VAL;
+    while (!__atomic_compare_exchange_n(&mux->owner, &expected, threadId, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        expected = portMUX_FREE_VAL;
+        std::this_thread::yield();
+    }
+    mux->count = 1;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    if (--mux->count == 0) {
+        __atomic_store_n(&mux->owner, (uint32_t)portMUX_FREE_VAL, __ATOMIC_RELEASE);
+    }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* createdTask, BaseType_t coreId) {
+    // Handles are never freed, a deleted task's handle may still be stored
+    HostTask* task = new HostTask(name);
+    if (createdTask) *createdTask = task;
+    
+    std::thread([code, parameters, task]() {
+        currentTask = task;
+        try {
+            code(parameters);
+        } catch (const HostTaskDeleted&) {
+        }
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* createdTask) {
+    return xTaskCreatePinnedToCore(code, name, stackDepth, parameters, priority, createdTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) throw HostTaskDeleted();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
+
+TickType_t xTaskGetTickCount() {
+    return millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return self();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    HostTask* task = self();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    waitFor(lock, task->wake, ticksToWait, [task]() { return task->notifications > 0; });
+    
+    uint32_t value = task->notifications;
+    if (value > 0) task->notifications = clearCountOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (!task) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostSemaphore(1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return new HostSemaphore(0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!waitFor(lock, semaphore->wake, ticksToWait, [semaphore]() { return semaphore->count > 0; })) return pdFALSE;
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->count > 0) return pdFALSE;
+        semaphore->count = 1;
+    }
+    semaphore->wake.notify_one();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+EventGroupHandle_t xEventGroupCreate() {
+    return new HostEventGroup();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t value;
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        group->bits |= bits;
+        value = group->bits;
+    }
+    group->wake.notify_all();
+    return value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    EventBits_t value = group->bits;
+    group->bits &= ~bits;
+    return value;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    std::lock_guard<std::mutex> lock(group->mutex);
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticksToWait) {
+    std::unique_lock<std::mutex> lock(group->mutex);
+    bool met = waitFor(lock, group->wake, ticksToWait, [group, bits, waitForAll]() {
+        return waitForAll ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    });
+    
+    EventBits_t value = group->bits;
+    if (met && clearOnExit) group->bits &= ~bits;
+    return value;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+    delete group;
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef SHIM_HARDWARE_SERIAL_H
+#define SHIM_HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+// Serial on the host writes to stdout and never has input
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) {}
+    void end() {}
+    int available() { return 0; }
+    int availableForWrite() { return 128; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    void flush();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buffer, size_t size);
+    using Print::write;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // SHIM_HARDWARE_SERIAL_H
\ No newline at end of file
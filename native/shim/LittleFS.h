@@ -0,0 +1,20 @@
+#ifndef SHIM_LITTLEFS_H
+#define SHIM_LITTLEFS_H
+
+#include "FS.h"
+
+// Internal flash on the host: a MemoryFS (LittleFSStorage in native/mock)
+class LittleFSFS : public fs::FS {
+public:
+    LittleFSFS(fs::FSImplPtr impl) : FS(impl) {}
+    
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = "spiffs") { return true; }
+    void end() {}
+    size_t totalBytes() { return 1536 * 1024; }
+    size_t usedBytes() { return 0; }
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // SHIM_LITTLEFS_H
\ No newline at end of file
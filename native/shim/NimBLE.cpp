@@ -0,0 +1,145 @@
+#include <NimBLEDevice.h>
+#include <BleKeyboard.h>
+
+#define HID_SERVICE_UUID  0x1812
+#define HID_REPORT_UUID   0x2A4D
+
+static NimBLEServer* server = nullptr;
+static NimBLEAdvertising advertising;
+static uint16_t nextHandle = 1;
+
+void NimBLECharacteristic::notify(bool is_notification) {
+    std::vector<uint16_t> peers = NimBLEDevice::getServer()->getPeerDevices();
+    if (peers.empty()) {
+        if (callbacks) callbacks->onStatus(this, NimBLECharacteristicCallbacks::ERROR_NO_CLIENT, 0);
+        return;
+    }
+    
+    int rc = ble_gattc_notify_custom(peers[0], handle, value.data(), value.size());
+    if (callbacks) {
+        callbacks->onStatus(this, rc == 0 ? NimBLECharacteristicCallbacks::SUCCESS_NOTIFY :
+                                            NimBLECharacteristicCallbacks::ERROR_GATT, rc);
+    }
+}
+
+NimBLEService::~NimBLEService() {
+    for (size_t i = 0; i < characteristics.size(); i++) delete characteristics[i];
+}
+
+NimBLECharacteristic* NimBLEService::createCharacteristic(const NimBLEUUID& id, uint32_t properties) {
+    NimBLECharacteristic* characteristic = new NimBLECharacteristic(id, nextHandle++);
+    characteristics.push_back(characteristic);
+    return characteristic;
+}
+
+NimBLECharacteristic* NimBLEService::getCharacteristic(const NimBLEUUID& id) {
+    for (size_t i = 0; i < characteristics.size(); i++) {
+        if (characteristics[i]->getUUID() == id) return characteristics[i];
+    }
+    return nullptr;
+}
+
+NimBLEServer::~NimBLEServer() {
+    for (size_t i = 0; i < services.size(); i++) delete services[i];
+}
+
+NimBLEService* NimBLEServer::createService(const NimBLEUUID& id) {
+    NimBLEService* service = new NimBLEService(id);
+    services.push_back(service);
+    return service;
+}
+
+NimBLEService* NimBLEServer::getServiceByUUID(const NimBLEUUID& id) {
+    for (size_t i = 0; i < services.size(); i++) {
+        if (services[i]->getUUID() == id) return services[i];
+    }
+    return nullptr;
+}
+
+std::vector<uint16_t> NimBLEServer::getPeerDevices() {
+    // One peripheral link at most, on the first connection handle
+    std::vector<uint16_t> peers;
+    ble_gap_conn_desc desc;
+    if (ble_gap_conn_find(0, &desc) == 0) peers.push_back(desc.conn_handle);
+    return peers;
+}
+
+NimBLEConnInfo NimBLEServer::getPeerIDInfo(uint16_t id) {
+    ble_gap_conn_desc desc;
+    memset(&desc, 0, sizeof(desc));
+    ble_gap_conn_find(id, &desc);
+    return NimBLEConnInfo(desc);
+}
+
+void NimBLEServer::updateConnParams(uint16_t conn_handle, uint16_t minInterval, uint16_t maxInterval,
+                                    uint16_t latency, uint16_t timeout) {
+    ble_gap_upd_params params;
+    memset(&params, 0, sizeof(params));
+    params.itvl_min = minInterval;
+    params.itvl_max = maxInterval;
+    params.latency = latency;
+    params.supervision_timeout = timeout;
+    ble_gap_update_params(conn_handle, &params);
+}
+
+NimBLEServer* NimBLEDevice::createServer() {
+    if (!server) server = new NimBLEServer();
+    return server;
+}
+
+NimBLEServer* NimBLEDevice::getServer() {
+    return server;
+}
+
+NimBLEAdvertising* NimBLEDevice::getAdvertising() {
+    return &advertising;
+}
+
+BleKeyboard::BleKeyboard(std::string name, std::string manufacturer, uint8_t batteryLevel) {
+    deviceName = name;
+    inputKeyboard = nullptr;
+    inputMediaKeys = nullptr;
+    memset(mediaKeyReport, 0, sizeof(mediaKeyReport));
+    delayMs = 7;
+}
+
+void BleKeyboard::begin() {
+    NimBLEServer* hidServer = NimBLEDevice::createServer();
+    NimBLEService* hid = hidServer->getServiceByUUID(NimBLEUUID((uint16_t)HID_SERVICE_UUID));
+    if (!hid) hid = hidServer->createService(NimBLEUUID((uint16_t)HID_SERVICE_UUID));
+    inputKeyboard = hid->createCharacteristic(NimBLEUUID((uint16_t)HID_REPORT_UUID));
+    inputMediaKeys = hid->createCharacteristic(NimBLEUUID((uint16_t)HID_REPORT_UUID));
+}
+
+bool BleKeyboard::isConnected() {
+    ble_gap_conn_desc desc;
+    return ble_gap_conn_find(0, &desc) == 0;
+}
+
+void BleKeyboard::sendReport(KeyReport* keys) {
+    if (!isConnected() || !inputKeyboard) return;
+    inputKeyboard->setValue((const uint8_t*)keys, sizeof(KeyReport));
+    inputKeyboard->notify();
+    ::delay(delayMs);
+}
+
+void BleKeyboard::sendReport(MediaKeyReport* keys) {
+    if (!isConnected() || !inputMediaKeys) return;
+    inputMediaKeys->setValue((const uint8_t*)keys, sizeof(MediaKeyReport));
+    inputMediaKeys->notify();
+    ::delay(delayMs);
+}
+
+size_t BleKeyboard::press(const MediaKeyReport k) {
+    mediaKeyReport[0] |= k[0];
+    mediaKeyReport[1] |= k[1];
+    sendReport(&mediaKeyReport);
+    return 1;
+}
+
+size_t BleKeyboard::release(const MediaKeyReport k) {
+    mediaKeyReport[0] &= ~k[0];
+    mediaKeyReport[1] &= ~k[1];
+    sendReport(&mediaKeyReport);
+    return 1;
+}
\ No newline at end of file
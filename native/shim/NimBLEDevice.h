@@ -0,0 +1,180 @@
+#ifndef SHIM_NIMBLE_DEVICE_H
+#define SHIM_NIMBLE_DEVICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// The parts of NimBLE-Arduino 1.4 the BLE backend uses. The GAP and GATT
+// calls underneath are served by the simulated link in
+// native/mock/BleLink.h.
+
+#define BLE_HS_EALREADY           2
+#define BLE_HS_ENOMEM             6
+#define BLE_HS_ENOTCONN           7
+#define BLE_HS_IO_NO_INPUT_OUTPUT 3
+
+#define BLE_GAP_EVENT_CONNECT     0
+#define BLE_GAP_EVENT_DISCONNECT  1
+#define BLE_GAP_EVENT_CONN_UPDATE 3
+
+typedef enum {
+    ESP_PWR_LVL_N12 = 0,
+    ESP_PWR_LVL_P9 = 7
+} esp_power_level_t;
+
+struct ble_gap_event {
+    uint8_t type;
+    union {
+        struct {
+            int status;
+            uint16_t conn_handle;
+        } connect;
+        struct {
+            int reason;
+            uint16_t conn_handle;
+        } disconnect;
+        struct {
+            int status;
+            uint16_t conn_handle;
+        } conn_update;
+    };
+};
+
+struct ble_gap_conn_desc {
+    uint16_t conn_handle;
+    uint16_t conn_itvl;            // 1.25 ms units
+    uint16_t conn_latency;
+    uint16_t supervision_timeout;  // 10 ms units
+};
+
+struct ble_gap_upd_params {
+    uint16_t itvl_min;
+    uint16_t itvl_max;
+    uint16_t latency;
+    uint16_t supervision_timeout;
+    uint16_t min_ce_len;
+    uint16_t max_ce_len;
+};
+
+typedef int ble_gap_event_fn(struct ble_gap_event* event, void* arg);
+
+struct ble_gap_event_listener {
+    ble_gap_event_fn* fn;
+    void* arg;
+    ble_gap_event_listener* next;
+};
+
+extern "C" int ble_gap_event_listener_register(struct ble_gap_event_listener* listener, ble_gap_event_fn* fn,
+                                               void* arg);
+extern "C" int ble_gap_conn_find(uint16_t handle, struct ble_gap_conn_desc* out_desc);
+extern "C" int ble_gap_update_params(uint16_t conn_handle, const struct ble_gap_upd_params* params);
+// Takes the value instead of an os_mbuf
+extern "C" int ble_gattc_notify_custom(uint16_t conn_handle, uint16_t att_handle, const void* data, uint16_t len);
+
+class NimBLEUUID {
+private:
+    uint16_t value;
+    
+public:
+    NimBLEUUID(uint16_t uuid = 0) : value(uuid) {}
+    bool operator==(const NimBLEUUID& other) const { return value == other.value; }
+};
+
+class NimBLECharacteristic;
+
+class NimBLECharacteristicCallbacks {
+public:
+    typedef enum {
+        SUCCESS_INDICATE,
+        SUCCESS_NOTIFY,
+        ERROR_INDICATE_DISABLED,
+        ERROR_NOTIFY_DISABLED,
+        ERROR_GATT,
+        ERROR_NO_CLIENT,
+        ERROR_INDICATE_TIMEOUT,
+        ERROR_INDICATE_FAILURE
+    } Status;
+    
+    virtual ~NimBLECharacteristicCallbacks() {}
+    virtual void onStatus(NimBLECharacteristic* pCharacteristic, Status s, int code) {}
+};
+
+class NimBLECharacteristic {
+private:
+    NimBLEUUID uuid;
+    uint16_t handle;
+    NimBLECharacteristicCallbacks* callbacks;
+    std::string value;
+    
+public:
+    NimBLECharacteristic(const NimBLEUUID& id, uint16_t attHandle) : uuid(id), handle(attHandle), callbacks(nullptr) {}
+    
+    const NimBLEUUID& getUUID() { return uuid; }
+    uint16_t getHandle() { return handle; }
+    void setCallbacks(NimBLECharacteristicCallbacks* pCallbacks) { callbacks = pCallbacks; }
+    void setValue(const uint8_t* data, size_t length) { value.assign((const char*)data, length); }
+    void notify(bool is_notification = true);
+};
+
+class NimBLEService {
+private:
+    NimBLEUUID uuid;
+    std::vector<NimBLECharacteristic*> characteristics;
+    
+public:
+    NimBLEService(const NimBLEUUID& id) : uuid(id) {}
+    ~NimBLEService();
+    
+    const NimBLEUUID& getUUID() { return uuid; }
+    NimBLECharacteristic* createCharacteristic(const NimBLEUUID& id, uint32_t properties = 0);
+    NimBLECharacteristic* getCharacteristic(const NimBLEUUID& id);
+};
+
+class NimBLEConnInfo {
+private:
+    ble_gap_conn_desc desc;
+    
+public:
+    NimBLEConnInfo(const ble_gap_conn_desc& connDesc) : desc(connDesc) {}
+    uint16_t getConnHandle() { return desc.conn_handle; }
+    uint16_t getConnInterval() { return desc.conn_itvl; }
+    uint16_t getConnLatency() { return desc.conn_latency; }
+};
+
+class NimBLEServer {
+private:
+    std::vector<NimBLEService*> services;
+    
+public:
+    ~NimBLEServer();
+    
+    NimBLEService* createService(const NimBLEUUID& id);
+    NimBLEService* getServiceByUUID(const NimBLEUUID& id);
+    std::vector<uint16_t> getPeerDevices();
+    NimBLEConnInfo getPeerIDInfo(uint16_t id);
+    void updateConnParams(uint16_t conn_handle, uint16_t minInterval, uint16_t maxInterval, uint16_t latency,
+                          uint16_t timeout);
+};
+
+class NimBLEAdvertising {
+public:
+    bool start() { return true; }
+    bool stop() { return true; }
+    void setScanResponse(bool enabled) {}
+    void setMinInterval(uint16_t interval) {}
+    void setMaxInterval(uint16_t interval) {}
+};
+
+class NimBLEDevice {
+public:
+    static NimBLEServer* createServer();
+    static NimBLEServer* getServer();
+    static NimBLEAdvertising* getAdvertising();
+    static void setSecurityAuth(bool bonding, bool mitm, bool sc) {}
+    static void setSecurityIOCap(uint8_t iocap) {}
+    static void setPower(esp_power_level_t powerLevel) {}
+};
+
+#endif // SHIM_NIMBLE_DEVICE_H
\ No newline at end of file
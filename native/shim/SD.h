@@ -0,0 +1,23 @@
+#ifndef SHIM_SD_H
+#define SHIM_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+// SD card on the host: a MemoryFS (SDStorage in native/mock) that mounts
+// unless a test marks the card as missing
+class SDFS : public fs::FS {
+public:
+    SDFS(fs::FSImplPtr impl) : FS(impl), present(true) {}
+    
+    bool begin(uint8_t ssPin = 5, SPIClass& spi = SPI, uint32_t frequency = 4000000, const char* mountpoint = "/sd",
+               uint8_t maxFiles = 5, bool formatIfEmpty = false) { return present; }
+    void end() {}
+    uint64_t cardSize() { return 0; }
+    
+    bool present;
+};
+
+extern SDFS SD;
+
+#endif // SHIM_SD_H
\ No newline at end of file
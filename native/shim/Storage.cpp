@@ -0,0 +1,11 @@
+#include <SD.h>
+#include <LittleFS.h>
+#include "MemoryFS.h"
+
+// In one file so the storage exists before the FS objects that use it
+std::shared_ptr<MemoryFS> SDStorage = std::make_shared<MemoryFS>();
+std::shared_ptr<MemoryFS> LittleFSStorage = std::make_shared<MemoryFS>();
+
+SPIClass SPI;
+SDFS SD(SDStorage);
+LittleFSFS LittleFS(LittleFSStorage);
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef SHIM_STREAM_H
+#define SHIM_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print {
+protected:
+    unsigned long _timeout;
+    
+public:
+    Stream() : _timeout(1000) {}
+    
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    String readString();
+    String readStringUntil(char terminator);
+};
+
+#endif // SHIM_STREAM_H
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include <Arduino.h>
+#include <USB.h>
+#include <USBHID.h>
+#include "UsbEndpoint.h"
+
+const esp_event_base_t ARDUINO_USB_EVENTS = "ARDUINO_USB_EVENTS";
+
+ESPUSB USB;
+
+void ESPUSB::postEvent(arduino_usb_event_t event) {
+    if (handler) handler(nullptr, ARDUINO_USB_EVENTS, event, nullptr);
+}
+
+bool USBHID::ready(uint32_t timeout_ms) {
+    return tud_hid_n_ready(0);
+}
+
+bool USBHID::SendReport(uint8_t report_id, const void* data, size_t len, uint32_t timeout_ms) {
+    if (!tud_hid_n_ready(0)) return false;
+    if (!tud_hid_n_report(0, report_id, data, len)) return false;
+    
+    // The core waits on a semaphore given by the report complete callback
+    return UsbEndpoint::waitComplete(timeout_ms);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef SHIM_USB_H
+#define SHIM_USB_H
+
+#include "esp_event.h"
+
+typedef enum {
+    ARDUINO_USB_ANY_EVENT = ESP_EVENT_ANY_ID,
+    ARDUINO_USB_STARTED_EVENT = 0,
+    ARDUINO_USB_STOPPED_EVENT,
+    ARDUINO_USB_SUSPEND_EVENT,
+    ARDUINO_USB_RESUME_EVENT,
+    ARDUINO_USB_MAX_EVENT
+} arduino_usb_event_t;
+
+extern const esp_event_base_t ARDUINO_USB_EVENTS;
+
+// USB device stack on the host. The bus is the simulated endpoint in
+// native/mock/UsbEndpoint.h, which posts mount and unmount events here.
+class ESPUSB {
+private:
+    esp_event_handler_t handler;
+    
+public:
+    ESPUSB() : handler(nullptr) {}
+    
+    void onEvent(esp_event_handler_t callback) { handler = callback; }
+    bool begin() { return true; }
+    
+    // Host only: deliver an event the way the core's event loop would
+    void postEvent(arduino_usb_event_t event);
+};
+
+extern ESPUSB USB;
+
+#endif // SHIM_USB_H
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef SHIM_USBHID_H
+#define SHIM_USBHID_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    HID_REPORT_ID_NONE,
+    HID_REPORT_ID_KEYBOARD,
+    HID_REPORT_ID_MOUSE,
+    HID_REPORT_ID_GAMEPAD,
+    HID_REPORT_ID_CONSUMER_CONTROL,
+    HID_REPORT_ID_SYSTEM_CONTROL,
+    HID_REPORT_ID_VENDOR
+} tinyusb_hid_device_report_id_t;
+
+// The core's HID interface. SendReport() queues the report on the IN
+// endpoint and blocks until the host has polled it or the timeout passes.
+class USBHID {
+public:
+    void begin() {}
+    bool ready(uint32_t timeout_ms = 0);
+    bool SendReport(uint8_t report_id, const void* data, size_t len, uint32_t timeout_ms = 100);
+};
+
+#endif // SHIM_USBHID_H
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef SHIM_USBHID_CONSUMER_CONTROL_H
+#define SHIM_USBHID_CONSUMER_CONTROL_H
+
+#include "USBHID.h"
+
+class USBHIDConsumerControl {
+private:
+    USBHID hid;
+    
+public:
+    void begin() { hid.begin(); }
+    void end() {}
+    size_t press(uint16_t usage) { return hid.SendReport(HID_REPORT_ID_CONSUMER_CONTROL, &usage, sizeof(usage)) ? 1 : 0; }
+    size_t release() { return press(0); }
+};
+
+#endif // SHIM_USBHID_CONSUMER_CONTROL_H
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef SHIM_USBHID_KEYBOARD_H
+#define SHIM_USBHID_KEYBOARD_H
+
+#include "USBHID.h"
+
+typedef struct {
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[6];
+} KeyReport;
+
+class USBHIDKeyboard {
+private:
+    USBHID hid;
+    
+public:
+    void begin() { hid.begin(); }
+    void end() {}
+    void sendReport(KeyReport* keys) { hid.SendReport(HID_REPORT_ID_KEYBOARD, keys, sizeof(KeyReport)); }
+};
+
+#endif // SHIM_USBHID_KEYBOARD_H
\ No newline at end of file
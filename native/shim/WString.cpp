@@ -0,0 +1,152 @@
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static std::string formatInteger(unsigned long long value, bool negative, unsigned char base) {
+    char digits[72];
+    size_t count = 0;
+    if (base < 2 || base > 36) base = 10;
+    do {
+        unsigned digit = value % base;
+        digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value > 0);
+    
+    std::string result;
+    if (negative) result += '-';
+    while (count > 0) result += digits[--count];
+    return result;
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    // Like the core: only base 10 has a sign, other bases show the bits
+    if (base == 10 && value < 0) return formatInteger(0ULL - (unsigned long long)value, true, base);
+    return formatInteger((unsigned long long)(unsigned long)value, false, base);
+}
+
+String::String(unsigned char value, unsigned char base) : text(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base) : text(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : text(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : text(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : text(formatInteger(value, false, base)) {}
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimalPlaces, value);
+    text = buffer;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    return text.size() == other.text.size() && strcasecmp(text.c_str(), other.text.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+    if (offset > text.size() || prefix.text.size() > text.size() - offset) return false;
+    return text.compare(offset, prefix.text.size(), prefix.text) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.text.size() > text.size()) return false;
+    return text.compare(text.size() - suffix.text.size(), suffix.text.size(), suffix.text) == 0;
+}
+
+void String::getBytes(unsigned char* buf, unsigned int size, unsigned int index) const {
+    if (!buf || size == 0) return;
+    if (index >= text.size()) {
+        buf[0] = 0;
+        return;
+    }
+    size_t count = text.size() - index;
+    if (count > size - 1) count = size - 1;
+    memcpy(buf, text.data() + index, count);
+    buf[count] = 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+    size_t found = text.find(c, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::indexOf(const String& value, unsigned int fromIndex) const {
+    size_t found = text.find(value.text, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t found = text.rfind(c);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::lastIndexOf(char c, unsigned int fromIndex) const {
+    size_t found = text.rfind(c, fromIndex);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::lastIndexOf(const String& value) const {
+    size_t found = text.rfind(value.text);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    // The core swaps reversed bounds and clamps both to the length
+    if (beginIndex > endIndex) {
+        unsigned int swap = beginIndex;
+        beginIndex = endIndex;
+        endIndex = swap;
+    }
+    if (beginIndex >= text.size()) return String();
+    if (endIndex > text.size()) endIndex = text.size();
+    return String(text.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replacement) {
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == find) text[i] = replacement;
+    }
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.text.empty()) return;
+    size_t position = 0;
+    while ((position = text.find(find.text, position)) != std::string::npos) {
+        text.replace(position, find.text.size(), replacement.text);
+        position += replacement.text.size();
+    }
+}
+
+void String::toLowerCase() {
+    for (size_t i = 0; i < text.size(); i++) text[i] = tolower((unsigned char)text[i]);
+}
+
+void String::toUpperCase() {
+    for (size_t i = 0; i < text.size(); i++) text[i] = toupper((unsigned char)text[i]);
+}
+
+void String::trim() {
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && isspace((unsigned char)text[begin])) begin++;
+    while (end > begin && isspace((unsigned char)text[end - 1])) end--;
+    text = text.substr(begin, end - begin);
+}
+
+long String::toInt() const {
+    return atol(text.c_str());
+}
+
+float String::toFloat() const {
+    return (float)atof(text.c_str());
+}
+
+double String::toDouble() const {
+    return atof(text.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef SHIM_WSTRING_H
+#define SHIM_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+// Arduino String on top of std::string. Same API and value semantics as
+// the core's class, so it allocates like it does: one heap block per
+// non-empty string.
+class String {
+private:
+    std::string text;
+    
+public:
+    String() {}
+    String(const char* cstr) : text(cstr ? cstr : "") {}
+    String(const char* cstr, unsigned int length) : text(cstr ? cstr : "", cstr ? length : 0) {}
+    String(const std::string& value) : text(value) {}
+    explicit String(char c) : text(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+    
+    unsigned int length() const { return text.size(); }
+    const char* c_str() const { return text.c_str(); }
+    bool isEmpty() const { return text.empty(); }
+    bool reserve(unsigned int size) { text.reserve(size); return true; }
+    
+    bool concat(const String& value) { text += value.text; return true; }
+    bool concat(const char* cstr) { if (cstr) text += cstr; return cstr != nullptr; }
+    bool concat(const char* cstr, unsigned int length) { text.append(cstr, length); return true; }
+    bool concat(char c) { text += c; return true; }
+    bool concat(unsigned char value) { return concat(String(value)); }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    
+    template <typename T>
+    String& operator+=(const T& value) { concat(value); return *this; }
+    
+    friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+    friend String operator+(const String& a, const char* b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const char* a, const String& b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String& a, char b) { String s(a); s.concat(b); return s; }
+    
+    int compareTo(const String& other) const { return text.compare(other.text); }
+    bool equals(const String& other) const { return text == other.text; }
+    bool equals(const char* cstr) const { return text == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& other) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& other) const { return compareTo(other) < 0; }
+    bool operator>(const String& other) const { return compareTo(other) > 0; }
+    bool startsWith(const String& prefix) const;
+    bool startsWith(const String& prefix, unsigned int offset) const;
+    bool endsWith(const String& suffix) const;
+    
+    char charAt(unsigned int index) const { return index < text.size() ? text[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < text.size()) text[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return text[index]; }
+    void getBytes(unsigned char* buf, unsigned int size, unsigned int index = 0) const;
+    void toCharArray(char* buf, unsigned int size, unsigned int index = 0) const { getBytes((unsigned char*)buf, size, index); }
+    
+    int indexOf(char c, unsigned int fromIndex = 0) const;
+    int indexOf(const String& value, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(char c, unsigned int fromIndex) const;
+    int lastIndexOf(const String& value) const;
+    String substring(unsigned int beginIndex) const { return substring(beginIndex, length()); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+    
+    void replace(char find, char replacement);
+    void replace(const String& find, const String& replacement);
+    void remove(unsigned int index) { if (index < text.size()) text.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < text.size()) text.erase(index, count); }
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+};
+
+#endif // SHIM_WSTRING_H
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef SHIM_ESP_EVENT_H
+#define SHIM_ESP_EVENT_H
+
+#include <stdint.h>
+
+#define ESP_EVENT_ANY_ID -1
+
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id,
+                                    void* event_data);
+
+#endif // SHIM_ESP_EVENT_H
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef SHIM_FREERTOS_EVENT_GROUPS_H
+#define SHIM_FREERTOS_EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+EventGroupHandle_t xEventGroupCreate();
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticksToWait);
+void vEventGroupDelete(EventGroupHandle_t group);
+
+#endif // SHIM_FREERTOS_EVENT_GROUPS_H
\ No newline at end of file
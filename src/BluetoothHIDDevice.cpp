@@ -1,4 +1,5 @@
 #include "BluetoothHIDDevice.h"
+#include "Log.h"
 #if defined(USE_NIMBLE)
 #include <NimBLEDevice.h>
 #endif
@@ -14,6 +15,50 @@
 #define RAW_KEY_RIGHT_ALT   0x86
 #define RAW_KEY_RIGHT_GUI   0x87
 
+// Connection intervals in 1.25 ms units
+#define CONN_INTERVAL_FAST_MIN    6   // 7.5 ms while a payload runs
+#define CONN_INTERVAL_FAST_MAX    12  // 15 ms
+#define CONN_INTERVAL_IDLE_MIN    24  // 30 ms when idle
+#define CONN_INTERVAL_IDLE_MAX    40  // 50 ms
+#define CONN_SUPERVISION_TIMEOUT  400 // 4 s in 10 ms units
+#define CONGESTION_WARN_EVENTS    10  // Events a report may wait before it is logged
+
+// Notification results from the keyboard input characteristic.
+// notify() reports synchronously whether the controller accepted the
+// notification, so a failure means its buffers are full for this event.
+class NotifyStatusCallbacks : public NimBLECharacteristicCallbacks {
+public:
+    volatile int lastStatus = SUCCESS_NOTIFY;
+    
+    void onStatus(NimBLECharacteristic* pCharacteristic, Status s, int code) override {
+        lastStatus = s;
+    }
+};
+
+static NotifyStatusCallbacks notifyCallbacks;
+
+// BleKeyboard owns the server callbacks, so connection parameter updates
+// come from a GAP event listener instead. Runs on the NimBLE host task.
+static ble_gap_event_listener gapListener;
+
+static int gapEventCallback(ble_gap_event* event, void* arg) {
+    BluetoothHIDDevice* device = static_cast<BluetoothHIDDevice*>(arg);
+    uint16_t connHandle;
+    if (event->type == BLE_GAP_EVENT_CONNECT && event->connect.status == 0) {
+        connHandle = event->connect.conn_handle;
+    } else if (event->type == BLE_GAP_EVENT_CONN_UPDATE && event->conn_update.status == 0) {
+        connHandle = event->conn_update.conn_handle;
+    } else {
+        return 0;
+    }
+    
+    ble_gap_conn_desc desc;
+    if (ble_gap_conn_find(connHandle, &desc) == 0) {
+        device->handleConnectionUpdate(desc.conn_itvl);
+    }
+    return 0;
+}
+
 BluetoothHIDDevice::BluetoothHIDDevice() {
     deviceConnected = false;
     currentMode = HID_MODE_KEYBOARD;
@@ -23,6 +68,10 @@ BluetoothHIDDevice::BluetoothHIDDevice() {
     isShuttingDown = false;
     isStarted = false;
     initStartTime = 0;
+    notificationsPerEvent = 4;
+    eventSent = 0;
+    eventStart = 0;
+    intervalUs = CONN_INTERVAL_IDLE_MAX * 1250UL;
 }
 
 BluetoothHIDDevice::~BluetoothHIDDevice() {
@@ -35,21 +84,21 @@ BluetoothHIDDevice::~BluetoothHIDDevice() {
 bool BluetoothHIDDevice::begin(const String& name) {
     // Prevent re-initialization during shutdown
     if (isShuttingDown) {
-        Serial.println("BLE init blocked: shutdown in progress");
+        LOG_WARN("BLE init blocked: shutdown in progress");
         return false;
     }
     
     // Check if we can reuse the existing instance
     if (bleKeyboard != nullptr) {
         if (deviceName == name) {
-            Serial.println("BLE reusing existing instance: " + deviceName);
+            LOG_INFO("BLE reusing existing instance: %s", deviceName);
             
             // Only start if not already started
             if (!isStarted) {
                 bleKeyboard->begin();
                 isStarted = true;
             } else {
-                Serial.println("BLE already running, skipping begin()");
+                LOG_INFO("BLE already running, skipping begin()");
             }
             
             deviceConnected = bleKeyboard->isConnected();
@@ -59,7 +108,7 @@ bool BluetoothHIDDevice::begin(const String& name) {
             // This is a heavy operation, but we'll try to avoid it by just updating the existing instance if possible
             // BleKeyboard doesn't support renaming after begin(), so we have to destroy it.
             // But to prevent crashes, we'll just stick with the old name for now if it exists.
-            Serial.println("BLE name change requested but ignored to prevent instability. Using: " + deviceName);
+            LOG_WARN("BLE name change ignored to prevent instability. Using: %s", deviceName);
             
             if (!isStarted) {
                 bleKeyboard->begin();
@@ -85,12 +134,12 @@ bool BluetoothHIDDevice::begin(const String& name) {
         bleKeyboard->end();
         delete bleKeyboard;
         bleKeyboard = nullptr;
-        delay(500); // Longer delay for BLE stack cleanup
+        ::delay(500); // Longer delay for BLE stack cleanup
         isShuttingDown = false;
     }
     
     // Additional safety delay
-    delay(200);
+    ::delay(200);
     
     // Create new instance with updated name
     // Initialize with standard parameters for broader compatibility
@@ -101,7 +150,7 @@ bool BluetoothHIDDevice::begin(const String& name) {
     bleKeyboard = new BleKeyboard(finalName.c_str(), "MeowCorp", 100);
     
     // IMPORTANT: Delay to allow object creation to settle
-    delay(100);
+    ::delay(100);
 
     // Initialize with comprehensive error handling
     bool success = false;
@@ -109,7 +158,7 @@ bool BluetoothHIDDevice::begin(const String& name) {
         bleKeyboard->begin();
         
         // Wait for BLE stack to stabilize
-        delay(100);
+        ::delay(100);
         
         // STOP Advertising to apply settings safely
         NimBLEAdvertising* pAdvertising = NimBLEDevice::getAdvertising();
@@ -139,15 +188,20 @@ bool BluetoothHIDDevice::begin(const String& name) {
             pAdvertising->start();
         }
         
+        // Pacing is done by the transmit pipeline, not per-report sleeps
+        bleKeyboard->setDelay(0);
+        attachNotifyCallbacks();
+        ble_gap_event_listener_register(&gapListener, gapEventCallback, this);
+        
         success = true;
         isStarted = true;
-        Serial.println("BLE Keyboard initialized: " + deviceName);
+        LOG_INFO("BLE Keyboard initialized: %s", deviceName);
         
         // Reset connection state
         deviceConnected = false;
         
     } catch (...) {
-        Serial.println("BLE Keyboard initialization failed!");
+        LOG_ERROR("BLE Keyboard initialization failed!");
         if (bleKeyboard) {
             delete bleKeyboard;
             bleKeyboard = nullptr;
@@ -164,20 +218,20 @@ void BluetoothHIDDevice::end() {
     if (bleKeyboard) {
         // Do NOT call bleKeyboard->end() as it causes instability
         // bleKeyboard->end();
-        Serial.println("BLE Keyboard 'stopped' (stack kept active)");
+        LOG_INFO("BLE Keyboard 'stopped' (stack kept active)");
         // We don't change isStarted to false because the stack is still up
     }
 }
 
 void BluetoothHIDDevice::setMode(HIDMode mode) {
     currentMode = mode;
-    Serial.println("BLE HID mode set to: " + String(mode));
+    LOG_INFO("BLE HID mode set to: %d", mode);
 }
 
 void BluetoothHIDDevice::sendKey(uint8_t key, uint8_t modifiers) {
     // Safety checks during unstable periods
     if (isInitializing || isShuttingDown) {
-        Serial.println("HID operation blocked: unstable state");
+        LOG_WARN("HID operation blocked: unstable state");
         return;
     }
     
@@ -185,41 +239,219 @@ void BluetoothHIDDevice::sendKey(uint8_t key, uint8_t modifiers) {
     
     // Additional safety delay during first 3 seconds
     if (initStartTime > 0 && (millis() - initStartTime) < 3000) {
-        delay(50); // Extra delay during critical period
+        ::delay(50); // Extra delay during critical period
     }
     
-    try {
-        // Use atomic pressRaw method to send Modifiers + Key in a single HID report
-        // This avoids issues where modifiers are sent separately or timing issues occur
+    LOG_DEBUG("BLE sendKey key=%x mods=%x", key, modifiers);
+    
+    // Modifiers + key in a single HID report
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    report.modifiers = modifiers;
+    
+    uint8_t usage = 0;
+    if (key != 0 && HIDReportEncoder::keyToUsage(key, usage, report.modifiers)) {
+        report.keys[0] = usage;
+    }
+    HIDOutput.pushReport(this, report);
+    
+    // Hold the key for one connection event, then release everything
+    HIDOutput.pushHold(this);
+    memset(&report, 0, sizeof(report));
+    HIDOutput.pushReport(this, report);
+}
+
+void BluetoothHIDDevice::sendString(const String& text) {
+    sendText(text.c_str(), text.length());
+}
+
+void BluetoothHIDDevice::sendText(const char* text, size_t length) {
+    if (!isConnected() || !bleKeyboard) return;
+    
+    HIDKeyReport report;
+    encoder.begin(text, length);
+    while (encoder.next(report)) {
+        HIDOutput.pushReport(this, report);
+    }
+}
+
+void BluetoothHIDDevice::writeReport(const HIDKeyReport& report) {
+    uint32_t retries = 0;
+    
+    // ESC drops the report instead of waiting for a congested link
+    while (bleKeyboard && bleKeyboard->isConnected() && !HIDOutput.isCancelled()) {
+        advanceEvent();
+        if (eventSent >= notificationsPerEvent) {
+            // Budget for this connection event used, wait for the next one
+            waitNextEvent();
+            continue;
+        }
         
-        Serial.println("BLE: Atomic sendKey: " + String(key, HEX) + " Mods: " + String(modifiers, HEX));
-        bleKeyboard->pressRaw(key, modifiers);
+        KeyReport keyReport;
+        memcpy(&keyReport, &report, sizeof(keyReport));
+        notifyCallbacks.lastStatus = NimBLECharacteristicCallbacks::SUCCESS_NOTIFY;
+        bleKeyboard->sendReport(&keyReport);
         
-        // Hold for a moment - increased for reliability
-        delay(100);
+        int status = notifyCallbacks.lastStatus;
+        if (status == NimBLECharacteristicCallbacks::ERROR_GATT) {
+            // Controller buffers full, retry in the next event. The report
+            // waits as long as the link is up and the run goes on; dropping
+            // it loses a key. NimBLE reports a notification as sent once it
+            // is queued, and the controller's completed packet count only
+            // feeds the host's own flow control, so a refused notify is the
+            // only completion feedback there is.
+            if (++retries == CONGESTION_WARN_EVENTS) {
+                LOG_WARN("BLE link congested, report waiting");
+            }
+            eventSent = notificationsPerEvent;
+            continue;
+        }
         
-        // Release everything
-        bleKeyboard->releaseAll();
-        delay(100);
-    } catch (...) {
-        Serial.println("HID operation failed - connection lost");
-        deviceConnected = false;
+        eventSent++;
+        return;
     }
 }
 
-void BluetoothHIDDevice::sendString(const String& text) {
+void BluetoothHIDDevice::writeHold() {
+    waitNextEvent();
+}
+
+void BluetoothHIDDevice::advanceEvent() {
+    // A new event once the interval has passed since the current one began
+    unsigned long now = micros();
+    if (now - eventStart >= intervalUs) {
+        eventStart = now;
+        eventSent = 0;
+    }
+}
+
+void BluetoothHIDDevice::waitNextEvent() {
+    unsigned long elapsed = micros() - eventStart;
+    if (elapsed < intervalUs) {
+        ::delay((intervalUs - elapsed + 999) / 1000);
+    }
+    eventStart = micros();
+    eventSent = 0;
+}
+
+void BluetoothHIDDevice::setExecuting(bool executing) {
+    HIDOutput.pushExecuting(this, executing);
+}
+
+void BluetoothHIDDevice::writeExecuting(bool executing) {
+    if (!bleKeyboard || !bleKeyboard->isConnected()) return;
+    
+    if (executing) {
+        requestConnectionParams(CONN_INTERVAL_FAST_MIN, CONN_INTERVAL_FAST_MAX);
+    } else {
+        requestConnectionParams(CONN_INTERVAL_IDLE_MIN, CONN_INTERVAL_IDLE_MAX);
+    }
+}
+
+void BluetoothHIDDevice::requestConnectionParams(uint16_t minInterval, uint16_t maxInterval) {
+    NimBLEServer* server = NimBLEDevice::getServer();
+    if (!server) return;
+    
+    for (uint16_t connId : server->getPeerDevices()) {
+        server->updateConnParams(connId, minInterval, maxInterval, 0, CONN_SUPERVISION_TIMEOUT);
+    }
+    
+    // Keep pacing on the interval in use; the host grants the new one with
+    // a connection update event, which sets it through the GAP listener
+    updateConnectionInterval();
+}
+
+void BluetoothHIDDevice::handleConnectionUpdate(uint16_t interval) {
+    if (interval == 0) return;
+    intervalUs = interval * 1250UL;
+    LOG_DEBUG("BLE connection interval %u us", intervalUs);
+}
+
+void BluetoothHIDDevice::updateConnectionInterval() {
+    NimBLEServer* server = NimBLEDevice::getServer();
+    if (!server) return;
+    
+    std::vector<uint16_t> peers = server->getPeerDevices();
+    if (peers.empty()) return;
+    
+    handleConnectionUpdate(server->getPeerIDInfo(peers[0]).getConnInterval());
+}
+
+void BluetoothHIDDevice::attachNotifyCallbacks() {
+    NimBLEServer* server = NimBLEDevice::getServer();
+    if (!server) return;
+    
+    // HID service, first Report characteristic is the keyboard input report
+    NimBLEService* hidService = server->getServiceByUUID(NimBLEUUID((uint16_t)0x1812));
+    if (!hidService) return;
+    
+    NimBLECharacteristic* inputReport = hidService->getCharacteristic(NimBLEUUID((uint16_t)0x2A4D));
+    if (inputReport) {
+        inputReport->setCallbacks(&notifyCallbacks);
+    }
+}
+
+void BluetoothHIDDevice::sendReport(const HIDKeyReport& report) {
+    if (!isConnected() || !bleKeyboard) return;
+    HIDOutput.pushReport(this, report);
+}
+
+void BluetoothHIDDevice::sendHold() {
     if (!isConnected() || !bleKeyboard) return;
-    bleKeyboard->print(text);
-    delay(20); // Small delay after string
+    HIDOutput.pushHold(this);
 }
 
-void BluetoothHIDDevice::sendKeySequence(const String& keys) {
+void BluetoothHIDDevice::sendKeySequence(const char* keys, size_t length) {
     // Not implemented for complex sequences yet
-    Serial.println("BLE Key Sequence: " + keys);
+    LOG_DEBUG("BLE key sequence ignored (%u bytes)", length);
+}
+
+void BluetoothHIDDevice::sendMediaKey(uint8_t mediaKey) {
+    if (!isConnected() || !bleKeyboard || mediaKey >= MEDIA_KEY_COUNT) return;
+    HIDOutput.pushMediaKey(this, mediaKey);
+}
+
+void BluetoothHIDDevice::writeMediaKey(uint8_t mediaKey) {
+    if (!bleKeyboard || !bleKeyboard->isConnected()) return;
+    
+    // MediaKey is the bit index in the 16-bit media report
+    uint16_t bits = 1 << mediaKey;
+    MediaKeyReport report = { (uint8_t)(bits & 0xFF), (uint8_t)(bits >> 8) };
+    
+    // Press in this event, so the release waits for the next one even
+    // after the link has been idle
+    advanceEvent();
+    bleKeyboard->press(report);
+    waitNextEvent();
+    bleKeyboard->release(report);
+    eventSent++;
 }
 
 void BluetoothHIDDevice::delay(uint32_t ms) {
-    ::delay(ms);
+    // Delays are part of the report stream
+    HIDOutput.pushDelay(ms);
+}
+
+bool BluetoothHIDDevice::isIdle() {
+    return HIDOutput.isIdle();
+}
+
+size_t BluetoothHIDDevice::outputSpace() {
+    return HIDOutput.space();
+}
+
+uint32_t BluetoothHIDDevice::reportTimeUs() {
+    // Payloads run at the fast connection interval
+    return CONN_INTERVAL_FAST_MAX * 1250UL / notificationsPerEvent;
+}
+
+uint32_t BluetoothHIDDevice::keyTimeUs() {
+    // Key is held for one connection event before the release
+    return CONN_INTERVAL_FAST_MAX * 1250UL + reportTimeUs();
+}
+
+void BluetoothHIDDevice::cancel() {
+    HIDOutput.cancel();
 }
 
 bool BluetoothHIDDevice::isConnected() {
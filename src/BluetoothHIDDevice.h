@@ -3,10 +3,12 @@
 
 #include <Arduino.h>
 #include "DuckyScriptParser.h"
+#include "HIDReportEncoder.h"
+#include "HIDOutputTask.h"
 
 class BleKeyboard;
 
-class BluetoothHIDDevice : public HIDDevice {
+class BluetoothHIDDevice : public HIDDevice, public HIDReportSink {
 private:
     BleKeyboard* bleKeyboard;
     HIDMode currentMode;
@@ -17,6 +19,20 @@ private:
     bool isStarted;
     unsigned long initStartTime;
     
+    // Transmit pipeline: reports from the output queue are sent as a
+    // burst of notifications per connection event
+    HIDReportEncoder encoder;
+    uint8_t notificationsPerEvent;
+    uint8_t eventSent;
+    unsigned long eventStart;      // micros() at start of the current event
+    volatile uint32_t intervalUs;  // Current connection interval, set from the NimBLE task
+    
+    void advanceEvent();
+    void waitNextEvent();
+    void updateConnectionInterval();
+    void requestConnectionParams(uint16_t minInterval, uint16_t maxInterval);
+    void attachNotifyCallbacks();
+    
 public:
     BluetoothHIDDevice();
     ~BluetoothHIDDevice();
@@ -27,12 +43,31 @@ public:
     // HIDDevice interface implementation
     void sendKey(uint8_t key, uint8_t modifiers = 0) override;
     void sendString(const String& text) override;
-    void sendKeySequence(const String& keys) override;
+    void sendText(const char* text, size_t length) override;
+    void sendKeySequence(const char* keys, size_t length) override;
+    void sendMediaKey(uint8_t mediaKey) override;
+    void sendReport(const HIDKeyReport& report) override;
+    void sendHold() override;
     void delay(uint32_t ms) override;
     bool isConnected() override;
+    void setExecuting(bool executing) override;
+    bool isIdle() override;
+    size_t outputSpace() override;
+    uint32_t reportTimeUs() override;
+    uint32_t keyTimeUs() override;
+    void cancel() override;
+    
+    // HIDReportSink implementation (runs on the HID output task)
+    void writeReport(const HIDKeyReport& report) override;
+    void writeMediaKey(uint8_t mediaKey) override;
+    void writeHold() override;
+    void writeExecuting(bool executing) override;
+    
+    void setNotificationsPerEvent(uint8_t count) { notificationsPerEvent = count > 0 ? count : 1; }
     
     // Bluetooth specific
     void handleConnection();
+    void handleConnectionUpdate(uint16_t interval); // Granted interval, 1.25 ms units
     String getDeviceName() { return deviceName; }
 };
 
@@ -0,0 +1,117 @@
+#include "BootSequence.h"
+#include "Log.h"
+
+#define BOOT_STACK_SIZE  4096
+#define BOOT_PRIORITY    1   // Same as loop(), either core
+
+BootSequence::BootSequence() {
+    count = 0;
+    finished = nullptr;
+    readyUs = 0;
+}
+
+EventBits_t BootSequence::add(const char* name, BootStepFunction run, EventBits_t after, bool background) {
+    if (count >= MAX_STEPS) {
+        LOG_ERROR("Too many boot steps, dropped %s", name);
+        return 0;
+    }
+    
+    Step& step = steps[count];
+    step.name = name;
+    step.run = run;
+    step.after = after;
+    step.background = background;
+    step.ok = false;
+    step.startUs = 0;
+    step.endUs = 0;
+    step.owner = this;
+    return 1 << count++;
+}
+
+void BootSequence::taskMain(void* arg) {
+    Step* step = static_cast<Step*>(arg);
+    step->owner->runStep(*step);
+    vTaskDelete(nullptr);
+}
+
+void BootSequence::runStep(Step& step) {
+    if (step.after) xEventGroupWaitBits(finished, step.after, pdFALSE, pdTRUE, portMAX_DELAY);
+    
+    step.startUs = micros();
+    step.ok = step.run();
+    step.endUs = micros();
+    xEventGroupSetBits(finished, 1 << (&step - steps));
+}
+
+bool BootSequence::run() {
+    if (!finished) finished = xEventGroupCreate();
+    if (!finished) {
+        LOG_ERROR("Boot steps run in series");
+        for (size_t i = 0; i < count; i++) {
+            steps[i].startUs = micros();
+            steps[i].ok = steps[i].run();
+            steps[i].endUs = micros();
+        }
+    } else {
+        // Background steps start at once and wait for their own dependencies
+        for (size_t i = 0; i < count; i++) {
+            Step& step = steps[i];
+            if (step.background &&
+                xTaskCreatePinnedToCore(taskMain, step.name, BOOT_STACK_SIZE, &step, BOOT_PRIORITY, nullptr,
+                                        tskNO_AFFINITY) != pdPASS) {
+                LOG_WARN("Boot step runs inline: %s", step.name);
+                step.background = false;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (!steps[i].background) runStep(steps[i]);
+        }
+        xEventGroupWaitBits(finished, (1 << count) - 1, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        if (!steps[i].ok) {
+            LOG_ERROR("Boot step failed: %s", steps[i].name);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool BootSequence::succeeded(EventBits_t step) {
+    for (size_t i = 0; i < count; i++) {
+        if (step == (EventBits_t)(1 << i)) return steps[i].ok;
+    }
+    return false;
+}
+
+void BootSequence::finish() {
+    readyUs = micros();
+    for (size_t i = 0; i < count; i++) {
+        Step& step = steps[i];
+        LOG_INFO("Boot %u - %u ms (%u ms): %s", step.startUs / 1000, step.endUs / 1000,
+                 (step.endUs - step.startUs) / 1000, step.name);
+    }
+    LOG_INFO("Boot to menu: %u ms", readyUs / 1000);
+}
+
+bool BootSequence::write(fs::FS& fs, const char* path) {
+    fs::File file = fs.open(path, FILE_WRITE);
+    if (!file) {
+        LOG_WARN("Cannot write boot timeline: %s", path);
+        return false;
+    }
+    
+    file.printf("# start_ms end_ms duration_ms step\n");
+    for (size_t i = 0; i < count; i++) {
+        Step& step = steps[i];
+        file.printf("%u.%03u %u.%03u %u.%03u %s%s\n",
+                    step.startUs / 1000, step.startUs % 1000, step.endUs / 1000, step.endUs % 1000,
+                    (step.endUs - step.startUs) / 1000, (step.endUs - step.startUs) % 1000,
+                    step.name, step.ok ? "" : " (failed)");
+    }
+    file.printf("%u.%03u menu\n", readyUs / 1000, readyUs % 1000);
+    file.close();
+    return true;
+}
\ No newline at end of file
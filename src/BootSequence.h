@@ -0,0 +1,60 @@
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/event_groups.h>
+
+typedef bool (*BootStepFunction)();
+
+// Runs the setup() steps that do not depend on each other at the same
+// time, and records when each one started and finished. Background steps
+// get their own task; the others run on the calling task (the only one
+// allowed to draw) in the order they were added. Every step first waits
+// for the steps it comes after.
+//
+// The timeline is logged and can be written to a file, so a slow card or
+// a regression in one step shows up as one long line.
+class BootSequence {
+public:
+    static const size_t MAX_STEPS = 8;
+    
+private:
+    struct Step {
+        const char* name;
+        BootStepFunction run;
+        EventBits_t after;    // Steps that must have finished first
+        bool background;
+        bool ok;
+        uint32_t startUs;     // Since reset
+        uint32_t endUs;
+        BootSequence* owner;
+    };
+    
+    Step steps[MAX_STEPS];
+    size_t count;
+    EventGroupHandle_t finished;  // One bit per step
+    uint32_t readyUs;             // finish(): the menu is up
+    
+    static void taskMain(void* arg);
+    void runStep(Step& step);
+    
+public:
+    BootSequence();
+    
+    // Returns the bit of the step, to list in the after mask of later steps
+    EventBits_t add(const char* name, BootStepFunction run, EventBits_t after = 0, bool background = false);
+    
+    // Until every step has finished. False if one failed.
+    bool run();
+    bool succeeded(EventBits_t step);
+    
+    // The device is usable: log the timeline
+    void finish();
+    uint32_t getReadyMs() { return readyUs / 1000; }
+    
+    // Timeline as text, one line per step
+    bool write(fs::FS& fs, const char* path);
+};
+
+#endif // BOOT_SEQUENCE_H
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "CompressedFile.h"
+#include "Log.h"
+#include <FSImpl.h>
+#include <new>
+
+#define WINDOW_MASK  (CompressedFile::WINDOW_SIZE - 1)
+#define LENGTH_MASK  ((1 << LZ_LENGTH_BITS) - 1)
+
+// Decoder state of one open payload. A match interrupted by the end of a
+// read() is finished by the next one, so any read size works.
+class CompressedFileImpl : public fs::FileImpl {
+private:
+    fs::File source;
+    uint32_t length;        // Decompressed size
+    uint32_t pos;           // Bytes decoded so far
+    uint8_t window[CompressedFile::WINDOW_SIZE];
+    size_t windowPos;
+    uint8_t input[CompressedFile::INPUT_SIZE];
+    size_t inputHead;
+    size_t inputCount;
+    uint8_t flags;
+    uint8_t flagBits;       // Items left in the current group
+    size_t matchDistance;
+    size_t matchRemaining;
+    bool truncated;
+    unsigned long decodeUs; // Time spent decoding, logged on close
+    
+    int nextByte() {
+        if (inputHead == inputCount) {
+            inputHead = 0;
+            inputCount = source.read(input, sizeof(input));
+            if (inputCount == 0) return -1;
+        }
+        return input[inputHead++];
+    }
+    
+    size_t decode(uint8_t* buf, size_t size) {
+        size_t done = 0;
+        if (size > length - pos) size = length - pos;
+    
+        while (done < size) {
+            if (matchRemaining > 0) {
+                size_t copy = std::min(matchRemaining, size - done);
+                matchRemaining -= copy;
+                while (copy-- > 0) {
+                    uint8_t c = window[(windowPos - matchDistance) & WINDOW_MASK];
+                    window[windowPos] = c;
+                    windowPos = (windowPos + 1) & WINDOW_MASK;
+                    buf[done++] = c;
+                }
+                continue;
+            }
+    
+            if (flagBits == 0) {
+                int next = nextByte();
+                if (next < 0) break;
+                flags = next;
+                flagBits = 8;
+            }
+            bool literal = flags & 1;
+            flags >>= 1;
+            flagBits--;
+    
+            if (literal) {
+                int c = nextByte();
+                if (c < 0) break;
+                window[windowPos] = c;
+                windowPos = (windowPos + 1) & WINDOW_MASK;
+                buf[done++] = c;
+            } else {
+                int low = nextByte();
+                int high = nextByte();
+                if (high < 0) break;
+                uint16_t value = low | (high << 8);
+                matchDistance = (value >> LZ_LENGTH_BITS) + 1;
+                matchRemaining = (value & LENGTH_MASK) + LZ_MIN_MATCH;
+            }
+        }
+    
+        if (done < size && !truncated) {
+            LOG_WARN("Compressed payload truncated at %u of %u bytes", pos + done, length);
+            truncated = true;
+        }
+        pos += done;
+        return done;
+    }
+    
+    void rewind() {
+        source.seek(sizeof(LZHeader));
+        pos = 0;
+        windowPos = 0;
+        inputHead = 0;
+        inputCount = 0;
+        flagBits = 0;
+        matchRemaining = 0;
+        truncated = false;
+        memset(window, 0, sizeof(window));
+    }
+    
+public:
+    CompressedFileImpl(fs::File& file, uint32_t size) : source(file), length(size), decodeUs(0) {
+        rewind();
+    }
+    
+    size_t write(const uint8_t* buf, size_t size) { return 0; }
+    
+    size_t read(uint8_t* buf, size_t size) {
+        unsigned long start = micros();
+        size_t bytes = decode(buf, size);
+        decodeUs += micros() - start;
+        return bytes;
+    }
+    
+    void flush() {}
+    
+    // Backwards seeks decode again from the start
+    bool seek(uint32_t position, fs::SeekMode mode) {
+        int64_t target = position;
+        if (mode == fs::SeekCur) target += pos;
+        if (mode == fs::SeekEnd) target += length;
+        if (target < 0 || target > length) return false;
+        if (target < pos) rewind();
+    
+        uint8_t skip[64];
+        while (pos < target) {
+            if (decode(skip, std::min((size_t)(target - pos), sizeof(skip))) == 0) return false;
+        }
+        return true;
+    }
+    
+    size_t position() const { return pos; }
+    size_t size() const { return length; }
+    bool setBufferSize(size_t size) { return false; }
+    
+    void close() {
+        if (!source) return;
+        LOG_DEBUG("Decoded %u bytes in %u us", pos, decodeUs);
+        source.close();
+    }
+    
+    time_t getLastWrite() { return source.getLastWrite(); }
+    const char* path() const { return source.path(); }
+    const char* name() const { return source.name(); }
+    bool isDirectory(void) { return false; }
+    fs::FileImplPtr openNextFile(const char* mode) { return fs::FileImplPtr(); }
+    bool seekDir(long position) { return false; }
+    String getNextFileName(void) { return String(); }
+    String getNextFileName(bool* isDir) { return String(); }
+    void rewindDirectory(void) {}
+    operator bool() { return source; }
+};
+
+fs::File CompressedFile::open(fs::File source) {
+    LZHeader header;
+    if (!source || source.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, LZ_MAGIC, sizeof(header.magic)) != 0 || header.version != LZ_VERSION ||
+        header.windowBits != LZ_WINDOW_BITS || header.lengthBits != LZ_LENGTH_BITS) {
+        LOG_WARN("Not a compressed payload: %s", source.name());
+        if (source) source.close();
+        return fs::File();
+    }
+    
+    CompressedFileImpl* impl = new (std::nothrow) CompressedFileImpl(source, header.size);
+    if (!impl) {
+        LOG_ERROR("Out of memory for compressed payload: %s", source.name());
+        source.close();
+        return fs::File();
+    }
+    return fs::File(fs::FileImplPtr(impl));
+}
+
+bool CompressedFile::isCompressed(const char* name) {
+    size_t length = strlen(name);
+    size_t extension = strlen(LZ_EXTENSION);
+    return length > extension && strcasecmp(name + length - extension, LZ_EXTENSION) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef COMPRESSED_FILE_H
+#define COMPRESSED_FILE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Compressed payload (.dsz), written by tools/compress_payload.py. LZSS
+// with a 2 KB window: after the header, each flag byte describes the next
+// eight items, low bit first. A set bit is one literal byte, a clear bit a
+// two byte match whose low LZ_LENGTH_BITS are the length - LZ_MIN_MATCH
+// and whose high bits are the distance - 1.
+#define LZ_MAGIC        "DSLZ"
+#define LZ_VERSION      1
+#define LZ_EXTENSION    ".dsz"
+#define LZ_WINDOW_BITS  11
+#define LZ_LENGTH_BITS  5
+#define LZ_MIN_MATCH    3
+
+struct LZHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t windowBits;
+    uint8_t lengthBits;
+    uint8_t reserved;
+    uint32_t size;  // Decompressed
+    uint32_t reserved2;
+};
+
+// Opens a .dsz payload as a File that decompresses while it is read, so
+// the parser streams it line by line like any other file. Decoding uses a
+// fixed window and input block (about 2.5 KB) whatever the payload size;
+// the payload is never inflated in RAM. size() is the decompressed size.
+class CompressedFile {
+public:
+    static const size_t WINDOW_SIZE = 1 << LZ_WINDOW_BITS;
+    static const size_t INPUT_SIZE = 512;
+    
+    // Takes over source. Invalid if it is not a compressed payload.
+    static fs::File open(fs::File source);
+    
+    static bool isCompressed(const char* name);
+};
+
+#endif // COMPRESSED_FILE_H
\ No newline at end of file
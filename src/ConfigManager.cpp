@@ -5,6 +5,9 @@
 ConfigManager::ConfigManager() {
     configFilePath = "/config.json";
     bluetoothName = getDefaultBluetoothName(); // Default name
+    usbReportGap = getDefaultUsbReportGap();
+    keyboardLayout = getDefaultKeyboardLayout();
+    autorunPayload = "";
 }
 
 bool ConfigManager::loadConfig() {
@@ -30,7 +33,7 @@ bool ConfigManager::loadConfig() {
     configFile.close();
     
     // Parse JSON
-    StaticJsonDocument<256> doc;
+    StaticJsonDocument<384> doc;
     DeserializationError error = deserializeJson(doc, configContent);
     
     if (error) {
@@ -40,14 +43,20 @@ bool ConfigManager::loadConfig() {
     
     // Load settings
     bluetoothName = doc["bluetooth_name"] | getDefaultBluetoothName();
+    usbReportGap = doc["usb_report_gap_us"] | getDefaultUsbReportGap();
+    keyboardLayout = doc["keyboard_layout"] | getDefaultKeyboardLayout();
+    autorunPayload = doc["autorun"] | "";
     
     return true;
 }
 
 bool ConfigManager::saveConfig() {
     // Create JSON
-    StaticJsonDocument<256> doc;
+    StaticJsonDocument<384> doc;
     doc["bluetooth_name"] = bluetoothName;
+    doc["usb_report_gap_us"] = usbReportGap;
+    doc["keyboard_layout"] = keyboardLayout;
+    if (autorunPayload.length() > 0) doc["autorun"] = autorunPayload;
     
     // Try to save to SD card first
     if (SD.exists("/")) {
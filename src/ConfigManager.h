@@ -8,6 +8,9 @@ class ConfigManager {
 private:
     String bluetoothName;
     String configFilePath;
+    uint32_t usbReportGap;
+    String keyboardLayout;
+    String autorunPayload;
     
 public:
     ConfigManager();
@@ -15,10 +18,27 @@ public:
     bool loadConfig();
     bool saveConfig();
     
-    String getBluetoothName() { return bluetoothName; }
+    const String& getBluetoothName() { return bluetoothName; }
     void setBluetoothName(const String& name) { bluetoothName = name; }
     
     String getDefaultBluetoothName() { return "M5-Ducky"; }
+    
+    // Minimum gap between USB HID reports in microseconds
+    uint32_t getUsbReportGap() { return usbReportGap; }
+    void setUsbReportGap(uint32_t us) { usbReportGap = us; }
+    
+    uint32_t getDefaultUsbReportGap() { return 1000; }
+    
+    // Host keyboard layout name (US, UK, DE, FR, ES, IT, SE)
+    String getKeyboardLayout() { return keyboardLayout; }
+    void setKeyboardLayout(const String& name) { keyboardLayout = name; }
+    
+    String getDefaultKeyboardLayout() { return "US"; }
+    
+    // Payload run over USB as soon as the host mounts the device, without
+    // the menu. Path on the SD card, or on internal storage; empty for none.
+    const String& getAutorunPayload() { return autorunPayload; }
+    void setAutorunPayload(const String& path) { autorunPayload = path; }
 };
 
 #endif // CONFIG_MANAGER_H
\ No newline at end of file
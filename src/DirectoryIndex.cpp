@@ -0,0 +1,255 @@
+#include "DirectoryIndex.h"
+#include "Hash.h"
+#include "Log.h"
+#include "ExternalSort.h"
+
+static bool recordLess(const DirectoryRecord& a, const DirectoryRecord& b) {
+    return DirectoryIndex::compare(a, b) < 0;
+}
+
+static String baseName(const String& path) {
+    int lastSlash = path.lastIndexOf('/');
+    return lastSlash >= 0 ? path.substring(lastSlash + 1) : path;
+}
+
+DirectoryIndex::DirectoryIndex() {
+    fs = nullptr;
+    count = 0;
+    signature = 0;
+    observer = nullptr;
+}
+
+int DirectoryIndex::compare(const DirectoryRecord& a, const DirectoryRecord& b) {
+    // Directories first, then case-insensitive by name
+    if ((a.flags ^ b.flags) & DIR_ENTRY_DIRECTORY) {
+        return (a.flags & DIR_ENTRY_DIRECTORY) ? -1 : 1;
+    }
+    int result = strcasecmp(a.name, b.name);
+    return result != 0 ? result : strcmp(a.name, b.name);
+}
+
+String DirectoryIndex::cachePath(const char* cacheDir, const String& dirPath) {
+    char name[20];
+    snprintf(name, sizeof(name), "/%08x.idx", (unsigned)fnv1a(FNV_OFFSET, dirPath));
+    return String(cacheDir) + name;
+}
+
+bool DirectoryIndex::open(fs::FS& fs, const String& path, const String& cachePath) {
+    DirectoryScanResult result = scan(fs, path, cachePath, nullptr);
+    if (result == SCAN_CURRENT) return true;
+    
+    return result == SCAN_REBUILT && replace(fs, cachePath) && openCached(fs, path, cachePath);
+}
+
+DirectoryScanResult DirectoryIndex::scan(fs::FS& fs, const String& path, const String& cachePath,
+                                         DirectoryScanObserver* observer) {
+    close();
+    this->fs = &fs;
+    this->observer = observer;
+    dirPath = path;
+    indexPath = cachePath;
+    
+    fs::File dir = fs.open(path);
+    if (!dir || !dir.isDirectory()) {
+        LOG_ERROR("Failed to open directory: %s", path);
+        if (dir) dir.close();
+        return SCAN_FAILED;
+    }
+    uint32_t listing = scanSignature(dir);
+    dir.close();
+    if (cancelled()) return SCAN_CANCELLED;
+    
+    if (openIndex(true, listing)) return SCAN_CURRENT;
+    
+    unsigned long start = millis();
+    if (!rebuild(listing)) {
+        if (cancelled()) return SCAN_CANCELLED;
+        LOG_ERROR("Failed to index directory: %s", path);
+        return SCAN_FAILED;
+    }
+    LOG_INFO("Indexed in %u ms: %s", millis() - start, path);
+    return SCAN_REBUILT;
+}
+
+bool DirectoryIndex::replace(fs::FS& fs, const String& cachePath) {
+    fs.remove(cachePath);
+    return fs.rename(cachePath + ".new", cachePath);
+}
+
+bool DirectoryIndex::openCached(fs::FS& fs, const String& path, const String& cachePath) {
+    close();
+    this->fs = &fs;
+    observer = nullptr;
+    dirPath = path;
+    indexPath = cachePath;
+    return openIndex(false, 0);
+}
+
+void DirectoryIndex::close() {
+    if (file) file.close();
+    count = 0;
+    signature = 0;
+}
+
+bool DirectoryIndex::cancelled() {
+    return observer && observer->isCancelled();
+}
+
+bool DirectoryIndex::openIndex(bool checkSignature, uint32_t listing) {
+    if (file) file.close();
+    if (!fs->exists(indexPath)) return false;
+    
+    file = fs->open(indexPath, FILE_READ);
+    if (!file) return false;
+    
+    DirectoryIndexHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, DIR_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DIR_INDEX_VERSION || (checkSignature && header.signature != listing) ||
+        file.size() != sizeof(header) + header.count * sizeof(DirectoryRecord)) {
+        file.close();
+        return false;
+    }
+    
+    count = header.count;
+    signature = header.signature;
+    return true;
+}
+
+uint32_t DirectoryIndex::scanSignature(fs::File& dir) {
+    // Names only: listing a directory does not open the files in it
+    uint32_t hash = FNV_OFFSET;
+    bool isDir = false;
+    String name = dir.getNextFileName(&isDir);
+    while (name.length() > 0) {
+        uint8_t flag = isDir ? DIR_ENTRY_DIRECTORY : 0;
+        hash = fnv1a(hash, name);
+        hash = fnv1a(hash, &flag, 1);
+        if (observer) {
+            if (observer->isCancelled()) break;
+            observer->onEntry(baseName(name), isDir);
+        }
+        name = dir.getNextFileName(&isDir);
+    }
+    return hash;
+}
+
+bool DirectoryIndex::rebuild(uint32_t signature) {
+    String runPath = indexPath + ".run";
+    String newPath = indexPath + ".new";
+    
+    // Sorted runs of RUN_RECORDS entries
+    fs::File dir = fs->open(dirPath);
+    fs::File runs = fs->open(runPath, FILE_WRITE);
+    if (!dir || !runs) {
+        if (dir) dir.close();
+        if (runs) runs.close();
+        return false;
+    }
+    size_t total = writeRuns(dir, runs);
+    dir.close();
+    runs.close();
+    if (cancelled()) {
+        fs->remove(runPath);
+        return false;
+    }
+    
+    // Merged into the new index
+    runs = fs->open(runPath, FILE_READ);
+    fs::File output = fs->open(newPath, FILE_WRITE);
+    bool success = runs && output;
+    if (success) {
+        DirectoryIndexHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, DIR_INDEX_MAGIC, sizeof(header.magic));
+        header.version = DIR_INDEX_VERSION;
+        header.count = total;
+        header.signature = signature;
+        success = output.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                  mergeRuns(runs, total, output);
+    }
+    if (runs) runs.close();
+    if (output) output.close();
+    fs->remove(runPath);
+    
+    if (!success) fs->remove(newPath);
+    return success;
+}
+
+size_t DirectoryIndex::writeRuns(fs::File& dir, fs::File& runs) {
+    RunWriter<DirectoryRecord, RUN_RECORDS> writer;
+    if (!writer.begin(runs, recordLess)) return 0;
+    
+    DirectoryRecord record;
+    bool isDir = false;
+    String name = dir.getNextFileName(&isDir);
+    while (name.length() > 0 && !cancelled()) {
+        name = baseName(name);
+    
+        if (name.length() >= DIR_NAME_SIZE) {
+            LOG_WARN("Name too long to index: %s", name);
+        } else if (name[0] != '.') {
+            if (writer.getTotal() == RUN_RECORDS * MAX_RUNS) {
+                LOG_WARN("Directory index limited to %u entries", writer.getTotal());
+                break;
+            }
+    
+            memset(&record, 0, sizeof(record));
+            record.flags = isDir ? DIR_ENTRY_DIRECTORY : 0;
+            record.nameLength = name.length();
+            memcpy(record.name, name.c_str(), name.length());
+            writer.add(record);
+        }
+        name = dir.getNextFileName(&isDir);
+    }
+    
+    bool written = writer.end();
+    return written && !cancelled() ? writer.getTotal() : 0;
+}
+
+bool DirectoryIndex::mergeRuns(fs::File& runs, size_t total, fs::File& output) {
+    RunMerger<DirectoryRecord, RUN_RECORDS, RUN_BUFFER> merger;
+    if (!merger.begin(runs, total, compare)) return false;
+    
+    DirectoryRecord record;
+    for (size_t written = 0; written < total; written++) {
+        if (!merger.next(record) || cancelled()) return false;
+        if (output.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) return false;
+    }
+    return true;
+}
+
+size_t DirectoryIndex::read(size_t first, DirectoryRecord* records, size_t max) {
+    if (first >= count || !file) return 0;
+    
+    size_t wanted = std::min(max, (size_t)count - first);
+    file.seek(sizeof(DirectoryIndexHeader) + first * sizeof(DirectoryRecord));
+    return file.read((uint8_t*)records, wanted * sizeof(DirectoryRecord)) / sizeof(DirectoryRecord);
+}
+
+bool DirectoryIndex::find(const char* name, bool isDir, size_t& position) {
+    DirectoryRecord key;
+    memset(&key, 0, sizeof(key));
+    key.flags = isDir ? DIR_ENTRY_DIRECTORY : 0;
+    strncpy(key.name, name, DIR_NAME_SIZE - 1);
+    
+    size_t low = 0;
+    size_t high = count;
+    DirectoryRecord record;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (read(middle, &record, 1) != 1) return false;
+    
+        int result = compare(record, key);
+        if (result == 0) {
+            position = middle;
+            return true;
+        }
+        if (result < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef DIRECTORY_INDEX_H
+#define DIRECTORY_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define DIR_INDEX_MAGIC     "DIDX"
+#define DIR_INDEX_VERSION   2
+#define DIR_NAME_SIZE       56   // Including the terminator
+
+#define DIR_ENTRY_DIRECTORY 0x01
+
+struct DirectoryIndexHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t count;
+    uint32_t signature;  // Hash of the directory listing the index was built from
+    uint32_t reserved2[4];
+};
+
+struct DirectoryRecord {
+    uint8_t flags;
+    uint8_t nameLength;
+    uint8_t reserved[6];
+    char name[DIR_NAME_SIZE];
+};
+
+enum DirectoryScanResult {
+    SCAN_CURRENT,    // The index matches the directory
+    SCAN_REBUILT,    // A new index was written next to the old one, see replace()
+    SCAN_FAILED,
+    SCAN_CANCELLED
+};
+
+// Progress of a scan, called on the task running it
+class DirectoryScanObserver {
+public:
+    virtual void onEntry(const String& name, bool isDir) = 0;  // Listing order, before sorting
+    virtual bool isCancelled() = 0;
+};
+
+// Sorted on-card index of one directory: directories first, then names
+// in case-insensitive order, as fixed 64 byte records. The UI reads it a
+// window at a time (FileList), so the size of a directory does not matter
+// for RAM.
+//
+// Opening a directory only lists its names (no file is opened) to check
+// the index signature. When the listing changed, the index is rebuilt
+// from the listing alone with an external merge sort in bounded memory.
+// Names starting with '.' are not indexed.
+class DirectoryIndex {
+public:
+    static const size_t RUN_RECORDS = 256;   // Records sorted in RAM per run
+    static const size_t RUN_BUFFER = 4;      // Records buffered per run while merging
+    static const size_t MAX_RUNS = 64;       // Limits a directory to 16384 entries
+    
+private:
+    fs::FS* fs;
+    fs::File file;
+    String dirPath;
+    String indexPath;
+    uint32_t count;
+    uint32_t signature;
+    DirectoryScanObserver* observer;
+    
+    bool openIndex(bool checkSignature, uint32_t listing);
+    bool cancelled();
+    uint32_t scanSignature(fs::File& dir);
+    bool rebuild(uint32_t signature);
+    size_t writeRuns(fs::File& dir, fs::File& runs);
+    bool mergeRuns(fs::File& runs, size_t total, fs::File& output);
+    
+public:
+    DirectoryIndex();
+    
+    // Open the index for a directory, rebuilding it if the directory changed
+    bool open(fs::FS& fs, const String& path, const String& cachePath);
+    void close();
+    
+    // The steps of open() for a background task: scan() checks the listing
+    // (leaving the index open if it matches) and otherwise writes a new
+    // index without touching the current one, replace() swaps it in, and
+    // openCached() opens whatever index is there without listing the
+    // directory.
+    DirectoryScanResult scan(fs::FS& fs, const String& path, const String& cachePath,
+                             DirectoryScanObserver* observer);
+    static bool replace(fs::FS& fs, const String& cachePath);
+    bool openCached(fs::FS& fs, const String& path, const String& cachePath);
+    
+    size_t getCount() { return count; }
+    uint32_t getSignature() { return signature; }
+    size_t read(size_t first, DirectoryRecord* records, size_t max); // Returns records read
+    bool find(const char* name, bool isDir, size_t& position);       // Binary search on the card
+    
+    static int compare(const DirectoryRecord& a, const DirectoryRecord& b);
+    static String cachePath(const char* cacheDir, const String& dirPath);
+};
+
+#endif // DIRECTORY_INDEX_H
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "DirectoryScanner.h"
+#include "Log.h"
+
+#define SCANNER_CORE        0   // loop() runs on core 1
+#define SCANNER_PRIORITY    1   // Below HID output
+#define SCANNER_STACK_SIZE  6144
+
+DirectoryScanner::DirectoryScanner() : generation(0), listed(0), scanning(false) {
+    task = nullptr;
+    lock = nullptr;
+    requestFS = nullptr;
+    requestGeneration = 0;
+    pending = false;
+    finished = false;
+    result = SCAN_FAILED;
+    scanGeneration = 0;
+    previewCount = 0;
+}
+
+bool DirectoryScanner::begin() {
+    if (task) return true;
+    
+    lock = xSemaphoreCreateMutex();
+    BaseType_t created = lock ? xTaskCreatePinnedToCore(taskMain, "dir_scan", SCANNER_STACK_SIZE, this,
+                                                        SCANNER_PRIORITY, &task, SCANNER_CORE) : pdFAIL;
+    if (created != pdPASS) {
+        LOG_ERROR("Directory scan task failed to start, scanning inline");
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void DirectoryScanner::taskMain(void* arg) {
+    static_cast<DirectoryScanner*>(arg)->run();
+}
+
+void DirectoryScanner::run() {
+    while (true) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        bool haveRequest = pending;
+        fs::FS* fs = requestFS;
+        String path = requestPath;
+        String cachePath = requestCache;
+        uint32_t scanId = requestGeneration;
+        pending = false;
+        if (haveRequest) scanning = true;
+        xSemaphoreGive(lock);
+    
+        if (!haveRequest) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        runScan(*fs, path, cachePath, scanId);
+    }
+}
+
+void DirectoryScanner::runScan(fs::FS& fs, const String& path, const String& cachePath, uint32_t scanId) {
+    scanGeneration = scanId;
+    unsigned long start = millis();
+    DirectoryScanResult scanResult = index.scan(fs, path, cachePath, this);
+    index.close();
+    
+    if (lock) xSemaphoreTake(lock, portMAX_DELAY);
+    if (scanId == generation && scanResult != SCAN_CANCELLED) {
+        result = scanResult;
+        finished = true;
+        LOG_DEBUG("Scanned %u entries in %u ms", (uint32_t)listed, millis() - start);
+    }
+    scanning = false;
+    if (lock) xSemaphoreGive(lock);
+}
+
+void DirectoryScanner::start(fs::FS& fs, const String& path, const String& cachePath) {
+    if (lock) xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t scanId = ++generation;
+    requestFS = &fs;
+    requestPath = path;
+    requestCache = cachePath;
+    requestGeneration = scanId;
+    pending = task != nullptr;
+    finished = false;
+    previewCount = 0;
+    listed = 0;
+    if (lock) xSemaphoreGive(lock);
+    
+    if (task) {
+        xTaskNotifyGive(task);
+    } else {
+        scanning = true;
+        runScan(fs, path, cachePath, scanId);
+    }
+}
+
+void DirectoryScanner::cancel() {
+    if (lock) xSemaphoreTake(lock, portMAX_DELAY);
+    generation++;
+    pending = false;
+    finished = false;
+    if (lock) xSemaphoreGive(lock);
+}
+
+void DirectoryScanner::waitIdle() {
+    while (scanning) {
+        delay(1);
+    }
+}
+
+bool DirectoryScanner::poll(DirectoryScanResult& scanResult) {
+    if (lock) xSemaphoreTake(lock, portMAX_DELAY);
+    bool done = finished;
+    if (done) scanResult = result;
+    finished = false;
+    if (lock) xSemaphoreGive(lock);
+    return done;
+}
+
+size_t DirectoryScanner::getPreviewCount() {
+    if (lock) xSemaphoreTake(lock, portMAX_DELAY);
+    size_t count = previewCount;
+    if (lock) xSemaphoreGive(lock);
+    return count;
+}
+
+bool DirectoryScanner::getPreview(size_t position, FileView& view) {
+    if (position >= getPreviewCount()) return false;
+    
+    // Filled slots are not written again before the next start()
+    view.name = previewNames[position];
+    view.isDir = previewDirs[position];
+    return true;
+}
+
+void DirectoryScanner::onEntry(const String& name, bool isDir) {
+    if (isCancelled()) return;
+    listed++;
+    
+    // Same entries as the index shows
+    if (name.length() == 0 || name.length() >= DIR_NAME_SIZE || name[0] == '.') return;
+    
+    if (lock) xSemaphoreTake(lock, portMAX_DELAY);
+    if (scanGeneration == generation && previewCount < PREVIEW_SIZE) {
+        memcpy(previewNames[previewCount], name.c_str(), name.length() + 1);
+        previewDirs[previewCount] = isDir;
+        previewCount++;
+    }
+    if (lock) xSemaphoreGive(lock);
+}
+
+bool DirectoryScanner::isCancelled() {
+    return scanGeneration != generation;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef DIRECTORY_SCANNER_H
+#define DIRECTORY_SCANNER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include <freertos/semphr.h>
+#include "DirectoryIndex.h"
+#include "FileList.h"
+
+// Checks and rebuilds directory indexes on a low priority task on the core
+// that does not run loop(), so listing a large folder does not freeze the
+// menu. The first entries of the listing are kept as a preview for a
+// folder that has no index yet. Starting a new scan cancels the running
+// one; its result is never reported.
+class DirectoryScanner : public DirectoryScanObserver {
+public:
+    static const size_t PREVIEW_SIZE = FileList::WINDOW_SIZE;
+    
+private:
+    TaskHandle_t task;
+    SemaphoreHandle_t lock;           // Request, result and preview
+    std::atomic<uint32_t> generation; // Bumped by start() and cancel()
+    std::atomic<uint32_t> listed;     // Names listed by the current scan
+    std::atomic<bool> scanning;
+    DirectoryIndex index;
+    
+    fs::FS* requestFS;
+    String requestPath;
+    String requestCache;
+    uint32_t requestGeneration;
+    bool pending;
+    bool finished;
+    DirectoryScanResult result;
+    uint32_t scanGeneration;
+    
+    char previewNames[PREVIEW_SIZE][DIR_NAME_SIZE];
+    bool previewDirs[PREVIEW_SIZE];
+    size_t previewCount;
+    
+    static void taskMain(void* arg);
+    void run();
+    void runScan(fs::FS& fs, const String& path, const String& cachePath, uint32_t scanId);
+    
+public:
+    DirectoryScanner();
+    bool begin();
+    
+    // Scan a directory in the background, cancelling the current scan
+    void start(fs::FS& fs, const String& path, const String& cachePath);
+    void cancel();
+    void waitIdle();  // Until a cancelled scan has let go of the card
+    
+    // True once when the last started scan has finished
+    bool poll(DirectoryScanResult& scanResult);
+    bool isScanning() { return scanning; }
+    size_t getListed() { return listed; }
+    
+    // Entries listed so far (up to PREVIEW_SIZE), in listing order. Names
+    // stay valid until the next start().
+    size_t getPreviewCount();
+    bool getPreview(size_t position, FileView& view);
+    
+    // DirectoryScanObserver, called on the scan task
+    void onEntry(const String& name, bool isDir) override;
+    bool isCancelled() override;
+};
+
+#endif // DIRECTORY_SCANNER_H
\ No newline at end of file
@@ -1,51 +1,182 @@
 #include "DuckyScriptParser.h"
+#include "HIDReportEncoder.h"
+#include "Log.h"
 
-DuckyScriptParser::DuckyScriptParser() {
+// STRING text is handed to the HID backend in slices of this many bytes.
+// A byte encodes to at most four reports (release, dead key, release, key),
+// so the parser only emits when the output queue has room for a whole
+// slice and the op that follows it and never blocks on a full queue.
+#define STRING_SLICE       24
+#define MIN_OUTPUT_SPACE   (4 * STRING_SLICE + 8)
+
+// Key name tables, sorted by name (strcmp order) for binary search.
+// Lookups compare against the script buffer in place and never allocate.
+struct KeyName {
+    const char* name;
+    uint8_t value;
+};
+
+static const KeyName SPECIAL_KEYS[] = {
+    { "APP", DuckyScriptParser::DUCKY_MENU },
+    { "BACKSPACE", DuckyScriptParser::DUCKY_BACKSPACE },
+    { "BREAK", DuckyScriptParser::DUCKY_PAUSE },
+    { "CAPSLOCK", DuckyScriptParser::DUCKY_CAPS_LOCK },
+    { "DEL", DuckyScriptParser::DUCKY_DELETE },
+    { "DELETE", DuckyScriptParser::DUCKY_DELETE },
+    { "DOWN", DuckyScriptParser::DUCKY_DOWN },
+    { "DOWNARROW", DuckyScriptParser::DUCKY_DOWN },
+    { "END", DuckyScriptParser::DUCKY_END },
+    { "ENTER", DuckyScriptParser::DUCKY_ENTER },
+    { "ESC", DuckyScriptParser::DUCKY_ESC },
+    { "ESCAPE", DuckyScriptParser::DUCKY_ESC },
+    { "F1", DuckyScriptParser::DUCKY_F1 },
+    { "F10", DuckyScriptParser::DUCKY_F1 + 9 },
+    { "F11", DuckyScriptParser::DUCKY_F1 + 10 },
+    { "F12", DuckyScriptParser::DUCKY_F1 + 11 },
+    { "F13", DuckyScriptParser::DUCKY_F13 },
+    { "F14", DuckyScriptParser::DUCKY_F13 + 1 },
+    { "F15", DuckyScriptParser::DUCKY_F13 + 2 },
+    { "F16", DuckyScriptParser::DUCKY_F13 + 3 },
+    { "F17", DuckyScriptParser::DUCKY_F13 + 4 },
+    { "F18", DuckyScriptParser::DUCKY_F13 + 5 },
+    { "F19", DuckyScriptParser::DUCKY_F13 + 6 },
+    { "F2", DuckyScriptParser::DUCKY_F1 + 1 },
+    { "F20", DuckyScriptParser::DUCKY_F13 + 7 },
+    { "F21", DuckyScriptParser::DUCKY_F13 + 8 },
+    { "F22", DuckyScriptParser::DUCKY_F13 + 9 },
+    { "F23", DuckyScriptParser::DUCKY_F13 + 10 },
+    { "F24", DuckyScriptParser::DUCKY_F13 + 11 },
+    { "F3", DuckyScriptParser::DUCKY_F1 + 2 },
+    { "F4", DuckyScriptParser::DUCKY_F1 + 3 },
+    { "F5", DuckyScriptParser::DUCKY_F1 + 4 },
+    { "F6", DuckyScriptParser::DUCKY_F1 + 5 },
+    { "F7", DuckyScriptParser::DUCKY_F1 + 6 },
+    { "F8", DuckyScriptParser::DUCKY_F1 + 7 },
+    { "F9", DuckyScriptParser::DUCKY_F1 + 8 },
+    { "HOME", DuckyScriptParser::DUCKY_HOME },
+    { "INSERT", DuckyScriptParser::DUCKY_INSERT },
+    { "LEFT", DuckyScriptParser::DUCKY_LEFT },
+    { "LEFTARROW", DuckyScriptParser::DUCKY_LEFT },
+    { "MENU", DuckyScriptParser::DUCKY_MENU },
+    { "NUMLOCK", DuckyScriptParser::DUCKY_NUM_LOCK },
+    { "PAGEDOWN", DuckyScriptParser::DUCKY_PAGE_DOWN },
+    { "PAGEUP", DuckyScriptParser::DUCKY_PAGE_UP },
+    { "PAUSE", DuckyScriptParser::DUCKY_PAUSE },
+    { "PRINTSCREEN", DuckyScriptParser::DUCKY_PRINT_SCREEN },
+    { "RIGHT", DuckyScriptParser::DUCKY_RIGHT },
+    { "RIGHTARROW", DuckyScriptParser::DUCKY_RIGHT },
+    { "SCROLLLOCK", DuckyScriptParser::DUCKY_SCROLL_LOCK },
+    { "SPACE", DuckyScriptParser::DUCKY_SPACE },
+    { "TAB", DuckyScriptParser::DUCKY_TAB },
+    { "UP", DuckyScriptParser::DUCKY_UP },
+    { "UPARROW", DuckyScriptParser::DUCKY_UP },
+};
+
+static const KeyName MODIFIERS[] = {
+    { "ALT", DuckyScriptParser::MOD_ALT_LEFT },
+    { "ALT-LEFT", DuckyScriptParser::MOD_ALT_LEFT },
+    { "ALT-RIGHT", DuckyScriptParser::MOD_ALT_RIGHT },
+    { "ALT-SHIFT", DuckyScriptParser::MOD_ALT_LEFT | DuckyScriptParser::MOD_SHIFT_LEFT },
+    { "COMMAND", DuckyScriptParser::MOD_GUI_LEFT },
+    { "COMMAND-OPTION", DuckyScriptParser::MOD_GUI_LEFT | DuckyScriptParser::MOD_ALT_LEFT },
+    { "CONTROL", DuckyScriptParser::MOD_CTRL_LEFT },
+    { "CTRL", DuckyScriptParser::MOD_CTRL_LEFT },
+    { "CTRL-ALT", DuckyScriptParser::MOD_CTRL_LEFT | DuckyScriptParser::MOD_ALT_LEFT },
+    { "CTRL-LEFT", DuckyScriptParser::MOD_CTRL_LEFT },
+    { "CTRL-RIGHT", DuckyScriptParser::MOD_CTRL_RIGHT },
+    { "CTRL-SHIFT", DuckyScriptParser::MOD_CTRL_LEFT | DuckyScriptParser::MOD_SHIFT_LEFT },
+    { "GUI", DuckyScriptParser::MOD_GUI_LEFT },
+    { "GUI-LEFT", DuckyScriptParser::MOD_GUI_LEFT },
+    { "GUI-RIGHT", DuckyScriptParser::MOD_GUI_RIGHT },
+    { "OPTION", DuckyScriptParser::MOD_ALT_LEFT },
+    { "SHIFT", DuckyScriptParser::MOD_SHIFT_LEFT },
+    { "SHIFT-LEFT", DuckyScriptParser::MOD_SHIFT_LEFT },
+    { "SHIFT-RIGHT", DuckyScriptParser::MOD_SHIFT_RIGHT },
+    { "WINDOWS", DuckyScriptParser::MOD_GUI_LEFT },
+};
+
+static const KeyName MEDIA_KEYS[] = {
+    { "MEDIA_BACK", MEDIA_KEY_WWW_BACK },
+    { "MEDIA_BOOKMARKS", MEDIA_KEY_WWW_BOOKMARKS },
+    { "MEDIA_BROWSER_STOP", MEDIA_KEY_WWW_STOP },
+    { "MEDIA_CALCULATOR", MEDIA_KEY_CALCULATOR },
+    { "MEDIA_COMPUTER", MEDIA_KEY_LOCAL_MACHINE_BROWSER },
+    { "MEDIA_CONFIG", MEDIA_KEY_CONSUMER_CONTROL_CONFIGURATION },
+    { "MEDIA_EMAIL", MEDIA_KEY_EMAIL_READER },
+    { "MEDIA_HOME", MEDIA_KEY_WWW_HOME },
+    { "MEDIA_MUTE", MEDIA_KEY_MUTE },
+    { "MEDIA_NEXT", MEDIA_KEY_NEXT_TRACK },
+    { "MEDIA_PLAY_PAUSE", MEDIA_KEY_PLAY_PAUSE },
+    { "MEDIA_PREV", MEDIA_KEY_PREVIOUS_TRACK },
+    { "MEDIA_SEARCH", MEDIA_KEY_WWW_SEARCH },
+    { "MEDIA_STOP", MEDIA_KEY_STOP },
+    { "MEDIA_VOLUME_DOWN", MEDIA_KEY_VOLUME_DOWN },
+    { "MEDIA_VOLUME_UP", MEDIA_KEY_VOLUME_UP },
+    { "MK_MUTE", MEDIA_KEY_MUTE },
+    { "MK_NEXT", MEDIA_KEY_NEXT_TRACK },
+    { "MK_PP", MEDIA_KEY_PLAY_PAUSE },
+    { "MK_PREV", MEDIA_KEY_PREVIOUS_TRACK },
+    { "MK_STOP", MEDIA_KEY_STOP },
+    { "MK_VOLDOWN", MEDIA_KEY_VOLUME_DOWN },
+    { "MK_VOLUP", MEDIA_KEY_VOLUME_UP },
+};
+
+#define KEY_TABLE_SIZE(table) (sizeof(table) / sizeof(table[0]))
+
+// Binary search for text[start, end) in a sorted key table
+static bool lookupKey(const KeyName* table, size_t count, const char* text, uint32_t start, uint32_t end, uint8_t& value) {
+    uint32_t length = end - start;
+    size_t low = 0;
+    size_t high = count;
+    
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        const char* name = table[mid].name;
+        int result = strncmp(text + start, name, length);
+        if (result == 0 && name[length] != '\0') result = -1; // Token is a prefix of name
+    
+        if (result == 0) {
+            value = table[mid].value;
+            return true;
+        }
+        if (result < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return false;
+}
+
+DuckyScriptParser::KeyKind DuckyScriptParser::findKey(const char* text, uint32_t start, uint32_t end, uint8_t& value) {
+    if (lookupKey(MODIFIERS, KEY_TABLE_SIZE(MODIFIERS), text, start, end, value)) return KEY_MODIFIER;
+    if (lookupKey(SPECIAL_KEYS, KEY_TABLE_SIZE(SPECIAL_KEYS), text, start, end, value)) return KEY_SPECIAL;
+    if (lookupKey(MEDIA_KEYS, KEY_TABLE_SIZE(MEDIA_KEYS), text, start, end, value)) return KEY_MEDIA;
+    return KEY_NONE;
+}
+
+DuckyScriptParser::DuckyScriptParser() : cancelRequested(false) {
     executionComplete = true;
     commandDelay = 100; // Increased default delay to 100ms for better reliability
-    currentLine = 0;
+    currentOp = 0;
     inCommentBlock = false;
+    streaming = false;
+    streamTextPending = false;
+    streamOpcode = OP_STRING;
+    playing = false;
+    wakeAt = 0;
+    pendingText = nullptr;
+    pendingLength = 0;
+    pendingOpcode = OP_STRING;
+    pendingFinal = false;
     hidDevice = nullptr;
-    
-    // Initialize special keys mapping
-    specialKeys["ENTER"] = DUCKY_ENTER;
-    specialKeys["ESC"] = DUCKY_ESC;
-    specialKeys["BACKSPACE"] = DUCKY_BACKSPACE;
-    specialKeys["TAB"] = DUCKY_TAB;
-    specialKeys["SPACE"] = DUCKY_SPACE;
-    specialKeys["DELETE"] = DUCKY_DELETE;
-    specialKeys["UP"] = DUCKY_UP;
-    specialKeys["DOWN"] = DUCKY_DOWN;
-    specialKeys["LEFT"] = DUCKY_LEFT;
-    specialKeys["RIGHT"] = DUCKY_RIGHT;
-    specialKeys["F1"] = 0x3A;
-    specialKeys["F2"] = 0x3B;
-    specialKeys["F3"] = 0x3C;
-    specialKeys["F4"] = 0x3D;
-    specialKeys["F5"] = 0x3E;
-    specialKeys["F6"] = 0x3F;
-    specialKeys["F7"] = 0x40;
-    specialKeys["F8"] = 0x41;
-    specialKeys["F9"] = 0x42;
-    specialKeys["F10"] = 0x43;
-    specialKeys["F11"] = 0x44;
-    specialKeys["F12"] = 0x45;
-    
-    // Initialize modifiers mapping
-    modifiers["CTRL"] = MOD_CTRL_LEFT;
-    modifiers["SHIFT"] = MOD_SHIFT_LEFT;
-    modifiers["ALT"] = MOD_ALT_LEFT;
-    modifiers["GUI"] = MOD_GUI_LEFT;
-    modifiers["WINDOWS"] = MOD_GUI_LEFT;
-    modifiers["COMMAND"] = MOD_GUI_LEFT;
-    modifiers["CTRL-LEFT"] = MOD_CTRL_LEFT;
-    modifiers["CTRL-RIGHT"] = MOD_CTRL_RIGHT;
-    modifiers["SHIFT-LEFT"] = MOD_SHIFT_LEFT;
-    modifiers["SHIFT-RIGHT"] = MOD_SHIFT_RIGHT;
-    modifiers["ALT-LEFT"] = MOD_ALT_LEFT;
-    modifiers["ALT-RIGHT"] = MOD_ALT_RIGHT;
-    modifiers["GUI-LEFT"] = MOD_GUI_LEFT;
-    modifiers["GUI-RIGHT"] = MOD_GUI_RIGHT;
+    script = nullptr;
+    scriptLength = 0;
+}
+
+DuckyScriptParser::~DuckyScriptParser() {
+    closeStream();
+    free(script);
 }
 
 void DuckyScriptParser::setHIDDevice(HIDDevice* device) {
@@ -53,236 +184,582 @@ void DuckyScriptParser::setHIDDevice(HIDDevice* device) {
 }
 
 void DuckyScriptParser::execute(const String& script) {
+    char* text = (char*)malloc(script.length() + 1);
+    if (!text) {
+        LOG_ERROR("Out of memory for a %u byte script", script.length());
+        return;
+    }
+    memcpy(text, script.c_str(), script.length() + 1);
+    execute(text, script.length());
+}
+
+void DuckyScriptParser::execute(char* text, uint32_t length) {
     if (!hidDevice || !hidDevice->isConnected()) {
-        Serial.println("HID device not available");
+        LOG_WARN("HID device not available");
+        free(text);
         return;
     }
     
-    executionComplete = false;
-    currentLine = 0;
+    prepare(text, length);
+    start();
+}
+
+void DuckyScriptParser::prepare(char* text, uint32_t length) {
+    closeStream();
+    currentOp = 0;
     inCommentBlock = false;
+    setScript(text, length);
     
-    // Split script into lines
-    lines.clear();
-    int start = 0;
-    int end = script.indexOf('\n');
+    // Index lines and compile once so that process() does no string work
+    unsigned long compileStart = micros();
+    indexLines();
+    compile();
+    inCommentBlock = false;
     
-    while (end != -1) {
-        lines.push_back(script.substring(start, end));
-        start = end + 1;
-        end = script.indexOf('\n', start);
+    LOG_INFO("Compiled DuckyScript, lines: %u, ops: %u, in %u us",
+             lines.size(), program.size(), micros() - compileStart);
+}
+
+bool DuckyScriptParser::start() {
+    if (!hidDevice || !hidDevice->isConnected()) {
+        LOG_WARN("HID device not available");
+        return false;
     }
     
-    // Add last line if it doesn't end with newline
-    if (start < script.length()) {
-        lines.push_back(script.substring(start));
+    executionComplete = false;
+    currentOp = 0;
+    wakeAt = millis();
+    cancelRequested = false;
+    hidDevice->setExecuting(true);
+    LOG_INFO("Starting DuckyScript execution");
+    return true;
+}
+
+void DuckyScriptParser::execute(fs::File file) {
+    if (!hidDevice || !hidDevice->isConnected()) {
+        LOG_WARN("HID device not available");
+        file.close();
+        return;
     }
     
-    Serial.println("Starting DuckyScript execution");
-    Serial.println("Lines: " + String(lines.size()));
+    closeStream();
+    executionComplete = false;
+    currentOp = 0;
+    inCommentBlock = false;
+    wakeAt = millis();
+    cancelRequested = false;
+    setScript(nullptr, 0);
+    lines.clear();
+    program.clear();
+    
+    hidDevice->setExecuting(true);
+    
+    // Lines are compiled and run one at a time as they are read
+    streamFile = file;
+    streaming = true;
+    streamTextPending = false;
+    reader.begin(&streamFile);
+    
+    LOG_INFO("Starting DuckyScript execution (streaming %u bytes)", streamFile.size());
 }
 
-void DuckyScriptParser::process() {
-    if (executionComplete || !hidDevice) return;
+void DuckyScriptParser::play(fs::File file) {
+    if (!hidDevice || !hidDevice->isConnected()) {
+        LOG_WARN("HID device not available");
+        file.close();
+        return;
+    }
     
-    if (currentLine < lines.size()) {
-        executeLine(lines[currentLine]);
-        currentLine++;
-    } else {
-        executionComplete = true;
+    closeStream();
+    currentOp = 0;
+    wakeAt = millis();
+    cancelRequested = false;
+    setScript(nullptr, 0);
+    lines.clear();
+    program.clear();
+    
+    streamFile = file;
+    HIDRHeader header;
+    if (!reportReader.begin(&streamFile, header)) {
+        streamFile.close();
+        return;
+    }
+    if (strcmp(header.layout, HIDReportEncoder::getLayout()->name) != 0) {
+        LOG_WARN("Report file was recorded for the %s layout", header.layout);
     }
+    
+    executionComplete = false;
+    playing = true;
+    hidDevice->setExecuting(true);
+    
+    LOG_INFO("Starting report playback (%u bytes)", streamFile.size());
 }
 
-String DuckyScriptParser::getCurrentLine() {
-    if (currentLine < lines.size()) {
-        return lines[currentLine];
+void DuckyScriptParser::indexLines() {
+    const char* text = script;
+    uint32_t length = scriptLength;
+    
+    // Count first so the span array is allocated exactly once
+    size_t count = 0;
+    const char* cursor = text;
+    const char* last = text + length;
+    while (cursor < last) {
+        const char* newline = (const char*)memchr(cursor, '\n', last - cursor);
+        count++;
+        if (!newline) break;
+        cursor = newline + 1;
+    }
+    
+    lines.clear();
+    lines.reserve(count);
+    
+    uint32_t start = 0;
+    while (start < length) {
+        const char* newline = (const char*)memchr(text + start, '\n', length - start);
+        uint32_t end = newline ? (uint32_t)(newline - text) : length;
+    
+        LineSpan span = { start, end - start };
+        lines.push_back(span);
+        start = end + 1;
     }
-    return "";
 }
 
-void DuckyScriptParser::executeLine(const String& line) {
-    if (executionComplete || !hidDevice) return;
+void DuckyScriptParser::compile() {
+    program.clear();
+    
+    // Upper bound: at most one op per line
+    const char* text = script;
+    program.reserve(lines.size());
     
-    String trimmedLine = trim(line);
+    for (uint32_t i = 0; i < lines.size(); i++) {
+        DuckyOp op;
+        if (compileLine(text, lines[i].offset, lines[i].offset + lines[i].length, i, op)) {
+            program.push_back(op);
+        }
+    }
+    
+    program.shrink_to_fit();
+}
+
+bool DuckyScriptParser::compileLine(const char* text, uint32_t start, uint32_t end, uint32_t lineIndex, DuckyOp& op) {
+    // Trim
+    while (start < end && isWhitespace(text[start])) start++;
+    while (end > start && isWhitespace(text[end - 1])) end--;
     
     // Skip empty lines
-    if (trimmedLine.length() == 0) return;
+    if (start == end) return false;
     
     // Handle comment blocks
     if (inCommentBlock) {
-        if (trimmedLine.startsWith("REM_BLOCK") && trimmedLine.indexOf("END") != -1) {
+        if (startsWith(text, start, end, "END_REM") ||
+            (startsWith(text, start, end, "REM_BLOCK") && contains(text, start, end, "END"))) {
             inCommentBlock = false;
         }
-        return;
+        return false;
+    }
+    
+    if (startsWith(text, start, end, "REM_BLOCK")) {
+        if (!contains(text, start + 9, end, "END")) {
+            inCommentBlock = true;
+        }
+        return false;
     }
     
     // Skip single line comments
-    if (trimmedLine.startsWith("REM")) {
-        return;
+    if (startsWith(text, start, end, "REM")) {
+        return false;
     }
     
     // Parse command
-    int spaceIndex = trimmedLine.indexOf(' ');
-    String command = (spaceIndex != -1) ? trimmedLine.substring(0, spaceIndex) : trimmedLine;
-    String parameters = (spaceIndex != -1) ? trimmedLine.substring(spaceIndex + 1) : "";
-    parameters = trim(parameters);
-    
-    // Execute command
-    if (command == "DELAY") {
-        handleDELAY(parameters);
-    } else if (command == "STRING") {
-        handleSTRING(parameters);
-    } else if (command == "STRINGLN") {
-        handleSTRINGLN(parameters);
-    } else if (command == "KEY") {
-        handleKEY(parameters);
-    } else if (command == "KEYS") {
-        handleKEYS(parameters);
-    } else if (command == "DEFAULTDELAY") {
-        handleDEFAULTDELAY(parameters);
-    } else if (command == "REM_BLOCK") {
-        handleREM_BLOCK(parameters);
-    } else if (command == "GUI" || command == "WINDOWS" || command == "COMMAND") {
-        // Explicitly handle GUI command which often has parameters like "GUI r"
-        if (parameters.length() > 0) {
-             // Treat "GUI r" as "GUI" modifier + "r" key
-             String newCmd = "GUI " + parameters;
-             handleKEY(newCmd);
-        } else {
-             // Just GUI key press
-             handleKEY("GUI");
-        }
-    } else if (command == "ENTER") {
+    uint32_t commandEnd = start;
+    while (commandEnd < end && !isWhitespace(text[commandEnd])) commandEnd++;
+    uint32_t paramStart = commandEnd;
+    while (paramStart < end && isWhitespace(text[paramStart])) paramStart++;
+    
+    op.line = lineIndex;
+    op.key = 0;
+    op.modifiers = 0;
+    op.arg = paramStart;
+    op.length = end - paramStart;
+    
+    uint8_t value;
+    if (equals(text, start, commandEnd, "DELAY")) {
+        op.opcode = OP_DELAY;
+        op.arg = parseNumber(text, paramStart, end);
+    } else if (equals(text, start, commandEnd, "STRING")) {
+        op.opcode = OP_STRING;
+    } else if (equals(text, start, commandEnd, "STRINGLN")) {
+        op.opcode = OP_STRINGLN;
+    } else if (equals(text, start, commandEnd, "KEY")) {
+        compileKey(text, paramStart, end, op);
+    } else if (equals(text, start, commandEnd, "KEYS")) {
+        op.opcode = OP_KEYS;
+    } else if (equals(text, start, commandEnd, "DEFAULTDELAY")) {
+        op.opcode = OP_DEFAULTDELAY;
+        op.arg = parseNumber(text, paramStart, end);
+    } else if (equals(text, start, commandEnd, "ENTER")) {
         // Explicitly handle ENTER
-        handleKEY("ENTER");
-    } else if (specialKeys.find(command.c_str()) != specialKeys.end() || modifiers.find(command.c_str()) != modifiers.end()) {
-        // Implicit key command (e.g., "CTRL c")
-        handleKEY(line);
+        op.opcode = OP_KEY;
+        op.key = DUCKY_ENTER;
+    } else if (findKey(text, start, commandEnd, value) != KEY_NONE) {
+        // Implicit key command (e.g., "CTRL c", "GUI r", "MK_VOLUP")
+        compileKey(text, start, end, op);
     } else {
-        Serial.println("Unknown command: " + command);
+        LOG_WARN("Unknown command on line %u", lineIndex + 1);
+        return false;
     }
     
-    // Apply default delay
-    if (commandDelay > 0) {
-        hidDevice->delay(commandDelay);
+    return true;
+}
+
+void DuckyScriptParser::compileKey(const char* text, uint32_t start, uint32_t end, DuckyOp& op) {
+    op.opcode = OP_KEY;
+    op.key = 0;
+    op.modifiers = 0;
+    
+    uint32_t i = start;
+    while (i < end) {
+        while (i < end && isWhitespace(text[i])) i++;
+        uint32_t tokenStart = i;
+        while (i < end && !isWhitespace(text[i])) i++;
+        if (tokenStart == i) break;
+    
+        uint8_t value;
+        KeyKind kind = findKey(text, tokenStart, i, value);
+        if (kind == KEY_MODIFIER) {
+            op.modifiers |= value;
+        } else if (kind == KEY_SPECIAL) {
+            op.key = value;
+        } else if (kind == KEY_MEDIA) {
+            op.opcode = OP_MEDIA;
+            op.key = value;
+        } else if (i - tokenStart == 1) {
+            // Single character
+            op.key = text[tokenStart];
+        } else {
+            LOG_WARN("Unknown key on line %u", op.line + 1);
+        }
     }
 }
 
-void DuckyScriptParser::handleREM(const String& line) {
-    // Comments are ignored
-    Serial.println("Comment: " + line);
+unsigned long DuckyScriptParser::process() {
+    if (executionComplete || !hidDevice) return millis();
+    
+    if (cancelRequested) {
+        stopExecution();
+        return millis();
+    }
+    
+    // Still inside a DELAY, or the output queue needs to drain first
+    unsigned long now = millis();
+    if ((long)(wakeAt - now) > 0) return wakeAt;
+    if (!hasOutputSpace()) return now + 1;
+    
+    if (pendingLength > 0) {
+        emitText();
+    } else if (playing) {
+        processReports();
+    } else if (streaming) {
+        processStream();
+    } else if (currentOp < program.size()) {
+        runOp(program[currentOp], script);
+        currentOp++;
+    } else {
+        executionComplete = true;
+        hidDevice->setExecuting(false);
+    }
+    
+    now = millis();
+    return (long)(wakeAt - now) > 0 ? wakeAt : now;
 }
 
-void DuckyScriptParser::handleREM_BLOCK(const String& line) {
-    if (line.indexOf("END") == -1) {
-        inCommentBlock = true;
+void DuckyScriptParser::processStream() {
+    if (!reader.readLine()) {
+        closeStream();
+        executionComplete = true;
+        hidDevice->setExecuting(false);
+        return;
     }
+    
+    const char* text = reader.line();
+    uint32_t length = reader.length();
+    
+    if (reader.isContinuation()) {
+        // Rest of an over-long line, only STRING/STRINGLN text is kept
+        if (!streamTextPending) return;
+    
+        bool final = !reader.isPartial();
+        if (final) {
+            while (length > 0 && isWhitespace(text[length - 1])) length--;
+            streamTextPending = false;
+        }
+        startText(text, length, streamOpcode, final);
+        return;
+    }
+    
+    DuckyOp op;
+    if (!compileLine(text, 0, length, reader.getLineNumber() - 1, op)) return;
+    
+    if (reader.isPartial() && (op.opcode == OP_STRING || op.opcode == OP_STRINGLN)) {
+        // Keep trailing whitespace, the text continues in the next chunk
+        streamOpcode = op.opcode;
+        streamTextPending = true;
+        startText(text + op.arg, length - op.arg, op.opcode, false);
+        return;
+    }
+    
+    runOp(op, text);
 }
 
-void DuckyScriptParser::handleDELAY(const String& line) {
-    int delayMs = line.toInt();
-    if (delayMs > 0) {
-        hidDevice->delay(delayMs);
-        Serial.println("Delay: " + String(delayMs) + "ms");
+void DuckyScriptParser::processReports() {
+    // Records go to the output queue unchanged until it is full or a delay
+    // comes up; there is nothing to parse or encode
+    HIDRecord record;
+    HIDKeyReport report;
+    while (!cancelRequested && hasOutputSpace()) {
+        if (!reportReader.next(record)) {
+            closeStream();
+            executionComplete = true;
+            hidDevice->setExecuting(false);
+            return;
+        }
+    
+        switch (record.type) {
+            case HIDR_REPORT:
+                record.toReport(report);
+                hidDevice->sendReport(report);
+                break;
+            case HIDR_HOLD:
+                hidDevice->sendHold();
+                break;
+            case HIDR_MEDIA:
+                hidDevice->sendMediaKey(record.modifiers);
+                break;
+            case HIDR_DELAY:
+                sleep(record.delayMs());
+                return;
+        }
     }
 }
 
-void DuckyScriptParser::handleSTRING(const String& line) {
-    hidDevice->sendString(line);
-    Serial.println("String: " + line);
+void DuckyScriptParser::closeStream() {
+    if (streaming) {
+        reader.end();
+        streamFile.close();
+        streaming = false;
+    }
+    if (playing) {
+        reportReader.end();
+        streamFile.close();
+        playing = false;
+    }
+    streamTextPending = false;
 }
 
-void DuckyScriptParser::handleSTRINGLN(const String& line) {
-    hidDevice->sendString(line);
-    hidDevice->sendKey(DUCKY_ENTER);
-    Serial.println("StringLN: " + line);
+void DuckyScriptParser::setScript(char* text, uint32_t length) {
+    free(script);
+    script = text;
+    scriptLength = length;
 }
 
-void DuckyScriptParser::handleKEY(const String& line) {
-    std::vector<String> keyParts = splitByWhitespace(line);
-    uint8_t key = 0;
-    uint8_t keyMods = 0;
+ScriptLine DuckyScriptParser::getCurrentLine() {
+    ScriptLine line = { "", 0 };
     
-    Serial.println("DEBUG: handleKEY processing line: '" + line + "'");
+    if (streaming) {
+        line.text = reader.line();
+        line.length = reader.length();
+    } else if (currentOp < program.size() && program[currentOp].line < lines.size()) {
+        const LineSpan& span = lines[program[currentOp].line];
+        line.text = script + span.offset;
+        line.length = span.length;
+    }
+    return line;
+}
 
-    for (const String& part : keyParts) {
-        Serial.println("DEBUG: Processing part: '" + part + "'");
-        if (modifiers.find(part.c_str()) != modifiers.end()) {
-            keyMods |= modifiers[part.c_str()];
-            Serial.println("DEBUG: Found modifier: " + part + ", val: " + String(modifiers[part.c_str()], HEX) + ", keyMods now: " + String(keyMods, HEX));
-        } else if (specialKeys.find(part.c_str()) != specialKeys.end()) {
-            key = specialKeys[part.c_str()];
-            Serial.println("DEBUG: Found special key: " + part + ", val: " + String(key, HEX));
-        } else if (part.length() == 1) {
-            // Single character
-            key = part[0];
-            Serial.println("DEBUG: Found char key: " + part + ", val: " + String(key, HEX));
-        } else {
-            Serial.println("DEBUG: Unknown part: " + part);
+void DuckyScriptParser::executeLine(const String& line) {
+    if (executionComplete || !hidDevice) return;
+    
+    DuckyOp op;
+    if (compileLine(line.c_str(), 0, line.length(), 0, op)) {
+        runOp(op, line.c_str());
+    
+        // The line does not outlive this call, send any remaining text now
+        if (pendingLength > 0) {
+            hidDevice->sendText(pendingText, pendingLength);
+            pendingLength = 0;
+            emitText();
         }
     }
+}
+
+void DuckyScriptParser::runOp(const DuckyOp& op, const char* text) {
+    switch (op.opcode) {
+        case OP_DELAY:
+            if (op.arg > 0) sleep(op.arg);
+            break;
+        case OP_STRING:
+        case OP_STRINGLN:
+            // Finished (ENTER and default delay) once the last slice is sent
+            startText(text + op.arg, op.length, op.opcode, true);
+            return;
+        case OP_KEY:
+            hidDevice->sendKey(op.key, op.modifiers);
+            break;
+        case OP_KEYS:
+            hidDevice->sendKeySequence(text + op.arg, op.length);
+            break;
+        case OP_DEFAULTDELAY:
+            if (op.arg > 0) commandDelay = op.arg;
+            break;
+        case OP_MEDIA:
+            hidDevice->sendMediaKey(op.key);
+            break;
+    }
     
-    Serial.println("DEBUG: Calling sendKey with key: " + String(key, HEX) + ", mods: " + String(keyMods, HEX));
-    hidDevice->sendKey(key, keyMods);
-    Serial.println("Key: " + line);
+    finishOp();
 }
 
-void DuckyScriptParser::handleKEYS(const String& line) {
-    hidDevice->sendKeySequence(line);
-    Serial.println("Keys: " + line);
+void DuckyScriptParser::startText(const char* text, uint32_t length, uint8_t opcode, bool final) {
+    pendingText = text;
+    pendingLength = length;
+    pendingOpcode = opcode;
+    pendingFinal = final;
+    emitText();
 }
 
-void DuckyScriptParser::handleDEFAULTDELAY(const String& line) {
-    int delayMs = line.toInt();
-    if (delayMs > 0) {
-        commandDelay = delayMs;
-        Serial.println("Default delay: " + String(delayMs) + "ms");
+void DuckyScriptParser::emitText() {
+    // Emit as many slices as the queue takes, checking for cancellation
+    // between them so a long STRING can be aborted part way through
+    while (pendingLength > 0) {
+        if (cancelRequested || !hasOutputSpace()) return;
+    
+        uint32_t count = pendingLength < STRING_SLICE ? pendingLength : STRING_SLICE;
+    
+        // Do not split a UTF-8 sequence across slices
+        while (count < pendingLength && count > 0 && ((uint8_t)pendingText[count] & 0xC0) == 0x80) {
+            count--;
+        }
+        if (count == 0) count = pendingLength < STRING_SLICE ? pendingLength : STRING_SLICE;
+        hidDevice->sendText(pendingText, count);
+        pendingText += count;
+        pendingLength -= count;
+    }
+    
+    if (pendingFinal) {
+        pendingFinal = false;
+        if (pendingOpcode == OP_STRINGLN) {
+            hidDevice->sendKey(DUCKY_ENTER);
+        }
+        finishOp();
     }
 }
 
-void DuckyScriptParser::stopExecution() {
-    executionComplete = true;
-    currentLine = 0;
-    lines.clear();
+void DuckyScriptParser::finishOp() {
+    // Apply default delay
+    if (commandDelay > 0) {
+        sleep(commandDelay);
+    }
 }
 
-String DuckyScriptParser::trim(const String& str) {
-    int start = 0;
-    int end = str.length() - 1;
-    
-    while (start <= end && isWhitespace(str[start])) start++;
-    while (end >= start && isWhitespace(str[end])) end--;
+void DuckyScriptParser::sleep(uint32_t ms) {
+    // The delay itself is timed by the output path; the parser just holds
+    // off producing until it has passed instead of blocking loop()
+    // Back-to-back delays add up in the output queue
+    if (!hidDevice->isRealtime()) {
+        hidDevice->delay(ms);
+        return;
+    }
     
-    return str.substring(start, end - start + 1);
+    unsigned long now = millis();
+    unsigned long start = (long)(wakeAt - now) > 0 ? wakeAt : now;
+    wakeAt = start + ms;
+    hidDevice->delay(ms);
+}
+
+bool DuckyScriptParser::hasOutputSpace() {
+    return hidDevice->outputSpace() >= MIN_OUTPUT_SPACE;
 }
 
-std::vector<String> DuckyScriptParser::splitByWhitespace(const String& str) {
-    std::vector<String> result;
-    int length = str.length();
-    int start = 0;
-    bool inWord = false;
+uint32_t DuckyScriptParser::estimateDuration() {
+    if (!hidDevice || streaming) return 0;
     
-    for (int i = 0; i < length; i++) {
-        if (isWhitespace(str[i])) {
-            if (inWord) {
-                result.push_back(str.substring(start, i));
-                inWord = false;
-            }
-        } else {
-            if (!inWord) {
-                start = i;
-                inWord = true;
-            }
+    // Walk the compiled program with the backend's timing model
+    uint32_t reportUs = hidDevice->reportTimeUs();
+    uint32_t keyUs = hidDevice->keyTimeUs();
+    unsigned long defaultDelay = commandDelay;
+    uint64_t totalUs = 0;
+    
+    HIDReportEncoder encoder;
+    HIDKeyReport report;
+    const char* text = script;
+    
+    for (size_t i = currentOp; i < program.size(); i++) {
+        const DuckyOp& op = program[i];
+        switch (op.opcode) {
+            case OP_DELAY:
+                totalUs += op.arg * 1000ULL;
+                break;
+            case OP_STRING:
+            case OP_STRINGLN:
+                encoder.begin(text + op.arg, op.length);
+                while (encoder.next(report)) totalUs += reportUs;
+                if (op.opcode == OP_STRINGLN) totalUs += keyUs;
+                break;
+            case OP_KEY:
+            case OP_MEDIA:
+                totalUs += keyUs;
+                break;
+            case OP_DEFAULTDELAY:
+                if (op.arg > 0) defaultDelay = op.arg;
+                break;
         }
+        totalUs += defaultDelay * 1000ULL;
     }
     
-    if (inWord) {
-        result.push_back(str.substring(start));
+    return (uint32_t)(totalUs / 1000);
+}
+
+void DuckyScriptParser::stopExecution() {
+    closeStream();
+    cancelRequested = false;
+    pendingLength = 0;
+    pendingFinal = false;
+    if (hidDevice) {
+        hidDevice->cancel();
+        if (!executionComplete) hidDevice->setExecuting(false);
     }
-    
-    return result;
+    executionComplete = true;
+    currentOp = 0;
+    lines.clear();
+    program.clear();
 }
 
 bool DuckyScriptParser::isWhitespace(char c) {
     return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool DuckyScriptParser::equals(const char* text, uint32_t start, uint32_t end, const char* word) {
+    size_t length = strlen(word);
+    return end - start == length && strncmp(text + start, word, length) == 0;
+}
+
+bool DuckyScriptParser::startsWith(const char* text, uint32_t start, uint32_t end, const char* word) {
+    size_t length = strlen(word);
+    return end - start >= length && strncmp(text + start, word, length) == 0;
+}
+
+bool DuckyScriptParser::contains(const char* text, uint32_t start, uint32_t end, const char* word) {
+    for (uint32_t i = start; i < end; i++) {
+        if (startsWith(text, i, end, word)) return true;
+    }
+    return false;
+}
+
+uint32_t DuckyScriptParser::parseNumber(const char* text, uint32_t start, uint32_t end) {
+    uint32_t value = 0;
+    while (start < end && text[start] >= '0' && text[start] <= '9') {
+        value = value * 10 + (text[start] - '0');
+        start++;
+    }
+    return value;
 }
\ No newline at end of file
@@ -2,17 +2,34 @@
 #define DUCKYSCRIPT_PARSER_H
 
 #include <Arduino.h>
+#include <FS.h>
 #include <vector>
-#include <map>
+#include <atomic>
+#include "ScriptLineReader.h"
+#include "HIDReportEncoder.h"
+#include "HIDReportFile.h"
 
 // HID Device interface
 class HIDDevice {
 public:
     virtual void sendKey(uint8_t key, uint8_t modifiers = 0) = 0;
     virtual void sendString(const String& text) = 0;
-    virtual void sendKeySequence(const String& keys) = 0;
+    virtual void sendText(const char* text, size_t length) = 0;
+    virtual void sendKeySequence(const char* keys, size_t length) = 0;
+    virtual void sendMediaKey(uint8_t mediaKey) = 0;
+    virtual void sendReport(const HIDKeyReport& report) = 0; // Pre-encoded report
+    virtual void sendHold() {}                   // Keep keys down for one report slot
     virtual void delay(uint32_t ms) = 0;
     virtual bool isConnected() = 0;
+    virtual void setExecuting(bool executing) {} // Hint for link tuning
+    virtual bool isIdle() { return true; }       // All queued output sent
+    virtual void cancel() {}                     // Drop queued output
+    virtual size_t outputSpace() { return SIZE_MAX; } // Free output queue entries
+    virtual bool isRealtime() { return true; }   // false: delays are recorded, not waited for
+    
+    // Timing model for duration estimates
+    virtual uint32_t reportTimeUs() { return 1000; }           // One report
+    virtual uint32_t keyTimeUs() { return 2 * reportTimeUs(); } // Press and release
 };
 
 // HID Modes
@@ -20,46 +37,151 @@ enum HIDMode {
     HID_MODE_KEYBOARD
 };
 
+// Compiled DuckyScript opcodes
+enum DuckyOpcode : uint8_t {
+    OP_DELAY,        // arg = milliseconds
+    OP_STRING,       // arg/length = text span in the script buffer
+    OP_STRINGLN,     // arg/length = text span in the script buffer
+    OP_KEY,          // key + modifiers
+    OP_KEYS,         // arg/length = key sequence span in the script buffer
+    OP_DEFAULTDELAY, // arg = milliseconds
+    OP_MEDIA         // key = MediaKey
+};
+
+// Consumer control keys (bit index in the BLE media report)
+enum MediaKey : uint8_t {
+    MEDIA_KEY_NEXT_TRACK,
+    MEDIA_KEY_PREVIOUS_TRACK,
+    MEDIA_KEY_STOP,
+    MEDIA_KEY_PLAY_PAUSE,
+    MEDIA_KEY_MUTE,
+    MEDIA_KEY_VOLUME_UP,
+    MEDIA_KEY_VOLUME_DOWN,
+    MEDIA_KEY_WWW_HOME,
+    MEDIA_KEY_LOCAL_MACHINE_BROWSER,
+    MEDIA_KEY_CALCULATOR,
+    MEDIA_KEY_WWW_BOOKMARKS,
+    MEDIA_KEY_WWW_SEARCH,
+    MEDIA_KEY_WWW_STOP,
+    MEDIA_KEY_WWW_BACK,
+    MEDIA_KEY_CONSUMER_CONTROL_CONFIGURATION,
+    MEDIA_KEY_EMAIL_READER,
+    MEDIA_KEY_COUNT
+};
+
+// View into the script buffer (not null-terminated)
+struct ScriptLine {
+    const char* text;
+    uint32_t length;
+};
+
+// Location of a source line in the script buffer
+struct LineSpan {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct DuckyOp {
+    uint8_t opcode;
+    uint8_t key;
+    uint8_t modifiers;
+    uint32_t line;   // Source line, used for display
+    uint32_t arg;
+    uint32_t length;
+};
+
 class DuckyScriptParser {
 private:
     HIDDevice* hidDevice;
     bool executionComplete;
     unsigned long commandDelay;
     
-    // DuckyScript commands
-    std::map<String, uint8_t> specialKeys;
-    std::map<String, uint8_t> modifiers;
-    
-    // Parsing state
-    std::vector<String> lines;
-    int currentLine;
+    // Parsing state. The script is one heap block owned by the parser,
+    // handed over by execute(char*, uint32_t) without a copy.
+    char* script;
+    uint32_t scriptLength;
+    std::vector<LineSpan> lines;
+    std::vector<DuckyOp> program;
+    size_t currentOp;
     bool inCommentBlock;
     
-    // Command handlers
-    void handleREM(const String& line);
-    void handleREM_BLOCK(const String& line);
-    void handleDELAY(const String& line);
-    void handleSTRING(const String& line);
-    void handleSTRINGLN(const String& line);
-    void handleKEY(const String& line);
-    void handleKEYS(const String& line);
-    void handleDEFAULTDELAY(const String& line);
+    // Streaming state (payloads too large to load into RAM)
+    fs::File streamFile;
+    ScriptLineReader reader;
+    bool streaming;
+    bool streamTextPending;
+    uint8_t streamOpcode;
+    
+    // Pre-rendered report playback (.hidr)
+    HIDReportReader reportReader;
+    bool playing;
+    
+    // Resumable execution state. process() never sleeps: DELAY is queued
+    // with the output and the parser waits for wakeAt before producing
+    // more, and STRING text is emitted in slices as queue space allows.
+    unsigned long wakeAt;
+    const char* pendingText;
+    uint32_t pendingLength;
+    uint8_t pendingOpcode;
+    bool pendingFinal;     // Last chunk of the STRING, finish the op after it
+    std::atomic<bool> cancelRequested;
+    
+    // Compiler
+    void indexLines();
+    void compile();
+    bool compileLine(const char* text, uint32_t start, uint32_t end, uint32_t lineIndex, DuckyOp& op);
+    void compileKey(const char* text, uint32_t start, uint32_t end, DuckyOp& op);
+    
+    // Interpreter
+    void runOp(const DuckyOp& op, const char* text);
+    void startText(const char* text, uint32_t length, uint8_t opcode, bool final);
+    void emitText();
+    void finishOp();
+    void sleep(uint32_t ms);
+    bool hasOutputSpace();
+    void processStream();
+    void processReports();
+    void closeStream();
+    void setScript(char* text, uint32_t length);
     
     // Utility functions
-    String trim(const String& str);
-    std::vector<String> splitByWhitespace(const String& str);
     bool isWhitespace(char c);
+    bool equals(const char* text, uint32_t start, uint32_t end, const char* word);
+    bool startsWith(const char* text, uint32_t start, uint32_t end, const char* word);
+    bool contains(const char* text, uint32_t start, uint32_t end, const char* word);
+    uint32_t parseNumber(const char* text, uint32_t start, uint32_t end);
     
 public:
     DuckyScriptParser();
+    ~DuckyScriptParser();
     
     void setHIDDevice(HIDDevice* device);
     void execute(const String& script);
-    void process(); // Process next line
-    String getCurrentLine(); // Get current line text
+    void execute(char* text, uint32_t length); // Takes a malloc()ed, null-terminated buffer
+    
+    // execute() in two halves: compile now, without a device, and start
+    // once the device is connected. start() fails while it is not.
+    void prepare(char* text, uint32_t length);
+    bool start();
+    void execute(fs::File file); // Stream lines from an open file
+    void play(fs::File file);    // Send a pre-rendered .hidr report stream
+    unsigned long process(); // Run until the next wait, returns the millis() to call again at
+    ScriptLine getCurrentLine(); // Get source line of the next op
     void executeLine(const String& line);
-    bool isExecutionComplete() { return executionComplete; }
+    bool isExecutionComplete() { return executionComplete && (!hidDevice || hidDevice->isIdle()); }
+    uint32_t estimateDuration(); // Milliseconds for the loaded script, 0 when streaming
     void stopExecution();
+    void requestStop() { cancelRequested = true; } // Safe from any task
+    
+    // Key name in text[start, end), searched in place in the sorted name
+    // tables: modifiers first, then keys, then media keys
+    enum KeyKind : uint8_t {
+        KEY_NONE,
+        KEY_MODIFIER,
+        KEY_SPECIAL,
+        KEY_MEDIA
+    };
+    static KeyKind findKey(const char* text, uint32_t start, uint32_t end, uint8_t& value);
     
     // Command constants (Arduino Keyboard.h compatible)
     static const uint8_t DUCKY_ENTER = 0xB0;
@@ -72,6 +194,19 @@ public:
     static const uint8_t DUCKY_DOWN = 0xD9;
     static const uint8_t DUCKY_LEFT = 0xD8;
     static const uint8_t DUCKY_RIGHT = 0xD7;
+    static const uint8_t DUCKY_INSERT = 0xD1;
+    static const uint8_t DUCKY_HOME = 0xD2;
+    static const uint8_t DUCKY_PAGE_UP = 0xD3;
+    static const uint8_t DUCKY_END = 0xD5;
+    static const uint8_t DUCKY_PAGE_DOWN = 0xD6;
+    static const uint8_t DUCKY_CAPS_LOCK = 0xC1;
+    static const uint8_t DUCKY_PRINT_SCREEN = 0xCE;
+    static const uint8_t DUCKY_SCROLL_LOCK = 0xCF;
+    static const uint8_t DUCKY_PAUSE = 0xD0;
+    static const uint8_t DUCKY_NUM_LOCK = 0xDB;
+    static const uint8_t DUCKY_MENU = 0xED;
+    static const uint8_t DUCKY_F1 = 0xC2;   // F1-F12 are contiguous
+    static const uint8_t DUCKY_F13 = 0xF0;  // F13-F24 are contiguous
     
     // Modifier constants (Bitmasks for internal use)
     static const uint8_t MOD_CTRL_LEFT   = 0x01;
@@ -0,0 +1,132 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <algorithm>
+#include <new>
+
+// External merge sort of fixed size records for the on-card indexes.
+// RunWriter sorts RUN_RECORDS records at a time in RAM and appends them to
+// a runs file; RunMerger then returns all records in order while holding
+// only RUN_BUFFER records of each run.
+template <typename T, size_t RUN_RECORDS>
+class RunWriter {
+private:
+    fs::File* runs;
+    T* buffer;
+    size_t buffered;
+    size_t total;
+    bool failed;
+    bool (*less)(const T&, const T&);
+    
+    void flush() {
+        std::sort(buffer, buffer + buffered, less);
+        size_t bytes = buffered * sizeof(T);
+        if (runs->write((const uint8_t*)buffer, bytes) != bytes) failed = true;
+        buffered = 0;
+    }
+    
+public:
+    RunWriter() : runs(nullptr), buffer(nullptr), buffered(0), total(0), failed(false), less(nullptr) {}
+    ~RunWriter() { delete[] buffer; }
+    
+    bool begin(fs::File& file, bool (*order)(const T&, const T&)) {
+        runs = &file;
+        less = order;
+        buffered = 0;
+        total = 0;
+        failed = false;
+        if (!buffer) buffer = new (std::nothrow) T[RUN_RECORDS];
+        return buffer != nullptr;
+    }
+    
+    void add(const T& record) {
+        buffer[buffered++] = record;
+        total++;
+        if (buffered == RUN_RECORDS) flush();
+    }
+    
+    // Write the last run and free the buffer, false if any write failed
+    bool end() {
+        if (buffered > 0) flush();
+        delete[] buffer;
+        buffer = nullptr;
+        return !failed;
+    }
+    
+    size_t getTotal() { return total; }
+};
+
+template <typename T, size_t RUN_RECORDS, size_t RUN_BUFFER>
+class RunMerger {
+private:
+    struct Cursor {
+        size_t next;   // Next record of the run in the runs file
+        size_t end;
+        size_t head;
+        size_t count;
+        T buffer[RUN_BUFFER];
+    };
+    
+    fs::File* runs;
+    Cursor* cursors;
+    size_t runCount;
+    int (*compare)(const T&, const T&);
+    
+public:
+    RunMerger() : runs(nullptr), cursors(nullptr), runCount(0), compare(nullptr) {}
+    ~RunMerger() { end(); }
+    
+    bool begin(fs::File& file, size_t total, int (*order)(const T&, const T&)) {
+        end();
+        runs = &file;
+        compare = order;
+        runCount = (total + RUN_RECORDS - 1) / RUN_RECORDS;
+        cursors = new (std::nothrow) Cursor[runCount > 0 ? runCount : 1];
+        if (!cursors) return false;
+    
+        for (size_t i = 0; i < runCount; i++) {
+            cursors[i].next = i * RUN_RECORDS;
+            cursors[i].end = std::min(cursors[i].next + RUN_RECORDS, total);
+            cursors[i].head = 0;
+            cursors[i].count = 0;
+        }
+        return true;
+    }
+    
+    // Smallest remaining record, false once all runs are consumed or a read failed
+    bool next(T& record) {
+        Cursor* best = nullptr;
+        for (size_t i = 0; i < runCount; i++) {
+            Cursor& cursor = cursors[i];
+            if (cursor.head == cursor.count) {
+                if (cursor.next == cursor.end) continue;
+    
+                size_t records = std::min((size_t)RUN_BUFFER, cursor.end - cursor.next);
+                runs->seek(cursor.next * sizeof(T));
+                if (runs->read((uint8_t*)cursor.buffer, records * sizeof(T)) != records * sizeof(T)) {
+                    return false;
+                }
+                cursor.next += records;
+                cursor.head = 0;
+                cursor.count = records;
+            }
+            if (!best || compare(cursor.buffer[cursor.head], best->buffer[best->head]) < 0) {
+                best = &cursor;
+            }
+        }
+        if (!best) return false;
+    
+        record = best->buffer[best->head++];
+        return true;
+    }
+    
+    void end() {
+        delete[] cursors;
+        cursors = nullptr;
+        runCount = 0;
+    }
+};
+
+#endif // EXTERNAL_SORT_H
\ No newline at end of file
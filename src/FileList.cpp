@@ -0,0 +1,99 @@
+#include "FileList.h"
+#include <algorithm>
+
+#define LOAD_BATCH 4  // Index records read per file access
+
+FileList::FileList() {
+    clear();
+}
+
+void FileList::attach(DirectoryIndex* source) {
+    clear();
+    index = source;
+}
+
+void FileList::attach(PackArchive* source) {
+    clear();
+    archive = source;
+}
+
+void FileList::attach(const char* const* names, size_t count) {
+    clear();
+    fixedNames = names;
+    fixedCount = count;
+}
+
+void FileList::clear() {
+    index = nullptr;
+    archive = nullptr;
+    fixedNames = nullptr;
+    fixedCount = 0;
+    windowStart = 0;
+    windowCount = 0;
+}
+
+size_t FileList::size() {
+    if (fixedNames) return fixedCount;
+    if (archive) return archive->getCount();
+    return index ? index->getCount() : 0;
+}
+
+bool FileList::get(size_t position, FileView& view) {
+    if (fixedNames) {
+        if (position >= fixedCount) return false;
+        view.name = fixedNames[position];
+        view.isDir = true;
+        return true;
+    }
+    if (archive) {
+        const PackEntry* entry = archive->getEntry(position);
+        if (!entry) return false;
+        view.name = entry->name;
+        view.isDir = false;
+        return true;
+    }
+    
+    if (position < windowStart || position >= windowStart + windowCount) {
+        if (!load(position)) return false;
+    }
+    
+    size_t slot = position - windowStart;
+    view.name = pool + nameOffsets[slot];
+    view.isDir = (flags[slot] & DIR_ENTRY_DIRECTORY) != 0;
+    return true;
+}
+
+bool FileList::load(size_t position) {
+    size_t count = size();
+    if (position >= count) return false;
+    
+    // Start a little before the request so scrolling either way stays
+    // inside the window
+    windowStart = position > WINDOW_SIZE / 4 ? position - WINDOW_SIZE / 4 : 0;
+    if (windowStart + WINDOW_SIZE > count) {
+        windowStart = count > WINDOW_SIZE ? count - WINDOW_SIZE : 0;
+    }
+    windowCount = 0;
+    
+    DirectoryRecord records[LOAD_BATCH];
+    size_t poolUsed = 0;
+    while (windowCount < WINDOW_SIZE && windowStart + windowCount < count) {
+        size_t wanted = std::min((size_t)LOAD_BATCH, count - windowStart - windowCount);
+        wanted = std::min(wanted, (size_t)WINDOW_SIZE - windowCount);
+        size_t loaded = index->read(windowStart + windowCount, records, wanted);
+        if (loaded == 0) break;
+    
+        for (size_t i = 0; i < loaded; i++) {
+            const DirectoryRecord& record = records[i];
+            size_t length = std::min((size_t)record.nameLength, (size_t)DIR_NAME_SIZE - 1);
+            size_t slot = windowCount++;
+            nameOffsets[slot] = poolUsed;
+            flags[slot] = record.flags;
+            memcpy(pool + poolUsed, record.name, length);
+            poolUsed += length;
+            pool[poolUsed++] = '\0';
+        }
+    }
+    
+    return position < windowStart + windowCount;
+}
\ No newline at end of file
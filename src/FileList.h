@@ -0,0 +1,50 @@
+#ifndef FILE_LIST_H
+#define FILE_LIST_H
+
+#include <Arduino.h>
+#include "DirectoryIndex.h"
+#include "PackArchive.h"
+
+// Read-only view of one entry. The name points into the list's window and
+// stays valid until an entry outside the window is requested.
+struct FileView {
+    const char* name;
+    bool isDir;
+};
+
+// File list model for the menu. Only a window of entries around the last
+// request is held, with the names packed into one fixed string pool and
+// the other fields in parallel arrays. Moving the selection inside the
+// window reads nothing and allocates nothing.
+class FileList {
+public:
+    static const size_t WINDOW_SIZE = 16;
+    static const size_t POOL_SIZE = WINDOW_SIZE * DIR_NAME_SIZE;
+    
+private:
+    DirectoryIndex* index;
+    PackArchive* archive;           // Table is in RAM, read without a window
+    const char* const* fixedNames;  // Entries that are not in an index (drive selection)
+    size_t fixedCount;
+    
+    size_t windowStart;
+    size_t windowCount;
+    uint16_t nameOffsets[WINDOW_SIZE];
+    uint8_t flags[WINDOW_SIZE];
+    char pool[POOL_SIZE];
+    
+    bool load(size_t position);
+    
+public:
+    FileList();
+    
+    void attach(DirectoryIndex* source);
+    void attach(PackArchive* source);
+    void attach(const char* const* names, size_t count);  // Directories only
+    void clear();
+    
+    size_t size();
+    bool get(size_t position, FileView& view);
+};
+
+#endif // FILE_LIST_H
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "HIDOutputTask.h"
+#include "Log.h"
+
+#define HID_OUTPUT_CORE       0   // loop() runs on core 1
+#define HID_OUTPUT_PRIORITY   3
+#define HID_OUTPUT_STACK_SIZE 4096
+#define HID_OUTPUT_IDLE_WAIT  10  // ms between queue checks when idle
+
+HIDOutputTask HIDOutput;
+
+HIDOutputTask::HIDOutputTask() : generation(0), busy(false), firstReportTime(0) {
+    task = nullptr;
+    lastSink = nullptr;
+    activeGeneration = 0;
+}
+
+bool HIDOutputTask::begin() {
+    if (task) return true;
+    
+    BaseType_t result = xTaskCreatePinnedToCore(taskMain, "hid_output", HID_OUTPUT_STACK_SIZE, this,
+                                                HID_OUTPUT_PRIORITY, &task, HID_OUTPUT_CORE);
+    if (result != pdPASS) {
+        LOG_ERROR("HID output task failed to start, sending inline");
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void HIDOutputTask::taskMain(void* arg) {
+    static_cast<HIDOutputTask*>(arg)->run();
+}
+
+void HIDOutputTask::run() {
+    HIDOutputEntry entry;
+    
+    while (true) {
+        // Release whatever a cancelled stream left pressed
+        uint32_t current = generation.load();
+        if (current != activeGeneration) {
+            activeGeneration = current;
+            if (lastSink) {
+                HIDKeyReport release;
+                memset(&release, 0, sizeof(release));
+                lastSink->writeReport(release);
+            }
+        }
+        
+        busy = true;
+        if (!queue.pop(entry)) {
+            busy = false;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HID_OUTPUT_IDLE_WAIT));
+            continue;
+        }
+        
+        if (entry.generation != activeGeneration) continue; // Cancelled
+        dispatch(entry);
+    }
+}
+
+void HIDOutputTask::dispatch(const HIDOutputEntry& entry) {
+    switch (entry.type) {
+        case HID_OUTPUT_REPORT:
+            entry.sink->writeReport(entry.report);
+            if (firstReportTime == 0) firstReportTime = millis();
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+            decoder.feed(entry.report, micros());
+#endif
+            lastSink = entry.sink;
+            break;
+        case HID_OUTPUT_MEDIA:
+            entry.sink->writeMediaKey(entry.value);
+            break;
+        case HID_OUTPUT_HOLD:
+            entry.sink->writeHold();
+            break;
+        case HID_OUTPUT_DELAY:
+            wait(entry.value, entry.generation);
+            break;
+        case HID_OUTPUT_EXECUTING:
+            entry.sink->writeExecuting(entry.value != 0);
+            if (entry.value) firstReportTime = 0;
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+            if (entry.value) {
+                decoder.reset();
+            } else {
+                logStats();
+            }
+#endif
+            break;
+    }
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+// Decoding the stream costs the output task time between reports, so
+// release builds leave it to the host harness (MockHIDDevice)
+void HIDOutputTask::logStats() {
+    if (decoder.getReports() == 0) return;
+    
+    const uint32_t* gaps = decoder.getGapHistogram();
+    LOG_INFO("Typed %u chars, %u keys in %u reports (%u chars/s)", decoder.getChars(),
+             decoder.getKeyEvents(), decoder.getReports(), decoder.getCharsPerSecond());
+    LOG_INFO("Report gaps <1ms: %u, <2ms: %u, <5ms: %u", gaps[0], gaps[1], gaps[2]);
+    LOG_INFO("Report gaps <10ms: %u, <20ms: %u, longer: %u", gaps[3], gaps[4], gaps[5]);
+    if (decoder.getRepeatRisks() > 0) {
+        LOG_WARN("%u keys held past the host repeat delay", decoder.getRepeatRisks());
+    }
+    const char* preview = decoder.getPreview();
+    size_t length = strlen(preview);
+    LOG_DEBUG("Typed text ends with: %s", preview + (length >= LOG_TEXT_SIZE ? length - (LOG_TEXT_SIZE - 1) : 0));
+}
+#endif
+
+void HIDOutputTask::wait(uint32_t ms, uint32_t entryGeneration) {
+    if (!task) {
+        ::delay(ms);
+        return;
+    }
+    
+    // Sleep in notification waits so cancel() wakes us immediately
+    unsigned long start = millis();
+    while (generation.load() == entryGeneration) {
+        unsigned long elapsed = millis() - start;
+        if (elapsed >= ms) break;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms - elapsed));
+    }
+}
+
+void HIDOutputTask::push(const HIDOutputEntry& entry) {
+    if (!task) {
+        // No output task, send inline
+        dispatch(entry);
+        return;
+    }
+    
+    while (!queue.push(entry)) {
+        if (entry.generation != generation.load()) return; // Cancelled while waiting
+        vTaskDelay(1);
+    }
+    xTaskNotifyGive(task);
+}
+
+void HIDOutputTask::pushReport(HIDReportSink* sink, const HIDKeyReport& report) {
+    HIDOutputEntry entry;
+    entry.sink = sink;
+    entry.generation = generation.load();
+    entry.value = 0;
+    entry.type = HID_OUTPUT_REPORT;
+    entry.report = report;
+    push(entry);
+}
+
+void HIDOutputTask::pushMediaKey(HIDReportSink* sink, uint8_t mediaKey) {
+    HIDOutputEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.sink = sink;
+    entry.generation = generation.load();
+    entry.value = mediaKey;
+    entry.type = HID_OUTPUT_MEDIA;
+    push(entry);
+}
+
+void HIDOutputTask::pushHold(HIDReportSink* sink) {
+    HIDOutputEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.sink = sink;
+    entry.generation = generation.load();
+    entry.type = HID_OUTPUT_HOLD;
+    push(entry);
+}
+
+void HIDOutputTask::pushDelay(uint32_t ms) {
+    HIDOutputEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.generation = generation.load();
+    entry.value = ms;
+    entry.type = HID_OUTPUT_DELAY;
+    push(entry);
+}
+
+void HIDOutputTask::pushExecuting(HIDReportSink* sink, bool executing) {
+    HIDOutputEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.sink = sink;
+    entry.generation = generation.load();
+    entry.value = executing ? 1 : 0;
+    entry.type = HID_OUTPUT_EXECUTING;
+    push(entry);
+}
+
+bool HIDOutputTask::isIdle() {
+    return queue.empty() && !busy;
+}
+
+size_t HIDOutputTask::space() {
+    if (!task) return SIZE_MAX; // Inline output never waits for the queue
+    return queue.capacity() - queue.size();
+}
+
+void HIDOutputTask::cancel() {
+    generation++;
+    if (task) {
+        xTaskNotifyGive(task);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef HID_OUTPUT_TASK_H
+#define HID_OUTPUT_TASK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "HIDReportEncoder.h"
+#include "HIDReportDecoder.h"
+#include "SpscQueue.h"
+#include "Log.h"
+
+// Transport side of a HID backend, called from the output task
+class HIDReportSink {
+public:
+    virtual void writeReport(const HIDKeyReport& report) = 0;
+    virtual void writeMediaKey(uint8_t mediaKey) = 0;
+    virtual void writeHold() {}                    // Keep keys down for one report slot
+    virtual void writeExecuting(bool executing) {} // Link tuning hint, in stream order
+};
+
+enum HIDOutputType : uint8_t {
+    HID_OUTPUT_REPORT,
+    HID_OUTPUT_MEDIA,
+    HID_OUTPUT_HOLD,
+    HID_OUTPUT_DELAY,
+    HID_OUTPUT_EXECUTING
+};
+
+struct HIDOutputEntry {
+    HIDReportSink* sink;
+    uint32_t generation;
+    uint32_t value;      // DELAY: milliseconds, MEDIA: key, EXECUTING: flag
+    uint8_t type;
+    HIDKeyReport report;
+};
+
+// Drains timed HID output on its own FreeRTOS task pinned to the core
+// that does not run loop(), so UI work does not add keystroke jitter.
+// The parser/UI side only produces into a lock-free SPSC queue.
+class HIDOutputTask {
+private:
+    static const size_t QUEUE_SIZE = 128;
+    
+    SpscQueue<HIDOutputEntry, QUEUE_SIZE> queue;
+    TaskHandle_t task;
+    std::atomic<uint32_t> generation; // Bumped by cancel() to drop queued output
+    std::atomic<bool> busy;
+    std::atomic<uint32_t> firstReportTime; // millis() of the first report of the payload, 0 before
+    HIDReportSink* lastSink;
+    uint32_t activeGeneration;
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    HIDReportDecoder decoder;  // What the host sees, for typing statistics
+#endif
+    
+    static void taskMain(void* arg);
+    void run();
+    void push(const HIDOutputEntry& entry);
+    void dispatch(const HIDOutputEntry& entry);
+    void wait(uint32_t ms, uint32_t entryGeneration);
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    void logStats();
+#endif
+    
+public:
+    HIDOutputTask();
+    
+    bool begin();
+    bool isRunning() { return task != nullptr; }
+    
+    // Producer side (loop task)
+    void pushReport(HIDReportSink* sink, const HIDKeyReport& report);
+    void pushMediaKey(HIDReportSink* sink, uint8_t mediaKey);
+    void pushHold(HIDReportSink* sink);
+    void pushDelay(uint32_t ms);
+    void pushExecuting(HIDReportSink* sink, bool executing);
+    
+    bool isIdle();  // Nothing queued or in flight
+    uint32_t getFirstReportTime() { return firstReportTime; }
+    size_t space(); // Entries that can be pushed without blocking
+    void cancel();  // Drop queued output and release all keys
+    
+    // Output task side: the entry being written was cancelled, so a sink
+    // waiting on its link can give up on it
+    bool isCancelled() { return task && generation.load() != activeGeneration; }
+};
+
+extern HIDOutputTask HIDOutput;
+
+#endif // HID_OUTPUT_TASK_H
\ No newline at end of file
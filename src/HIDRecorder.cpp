@@ -0,0 +1,168 @@
+#include "HIDRecorder.h"
+#include "Log.h"
+
+HIDRecorder::HIDRecorder() {
+    file = nullptr;
+    forward = nullptr;
+    buffered = 0;
+    recordCount = 0;
+    pendingDelay = 0;
+    failed = false;
+}
+
+bool HIDRecorder::begin(fs::File& output, const HIDRSource& source, HIDDevice* device) {
+    if (!output) return false;
+    
+    file = &output;
+    forward = device;
+    buffered = 0;
+    recordCount = 0;
+    pendingDelay = 0;
+    failed = false;
+    
+    HIDRHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HIDR_MAGIC, sizeof(header.magic));
+    header.version = HIDR_VERSION;
+    strncpy(header.layout, HIDReportEncoder::getLayout()->name, HIDR_LAYOUT_SIZE - 1);
+    header.layout[HIDR_LAYOUT_SIZE - 1] = '\0';
+    header.source = source;
+    
+    if (file->write((const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        failed = true;
+    }
+    return !failed;
+}
+
+bool HIDRecorder::end() {
+    if (!file) return false;
+    
+    writeDelay();
+    flush();
+    file = nullptr;
+    forward = nullptr;
+    
+    LOG_INFO("Recorded %u HID records", recordCount);
+    return !failed;
+}
+
+void HIDRecorder::write(const HIDRecord& record) {
+    buffer[buffered++] = record;
+    recordCount++;
+    if (buffered == BUFFER_RECORDS) flush();
+}
+
+void HIDRecorder::writeReport(const HIDKeyReport& report) {
+    writeDelay();
+    
+    HIDRecord record;
+    record.type = HIDR_REPORT;
+    record.modifiers = report.modifiers;
+    memcpy(record.data, report.keys, sizeof(record.data));
+    write(record);
+    
+    if (forward) forward->sendReport(report);
+}
+
+void HIDRecorder::writeDelay() {
+    if (pendingDelay == 0) return;
+    
+    HIDRecord record;
+    memset(&record, 0, sizeof(record));
+    record.type = HIDR_DELAY;
+    record.data[2] = pendingDelay & 0xFF;
+    record.data[3] = (pendingDelay >> 8) & 0xFF;
+    record.data[4] = (pendingDelay >> 16) & 0xFF;
+    record.data[5] = (pendingDelay >> 24) & 0xFF;
+    pendingDelay = 0;
+    write(record);
+}
+
+void HIDRecorder::flush() {
+    if (buffered == 0) return;
+    
+    size_t size = buffered * sizeof(HIDRecord);
+    if (file->write((const uint8_t*)buffer, size) != size) {
+        if (!failed) LOG_ERROR("HID record write failed");
+        failed = true;
+    }
+    buffered = 0;
+}
+
+void HIDRecorder::sendKey(uint8_t key, uint8_t modifiers) {
+    if (!file) return;
+    
+    // Same press, hold, release sequence as the live backends
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    report.modifiers = modifiers;
+    
+    uint8_t usage = 0;
+    if (key != 0 && HIDReportEncoder::keyToUsage(key, usage, report.modifiers)) {
+        report.keys[0] = usage;
+    }
+    writeReport(report);
+    sendHold();
+    
+    memset(&report, 0, sizeof(report));
+    writeReport(report);
+}
+
+void HIDRecorder::sendString(const String& text) {
+    sendText(text.c_str(), text.length());
+}
+
+void HIDRecorder::sendText(const char* text, size_t length) {
+    if (!file) return;
+    
+    HIDKeyReport report;
+    encoder.begin(text, length);
+    while (encoder.next(report)) {
+        writeReport(report);
+    }
+}
+
+void HIDRecorder::sendKeySequence(const char* keys, size_t length) {
+    // Not supported by the live backends either
+    if (forward) forward->sendKeySequence(keys, length);
+}
+
+void HIDRecorder::sendMediaKey(uint8_t mediaKey) {
+    if (!file || mediaKey >= MEDIA_KEY_COUNT) return;
+    writeDelay();
+    
+    HIDRecord record;
+    memset(&record, 0, sizeof(record));
+    record.type = HIDR_MEDIA;
+    record.modifiers = mediaKey;
+    write(record);
+    
+    if (forward) forward->sendMediaKey(mediaKey);
+}
+
+void HIDRecorder::sendReport(const HIDKeyReport& report) {
+    if (!file) return;
+    writeReport(report);
+}
+
+void HIDRecorder::sendHold() {
+    if (!file) return;
+    writeDelay();
+    
+    HIDRecord record;
+    memset(&record, 0, sizeof(record));
+    record.type = HIDR_HOLD;
+    write(record);
+    
+    if (forward) forward->sendHold();
+}
+
+void HIDRecorder::delay(uint32_t ms) {
+    pendingDelay += ms;
+    if (forward) forward->delay(ms);
+}
+
+bool HIDRecorder::isConnected() {
+    if (!file) return false;
+    return !forward || forward->isConnected();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef HID_RECORDER_H
+#define HID_RECORDER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "DuckyScriptParser.h"
+#include "HIDReportFile.h"
+
+// HIDDevice that writes everything the parser sends to a .hidr file.
+// On its own, delays are recorded instead of waited for, so a payload
+// compiles as fast as it parses. With a forward device the recorder sits
+// in front of a live backend and sends it exactly the recorded reports.
+class HIDRecorder : public HIDDevice {
+private:
+    static const size_t BUFFER_RECORDS = 64;
+    
+    fs::File* file;
+    HIDDevice* forward;
+    HIDRecord buffer[BUFFER_RECORDS];
+    size_t buffered;
+    uint32_t recordCount;
+    uint32_t pendingDelay;  // Back-to-back delays are merged
+    bool failed;
+    HIDReportEncoder encoder;
+    
+    void write(const HIDRecord& record);
+    void writeReport(const HIDKeyReport& report);
+    void writeDelay();
+    void flush();
+    
+public:
+    HIDRecorder();
+    
+    bool begin(fs::File& output, const HIDRSource& source, HIDDevice* device = nullptr);
+    bool end();  // Flush, returns false if a write failed
+    uint32_t getRecordCount() { return recordCount; }
+    
+    // HIDDevice interface implementation
+    void sendKey(uint8_t key, uint8_t modifiers = 0) override;
+    void sendString(const String& text) override;
+    void sendText(const char* text, size_t length) override;
+    void sendKeySequence(const char* keys, size_t length) override;
+    void sendMediaKey(uint8_t mediaKey) override;
+    void sendReport(const HIDKeyReport& report) override;
+    void sendHold() override;
+    void delay(uint32_t ms) override;
+    bool isConnected() override;
+    bool isRealtime() override { return forward != nullptr; }
+    
+    // Forwarded to the live backend
+    void setExecuting(bool executing) override { if (forward) forward->setExecuting(executing); }
+    bool isIdle() override { return !forward || forward->isIdle(); }
+    void cancel() override { if (forward) forward->cancel(); }
+    size_t outputSpace() override { return forward ? forward->outputSpace() : SIZE_MAX; }
+    uint32_t reportTimeUs() override { return forward ? forward->reportTimeUs() : HIDDevice::reportTimeUs(); }
+    uint32_t keyTimeUs() override { return forward ? forward->keyTimeUs() : HIDDevice::keyTimeUs(); }
+};
+
+#endif // HID_RECORDER_H
\ No newline at end of file
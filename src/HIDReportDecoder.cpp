@@ -0,0 +1,161 @@
+#include "HIDReportDecoder.h"
+
+#define MOD_SHIFT_ANY 0x22  // Left or right shift
+#define MOD_COMMAND   0x9D  // Ctrl or GUI on either side, left Alt
+#define USAGE_ROLLOVER 0x01
+
+const uint32_t HIDReportDecoder::GAP_LIMITS[DECODER_GAP_BUCKETS] = {
+    1000, 2000, 5000, 10000, 20000, 0xFFFFFFFF
+};
+
+char HIDReportDecoder::usageChars[DECODER_LEVELS][DECODER_USAGE_COUNT];
+const KeyboardLayout* HIDReportDecoder::tablesLayout = nullptr;
+
+HIDReportDecoder::HIDReportDecoder() {
+    reset();
+}
+
+void HIDReportDecoder::buildTables() {
+    const KeyboardLayout* layout = HIDReportEncoder::getLayout();
+    if (tablesLayout == layout) return;
+    
+    // Invert the encoder's layout so both directions always agree
+    memset(usageChars, 0, sizeof(usageChars));
+    for (uint32_t c = 0xFF; c > 0; c--) {
+        LayoutKey key;
+        if (!layout->lookup(c, key)) continue;
+        
+        if (key.deadUsage != 0) {
+            if (key.deadUsage < DECODER_USAGE_COUNT) {
+                usageChars[levelOf(key.deadModifiers)][key.deadUsage] = DECODER_DEAD_KEY;
+            }
+        } else if (key.usage < DECODER_USAGE_COUNT) {
+            usageChars[levelOf(key.modifiers)][key.usage] = c < 0x80 ? (char)c : DECODER_NON_ASCII;
+        }
+    }
+    for (uint8_t i = 0; i < layout->extraCount; i++) {
+        const LayoutKey& key = layout->extra[i].key;
+        if (key.deadUsage == 0 && key.usage < DECODER_USAGE_COUNT) {
+            usageChars[levelOf(key.modifiers)][key.usage] = DECODER_NON_ASCII;
+        }
+    }
+    tablesLayout = layout;
+}
+
+uint8_t HIDReportDecoder::levelOf(uint8_t modifiers) {
+    return ((modifiers & MOD_SHIFT_ANY) ? 1 : 0) | ((modifiers & LAYOUT_MOD_ALTGR) ? 2 : 0);
+}
+
+void HIDReportDecoder::reset() {
+    buildTables();
+    memset(&previous, 0, sizeof(previous));
+    startUs = 0;
+    lastReportUs = 0;
+    reports = 0;
+    chars = 0;
+    keyEvents = 0;
+    repeatRisks = 0;
+    memset(gapHistogram, 0, sizeof(gapHistogram));
+    preview[0] = '\0';
+    previewLength = 0;
+    pendingDead = 0;
+    pendingDeadLevel = 0;
+}
+
+void HIDReportDecoder::feed(const HIDKeyReport& report, unsigned long timeUs) {
+    if (reports == 0) {
+        startUs = timeUs;
+    } else {
+        unsigned long gap = timeUs - lastReportUs;
+        for (uint8_t i = 0; i < DECODER_GAP_BUCKETS; i++) {
+            if (gap < GAP_LIMITS[i] || i == DECODER_GAP_BUCKETS - 1) {
+                gapHistogram[i]++;
+                break;
+            }
+        }
+        
+        // Host starts autorepeat if a key stays down this long
+        bool held = false;
+        for (uint8_t i = 0; i < sizeof(previous.keys); i++) {
+            if (previous.keys[i] != 0) held = true;
+        }
+        if (held && gap >= HOST_REPEAT_DELAY_MS * 1000UL) repeatRisks++;
+    }
+    reports++;
+    lastReportUs = timeUs;
+    
+    // Phantom state, the host ignores the whole report
+    if (report.keys[0] == USAGE_ROLLOVER) return;
+    
+    for (uint8_t i = 0; i < sizeof(report.keys); i++) {
+        uint8_t usage = report.keys[i];
+        if (usage == 0 || wasPressed(usage)) continue;
+        
+        // Newly pressed key
+        char c = (report.modifiers & MOD_COMMAND) ? 0 : usageToChar(usage, report.modifiers);
+        if (c == DECODER_DEAD_KEY && !pendingDead) {
+            // Produces nothing until the next key
+            pendingDead = usage;
+            pendingDeadLevel = levelOf(report.modifiers);
+            continue;
+        }
+        if (pendingDead) {
+            c = compose(usage, levelOf(report.modifiers));
+            pendingDead = 0;
+        }
+        
+        if (c == '\b') {
+            keyEvents++;
+            if (previewLength > 0) preview[--previewLength] = '\0';
+        } else if (c != 0) {
+            type(c);
+        } else {
+            keyEvents++;
+        }
+    }
+    previous = report;
+}
+
+bool HIDReportDecoder::wasPressed(uint8_t usage) {
+    for (uint8_t i = 0; i < sizeof(previous.keys); i++) {
+        if (previous.keys[i] == usage) return true;
+    }
+    return false;
+}
+
+void HIDReportDecoder::type(char c) {
+    chars++;
+    
+    if (previewLength == DECODER_PREVIEW_SIZE - 1) {
+        // Keep the most recent text
+        memmove(preview, preview + 1, previewLength - 1);
+        previewLength--;
+    }
+    preview[previewLength++] = c;
+    preview[previewLength] = '\0';
+}
+
+char HIDReportDecoder::compose(uint8_t usage, uint8_t level) {
+    // Find the character the layout types with this dead key sequence
+    const KeyboardLayout* layout = HIDReportEncoder::getLayout();
+    for (uint32_t c = 1; c <= 0xFF; c++) {
+        LayoutKey key;
+        if (layout->lookup(c, key) && key.deadUsage == pendingDead && levelOf(key.deadModifiers) == pendingDeadLevel &&
+            key.usage == usage && levelOf(key.modifiers) == level) {
+            return c < 0x80 ? (char)c : DECODER_NON_ASCII;
+        }
+    }
+    return DECODER_NON_ASCII;
+}
+
+uint32_t HIDReportDecoder::getCharsPerSecond() {
+    unsigned long elapsed = lastReportUs - startUs;
+    if (reports < 2 || elapsed == 0) return 0;
+    return (uint32_t)((uint64_t)chars * 1000000ULL / elapsed);
+}
+
+char HIDReportDecoder::usageToChar(uint8_t usage, uint8_t modifiers) {
+    buildTables();
+    if (usage >= DECODER_USAGE_COUNT) return 0;
+    return usageChars[levelOf(modifiers)][usage];
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef HID_REPORT_DECODER_H
+#define HID_REPORT_DECODER_H
+
+#include <Arduino.h>
+#include "HIDReportEncoder.h"
+
+#define DECODER_USAGE_COUNT   0x68  // Usages that can map to characters
+#define DECODER_LEVELS        4     // None, Shift, AltGr, Shift+AltGr
+#define DECODER_DEAD_KEY      '\x01' // Table marker for dead keys
+#define DECODER_NON_ASCII     '?'    // Shown for characters outside ASCII
+#define DECODER_PREVIEW_SIZE  64    // Last typed characters kept for preview
+#define DECODER_GAP_BUCKETS   6
+#define HOST_REPEAT_DELAY_MS  500   // Typical host autorepeat delay
+
+// Plays the role of the host: consumes the report stream as it goes out,
+// applies boot keyboard semantics (a key is typed when it appears in a
+// report, modifiers apply to it, keys held across reports do not repeat)
+// and rebuilds what the host sees. Used for typing statistics and to
+// verify that an encoder change still produces the intended text.
+class HIDReportDecoder {
+private:
+    HIDKeyReport previous;
+    unsigned long startUs;
+    unsigned long lastReportUs;
+    uint32_t reports;
+    uint32_t chars;
+    uint32_t keyEvents;        // Presses that do not produce a character
+    uint32_t repeatRisks;      // Keys held long enough for host autorepeat
+    uint32_t gapHistogram[DECODER_GAP_BUCKETS];
+    char preview[DECODER_PREVIEW_SIZE];
+    uint8_t previewLength;
+    uint8_t pendingDead;       // Dead key waiting for the next key
+    uint8_t pendingDeadLevel;
+    
+    // Inverse of the active keyboard layout, rebuilt when it changes
+    static char usageChars[DECODER_LEVELS][DECODER_USAGE_COUNT];
+    static const KeyboardLayout* tablesLayout;
+    static void buildTables();
+    static uint8_t levelOf(uint8_t modifiers);
+    
+    bool wasPressed(uint8_t usage);
+    char compose(uint8_t usage, uint8_t level);
+    void type(char c);
+    
+public:
+    HIDReportDecoder();
+    
+    void reset();
+    void feed(const HIDKeyReport& report, unsigned long timeUs);
+    
+    uint32_t getReports() { return reports; }
+    uint32_t getChars() { return chars; }
+    uint32_t getKeyEvents() { return keyEvents; }
+    uint32_t getRepeatRisks() { return repeatRisks; }
+    uint32_t getCharsPerSecond();
+    const uint32_t* getGapHistogram() { return gapHistogram; }
+    const char* getPreview() { return preview; } // Null-terminated
+    
+    // Upper bound in microseconds of each inter-report gap bucket
+    static const uint32_t GAP_LIMITS[DECODER_GAP_BUCKETS];
+    
+    // Map a usage ID back to the ASCII character it types with the active
+    // layout, DECODER_DEAD_KEY for dead keys, 0 if none
+    static char usageToChar(uint8_t usage, uint8_t modifiers);
+};
+
+#endif // HID_REPORT_DECODER_H
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "HIDReportEncoder.h"
+
+#define DEAD_NONE     0
+#define DEAD_PRESSED  1
+#define DEAD_RELEASED 2
+
+const KeyboardLayout* HIDReportEncoder::layout = &KEYBOARD_LAYOUTS[0];
+
+void HIDReportEncoder::setLayout(const KeyboardLayout* newLayout) {
+    if (newLayout) layout = newLayout;
+}
+
+HIDReportEncoder::HIDReportEncoder() {
+    begin(nullptr, 0);
+}
+
+void HIDReportEncoder::begin(const char* text, size_t length) {
+    this->text = text;
+    this->length = length;
+    position = 0;
+    memset(&current, 0, sizeof(current));
+    keyCount = 0;
+    deadPhase = DEAD_NONE;
+}
+
+bool HIDReportEncoder::next(HIDKeyReport& report) {
+    while (position < length) {
+        uint32_t codepoint;
+        uint8_t size = decodeUtf8(text + position, length - position, codepoint);
+        
+        LayoutKey key;
+        if (!layout->lookup(codepoint, key)) {
+            // Not typeable, skip
+            position += size;
+            continue;
+        }
+        
+        if (key.deadUsage != 0 && deadPhase == DEAD_NONE) {
+            // Dead key goes down on its own
+            if (keyCount > 0) return release(report);
+            current.modifiers = key.deadModifiers;
+            current.keys[0] = key.deadUsage;
+            keyCount = 1;
+            deadPhase = DEAD_PRESSED;
+            report = current;
+            return true;
+        }
+        if (deadPhase == DEAD_PRESSED) {
+            deadPhase = DEAD_RELEASED;
+            return release(report);
+        }
+        
+        if (keyCount > 0 && (key.modifiers != current.modifiers || keyCount == sizeof(current.keys) || isPressed(key.usage))) {
+            // Release everything before this key can be pressed
+            return release(report);
+        }
+        
+        current.modifiers = key.modifiers;
+        current.keys[keyCount++] = key.usage;
+        deadPhase = DEAD_NONE;
+        position += size;
+        report = current;
+        return true;
+    }
+    
+    // Final release
+    if (keyCount > 0) {
+        return release(report);
+    }
+    return false;
+}
+
+bool HIDReportEncoder::release(HIDKeyReport& report) {
+    memset(&current, 0, sizeof(current));
+    keyCount = 0;
+    report = current;
+    return true;
+}
+
+bool HIDReportEncoder::isPressed(uint8_t usage) {
+    for (uint8_t i = 0; i < keyCount; i++) {
+        if (current.keys[i] == usage) return true;
+    }
+    return false;
+}
+
+bool HIDReportEncoder::charToUsage(char c, uint8_t& usage, uint8_t& modifiers) {
+    LayoutKey key;
+    if ((uint8_t)c >= 0x80 || !layout->lookup((uint8_t)c, key)) return false;
+    
+    usage = key.usage;
+    modifiers |= key.modifiers;
+    return true;
+}
+
+bool HIDReportEncoder::keyToUsage(uint8_t key, uint8_t& usage, uint8_t& modifiers) {
+    if (key >= 0x88) {
+        // Raw usage ID
+        usage = key - 0x88;
+        return true;
+    }
+    if (key >= 0x80) {
+        // Modifier key
+        modifiers |= 1 << (key - 0x80);
+        usage = 0;
+        return true;
+    }
+    return charToUsage((char)key, usage, modifiers);
+}
+
+uint8_t HIDReportEncoder::decodeUtf8(const char* text, size_t length, uint32_t& codepoint) {
+    uint8_t lead = (uint8_t)text[0];
+    if (lead < 0x80) {
+        codepoint = lead;
+        return 1;
+    }
+    
+    uint8_t size;
+    if ((lead & 0xE0) == 0xC0) {
+        size = 2;
+        codepoint = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        size = 3;
+        codepoint = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        size = 4;
+        codepoint = lead & 0x07;
+    } else {
+        codepoint = 0xFFFD;
+        return 1;
+    }
+    
+    if (size > length) {
+        codepoint = 0xFFFD;
+        return 1;
+    }
+    for (uint8_t i = 1; i < size; i++) {
+        uint8_t byte = (uint8_t)text[i];
+        if ((byte & 0xC0) != 0x80) {
+            codepoint = 0xFFFD;
+            return i;
+        }
+        codepoint = (codepoint << 6) | (byte & 0x3F);
+    }
+    return size;
+}
\ No newline at end of file
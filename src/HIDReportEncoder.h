@@ -0,0 +1,61 @@
+#ifndef HID_REPORT_ENCODER_H
+#define HID_REPORT_ENCODER_H
+
+#include <Arduino.h>
+#include "KeyboardLayout.h"
+
+// Boot protocol keyboard report
+struct HIDKeyReport {
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[6];
+};
+
+// Turns text into a minimal sequence of keyboard reports.
+// Each report presses exactly one more key, so the order the host sees is
+// unambiguous, and keys are only released when a key repeats, the modifier
+// state changes or all six slots are in use. This roughly halves the
+// number of reports compared to a press/release pair per character.
+// Text is UTF-8 and typed with the active host keyboard layout; characters
+// behind a dead key are sent as dead key press, release, then the key.
+class HIDReportEncoder {
+private:
+    const char* text;
+    size_t length;
+    size_t position;
+    HIDKeyReport current;
+    uint8_t keyCount;
+    uint8_t deadPhase;
+    
+    static const KeyboardLayout* layout;
+    
+    bool isPressed(uint8_t usage);
+    bool release(HIDKeyReport& report);
+    
+public:
+    HIDReportEncoder();
+    
+    void begin(const char* text, size_t length);
+    
+    // Get the next report. Returns false once the text is fully typed and
+    // all keys have been released.
+    bool next(HIDKeyReport& report);
+    
+    // Map an ASCII character to a usage ID and modifiers (active layout,
+    // dead keys are not applied)
+    static bool charToUsage(char c, uint8_t& usage, uint8_t& modifiers);
+    
+    // Map an Arduino Keyboard key code (ASCII, 0x80-0x87 modifiers,
+    // 0x88+ raw usage) to a usage ID and modifiers
+    static bool keyToUsage(uint8_t key, uint8_t& usage, uint8_t& modifiers);
+    
+    // Decode one UTF-8 sequence, returns its length in bytes (at least 1).
+    // Malformed input decodes to 0xFFFD.
+    static uint8_t decodeUtf8(const char* text, size_t length, uint32_t& codepoint);
+    
+    // Host keyboard layout used by all encoders (US by default)
+    static void setLayout(const KeyboardLayout* newLayout);
+    static const KeyboardLayout* getLayout() { return layout; }
+};
+
+#endif // HID_REPORT_ENCODER_H
\ No newline at end of file
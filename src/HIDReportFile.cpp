@@ -0,0 +1,64 @@
+#include "HIDReportFile.h"
+#include "Log.h"
+
+#define HEADER_RECORDS (sizeof(HIDRHeader) / sizeof(HIDRecord))
+
+uint32_t HIDRecord::delayMs() const {
+    return (uint32_t)data[2] | ((uint32_t)data[3] << 8) |
+           ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 24);
+}
+
+void HIDRecord::toReport(HIDKeyReport& report) const {
+    report.modifiers = modifiers;
+    report.reserved = 0;
+    memcpy(report.keys, data, sizeof(report.keys));
+}
+
+HIDReportReader::HIDReportReader() {
+    file = nullptr;
+    head = 0;
+    count = 0;
+}
+
+bool HIDReportReader::begin(fs::File* source, HIDRHeader& header) {
+    file = source;
+    head = 0;
+    
+    // The header shares the first sector with the records, so every read
+    // starts on a sector boundary of the file
+    count = file->read((uint8_t*)block, FIRST_READ) / sizeof(HIDRecord);
+    if (count < HEADER_RECORDS) {
+        end();
+        return false;
+    }
+    memcpy(&header, block, sizeof(header));
+    head = HEADER_RECORDS;
+    
+    if (memcmp(header.magic, HIDR_MAGIC, sizeof(header.magic)) != 0 || header.version != HIDR_VERSION) {
+        LOG_WARN("Not a HID report file (version %u)", header.version);
+        end();
+        return false;
+    }
+    header.layout[HIDR_LAYOUT_SIZE - 1] = '\0';
+    return true;
+}
+
+void HIDReportReader::end() {
+    file = nullptr;
+    head = 0;
+    count = 0;
+}
+
+bool HIDReportReader::next(HIDRecord& record) {
+    if (head >= count) {
+        if (!file) return false;
+    
+        size_t bytes = file->read((uint8_t*)block, BLOCK_SIZE);
+        head = 0;
+        count = bytes / sizeof(HIDRecord);
+        if (count == 0) return false;
+    }
+    
+    record = block[head++];
+    return true;
+}
\ No newline at end of file
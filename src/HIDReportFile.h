@@ -0,0 +1,79 @@
+#ifndef HID_REPORT_FILE_H
+#define HID_REPORT_FILE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "HIDReportEncoder.h"
+
+// Pre-rendered report stream (.hidr). A DuckyScript payload is run once
+// into a HIDRecorder (HIDRecorder.h), which stores the already encoded
+// reports and the delays between them. Playback just copies records into
+// the output queue, nothing is parsed or encoded.
+//
+// The file is a 32 byte header followed by 8 byte records. Every record
+// has the size of a keyboard report, so a block of whole sectors always
+// holds whole records.
+#define HIDR_MAGIC          "HIDR"
+#define HIDR_VERSION        1
+#define HIDR_EXTENSION      ".hidr"
+#define HIDR_LAYOUT_SIZE    8
+
+// Script the stream was recorded from, all zero if unknown
+struct HIDRSource {
+    uint32_t size;
+    uint32_t modified;  // Last write time
+    uint32_t hash;      // FNV-1a of the content
+    uint32_t reserved;
+};
+
+struct HIDRHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t reserved[3];
+    char layout[HIDR_LAYOUT_SIZE];  // Host layout the reports were encoded for
+    HIDRSource source;
+};
+
+enum HIDRRecordType : uint8_t {
+    HIDR_REPORT = 1,   // modifiers + keys
+    HIDR_HOLD,         // Keep keys down for one report slot (BLE)
+    HIDR_DELAY,        // data[2..5] = milliseconds, little endian
+    HIDR_MEDIA         // modifiers = MediaKey
+};
+
+// Same layout as HIDKeyReport, the reserved byte holds the record type
+struct HIDRecord {
+    uint8_t type;
+    uint8_t modifiers;
+    uint8_t data[6];
+    
+    uint32_t delayMs() const;
+    void toReport(HIDKeyReport& report) const;
+};
+
+// Reads .hidr records in sector sized blocks into a word aligned buffer,
+// so the SD driver can transfer straight into it. The first read is one
+// sector, so playback starts without waiting for a whole block.
+class HIDReportReader {
+public:
+    static const size_t BLOCK_SIZE = 4096;
+    static const size_t FIRST_READ = 512;
+    
+private:
+    fs::File* file;
+    HIDRecord block[BLOCK_SIZE / sizeof(HIDRecord)];
+    size_t head;
+    size_t count;
+    
+public:
+    HIDReportReader();
+    
+    // Check the header, the file is positioned at the first record
+    bool begin(fs::File* source, HIDRHeader& header);
+    void end();
+    
+    // Returns false at end of file
+    bool next(HIDRecord& record);
+};
+
+#endif // HID_REPORT_FILE_H
\ No newline at end of file
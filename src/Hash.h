@@ -0,0 +1,22 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <Arduino.h>
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+// 32-bit FNV-1a, pass FNV_OFFSET to start and the previous result to continue
+inline uint32_t fnv1a(uint32_t hash, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+inline uint32_t fnv1a(uint32_t hash, const String& text) {
+    return fnv1a(hash, (const uint8_t*)text.c_str(), text.length());
+}
+
+#endif // HASH_H
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "KeyboardLayout.h"
+
+bool KeyboardLayout::lookup(uint32_t codepoint, LayoutKey& key) const {
+    const LayoutKey* entry = nullptr;
+    
+    if (codepoint < 0x80) {
+        entry = &ascii[codepoint];
+    } else if (codepoint >= 0xA0 && codepoint <= 0xFF) {
+        if (latin1) entry = &latin1[codepoint - 0xA0];
+    } else {
+        // Few entries (currency signs), binary search
+        int low = 0;
+        int high = (int)extraCount - 1;
+        while (low <= high) {
+            int mid = (low + high) / 2;
+            if (extra[mid].codepoint == codepoint) {
+                entry = &extra[mid].key;
+                break;
+            }
+            if (extra[mid].codepoint < codepoint) {
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+    }
+    
+    if (!entry || entry->usage == 0) return false;
+    key = *entry;
+    return true;
+}
+
+const KeyboardLayout* findKeyboardLayout(const char* name) {
+    for (size_t i = 0; i < KEYBOARD_LAYOUT_COUNT; i++) {
+        if (strcasecmp(KEYBOARD_LAYOUTS[i].name, name) == 0) {
+            return &KEYBOARD_LAYOUTS[i];
+        }
+    }
+    return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef KEYBOARD_LAYOUT_H
+#define KEYBOARD_LAYOUT_H
+
+#include <Arduino.h>
+
+#define LAYOUT_MOD_SHIFT 0x02
+#define LAYOUT_MOD_ALTGR 0x40  // Right Alt
+
+// How to type one character: an optional dead key, then the key itself.
+// A usage of 0 means the layout cannot type the character.
+struct LayoutKey {
+    uint8_t usage;
+    uint8_t modifiers;
+    uint8_t deadUsage;
+    uint8_t deadModifiers;
+};
+
+struct LayoutExtraKey {
+    uint16_t codepoint;
+    LayoutKey key;
+};
+
+// Host keyboard layout. Tables are generated by tools/gen_layouts.py and
+// live in flash; ASCII and Latin-1 lookups are a direct index.
+struct KeyboardLayout {
+    const char* name;
+    const LayoutKey* ascii;        // U+0000-U+007F
+    const LayoutKey* latin1;       // U+00A0-U+00FF, nullptr if none
+    const LayoutExtraKey* extra;   // Other code points, sorted
+    uint8_t extraCount;
+    
+    bool lookup(uint32_t codepoint, LayoutKey& key) const;
+};
+
+extern const KeyboardLayout KEYBOARD_LAYOUTS[];
+extern const size_t KEYBOARD_LAYOUT_COUNT;
+
+// Find a layout by name (case-insensitive), nullptr if unknown
+const KeyboardLayout* findKeyboardLayout(const char* name);
+
+#endif // KEYBOARD_LAYOUT_H
\ No newline at end of file
@@ -0,0 +1,448 @@
+// Generated by tools/gen_layouts.py, do not edit by hand.
+#include "KeyboardLayout.h"
+
+static const LayoutKey US_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x34, 0x02, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0x24 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 }, { 0x34, 0x00, 0x00, 0x00 },
+    /* 0x28 */ { 0x26, 0x02, 0x00, 0x00 }, { 0x27, 0x02, 0x00, 0x00 }, { 0x25, 0x02, 0x00, 0x00 }, { 0x2E, 0x02, 0x00, 0x00 },
+    /* 0x2C */ { 0x36, 0x00, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x00, 0x00, 0x00 }, { 0x22, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x24, 0x00, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 }, { 0x33, 0x02, 0x00, 0x00 }, { 0x33, 0x00, 0x00, 0x00 },
+    /* 0x3C */ { 0x36, 0x02, 0x00, 0x00 }, { 0x2E, 0x00, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x1F, 0x02, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 }, { 0x2F, 0x00, 0x00, 0x00 },
+    /* 0x5C */ { 0x31, 0x00, 0x00, 0x00 }, { 0x30, 0x00, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x2D, 0x02, 0x00, 0x00 },
+    /* 0x60 */ { 0x35, 0x00, 0x00, 0x00 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x10, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 }, { 0x2F, 0x02, 0x00, 0x00 },
+    /* 0x7C */ { 0x31, 0x02, 0x00, 0x00 }, { 0x30, 0x02, 0x00, 0x00 }, { 0x35, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey UK_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x1F, 0x02, 0x00, 0x00 }, { 0x32, 0x00, 0x00, 0x00 },
+    /* 0x24 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 }, { 0x34, 0x00, 0x00, 0x00 },
+    /* 0x28 */ { 0x26, 0x02, 0x00, 0x00 }, { 0x27, 0x02, 0x00, 0x00 }, { 0x25, 0x02, 0x00, 0x00 }, { 0x2E, 0x02, 0x00, 0x00 },
+    /* 0x2C */ { 0x36, 0x00, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x00, 0x00, 0x00 }, { 0x22, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x24, 0x00, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 }, { 0x33, 0x02, 0x00, 0x00 }, { 0x33, 0x00, 0x00, 0x00 },
+    /* 0x3C */ { 0x36, 0x02, 0x00, 0x00 }, { 0x2E, 0x00, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x34, 0x02, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 }, { 0x2F, 0x00, 0x00, 0x00 },
+    /* 0x5C */ { 0x64, 0x00, 0x00, 0x00 }, { 0x30, 0x00, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x2D, 0x02, 0x00, 0x00 },
+    /* 0x60 */ { 0x35, 0x00, 0x00, 0x00 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x10, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 }, { 0x2F, 0x02, 0x00, 0x00 },
+    /* 0x7C */ { 0x64, 0x02, 0x00, 0x00 }, { 0x30, 0x02, 0x00, 0x00 }, { 0x32, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey UK_LATIN1[96] = {
+    /* 0xA0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0xA4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x35, 0x40, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xA8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xAC */ { 0x35, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xBC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xCC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xDC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xEC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xFC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutExtraKey UK_EXTRA[] = {
+    { 0x20AC, { 0x21, 0x40, 0x00, 0x00 } }
+};
+
+static const LayoutKey DE_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x1F, 0x02, 0x00, 0x00 }, { 0x32, 0x00, 0x00, 0x00 },
+    /* 0x24 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x32, 0x02, 0x00, 0x00 },
+    /* 0x28 */ { 0x25, 0x02, 0x00, 0x00 }, { 0x26, 0x02, 0x00, 0x00 }, { 0x30, 0x02, 0x00, 0x00 }, { 0x30, 0x00, 0x00, 0x00 },
+    /* 0x2C */ { 0x36, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x00, 0x00, 0x00 }, { 0x22, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x24, 0x00, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 }, { 0x36, 0x02, 0x00, 0x00 },
+    /* 0x3C */ { 0x64, 0x00, 0x00, 0x00 }, { 0x27, 0x02, 0x00, 0x00 }, { 0x64, 0x02, 0x00, 0x00 }, { 0x2D, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x14, 0x40, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x25, 0x40, 0x00, 0x00 },
+    /* 0x5C */ { 0x2D, 0x40, 0x00, 0x00 }, { 0x26, 0x40, 0x00, 0x00 }, { 0x2C, 0x00, 0x35, 0x00 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0x60 */ { 0x2C, 0x00, 0x2E, 0x02 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x10, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x24, 0x40, 0x00, 0x00 },
+    /* 0x7C */ { 0x64, 0x40, 0x00, 0x00 }, { 0x27, 0x40, 0x00, 0x00 }, { 0x30, 0x40, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey DE_LATIN1[96] = {
+    /* 0xA0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xA4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0xA8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xAC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB0 */ { 0x35, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x1F, 0x40, 0x00, 0x00 }, { 0x20, 0x40, 0x00, 0x00 },
+    /* 0xB4 */ { 0x2C, 0x00, 0x2E, 0x00 }, { 0x10, 0x40, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xBC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC0 */ { 0x04, 0x02, 0x2E, 0x02 }, { 0x04, 0x02, 0x2E, 0x00 }, { 0x04, 0x02, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC4 */ { 0x34, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC8 */ { 0x08, 0x02, 0x2E, 0x02 }, { 0x08, 0x02, 0x2E, 0x00 }, { 0x08, 0x02, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xCC */ { 0x0C, 0x02, 0x2E, 0x02 }, { 0x0C, 0x02, 0x2E, 0x00 }, { 0x0C, 0x02, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x12, 0x02, 0x2E, 0x02 }, { 0x12, 0x02, 0x2E, 0x00 },
+    /* 0xD4 */ { 0x12, 0x02, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x33, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x02, 0x2E, 0x02 }, { 0x18, 0x02, 0x2E, 0x00 }, { 0x18, 0x02, 0x35, 0x00 },
+    /* 0xDC */ { 0x2F, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x2E, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 },
+    /* 0xE0 */ { 0x04, 0x00, 0x2E, 0x02 }, { 0x04, 0x00, 0x2E, 0x00 }, { 0x04, 0x00, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE4 */ { 0x34, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE8 */ { 0x08, 0x00, 0x2E, 0x02 }, { 0x08, 0x00, 0x2E, 0x00 }, { 0x08, 0x00, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xEC */ { 0x0C, 0x00, 0x2E, 0x02 }, { 0x0C, 0x00, 0x2E, 0x00 }, { 0x0C, 0x00, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x2E, 0x02 }, { 0x12, 0x00, 0x2E, 0x00 },
+    /* 0xF4 */ { 0x12, 0x00, 0x35, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x33, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x2E, 0x02 }, { 0x18, 0x00, 0x2E, 0x00 }, { 0x18, 0x00, 0x35, 0x00 },
+    /* 0xFC */ { 0x2F, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x2E, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutExtraKey DE_EXTRA[] = {
+    { 0x20AC, { 0x08, 0x40, 0x00, 0x00 } }
+};
+
+static const LayoutKey FR_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 }, { 0x20, 0x40, 0x00, 0x00 },
+    /* 0x24 */ { 0x30, 0x00, 0x00, 0x00 }, { 0x34, 0x02, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x21, 0x00, 0x00, 0x00 },
+    /* 0x28 */ { 0x22, 0x00, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 }, { 0x32, 0x00, 0x00, 0x00 }, { 0x2E, 0x02, 0x00, 0x00 },
+    /* 0x2C */ { 0x10, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x36, 0x02, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x02, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x1F, 0x02, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x02, 0x00, 0x00 }, { 0x26, 0x02, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x36, 0x00, 0x00, 0x00 },
+    /* 0x3C */ { 0x64, 0x00, 0x00, 0x00 }, { 0x2E, 0x00, 0x00, 0x00 }, { 0x64, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x27, 0x40, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x33, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 }, { 0x22, 0x40, 0x00, 0x00 },
+    /* 0x5C */ { 0x25, 0x40, 0x00, 0x00 }, { 0x2D, 0x40, 0x00, 0x00 }, { 0x26, 0x40, 0x00, 0x00 }, { 0x25, 0x00, 0x00, 0x00 },
+    /* 0x60 */ { 0x2C, 0x00, 0x24, 0x40 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x33, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 }, { 0x21, 0x40, 0x00, 0x00 },
+    /* 0x7C */ { 0x23, 0x40, 0x00, 0x00 }, { 0x2E, 0x40, 0x00, 0x00 }, { 0x2C, 0x00, 0x1F, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey FR_LATIN1[96] = {
+    /* 0xA0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x30, 0x02, 0x00, 0x00 },
+    /* 0xA4 */ { 0x30, 0x40, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0xA8 */ { 0x2C, 0x00, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xAC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB0 */ { 0x2D, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x35, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x32, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xBC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC0 */ { 0x14, 0x02, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x14, 0x02, 0x2F, 0x00 }, { 0x14, 0x02, 0x1F, 0x40 },
+    /* 0xC4 */ { 0x14, 0x02, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC8 */ { 0x08, 0x02, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x08, 0x02, 0x2F, 0x00 }, { 0x08, 0x02, 0x2F, 0x02 },
+    /* 0xCC */ { 0x0C, 0x02, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x0C, 0x02, 0x2F, 0x00 }, { 0x0C, 0x02, 0x2F, 0x02 },
+    /* 0xD0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x11, 0x02, 0x1F, 0x40 }, { 0x12, 0x02, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD4 */ { 0x12, 0x02, 0x2F, 0x00 }, { 0x12, 0x02, 0x1F, 0x40 }, { 0x12, 0x02, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x02, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x02, 0x2F, 0x00 },
+    /* 0xDC */ { 0x18, 0x02, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE0 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x2F, 0x00 }, { 0x14, 0x00, 0x1F, 0x40 },
+    /* 0xE4 */ { 0x14, 0x00, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 },
+    /* 0xE8 */ { 0x24, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x2F, 0x00 }, { 0x08, 0x00, 0x2F, 0x02 },
+    /* 0xEC */ { 0x0C, 0x00, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x2F, 0x00 }, { 0x0C, 0x00, 0x2F, 0x02 },
+    /* 0xF0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x1F, 0x40 }, { 0x12, 0x00, 0x24, 0x40 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF4 */ { 0x12, 0x00, 0x2F, 0x00 }, { 0x12, 0x00, 0x1F, 0x40 }, { 0x12, 0x00, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x34, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x2F, 0x00 },
+    /* 0xFC */ { 0x18, 0x00, 0x2F, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x2F, 0x02 }
+};
+
+static const LayoutExtraKey FR_EXTRA[] = {
+    { 0x20AC, { 0x08, 0x40, 0x00, 0x00 } }
+};
+
+static const LayoutKey ES_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x1F, 0x02, 0x00, 0x00 }, { 0x20, 0x40, 0x00, 0x00 },
+    /* 0x24 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 },
+    /* 0x28 */ { 0x25, 0x02, 0x00, 0x00 }, { 0x26, 0x02, 0x00, 0x00 }, { 0x30, 0x02, 0x00, 0x00 }, { 0x30, 0x00, 0x00, 0x00 },
+    /* 0x2C */ { 0x36, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x00, 0x00, 0x00 }, { 0x22, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x24, 0x00, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 }, { 0x36, 0x02, 0x00, 0x00 },
+    /* 0x3C */ { 0x64, 0x00, 0x00, 0x00 }, { 0x27, 0x02, 0x00, 0x00 }, { 0x64, 0x02, 0x00, 0x00 }, { 0x2D, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x1F, 0x40, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 }, { 0x2F, 0x40, 0x00, 0x00 },
+    /* 0x5C */ { 0x35, 0x40, 0x00, 0x00 }, { 0x30, 0x40, 0x00, 0x00 }, { 0x2C, 0x00, 0x2F, 0x02 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0x60 */ { 0x2C, 0x00, 0x2F, 0x00 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x10, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 }, { 0x34, 0x40, 0x00, 0x00 },
+    /* 0x7C */ { 0x1E, 0x40, 0x00, 0x00 }, { 0x32, 0x40, 0x00, 0x00 }, { 0x2C, 0x00, 0x21, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey ES_LATIN1[96] = {
+    /* 0xA0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x2E, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xA4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xA8 */ { 0x2C, 0x00, 0x34, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x35, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xAC */ { 0x23, 0x40, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB4 */ { 0x2C, 0x00, 0x34, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0xB8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x35, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xBC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x2E, 0x02, 0x00, 0x00 },
+    /* 0xC0 */ { 0x04, 0x02, 0x2F, 0x00 }, { 0x04, 0x02, 0x34, 0x00 }, { 0x04, 0x02, 0x2F, 0x02 }, { 0x04, 0x02, 0x21, 0x40 },
+    /* 0xC4 */ { 0x04, 0x02, 0x34, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x32, 0x02, 0x00, 0x00 },
+    /* 0xC8 */ { 0x08, 0x02, 0x2F, 0x00 }, { 0x08, 0x02, 0x34, 0x00 }, { 0x08, 0x02, 0x2F, 0x02 }, { 0x08, 0x02, 0x34, 0x02 },
+    /* 0xCC */ { 0x0C, 0x02, 0x2F, 0x00 }, { 0x0C, 0x02, 0x34, 0x00 }, { 0x0C, 0x02, 0x2F, 0x02 }, { 0x0C, 0x02, 0x34, 0x02 },
+    /* 0xD0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x33, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x2F, 0x00 }, { 0x12, 0x02, 0x34, 0x00 },
+    /* 0xD4 */ { 0x12, 0x02, 0x2F, 0x02 }, { 0x12, 0x02, 0x21, 0x40 }, { 0x12, 0x02, 0x34, 0x02 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x02, 0x2F, 0x00 }, { 0x18, 0x02, 0x34, 0x00 }, { 0x18, 0x02, 0x2F, 0x02 },
+    /* 0xDC */ { 0x18, 0x02, 0x34, 0x02 }, { 0x1C, 0x02, 0x34, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE0 */ { 0x04, 0x00, 0x2F, 0x00 }, { 0x04, 0x00, 0x34, 0x00 }, { 0x04, 0x00, 0x2F, 0x02 }, { 0x04, 0x00, 0x21, 0x40 },
+    /* 0xE4 */ { 0x04, 0x00, 0x34, 0x02 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x32, 0x00, 0x00, 0x00 },
+    /* 0xE8 */ { 0x08, 0x00, 0x2F, 0x00 }, { 0x08, 0x00, 0x34, 0x00 }, { 0x08, 0x00, 0x2F, 0x02 }, { 0x08, 0x00, 0x34, 0x02 },
+    /* 0xEC */ { 0x0C, 0x00, 0x2F, 0x00 }, { 0x0C, 0x00, 0x34, 0x00 }, { 0x0C, 0x00, 0x2F, 0x02 }, { 0x0C, 0x00, 0x34, 0x02 },
+    /* 0xF0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x33, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x2F, 0x00 }, { 0x12, 0x00, 0x34, 0x00 },
+    /* 0xF4 */ { 0x12, 0x00, 0x2F, 0x02 }, { 0x12, 0x00, 0x21, 0x40 }, { 0x12, 0x00, 0x34, 0x02 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x2F, 0x00 }, { 0x18, 0x00, 0x34, 0x00 }, { 0x18, 0x00, 0x2F, 0x02 },
+    /* 0xFC */ { 0x18, 0x00, 0x34, 0x02 }, { 0x1C, 0x00, 0x34, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x34, 0x02 }
+};
+
+static const LayoutExtraKey ES_EXTRA[] = {
+    { 0x20AC, { 0x08, 0x40, 0x00, 0x00 } }
+};
+
+static const LayoutKey IT_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x1F, 0x02, 0x00, 0x00 }, { 0x34, 0x40, 0x00, 0x00 },
+    /* 0x24 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 },
+    /* 0x28 */ { 0x25, 0x02, 0x00, 0x00 }, { 0x26, 0x02, 0x00, 0x00 }, { 0x30, 0x02, 0x00, 0x00 }, { 0x30, 0x00, 0x00, 0x00 },
+    /* 0x2C */ { 0x36, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x00, 0x00, 0x00 }, { 0x22, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x24, 0x00, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 }, { 0x36, 0x02, 0x00, 0x00 },
+    /* 0x3C */ { 0x64, 0x00, 0x00, 0x00 }, { 0x27, 0x02, 0x00, 0x00 }, { 0x64, 0x02, 0x00, 0x00 }, { 0x2D, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x33, 0x40, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 }, { 0x2F, 0x40, 0x00, 0x00 },
+    /* 0x5C */ { 0x35, 0x00, 0x00, 0x00 }, { 0x30, 0x40, 0x00, 0x00 }, { 0x2E, 0x02, 0x00, 0x00 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0x60 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x10, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 }, { 0x2F, 0x42, 0x00, 0x00 },
+    /* 0x7C */ { 0x35, 0x02, 0x00, 0x00 }, { 0x30, 0x42, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey IT_LATIN1[96] = {
+    /* 0xA0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0xA4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x32, 0x02, 0x00, 0x00 },
+    /* 0xA8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xAC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB0 */ { 0x34, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xBC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xCC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xDC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE0 */ { 0x34, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x33, 0x02, 0x00, 0x00 },
+    /* 0xE8 */ { 0x2F, 0x00, 0x00, 0x00 }, { 0x2F, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xEC */ { 0x2E, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x33, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF4 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x32, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xFC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutExtraKey IT_EXTRA[] = {
+    { 0x20AC, { 0x08, 0x40, 0x00, 0x00 } }
+};
+
+static const LayoutKey SE_ASCII[128] = {
+    /* 0x00 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x04 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x08 */ { 0x2A, 0x00, 0x00, 0x00 }, { 0x2B, 0x00, 0x00, 0x00 }, { 0x28, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x0C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x10 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x14 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x18 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x1C */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0x20 */ { 0x2C, 0x00, 0x00, 0x00 }, { 0x1E, 0x02, 0x00, 0x00 }, { 0x1F, 0x02, 0x00, 0x00 }, { 0x20, 0x02, 0x00, 0x00 },
+    /* 0x24 */ { 0x21, 0x40, 0x00, 0x00 }, { 0x22, 0x02, 0x00, 0x00 }, { 0x23, 0x02, 0x00, 0x00 }, { 0x32, 0x00, 0x00, 0x00 },
+    /* 0x28 */ { 0x25, 0x02, 0x00, 0x00 }, { 0x26, 0x02, 0x00, 0x00 }, { 0x32, 0x02, 0x00, 0x00 }, { 0x2D, 0x00, 0x00, 0x00 },
+    /* 0x2C */ { 0x36, 0x00, 0x00, 0x00 }, { 0x38, 0x00, 0x00, 0x00 }, { 0x37, 0x00, 0x00, 0x00 }, { 0x24, 0x02, 0x00, 0x00 },
+    /* 0x30 */ { 0x27, 0x00, 0x00, 0x00 }, { 0x1E, 0x00, 0x00, 0x00 }, { 0x1F, 0x00, 0x00, 0x00 }, { 0x20, 0x00, 0x00, 0x00 },
+    /* 0x34 */ { 0x21, 0x00, 0x00, 0x00 }, { 0x22, 0x00, 0x00, 0x00 }, { 0x23, 0x00, 0x00, 0x00 }, { 0x24, 0x00, 0x00, 0x00 },
+    /* 0x38 */ { 0x25, 0x00, 0x00, 0x00 }, { 0x26, 0x00, 0x00, 0x00 }, { 0x37, 0x02, 0x00, 0x00 }, { 0x36, 0x02, 0x00, 0x00 },
+    /* 0x3C */ { 0x64, 0x00, 0x00, 0x00 }, { 0x27, 0x02, 0x00, 0x00 }, { 0x64, 0x02, 0x00, 0x00 }, { 0x2D, 0x02, 0x00, 0x00 },
+    /* 0x40 */ { 0x1F, 0x40, 0x00, 0x00 }, { 0x04, 0x02, 0x00, 0x00 }, { 0x05, 0x02, 0x00, 0x00 }, { 0x06, 0x02, 0x00, 0x00 },
+    /* 0x44 */ { 0x07, 0x02, 0x00, 0x00 }, { 0x08, 0x02, 0x00, 0x00 }, { 0x09, 0x02, 0x00, 0x00 }, { 0x0A, 0x02, 0x00, 0x00 },
+    /* 0x48 */ { 0x0B, 0x02, 0x00, 0x00 }, { 0x0C, 0x02, 0x00, 0x00 }, { 0x0D, 0x02, 0x00, 0x00 }, { 0x0E, 0x02, 0x00, 0x00 },
+    /* 0x4C */ { 0x0F, 0x02, 0x00, 0x00 }, { 0x10, 0x02, 0x00, 0x00 }, { 0x11, 0x02, 0x00, 0x00 }, { 0x12, 0x02, 0x00, 0x00 },
+    /* 0x50 */ { 0x13, 0x02, 0x00, 0x00 }, { 0x14, 0x02, 0x00, 0x00 }, { 0x15, 0x02, 0x00, 0x00 }, { 0x16, 0x02, 0x00, 0x00 },
+    /* 0x54 */ { 0x17, 0x02, 0x00, 0x00 }, { 0x18, 0x02, 0x00, 0x00 }, { 0x19, 0x02, 0x00, 0x00 }, { 0x1A, 0x02, 0x00, 0x00 },
+    /* 0x58 */ { 0x1B, 0x02, 0x00, 0x00 }, { 0x1C, 0x02, 0x00, 0x00 }, { 0x1D, 0x02, 0x00, 0x00 }, { 0x25, 0x40, 0x00, 0x00 },
+    /* 0x5C */ { 0x2D, 0x40, 0x00, 0x00 }, { 0x26, 0x40, 0x00, 0x00 }, { 0x2C, 0x00, 0x30, 0x02 }, { 0x38, 0x02, 0x00, 0x00 },
+    /* 0x60 */ { 0x2C, 0x00, 0x2E, 0x02 }, { 0x04, 0x00, 0x00, 0x00 }, { 0x05, 0x00, 0x00, 0x00 }, { 0x06, 0x00, 0x00, 0x00 },
+    /* 0x64 */ { 0x07, 0x00, 0x00, 0x00 }, { 0x08, 0x00, 0x00, 0x00 }, { 0x09, 0x00, 0x00, 0x00 }, { 0x0A, 0x00, 0x00, 0x00 },
+    /* 0x68 */ { 0x0B, 0x00, 0x00, 0x00 }, { 0x0C, 0x00, 0x00, 0x00 }, { 0x0D, 0x00, 0x00, 0x00 }, { 0x0E, 0x00, 0x00, 0x00 },
+    /* 0x6C */ { 0x0F, 0x00, 0x00, 0x00 }, { 0x10, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x00, 0x00 }, { 0x12, 0x00, 0x00, 0x00 },
+    /* 0x70 */ { 0x13, 0x00, 0x00, 0x00 }, { 0x14, 0x00, 0x00, 0x00 }, { 0x15, 0x00, 0x00, 0x00 }, { 0x16, 0x00, 0x00, 0x00 },
+    /* 0x74 */ { 0x17, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x00, 0x00 }, { 0x19, 0x00, 0x00, 0x00 }, { 0x1A, 0x00, 0x00, 0x00 },
+    /* 0x78 */ { 0x1B, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x00, 0x00 }, { 0x1D, 0x00, 0x00, 0x00 }, { 0x24, 0x40, 0x00, 0x00 },
+    /* 0x7C */ { 0x64, 0x40, 0x00, 0x00 }, { 0x27, 0x40, 0x00, 0x00 }, { 0x2C, 0x00, 0x30, 0x40 }, { 0x00, 0x00, 0x00, 0x00 }
+};
+
+static const LayoutKey SE_LATIN1[96] = {
+    /* 0xA0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x20, 0x40, 0x00, 0x00 },
+    /* 0xA4 */ { 0x21, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x35, 0x00, 0x00, 0x00 },
+    /* 0xA8 */ { 0x2C, 0x00, 0x30, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xAC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB4 */ { 0x2C, 0x00, 0x2E, 0x00 }, { 0x10, 0x40, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xB8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xBC */ { 0x00, 0x00, 0x00, 0x00 }, { 0x35, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC0 */ { 0x04, 0x02, 0x2E, 0x02 }, { 0x04, 0x02, 0x2E, 0x00 }, { 0x04, 0x02, 0x30, 0x02 }, { 0x04, 0x02, 0x30, 0x40 },
+    /* 0xC4 */ { 0x34, 0x02, 0x00, 0x00 }, { 0x2F, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xC8 */ { 0x08, 0x02, 0x2E, 0x02 }, { 0x08, 0x02, 0x2E, 0x00 }, { 0x08, 0x02, 0x30, 0x02 }, { 0x08, 0x02, 0x30, 0x00 },
+    /* 0xCC */ { 0x0C, 0x02, 0x2E, 0x02 }, { 0x0C, 0x02, 0x2E, 0x00 }, { 0x0C, 0x02, 0x30, 0x02 }, { 0x0C, 0x02, 0x30, 0x00 },
+    /* 0xD0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x11, 0x02, 0x30, 0x40 }, { 0x12, 0x02, 0x2E, 0x02 }, { 0x12, 0x02, 0x2E, 0x00 },
+    /* 0xD4 */ { 0x12, 0x02, 0x30, 0x02 }, { 0x12, 0x02, 0x30, 0x40 }, { 0x33, 0x02, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xD8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x02, 0x2E, 0x02 }, { 0x18, 0x02, 0x2E, 0x00 }, { 0x18, 0x02, 0x30, 0x02 },
+    /* 0xDC */ { 0x18, 0x02, 0x30, 0x00 }, { 0x1C, 0x02, 0x2E, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE0 */ { 0x04, 0x00, 0x2E, 0x02 }, { 0x04, 0x00, 0x2E, 0x00 }, { 0x04, 0x00, 0x30, 0x02 }, { 0x04, 0x00, 0x30, 0x40 },
+    /* 0xE4 */ { 0x34, 0x00, 0x00, 0x00 }, { 0x2F, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xE8 */ { 0x08, 0x00, 0x2E, 0x02 }, { 0x08, 0x00, 0x2E, 0x00 }, { 0x08, 0x00, 0x30, 0x02 }, { 0x08, 0x00, 0x30, 0x00 },
+    /* 0xEC */ { 0x0C, 0x00, 0x2E, 0x02 }, { 0x0C, 0x00, 0x2E, 0x00 }, { 0x0C, 0x00, 0x30, 0x02 }, { 0x0C, 0x00, 0x30, 0x00 },
+    /* 0xF0 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x11, 0x00, 0x30, 0x40 }, { 0x12, 0x00, 0x2E, 0x02 }, { 0x12, 0x00, 0x2E, 0x00 },
+    /* 0xF4 */ { 0x12, 0x00, 0x30, 0x02 }, { 0x12, 0x00, 0x30, 0x40 }, { 0x33, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00 },
+    /* 0xF8 */ { 0x00, 0x00, 0x00, 0x00 }, { 0x18, 0x00, 0x2E, 0x02 }, { 0x18, 0x00, 0x2E, 0x00 }, { 0x18, 0x00, 0x30, 0x02 },
+    /* 0xFC */ { 0x18, 0x00, 0x30, 0x00 }, { 0x1C, 0x00, 0x2E, 0x00 }, { 0x00, 0x00, 0x00, 0x00 }, { 0x1C, 0x00, 0x30, 0x00 }
+};
+
+static const LayoutExtraKey SE_EXTRA[] = {
+    { 0x20AC, { 0x08, 0x40, 0x00, 0x00 } }
+};
+
+const KeyboardLayout KEYBOARD_LAYOUTS[] = {
+    { "US", US_ASCII, nullptr, nullptr, 0 },
+    { "UK", UK_ASCII, UK_LATIN1, UK_EXTRA, 1 },
+    { "GB", UK_ASCII, UK_LATIN1, UK_EXTRA, 1 },
+    { "DE", DE_ASCII, DE_LATIN1, DE_EXTRA, 1 },
+    { "FR", FR_ASCII, FR_LATIN1, FR_EXTRA, 1 },
+    { "ES", ES_ASCII, ES_LATIN1, ES_EXTRA, 1 },
+    { "IT", IT_ASCII, IT_LATIN1, IT_EXTRA, 1 },
+    { "SE", SE_ASCII, SE_LATIN1, SE_EXTRA, 1 },
+    { "FI", SE_ASCII, SE_LATIN1, SE_EXTRA, 1 },
+    { "NORDIC", SE_ASCII, SE_LATIN1, SE_EXTRA, 1 }
+};
+
+const size_t KEYBOARD_LAYOUT_COUNT = sizeof(KEYBOARD_LAYOUTS) / sizeof(KEYBOARD_LAYOUTS[0]);
\ No newline at end of file
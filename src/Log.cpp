@@ -0,0 +1,113 @@
+#include "Log.h"
+
+#define LOG_CORE          0
+#define LOG_PRIORITY      1   // Below the HID output task
+#define LOG_STACK_SIZE    3072
+#define LOG_IDLE_WAIT     20  // ms between ring checks when idle
+#define LOG_LINE_SIZE     160
+
+Logger Log;
+
+static const char LEVEL_TAGS[] = { '-', 'E', 'W', 'I', 'D' };
+
+Logger::Logger() {
+    head = 0;
+    count = 0;
+    dropped = 0;
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    lock = unlocked;
+    task = nullptr;
+}
+
+bool Logger::begin() {
+    if (task) return true;
+    
+    BaseType_t result = xTaskCreatePinnedToCore(taskMain, "log", LOG_STACK_SIZE, this,
+                                                LOG_PRIORITY, &task, LOG_CORE);
+    if (result != pdPASS) {
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void Logger::taskMain(void* arg) {
+    Logger* logger = static_cast<Logger*>(arg);
+    while (true) {
+        logger->flush();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_IDLE_WAIT));
+    }
+}
+
+void Logger::addArg(LogEntry& entry, const char* text) {
+    if (entry.hasText) return;
+    strncpy(entry.text, text ? text : "", LOG_TEXT_SIZE - 1);
+    entry.text[LOG_TEXT_SIZE - 1] = '\0';
+    entry.hasText = true;
+}
+
+void Logger::commit(const LogEntry& entry) {
+    portENTER_CRITICAL(&lock);
+    if (count == RING_SIZE) {
+        // Keep the older records, they explain how we got here
+        dropped++;
+    } else {
+        ring[(head + count) % RING_SIZE] = entry;
+        count++;
+    }
+    portEXIT_CRITICAL(&lock);
+    
+    if (task && entry.level <= LOG_LEVEL_WARN) {
+        xTaskNotifyGive(task);
+    }
+}
+
+bool Logger::pop(LogEntry& entry) {
+    bool found = false;
+    portENTER_CRITICAL(&lock);
+    if (count > 0) {
+        entry = ring[head];
+        head = (head + 1) % RING_SIZE;
+        count--;
+        found = true;
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
+
+void Logger::flush() {
+    LogEntry entry;
+    while (pop(entry)) {
+        print(entry);
+    }
+    
+    portENTER_CRITICAL(&lock);
+    uint32_t lost = dropped;
+    dropped = 0;
+    portEXIT_CRITICAL(&lock);
+    
+    if (lost > 0) {
+        Serial.printf("[W] %u log messages dropped\n", (unsigned)lost);
+    }
+}
+
+void Logger::print(const LogEntry& entry) {
+    char line[LOG_LINE_SIZE];
+    uint32_t a[LOG_MAX_ARGS] = { 0 };
+    memcpy(a, entry.args, entry.argCount * sizeof(uint32_t));
+    
+    // The string argument always comes after the integer arguments
+    if (entry.hasText) {
+        switch (entry.argCount) {
+            case 0: snprintf(line, sizeof(line), entry.format, entry.text); break;
+            case 1: snprintf(line, sizeof(line), entry.format, a[0], entry.text); break;
+            case 2: snprintf(line, sizeof(line), entry.format, a[0], a[1], entry.text); break;
+            default: snprintf(line, sizeof(line), entry.format, a[0], a[1], a[2], entry.text); break;
+        }
+    } else {
+        snprintf(line, sizeof(line), entry.format, a[0], a[1], a[2], a[3]);
+    }
+    
+    uint8_t level = entry.level < sizeof(LEVEL_TAGS) ? entry.level : LOG_LEVEL_DEBUG;
+    Serial.printf("[%lu][%c] %s\n", (unsigned long)entry.timestamp, LEVEL_TAGS[level], line);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Log levels. Messages above LOG_LEVEL are removed at compile time, so a
+// disabled LOG_DEBUG() generates no code and builds no String. Its
+// arguments are still compiled, never evaluated, so a variable only used
+// in a log message does not warn as unused.
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Log.write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do { if (0) Log.write(LOG_LEVEL_ERROR, __VA_ARGS__); } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) Log.write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do { if (0) Log.write(LOG_LEVEL_WARN, __VA_ARGS__); } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) Log.write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do { if (0) Log.write(LOG_LEVEL_INFO, __VA_ARGS__); } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Log.write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do { if (0) Log.write(LOG_LEVEL_DEBUG, __VA_ARGS__); } while (0)
+#endif
+
+#define LOG_MAX_ARGS  4
+#define LOG_TEXT_SIZE 24
+
+// One binary log record. The format string is a literal in flash and is
+// only expanded when the record is printed.
+struct LogEntry {
+    const char* format;
+    uint32_t timestamp;
+    uint32_t args[LOG_MAX_ARGS];   // Integer arguments (%d, %u, %x, %c)
+    char text[LOG_TEXT_SIZE];      // Copy of the string argument (%s)
+    uint8_t level;
+    uint8_t argCount;
+    bool hasText;
+};
+
+// Deferred logger. write() only copies the format pointer and arguments
+// into a fixed-size ring buffer; a low priority task formats and prints
+// the records, so logging never waits on the serial port.
+//
+// Arguments are 32-bit integers plus at most one string, which must be the
+// last argument. Strings are truncated to LOG_TEXT_SIZE - 1 characters.
+class Logger {
+private:
+    static const size_t RING_SIZE = 64;
+    
+    LogEntry ring[RING_SIZE];
+    size_t head;
+    size_t count;
+    uint32_t dropped;
+    portMUX_TYPE lock;
+    TaskHandle_t task;
+    
+    static void taskMain(void* arg);
+    void commit(const LogEntry& entry);
+    bool pop(LogEntry& entry);
+    void print(const LogEntry& entry);
+    
+    static void store(LogEntry& entry) {}
+    
+    template <typename T, typename... Rest>
+    static void store(LogEntry& entry, const T& value, const Rest&... rest) {
+        addArg(entry, value);
+        store(entry, rest...);
+    }
+    
+    template <typename T>
+    static void addArg(LogEntry& entry, T value) {
+        if (entry.argCount < LOG_MAX_ARGS) entry.args[entry.argCount++] = (uint32_t)value;
+    }
+    
+    static void addArg(LogEntry& entry, const char* text);
+    static void addArg(LogEntry& entry, char* text) { addArg(entry, (const char*)text); }
+    static void addArg(LogEntry& entry, const String& text) { addArg(entry, text.c_str()); }
+
+public:
+    Logger();
+    
+    bool begin();   // Start the drain task
+    void flush();   // Print everything pending from the calling task
+    
+    template <typename... Args>
+    void write(uint8_t level, const char* format, const Args&... args) {
+        LogEntry entry;
+        entry.format = format;
+        entry.timestamp = millis();
+        entry.level = level;
+        entry.argCount = 0;
+        entry.hasText = false;
+        store(entry, args...);
+        commit(entry);
+    }
+};
+
+extern Logger Log;
+
+#endif // LOG_H
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "PackArchive.h"
+#include "Log.h"
+#include <FSImpl.h>
+#include <new>
+
+// One payload of an archive as a read-only File. Entries share the open
+// archive, each keeps its own position and seeks only when another entry
+// moved the archive since.
+class PackFileImpl : public fs::FileImpl {
+private:
+    fs::File archive;
+    uint32_t start;
+    uint32_t length;
+    uint32_t pos;
+    String entryPath;
+    String entryName;
+    bool open;
+    
+public:
+    PackFileImpl(fs::File& source, const PackEntry& entry)
+        : archive(source), start(entry.offset), length(entry.size), pos(0), open(true) {
+        entryName = entry.name;
+        entryPath = String(source.path()) + "/" + entryName;
+    }
+    
+    size_t write(const uint8_t* buf, size_t size) { return 0; }
+    
+    size_t read(uint8_t* buf, size_t size) {
+        if (!open || pos >= length) return 0;
+        if (size > length - pos) size = length - pos;
+        if (archive.position() != start + pos && !archive.seek(start + pos)) return 0;
+    
+        size_t bytes = archive.read(buf, size);
+        pos += bytes;
+        return bytes;
+    }
+    
+    void flush() {}
+    
+    bool seek(uint32_t position, fs::SeekMode mode) {
+        int64_t target = position;
+        if (mode == fs::SeekCur) target += pos;
+        if (mode == fs::SeekEnd) target += length;
+        if (target < 0 || target > length) return false;
+        pos = target;
+        return true;
+    }
+    
+    size_t position() const { return pos; }
+    size_t size() const { return length; }
+    bool setBufferSize(size_t size) { return false; }
+    void close() { open = false; }
+    time_t getLastWrite() { return archive.getLastWrite(); }
+    const char* path() const { return entryPath.c_str(); }
+    const char* name() const { return entryName.c_str(); }
+    bool isDirectory(void) { return false; }
+    fs::FileImplPtr openNextFile(const char* mode) { return fs::FileImplPtr(); }
+    bool seekDir(long position) { return false; }
+    String getNextFileName(void) { return String(); }
+    String getNextFileName(bool* isDir) { return String(); }
+    void rewindDirectory(void) {}
+    operator bool() { return open; }
+};
+
+PackArchive::PackArchive() {
+    entries = nullptr;
+    count = 0;
+}
+
+bool PackArchive::isArchive(const char* name) {
+    size_t length = strlen(name);
+    size_t extension = strlen(PACK_EXTENSION);
+    return length > extension && strcasecmp(name + length - extension, PACK_EXTENSION) == 0;
+}
+
+bool PackArchive::open(fs::FS& fs, const String& path) {
+    close();
+    
+    file = fs.open(path, FILE_READ);
+    if (!file) return false;
+    
+    PackHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, PACK_MAGIC, sizeof(header.magic)) != 0 || header.version != PACK_VERSION ||
+        header.dataOffset != sizeof(header) + header.count * sizeof(PackEntry) ||
+        header.dataOffset > file.size()) {
+        LOG_WARN("Not a payload archive: %s", path);
+        close();
+        return false;
+    }
+    if (header.count > MAX_ENTRIES) {
+        LOG_WARN("Archive has %u payloads, only %u are listed", header.count, (uint32_t)MAX_ENTRIES);
+    }
+    
+    // The whole table in one read
+    count = std::min((size_t)header.count, (size_t)MAX_ENTRIES);
+    entries = new (std::nothrow) PackEntry[count > 0 ? count : 1];
+    if (!entries || file.read((uint8_t*)entries, count * sizeof(PackEntry)) != count * sizeof(PackEntry)) {
+        LOG_ERROR("Failed to read archive table: %s", path);
+        close();
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        PackEntry& entry = entries[i];
+        entry.name[PACK_NAME_SIZE - 1] = '\0';
+        if (entry.offset < header.dataOffset || entry.offset > file.size() ||
+            entry.size > file.size() - entry.offset) {
+            LOG_WARN("Archive entry out of range: %s", entry.name);
+            entry.size = 0;
+        }
+    }
+    return true;
+}
+
+void PackArchive::close() {
+    if (file) file.close();
+    delete[] entries;
+    entries = nullptr;
+    count = 0;
+}
+
+const PackEntry* PackArchive::getEntry(size_t position) {
+    return position < count ? &entries[position] : nullptr;
+}
+
+bool PackArchive::find(const char* name, size_t& position) {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        int result = strcasecmp(entries[middle].name, name);
+        if (result == 0) result = strcmp(entries[middle].name, name);
+        if (result == 0) {
+            position = middle;
+            return true;
+        }
+        if (result < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
+
+fs::File PackArchive::openEntry(const char* name) {
+    size_t position;
+    if (!isOpen() || !find(name, position)) return fs::File();
+    return fs::File(fs::FileImplPtr(new PackFileImpl(file, entries[position])));
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef PACK_ARCHIVE_H
+#define PACK_ARCHIVE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "DirectoryIndex.h"
+
+#define PACK_MAGIC      "PPAK"
+#define PACK_VERSION    1
+#define PACK_EXTENSION  ".pak"
+#define PACK_NAME_SIZE  DIR_NAME_SIZE  // Including the terminator
+
+struct PackHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t count;
+    uint32_t dataOffset;  // First payload byte, after the table
+    uint32_t reserved2[4];
+};
+
+// Table entry, sorted in DirectoryIndex order (case-insensitive by name)
+struct PackEntry {
+    uint32_t offset;  // From the start of the archive
+    uint32_t size;
+    char name[PACK_NAME_SIZE];
+};
+
+// Read-only archive of payloads packed into one file by
+// tools/pack_payloads.py: a header, the sorted entry table, then the
+// payloads back to back. Mounting reads the table into RAM once, so
+// listing touches no storage, and a payload is opened as a File over its
+// byte range of the archive: loading it is one seek and one read of the
+// already open archive instead of a file system lookup per payload.
+class PackArchive {
+public:
+    static const size_t MAX_ENTRIES = 256;
+    
+private:
+    fs::File file;
+    PackEntry* entries;
+    uint32_t count;
+    
+public:
+    PackArchive();
+    
+    bool open(fs::FS& fs, const String& path);
+    void close();
+    bool isOpen() { return entries != nullptr; }
+    
+    size_t getCount() { return count; }
+    const PackEntry* getEntry(size_t position);
+    bool find(const char* name, size_t& position);  // Binary search of the table
+    
+    // Entry as a read-only File, invalid if there is no such entry
+    fs::File openEntry(const char* name);
+    
+    static bool isArchive(const char* name);
+};
+
+#endif // PACK_ARCHIVE_H
\ No newline at end of file
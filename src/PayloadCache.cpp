@@ -0,0 +1,101 @@
+#include "PayloadCache.h"
+#include "Hash.h"
+#include "Log.h"
+
+PayloadCache::PayloadCache() {
+    cacheFS = nullptr;
+    recording = false;
+}
+
+String PayloadCache::entryPath(const String& scriptPath) {
+    // Short fixed-length names work on every file system
+    uint32_t hash = fnv1a(FNV_OFFSET, scriptPath);
+    char name[20];
+    snprintf(name, sizeof(name), "/%08x", (unsigned)hash);
+    return String(CACHE_DIR) + name + HIDR_EXTENSION;
+}
+
+HIDRSource PayloadCache::sourceKey(fs::File& script) {
+    HIDRSource source;
+    memset(&source, 0, sizeof(source));
+    source.size = script.size();
+    source.modified = (uint32_t)script.getLastWrite();
+    
+    // Size and write time catch almost every edit, the hash of the first
+    // sector covers the rest in one read. Hashing more delayed every run,
+    // a miss as much as a hit.
+    size_t bytes = script.read(hashBuffer, HASH_BLOCK);
+    source.hash = fnv1a(FNV_OFFSET, hashBuffer, bytes);
+    script.seek(0);
+    return source;
+}
+
+fs::File PayloadCache::lookup(fs::FS& fs, const String& scriptPath, const HIDRSource& source) {
+    if (source.size < MIN_SCRIPT_SIZE) return fs::File();
+    
+    String path = entryPath(scriptPath);
+    if (!fs.exists(path)) return fs::File();
+    
+    fs::File entry = fs.open(path, FILE_READ);
+    if (!entry) return fs::File();
+    
+    HIDRHeader header;
+    bool valid = entry.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 memcmp(header.magic, HIDR_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == HIDR_VERSION &&
+                 header.source.size == source.size &&
+                 header.source.modified == source.modified &&
+                 header.source.hash == source.hash &&
+                 strncmp(header.layout, HIDReportEncoder::getLayout()->name, HIDR_LAYOUT_SIZE) == 0;
+    
+    if (!valid) {
+        LOG_INFO("Payload cache stale: %s", path);
+        entry.close();
+        return fs::File();
+    }
+    
+    entry.seek(0);
+    return entry;
+}
+
+HIDDevice* PayloadCache::record(fs::FS& fs, const String& scriptPath, const HIDRSource& source, HIDDevice* device) {
+    finish(false);
+    if (source.size < MIN_SCRIPT_SIZE) return device;
+    
+    if (!fs.exists(CACHE_DIR) && !fs.mkdir(CACHE_DIR)) {
+        LOG_WARN("Cannot create payload cache directory");
+        return device;
+    }
+    
+    // Written under a temporary name so an aborted run never leaves an
+    // entry that looks valid
+    recordPath = entryPath(scriptPath);
+    recordFile = fs.open(recordPath + ".tmp", FILE_WRITE);
+    if (!recordFile || !recorder.begin(recordFile, source, device)) {
+        if (recordFile) recordFile.close();
+        LOG_WARN("Cannot write payload cache entry");
+        return device;
+    }
+    
+    cacheFS = &fs;
+    recording = true;
+    return &recorder;
+}
+
+void PayloadCache::finish(bool completed) {
+    if (!recording) return;
+    recording = false;
+    
+    bool written = recorder.end() && recorder.getRecordCount() > 0;
+    recordFile.close();
+    
+    String tempPath = recordPath + ".tmp";
+    if (completed && written) {
+        cacheFS->remove(recordPath);
+        if (cacheFS->rename(tempPath, recordPath)) {
+            LOG_INFO("Payload cached: %s", recordPath);
+            return;
+        }
+    }
+    cacheFS->remove(tempPath);
+}
\ No newline at end of file
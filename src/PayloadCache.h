@@ -0,0 +1,57 @@
+#ifndef PAYLOAD_CACHE_H
+#define PAYLOAD_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "HIDRecorder.h"
+
+#define CACHE_DIR "/.cache"
+
+// Cache of compiled payloads, kept as .hidr report streams in CACHE_DIR on
+// the same storage as the script. The first run of a script records what
+// it sends on the way to the backend; later runs of the unchanged script
+// play the recording back without parsing or encoding anything.
+//
+// Entries are keyed by script size, last write time, a hash of the start
+// of the content and the keyboard layout. A mismatch on any of them is a
+// miss, and the entry is overwritten by the next run.
+//
+// A recording is several times the size of its script, but playback only
+// waits for its first sector while a loaded script is read whole before
+// it starts. Scripts under MIN_SCRIPT_SIZE load faster than a recording
+// opens and starts, so they are not cached.
+class PayloadCache {
+public:
+    static const size_t MIN_SCRIPT_SIZE = 2048;
+    
+private:
+    static const size_t HASH_BLOCK = 512;    // Bytes of content hashed, one sector
+    
+    HIDRecorder recorder;
+    fs::FS* cacheFS;
+    fs::File recordFile;
+    String recordPath;
+    bool recording;
+    uint8_t hashBuffer[HASH_BLOCK];
+    
+    static String entryPath(const String& scriptPath);
+    
+public:
+    PayloadCache();
+    
+    // Key for an open script, the file is rewound afterwards
+    HIDRSource sourceKey(fs::File& script);
+    
+    // Open the cached report stream for a script, or an invalid File on a miss
+    fs::File lookup(fs::FS& fs, const String& scriptPath, const HIDRSource& source);
+    
+    // Record the run of a script. Returns the device the parser should
+    // send to: a recorder in front of device, or device itself if the
+    // entry cannot be written.
+    HIDDevice* record(fs::FS& fs, const String& scriptPath, const HIDRSource& source, HIDDevice* device);
+    
+    // Keep the recording if the script ran to the end, drop it otherwise
+    void finish(bool completed);
+};
+
+#endif // PAYLOAD_CACHE_H
\ No newline at end of file
@@ -1,8 +1,23 @@
 #include "PayloadManager.h"
+#include "Log.h"
+#include "HIDReportFile.h"
+#include "PayloadCache.h"
+#include "CompressedFile.h"
+
+// Entries of the virtual drive selection
+static const char* const STORAGE_NAMES[] = { "SD Card", "Internal Storage" };
+#define STORAGE_NAME_COUNT (sizeof(STORAGE_NAMES) / sizeof(STORAGE_NAMES[0]))
+
+#define SCAN_REDRAW_MS 250  // Interval of progress updates while a folder is listed
 
 PayloadManager::PayloadManager() {
     currentStorage = STORAGE_ROOT_SELECT;
     currentPath = "/";
+    indexOpen = false;
+    scanning = false;
+    previewShown = 0;
+    listedShown = 0;
+    lastScanUpdate = 0;
 }
 
 bool PayloadManager::begin() {
@@ -10,61 +25,47 @@ bool PayloadManager::begin() {
     
     // Initialize LittleFS
     if (!LittleFS.begin(true)) {
-        Serial.println("LittleFS Mount Failed");
+        LOG_ERROR("LittleFS Mount Failed");
     } else {
-        Serial.println("LittleFS Mounted");
+        LOG_INFO("LittleFS Mounted");
     }
     
+    scanner.begin();
     refresh();
     return true;
 }
 
 void PayloadManager::scanDirectory(fs::FS &fs, const String& path) {
-    currentFiles.clear();
-    
-    File root = fs.open(path);
-    if (!root || !root.isDirectory()) {
-        Serial.println("Failed to open directory: " + path);
-        return;
+    // Indexes live with the payload cache on the same storage
+    if (!fs.exists(CACHE_DIR) && !fs.mkdir(CACHE_DIR)) {
+        LOG_ERROR("Cannot create %s", CACHE_DIR);
     }
     
-    File file = root.openNextFile();
-    while (file) {
-        // Watchdog prevention for large directories
-        delay(10); 
-        
-        if (currentFiles.size() >= MAX_FILES) {
-            Serial.println("Max file limit reached!");
-            file.close(); // Ensure current file is closed
-            break;
-        }
-
-        FileEntry entry;
-        String fileName = String(file.name());
-        
-        // Handle full paths if returned by FS
-        int lastSlash = fileName.lastIndexOf('/');
-        if (lastSlash >= 0) fileName = fileName.substring(lastSlash + 1);
-        
-        entry.name = fileName;
-        entry.isDir = file.isDirectory();
-        
-        currentFiles.push_back(entry);
-        
-        // Close current file handle before opening next
-        file.close();
-        
-        file = root.openNextFile();
-    }
-    root.close();
+    // The last index of the folder is shown at once. The scan checks it
+    // against the listing in the background and a rebuilt one is swapped
+    // in by update().
+    String cachePath = DirectoryIndex::cachePath(CACHE_DIR, path);
+    indexOpen = index.openCached(fs, path, cachePath);
+    if (indexOpen) files.attach(&index);
+    
+    scanning = true;
+    previewShown = 0;
+    listedShown = 0;
+    lastScanUpdate = millis();
+    scanner.start(fs, path, cachePath);
 }
 
 void PayloadManager::refresh() {
-    currentFiles.clear();
+    scanner.cancel();
+    scanning = false;
+    indexOpen = false;
+    files.clear();
+    index.close();
     
     if (currentStorage == STORAGE_ROOT_SELECT) {
-        currentFiles.push_back({"SD Card", true});
-        currentFiles.push_back({"Internal Storage", true});
+        files.attach(STORAGE_NAMES, STORAGE_NAME_COUNT);
+    } else if (archive.isOpen()) {
+        files.attach(&archive);
     } else if (currentStorage == STORAGE_SD) {
         scanDirectory(SD, currentPath);
     } else if (currentStorage == STORAGE_LITTLEFS) {
@@ -72,8 +73,48 @@ void PayloadManager::refresh() {
     }
 }
 
+bool PayloadManager::update() {
+    if (!scanning) return false;
+    
+    DirectoryScanResult result;
+    if (!scanner.poll(result)) {
+        // A folder without an index fills in as it is listed
+        bool changed = false;
+        if (!indexOpen && scanner.getPreviewCount() != previewShown) {
+            previewShown = scanner.getPreviewCount();
+            changed = true;
+        }
+        if (scanner.getListed() != listedShown && millis() - lastScanUpdate >= SCAN_REDRAW_MS) {
+            listedShown = scanner.getListed();
+            lastScanUpdate = millis();
+            changed = true;
+        }
+        return changed;
+    }
+    
+    scanning = false;
+    fs::FS* fs = getFS();
+    if (!fs) return true;
+    if (result == SCAN_CURRENT && indexOpen) return true;
+    
+    String cachePath = DirectoryIndex::cachePath(CACHE_DIR, currentPath);
+    if (result == SCAN_REBUILT) {
+        files.clear();
+        index.close();
+        DirectoryIndex::replace(*fs, cachePath);
+    }
+    indexOpen = result != SCAN_FAILED && index.openCached(*fs, currentPath, cachePath);
+    if (indexOpen) {
+        files.attach(&index);
+    } else {
+        files.clear();
+    }
+    return true;
+}
+
 void PayloadManager::navigateUp() {
     if (currentStorage == STORAGE_ROOT_SELECT) return;
+    archive.close();
     
     if (currentPath == "/") {
         currentStorage = STORAGE_ROOT_SELECT;
@@ -110,6 +151,15 @@ bool PayloadManager::navigateDown(const String& name) {
     newPath += name;
     
     fs::FS* fs = (currentStorage == STORAGE_SD) ? (fs::FS*)&SD : (fs::FS*)&LittleFS;
+    
+    // Archives are mounted as a read-only folder
+    if (!archive.isOpen() && PackArchive::isArchive(name.c_str())) {
+        if (!archive.open(*fs, newPath)) return false;
+        currentPath = newPath;
+        refresh();
+        return true;
+    }
+    
     File f = fs->open(newPath);
     if (f && f.isDirectory()) {
         currentPath = newPath;
@@ -121,38 +171,163 @@ bool PayloadManager::navigateDown(const String& name) {
     return false;
 }
 
-std::vector<FileEntry> PayloadManager::getFileList() {
-    return currentFiles;
+bool PayloadManager::navigateTo(const String& path, const char* filename, size_t& position) {
+    fs::FS* fs = getFS();
+    if (!fs) return false;
+    
+    File f = fs->open(path);
+    bool isDir = f && f.isDirectory();
+    if (f) f.close();
+    if (!isDir) return false;
+    
+    archive.close();
+    currentPath = path;
+    refresh();
+    return index.find(filename, false, position);
+}
+
+SearchIndex* PayloadManager::openSearch() {
+    fs::FS* fs = getFS();
+    if (!fs) return nullptr;
+    
+    // The walk may rebuild the index of the current directory
+    scanner.cancel();
+    scanner.waitIdle();
+    scanning = false;
+    indexOpen = false;
+    files.clear();
+    index.close();
+    if (!search.open(*fs, CACHE_DIR)) {
+        refresh();
+        return nullptr;
+    }
+    return &search;
+}
+
+void PayloadManager::closeSearch() {
+    search.close();
+    refresh();
 }
 
-String PayloadManager::getCurrentPath() {
+size_t PayloadManager::getFileCount() {
+    if (scanning && !indexOpen) return scanner.getPreviewCount();
+    return files.size();
+}
+
+bool PayloadManager::getFile(size_t position, FileView& view) {
+    bool found = scanning && !indexOpen ? scanner.getPreview(position, view) : files.get(position, view);
+    if (found && !archive.isOpen() && PackArchive::isArchive(view.name)) view.isDir = true;
+    return found;
+}
+
+const char* PayloadManager::getCurrentPath() {
     if (currentStorage == STORAGE_ROOT_SELECT) return "Select Drive";
-    return currentPath;
+    return currentPath.c_str();
 }
 
-String PayloadManager::loadFile(const String& filename) {
-    if (currentStorage == STORAGE_ROOT_SELECT) return "";
-    
+fs::FS* PayloadManager::getFS() {
+    if (currentStorage == STORAGE_ROOT_SELECT) return nullptr;
+    return (currentStorage == STORAGE_SD) ? (fs::FS*)&SD : (fs::FS*)&LittleFS;
+}
+
+String PayloadManager::getFullPath(const String& filename) {
     String fullPath = currentPath;
     if (fullPath != "/") fullPath += "/";
     fullPath += filename;
+    return fullPath;
+}
+
+File PayloadManager::openFile(const String& filename, bool decode) {
+    fs::FS* fs = getFS();
+    if (!fs) return File();
     
-    fs::FS* fs = (currentStorage == STORAGE_SD) ? (fs::FS*)&SD : (fs::FS*)&LittleFS;
+    File file = archive.isOpen() ? archive.openEntry(filename.c_str()) : fs->open(getFullPath(filename), FILE_READ);
+    
+    // Compressed payloads are decoded as they are read
+    if (file && decode && CompressedFile::isCompressed(filename.c_str())) return CompressedFile::open(file);
+    return file;
+}
+
+File PayloadManager::createFile(const String& filename) {
+    fs::FS* fs = getFS();
+    if (!fs || archive.isOpen()) return File(); // Archives are read-only
     
-    File file = fs->open(fullPath, FILE_READ);
+    return fs->open(getFullPath(filename), FILE_WRITE);
+}
+
+String PayloadManager::loadFile(const String& filename) {
+    File file = openFile(filename);
     if (!file) return "";
     
+    String content = readFile(file);
+    file.close();
+    return content;
+}
+
+String PayloadManager::readFile(File& file) {
     // Safety check for file size to prevent OOM
-    if (file.size() > 20000) { // Limit RAM loading to ~20KB
-        Serial.println("File too large for RAM loading!");
-        file.close();
+    if (file.size() > MAX_LOAD_SIZE) { // Limit RAM loading to ~20KB
+        LOG_WARN("File too large for RAM loading!");
         return "";
     }
     
-    String content = "";
-    while (file.available()) {
-        content += (char)file.read();
-    }
-    file.close();
+    uint32_t length = 0;
+    char* buffer = readBuffer(file, length);
+    if (!buffer) return "";
+    
+    String content;
+    content.reserve(length);
+    content.concat(buffer, length);
+    free(buffer);
     return content;
+}
+
+char* PayloadManager::readBuffer(File& file, uint32_t& length) {
+    length = 0;
+    size_t size = file.size() - file.position();
+    
+    // Sized once from the file. The first read stops at a block boundary,
+    // so the reads after it start on a sector and cover whole sectors, and
+    // the file system copies them straight into the buffer instead of going
+    // through its sector cache. Only the first and last read can be partial.
+    char* buffer = (char*)malloc(size + 1);
+    if (!buffer) {
+        LOG_ERROR("Out of memory loading %u bytes", size);
+        return nullptr;
+    }
+    
+    unsigned long start = micros();
+    size_t block = READ_BLOCK - file.position() % READ_BLOCK;
+    while (length < size) {
+        size_t bytes = file.read((uint8_t*)buffer + length, std::min(size - length, block));
+        if (bytes == 0) break;
+        length += bytes;
+        block = READ_BLOCK;
+    }
+    if (length < size) {
+        // Half a payload must not run as if it were the whole one
+        LOG_ERROR("Read %u of %u bytes", length, size);
+        free(buffer);
+        length = 0;
+        return nullptr;
+    }
+    buffer[length] = '\0';
+    
+    unsigned long elapsed = micros() - start;
+    LOG_DEBUG("Loaded %u bytes in %u us (%u KB/s)", length, elapsed,
+              elapsed > 0 ? (uint32_t)((uint64_t)length * 1000000 / 1024 / elapsed) : 0);
+    return buffer;
+}
+
+bool PayloadManager::isReportFile(const String& filename) {
+    String lower = filename;
+    lower.toLowerCase();
+    return lower.endsWith(HIDR_EXTENSION);
+}
+
+String PayloadManager::reportFileName(const String& scriptName) {
+    // payload.txt -> payload.hidr
+    int dot = scriptName.lastIndexOf('.');
+    String base = dot > 0 ? scriptName.substring(0, dot) : scriptName;
+    return base + HIDR_EXTENSION;
 }
\ No newline at end of file
@@ -6,12 +6,11 @@
 #include <SPI.h>
 #include <SD.h>
 #include <LittleFS.h>
-#include <vector>
-
-struct FileEntry {
-    String name;
-    bool isDir;
-};
+#include "DirectoryIndex.h"
+#include "FileList.h"
+#include "SearchIndex.h"
+#include "DirectoryScanner.h"
+#include "PackArchive.h"
 
 enum StorageType {
     STORAGE_ROOT_SELECT, // Virtual root to select drive
@@ -23,12 +22,19 @@ class PayloadManager {
 private:
     StorageType currentStorage;
     String currentPath;
-    std::vector<FileEntry> currentFiles;
+    DirectoryIndex index;   // Entries of currentPath
+    FileList files;         // Window of index entries for the menu
+    SearchIndex search;     // Names of the whole storage, open while searching
+    DirectoryScanner scanner;  // Checks the index of currentPath on the other core
+    PackArchive archive;    // Mounted when currentPath is a .pak file
+    bool indexOpen;
+    bool scanning;
+    size_t previewShown;
+    size_t listedShown;
+    unsigned long lastScanUpdate;
     
     void scanDirectory(fs::FS &fs, const String& path);
-
-    static const size_t MAX_FILES = 100; // Limit to prevent OOM/Freezes
-
+    
 public:
     PayloadManager();
     bool begin();
@@ -36,15 +42,43 @@ public:
     // Navigation
     void navigateUp();
     bool navigateDown(const String& name);
+    bool navigateTo(const String& path, const char* filename, size_t& position);
+    
+    // Search over the current storage, subfolders included. Builds or
+    // validates the index; nullptr on the drive selection or on failure.
+    SearchIndex* openSearch();
+    void closeSearch();
     
     // Getters
-    std::vector<FileEntry> getFileList();
-    String getCurrentPath();
+    size_t getFileCount();
+    bool getFile(size_t position, FileView& view);
+    const char* getCurrentPath();
+    fs::FS* getFS();                         // nullptr on the drive selection
+    String getFullPath(const String& filename);
     
     // File Operations
+    static const size_t MAX_LOAD_SIZE = 20000; // Larger payloads are streamed
+    static const size_t READ_BLOCK = 4096;     // Whole sectors per read
+    
+    File openFile(const String& filename, bool decode = true); // decode: decompress .dsz payloads
+    File createFile(const String& filename); // Truncates an existing file
     String loadFile(const String& filename);
+    String readFile(File& file);
+    
+    // Rest of the file in one malloc()ed, null-terminated buffer that can be
+    // handed to DuckyScriptParser::execute(char*, uint32_t). nullptr on failure.
+    char* readBuffer(File& file, uint32_t& length);
+    
+    // Pre-rendered report streams (.hidr) are played back, not parsed
+    static bool isReportFile(const String& filename);
+    static String reportFileName(const String& scriptName);
     
     void refresh();
+    
+    // Applies the progress of a background scan, true if the list changed
+    bool update();
+    bool isScanning() { return scanning; }
+    size_t getScannedCount() { return scanner.getListed(); }
 };
 
 #endif // PAYLOAD_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "PayloadRamCache.h"
+#include "Log.h"
+#include <FSImpl.h>
+
+// A cache entry as a read-only File. It keeps its own reference to the
+// data, so it stays readable if the entry is evicted while it is open.
+class RamFileImpl : public fs::FileImpl {
+private:
+    std::shared_ptr<char> data;
+    uint32_t length;
+    uint32_t pos;
+    String filePath;
+    bool open;
+    
+public:
+    RamFileImpl(const std::shared_ptr<char>& source, uint32_t size, const String& path)
+        : data(source), length(size), pos(0), filePath(path), open(true) {}
+    
+    size_t write(const uint8_t* buf, size_t size) { return 0; }
+    
+    size_t read(uint8_t* buf, size_t size) {
+        if (!open || pos >= length) return 0;
+        if (size > length - pos) size = length - pos;
+        memcpy(buf, data.get() + pos, size);
+        pos += size;
+        return size;
+    }
+    
+    void flush() {}
+    
+    bool seek(uint32_t position, fs::SeekMode mode) {
+        int64_t target = position;
+        if (mode == fs::SeekCur) target += pos;
+        if (mode == fs::SeekEnd) target += length;
+        if (target < 0 || target > length) return false;
+        pos = target;
+        return true;
+    }
+    
+    size_t position() const { return pos; }
+    size_t size() const { return length; }
+    bool setBufferSize(size_t size) { return false; }
+    void close() { open = false; }
+    time_t getLastWrite() { return 0; }
+    const char* path() const { return filePath.c_str(); }
+    const char* name() const { return strrchr(filePath.c_str(), '/') ? strrchr(filePath.c_str(), '/') + 1 : filePath.c_str(); }
+    bool isDirectory(void) { return false; }
+    fs::FileImplPtr openNextFile(const char* mode) { return fs::FileImplPtr(); }
+    bool seekDir(long position) { return false; }
+    String getNextFileName(void) { return String(); }
+    String getNextFileName(bool* isDir) { return String(); }
+    void rewindDirectory(void) {}
+    operator bool() { return open; }
+};
+
+PayloadRamCache::PayloadRamCache() {
+    used = 0;
+    useClock = 0;
+    pinnedCount = 0;
+    for (size_t i = 0; i < MAX_ENTRIES; i++) {
+        entries[i].storage = nullptr;
+        entries[i].size = 0;
+        entries[i].pinned = false;
+    }
+}
+
+int PayloadRamCache::findEntry(const fs::FS* storage, const String& path) {
+    for (size_t i = 0; i < MAX_ENTRIES; i++) {
+        if (entries[i].storage == storage && entries[i].path == path) return i;
+    }
+    return -1;
+}
+
+void PayloadRamCache::remove(int slot) {
+    Entry& entry = entries[slot];
+    used -= entry.size;
+    if (entry.pinned) pinnedCount--;
+    entry.storage = nullptr;
+    entry.path = String();
+    entry.data.reset();
+    entry.size = 0;
+    entry.pinned = false;
+}
+
+int PayloadRamCache::makeRoom(size_t size) {
+    while (true) {
+        int freeSlot = -1;
+        int oldest = -1;
+        for (size_t i = 0; i < MAX_ENTRIES; i++) {
+            Entry& entry = entries[i];
+            if (!entry.storage) {
+                if (freeSlot < 0) freeSlot = i;
+            } else if (!entry.pinned && (oldest < 0 || (int32_t)(entry.lastUse - entries[oldest].lastUse) < 0)) {
+                oldest = i;
+            }
+        }
+        if (freeSlot >= 0 && used + size <= BUDGET) return freeSlot;
+        if (oldest < 0) return -1;  // Everything left is pinned
+    
+        LOG_DEBUG("RAM cache evicts %s", entries[oldest].path);
+        remove(oldest);
+    }
+}
+
+fs::File PayloadRamCache::lookup(const fs::FS* storage, const String& path, uint32_t modified, bool& compiled) {
+    int slot = findEntry(storage, path);
+    if (slot < 0) return fs::File();
+    
+    Entry& entry = entries[slot];
+    if (entry.modified != modified) {
+        LOG_DEBUG("RAM cache has another version: %s", path);
+        return fs::File();
+    }
+    entry.lastUse = ++useClock;
+    compiled = entry.compiled;
+    return fs::File(fs::FileImplPtr(new RamFileImpl(entry.data, entry.size, path)));
+}
+
+bool PayloadRamCache::insert(const fs::FS* storage, const String& path, uint32_t modified,
+                             char* data, uint32_t size, bool compiled) {
+    bool pinned = false;
+    int slot = findEntry(storage, path);
+    if (slot >= 0) {
+        pinned = entries[slot].pinned;
+        remove(slot);
+    }
+    
+    slot = size <= MAX_ENTRY_SIZE ? makeRoom(size) : -1;
+    if (slot < 0) {
+        LOG_DEBUG("RAM cache has no room for %u bytes: %s", size, path);
+        free(data);
+        return false;
+    }
+    
+    Entry& entry = entries[slot];
+    entry.storage = storage;
+    entry.path = path;
+    entry.modified = modified;
+    entry.data = std::shared_ptr<char>(data, free);
+    entry.size = size;
+    entry.compiled = compiled;
+    entry.pinned = pinned;
+    entry.lastUse = ++useClock;
+    used += size;
+    if (pinned) pinnedCount++;
+    
+    LOG_INFO("RAM cache holds %u bytes (%u used): %s", size, used, path);
+    return true;
+}
+
+void PayloadRamCache::invalidate(const fs::FS* storage, const String& path) {
+    int slot = findEntry(storage, path);
+    if (slot >= 0) remove(slot);
+}
+
+bool PayloadRamCache::pin(const fs::FS* storage, const String& path, bool pinned) {
+    int slot = findEntry(storage, path);
+    if (slot < 0) return false;
+    if (pinned && !entries[slot].pinned) pinnedCount++;
+    if (!pinned && entries[slot].pinned) pinnedCount--;
+    entries[slot].pinned = pinned;
+    return true;
+}
+
+bool PayloadRamCache::isPinned(const fs::FS* storage, const String& path) {
+    int slot = findEntry(storage, path);
+    return slot >= 0 && entries[slot].pinned;
+}
+
+bool PayloadRamCache::isPinned(const fs::FS* storage, const char* dir, const char* name) {
+    if (pinnedCount == 0 || !storage) return false;
+    
+    // Matches dir + "/" + name without building the path
+    size_t dirLength = strcmp(dir, "/") == 0 ? 0 : strlen(dir);
+    for (size_t i = 0; i < MAX_ENTRIES; i++) {
+        const Entry& entry = entries[i];
+        if (!entry.pinned || entry.storage != storage) continue;
+        const char* path = entry.path.c_str();
+        if (strncmp(path, dir, dirLength) == 0 && path[dirLength] == '/' &&
+            strcmp(path + dirLength + 1, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PayloadRamCache::contains(const fs::FS* storage, const String& path, uint32_t modified) {
+    int slot = findEntry(storage, path);
+    return slot >= 0 && entries[slot].modified == modified;
+}
\ No newline at end of file
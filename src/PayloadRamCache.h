@@ -0,0 +1,74 @@
+#ifndef PAYLOAD_RAM_CACHE_H
+#define PAYLOAD_RAM_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <memory>
+
+// Recently run payloads kept in RAM, so running one again starts without
+// touching storage: no SPI transfers, no FAT lookup, no reads. An entry
+// holds the compiled report stream recorded by PayloadCache when it is
+// small enough, or else the payload file as stored (.txt, .dsz or .hidr).
+// Entries are keyed by storage, path and the script's last write time; the
+// least recently used ones are evicted to stay within BUDGET bytes, except
+// pinned entries (favourites), which stay until unpinned.
+//
+// A hit reads no data, but the caller passes the write time of the file
+// from its directory entry, so a changed file, or another card in the
+// slot, is not served from RAM. The firmware also calls invalidate() when
+// it writes a file.
+class PayloadRamCache {
+public:
+    static const size_t BUDGET = 49152;
+    static const size_t MAX_ENTRY_SIZE = 16384;
+    static const size_t MAX_ENTRIES = 16;
+    
+private:
+    struct Entry {
+        const fs::FS* storage;
+        String path;
+        uint32_t modified;          // Last write time of the script
+        std::shared_ptr<char> data; // Shared with open Files, so eviction is safe
+        uint32_t size;
+        bool compiled;              // Report stream instead of the file itself
+        bool pinned;
+        uint32_t lastUse;
+    };
+    
+    Entry entries[MAX_ENTRIES];
+    size_t used;       // Bytes held by all entries
+    uint32_t useClock;
+    size_t pinnedCount;
+    
+    int findEntry(const fs::FS* storage, const String& path);
+    void remove(int slot);
+    int makeRoom(size_t size);  // Free slot with size bytes to spare, -1 if none
+    
+public:
+    PayloadRamCache();
+    
+    // The cached payload as a read-only File, invalid on a miss or when the
+    // entry is of another version of the file. compiled tells whether it
+    // holds the recorded reports or the file as stored.
+    fs::File lookup(const fs::FS* storage, const String& path, uint32_t modified, bool& compiled);
+    
+    // Takes over a malloc()ed buffer (see PayloadManager::readBuffer()),
+    // replacing the entry of the same path and keeping its pin. The buffer
+    // is freed if it does not fit.
+    bool insert(const fs::FS* storage, const String& path, uint32_t modified,
+                char* data, uint32_t size, bool compiled);
+    
+    void invalidate(const fs::FS* storage, const String& path);
+    
+    // Favourites. Only cached payloads can be pinned.
+    bool pin(const fs::FS* storage, const String& path, bool pinned);
+    bool isPinned(const fs::FS* storage, const String& path);
+    bool isPinned(const fs::FS* storage, const char* dir, const char* name); // For the menu, allocates nothing
+    
+    // Entry of this version of a file, so it need not be read again
+    bool contains(const fs::FS* storage, const String& path, uint32_t modified);
+    
+    size_t getUsed() { return used; }
+};
+
+#endif // PAYLOAD_RAM_CACHE_H
\ No newline at end of file
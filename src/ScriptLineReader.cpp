@@ -0,0 +1,95 @@
+#include "ScriptLineReader.h"
+
+// Bytes at the end of text that start a UTF-8 sequence without its last bytes
+static size_t incompleteTail(const char* text, size_t length) {
+    for (size_t back = 1; back <= 3 && back <= length; back++) {
+        uint8_t c = text[length - back];
+        if ((c & 0xC0) == 0x80) continue;  // Continuation byte
+        size_t need = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        return need > back ? back : 0;
+    }
+    return 0;
+}
+
+ScriptLineReader::ScriptLineReader() {
+    stream = nullptr;
+    end();
+}
+
+void ScriptLineReader::begin(Stream* source) {
+    end();
+    stream = source;
+}
+
+void ScriptLineReader::end() {
+    stream = nullptr;
+    head = 0;
+    count = 0;
+    lineLength = 0;
+    carryLength = 0;
+    lineNumber = 0;
+    partial = false;
+    continuation = false;
+    endOfStream = false;
+    lineBuffer[0] = '\0';
+}
+
+bool ScriptLineReader::fill() {
+    if (!stream || endOfStream) return false;
+    
+    // Only called once the buffer is drained, so refill from the start
+    head = 0;
+    count = stream->readBytes(buffer, BUFFER_SIZE);
+    if (count == 0) {
+        endOfStream = true;
+        return false;
+    }
+    return true;
+}
+
+bool ScriptLineReader::readLine() {
+    continuation = partial;
+    partial = false;
+    lineLength = 0;
+    if (!continuation) lineNumber++;
+    
+    // A character cut off the last chunk starts this one
+    memcpy(lineBuffer, carry, carryLength);
+    lineLength = carryLength;
+    carryLength = 0;
+    
+    while (true) {
+        if (count == 0 && !fill()) {
+            lineBuffer[lineLength] = '\0';
+            // A pending continuation still needs its (possibly empty) final chunk
+            return lineLength > 0 || continuation;
+        }
+    
+        size_t room = LINE_SIZE - 1 - lineLength;
+        size_t available = count < room ? count : room;
+        const char* newline = (const char*)memchr(buffer + head, '\n', available);
+        size_t copy = newline ? (size_t)(newline - (buffer + head)) : available;
+    
+        memcpy(lineBuffer + lineLength, buffer + head, copy);
+        lineLength += copy;
+        head += copy;
+        count -= copy;
+    
+        if (newline) {
+            // Consume the newline itself
+            head++;
+            count--;
+            lineBuffer[lineLength] = '\0';
+            return true;
+        }
+    
+        if (lineLength == LINE_SIZE - 1) {
+            carryLength = incompleteTail(lineBuffer, lineLength);
+            lineLength -= carryLength;
+            memcpy(carry, lineBuffer + lineLength, carryLength);
+            lineBuffer[lineLength] = '\0';
+            partial = true;
+            return true;
+        }
+    }
+}
\ No newline at end of file
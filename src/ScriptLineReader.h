@@ -0,0 +1,48 @@
+#ifndef SCRIPT_LINE_READER_H
+#define SCRIPT_LINE_READER_H
+
+#include <Arduino.h>
+
+// Reads a script line by line from a Stream using fixed-size buffers.
+// Lines longer than LINE_SIZE are returned in several chunks, so memory
+// use does not depend on the payload or line size. A chunk never ends in
+// the middle of a UTF-8 sequence: the cut bytes start the next chunk.
+class ScriptLineReader {
+public:
+    static const size_t BUFFER_SIZE = 1024;
+    static const size_t LINE_SIZE = 256;
+    
+private:
+    Stream* stream;
+    char buffer[BUFFER_SIZE];
+    size_t head;
+    size_t count;
+    char lineBuffer[LINE_SIZE];
+    size_t lineLength;
+    char carry[3];         // Start of a UTF-8 sequence cut off the last chunk
+    size_t carryLength;
+    uint32_t lineNumber;
+    bool partial;
+    bool continuation;
+    bool endOfStream;
+    
+    bool fill();
+    
+public:
+    ScriptLineReader();
+    
+    void begin(Stream* source);
+    void end();
+    
+    // Read the next line, or the next chunk of an over-long line.
+    // Returns false at end of stream.
+    bool readLine();
+    
+    const char* line() const { return lineBuffer; }
+    size_t length() const { return lineLength; }
+    uint32_t getLineNumber() const { return lineNumber; }
+    bool isPartial() const { return partial; }           // Line continues in the next chunk
+    bool isContinuation() const { return continuation; } // Chunk continues the previous line
+};
+
+#endif // SCRIPT_LINE_READER_H
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "SearchIndex.h"
+#include "ExternalSort.h"
+#include "Hash.h"
+#include "Log.h"
+#include <vector>
+
+#define WALK_BATCH      8   // Directory records read at once while walking
+#define COLLECT_BATCH   16  // Keys read at once while collecting results
+
+struct SearchBuild {
+    RunWriter<SearchKey, SearchIndex::RUN_RECORDS> keys;
+    fs::File entries;
+    fs::File directories;
+    uint32_t entryCount;
+    uint32_t directoryCount;
+    bool full;
+    bool failed;
+};
+
+static bool keyLess(const SearchKey& a, const SearchKey& b) {
+    return SearchIndex::compare(a, b) < 0;
+}
+
+static bool isWordStart(const char* name, size_t i) {
+    if (i == 0) return true;
+    char c = name[i];
+    char previous = name[i - 1];
+    if (!isalnum(c)) return false;
+    if (!isalnum(previous)) return true;
+    return isupper(c) && islower(previous);  // camelCase
+}
+
+SearchIndex::SearchIndex() {
+    fs = nullptr;
+    keyCount = 0;
+    entryCount = 0;
+    seen = nullptr;
+    queryLength = 0;
+    query[0] = '\0';
+    resultCount = 0;
+    moreResults = false;
+}
+
+SearchIndex::~SearchIndex() {
+    close();
+}
+
+int SearchIndex::compare(const SearchKey& a, const SearchKey& b) {
+    int result = strncmp(a.text, b.text, SEARCH_KEY_SIZE);
+    if (result != 0) return result;
+    return a.entry < b.entry ? -1 : (a.entry > b.entry ? 1 : 0);
+}
+
+bool SearchIndex::open(fs::FS& fs, const char* cacheDir) {
+    close();
+    this->fs = &fs;
+    keyPath = String(cacheDir) + "/search.key";
+    entryPath = String(cacheDir) + "/search.ent";
+    directoryPath = String(cacheDir) + "/search.dir";
+    
+    // Walking opens the index of every folder, which only lists names
+    unsigned long start = millis();
+    uint32_t signature = walk(cacheDir, nullptr);
+    if (!openIndex(signature)) {
+        if (!rebuild(cacheDir, signature) || !openIndex(signature)) {
+            LOG_ERROR("Failed to build the search index");
+            close();
+            return false;
+        }
+        LOG_INFO("Indexed %u names for search in %u ms", entryCount, millis() - start);
+    }
+    
+    seen = new (std::nothrow) uint8_t[(entryCount + 7) / 8 + 1];
+    if (!seen) {
+        close();
+        return false;
+    }
+    
+    rangeLow[0] = 0;
+    rangeHigh[0] = keyCount;
+    queryLength = 0;
+    setQuery("");
+    return true;
+}
+
+void SearchIndex::close() {
+    if (keyFile) keyFile.close();
+    if (entryFile) entryFile.close();
+    if (directoryFile) directoryFile.close();
+    delete[] seen;
+    seen = nullptr;
+    keyCount = 0;
+    entryCount = 0;
+    queryLength = 0;
+    query[0] = '\0';
+    resultCount = 0;
+    moreResults = false;
+}
+
+bool SearchIndex::openIndex(uint32_t signature) {
+    if (!fs->exists(keyPath) || !fs->exists(entryPath) || !fs->exists(directoryPath)) return false;
+    
+    keyFile = fs->open(keyPath, FILE_READ);
+    entryFile = fs->open(entryPath, FILE_READ);
+    directoryFile = fs->open(directoryPath, FILE_READ);
+    
+    SearchIndexHeader header;
+    bool valid = keyFile && entryFile && directoryFile &&
+                 keyFile.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 memcmp(header.magic, SEARCH_INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == SEARCH_INDEX_VERSION && header.signature == signature &&
+                 keyFile.size() == sizeof(header) + header.keys * sizeof(SearchKey) &&
+                 entryFile.size() == header.entries * sizeof(SearchEntry) &&
+                 directoryFile.size() == header.directories * sizeof(SearchDirectory);
+    if (!valid) {
+        if (keyFile) keyFile.close();
+        if (entryFile) entryFile.close();
+        if (directoryFile) directoryFile.close();
+        return false;
+    }
+    
+    keyCount = header.keys;
+    entryCount = header.entries;
+    return true;
+}
+
+uint32_t SearchIndex::walk(const char* cacheDir, SearchBuild* build) {
+    // Depth first, in index order, so the same tree always gives the
+    // same signature and the same directory numbers
+    std::vector<String> pending;
+    pending.push_back("/");
+    
+    uint32_t hash = FNV_OFFSET;
+    DirectoryIndex index;
+    DirectoryRecord records[WALK_BATCH];
+    while (!pending.empty()) {
+        String path = pending.back();
+        pending.pop_back();
+        if (!index.open(*fs, path, DirectoryIndex::cachePath(cacheDir, path))) continue;
+    
+        uint32_t listing = index.getSignature();
+        hash = fnv1a(hash, path);
+        hash = fnv1a(hash, (const uint8_t*)&listing, sizeof(listing));
+    
+        uint32_t directory = 0;
+        if (build) {
+            SearchDirectory record;
+            memset(&record, 0, sizeof(record));
+            memcpy(record.path, path.c_str(), path.length());
+            directory = build->directoryCount++;
+            if (build->directories.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+                build->failed = true;
+            }
+        }
+    
+        size_t count = index.getCount();
+        for (size_t first = 0; first < count;) {
+            size_t read = index.read(first, records, WALK_BATCH);
+            if (read == 0) break;
+            first += read;
+    
+            for (size_t i = 0; i < read; i++) {
+                if (records[i].flags & DIR_ENTRY_DIRECTORY) {
+                    String child = path == "/" ? path + records[i].name : path + "/" + records[i].name;
+                    if (child.length() < SEARCH_PATH_SIZE) {
+                        pending.push_back(child);
+                    } else {
+                        LOG_WARN("Path too long to search: %s", child);
+                    }
+                } else if (build) {
+                    addEntry(*build, directory, records[i]);
+                }
+            }
+        }
+        index.close();
+    }
+    return hash;
+}
+
+void SearchIndex::addEntry(SearchBuild& build, uint32_t directory, const DirectoryRecord& record) {
+    if (build.full) return;
+    if (build.keys.getTotal() + MAX_WORDS > RUN_RECORDS * MAX_RUNS) {
+        LOG_WARN("Search index limited to %u names", build.entryCount);
+        build.full = true;
+        return;
+    }
+    
+    SearchEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.directory = directory;
+    entry.nameLength = record.nameLength;
+    memcpy(entry.name, record.name, record.nameLength);
+    if (build.entries.write((const uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) {
+        build.failed = true;
+        return;
+    }
+    
+    SearchKey key;
+    size_t words = 0;
+    for (size_t i = 0; i < record.nameLength && words < MAX_WORDS; i++) {
+        if (!isWordStart(record.name, i)) continue;
+    
+        memset(&key, 0, sizeof(key));
+        for (size_t j = 0; j < SEARCH_KEY_SIZE - 1 && i + j < record.nameLength; j++) {
+            key.text[j] = tolower(record.name[i + j]);
+        }
+        key.entry = build.entryCount;
+        build.keys.add(key);
+        words++;
+    }
+    build.entryCount++;
+}
+
+bool SearchIndex::rebuild(const char* cacheDir, uint32_t& signature) {
+    String runPath = keyPath + ".run";
+    String newKeyPath = keyPath + ".new";
+    String newEntryPath = entryPath + ".new";
+    String newDirectoryPath = directoryPath + ".new";
+    
+    // Entries and directories are written in walk order, the keys as sorted runs
+    SearchBuild* build = new (std::nothrow) SearchBuild();
+    if (!build) return false;
+    build->entryCount = 0;
+    build->directoryCount = 0;
+    build->full = false;
+    build->failed = false;
+    
+    fs::File runs = fs->open(runPath, FILE_WRITE);
+    build->entries = fs->open(newEntryPath, FILE_WRITE);
+    build->directories = fs->open(newDirectoryPath, FILE_WRITE);
+    bool success = runs && build->entries && build->directories && build->keys.begin(runs, keyLess);
+    if (success) {
+        signature = walk(cacheDir, build);
+        success = build->keys.end() && !build->failed;
+    }
+    if (runs) runs.close();
+    if (build->entries) build->entries.close();
+    if (build->directories) build->directories.close();
+    
+    SearchIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SEARCH_INDEX_MAGIC, sizeof(header.magic));
+    header.version = SEARCH_INDEX_VERSION;
+    header.keys = build->keys.getTotal();
+    header.entries = build->entryCount;
+    header.directories = build->directoryCount;
+    header.signature = signature;
+    delete build;
+    
+    // Runs merged into the new key file
+    if (success) {
+        runs = fs->open(runPath, FILE_READ);
+        fs::File output = fs->open(newKeyPath, FILE_WRITE);
+        RunMerger<SearchKey, RUN_RECORDS, RUN_BUFFER> merger;
+        success = runs && output && merger.begin(runs, header.keys, compare) &&
+                  output.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    
+        SearchKey key;
+        for (uint32_t written = 0; written < header.keys && success; written++) {
+            success = merger.next(key) && output.write((const uint8_t*)&key, sizeof(key)) == sizeof(key);
+        }
+        if (runs) runs.close();
+        if (output) output.close();
+    }
+    fs->remove(runPath);
+    
+    if (!success) {
+        fs->remove(newKeyPath);
+        fs->remove(newEntryPath);
+        fs->remove(newDirectoryPath);
+        return false;
+    }
+    
+    // The key file holds the signature, so it is replaced last
+    fs->remove(keyPath);
+    fs->remove(entryPath);
+    fs->remove(directoryPath);
+    return fs->rename(newEntryPath, entryPath) &&
+           fs->rename(newDirectoryPath, directoryPath) &&
+           fs->rename(newKeyPath, keyPath);
+}
+
+bool SearchIndex::readKey(uint32_t position, SearchKey& key) {
+    keyFile.seek(sizeof(SearchIndexHeader) + position * sizeof(SearchKey));
+    return keyFile.read((uint8_t*)&key, sizeof(key)) == sizeof(key);
+}
+
+uint32_t SearchIndex::bound(uint32_t low, uint32_t high, size_t length, bool upper) {
+    // First key in [low, high) whose prefix is not below (or with upper,
+    // not at or below) the first length characters of the query
+    SearchKey key;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (!readKey(middle, key)) return high;
+    
+        int result = strncmp(key.text, query, length);
+        if (result < 0 || (upper && result == 0)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void SearchIndex::setQuery(const char* text) {
+    char lowered[SEARCH_KEY_SIZE];
+    size_t length = 0;
+    while (text[length] && length < SEARCH_KEY_SIZE - 1) {
+        lowered[length] = tolower(text[length]);
+        length++;
+    }
+    
+    // Ranges of the prefix shared with the previous query are still valid
+    size_t common = 0;
+    while (common < length && common < queryLength && lowered[common] == query[common]) common++;
+    
+    memcpy(query, lowered, length);
+    query[length] = '\0';
+    queryLength = length;
+    for (size_t i = common + 1; i <= length; i++) {
+        rangeLow[i] = bound(rangeLow[i - 1], rangeHigh[i - 1], i, false);
+        rangeHigh[i] = bound(rangeLow[i], rangeHigh[i - 1], i, true);
+    }
+    collect();
+}
+
+void SearchIndex::collect() {
+    resultCount = 0;
+    moreResults = false;
+    if (queryLength == 0 || !seen) return;
+    
+    memset(seen, 0, (entryCount + 7) / 8 + 1);
+    uint32_t position = rangeLow[queryLength];
+    uint32_t end = rangeHigh[queryLength];
+    
+    SearchKey keys[COLLECT_BATCH];
+    keyFile.seek(sizeof(SearchIndexHeader) + position * sizeof(SearchKey));
+    while (position < end) {
+        size_t wanted = std::min((size_t)COLLECT_BATCH, (size_t)(end - position));
+        size_t read = keyFile.read((uint8_t*)keys, wanted * sizeof(SearchKey)) / sizeof(SearchKey);
+        if (read == 0) break;
+    
+        for (size_t i = 0; i < read; i++) {
+            uint32_t entry = keys[i].entry;
+            if (entry >= entryCount || (seen[entry / 8] & (1 << (entry % 8)))) continue;
+    
+            if (resultCount == MAX_RESULTS) {
+                moreResults = true;
+                return;
+            }
+            seen[entry / 8] |= 1 << (entry % 8);
+            results[resultCount++] = entry;
+        }
+        position += read;
+    }
+}
+
+bool SearchIndex::getResult(size_t position, SearchEntry& entry, String& directory) {
+    if (position >= resultCount) return false;
+    
+    entryFile.seek(results[position] * sizeof(SearchEntry));
+    if (entryFile.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) return false;
+    entry.name[DIR_NAME_SIZE - 1] = '\0';
+    
+    SearchDirectory record;
+    directoryFile.seek(entry.directory * sizeof(SearchDirectory));
+    if (directoryFile.read((uint8_t*)&record, sizeof(record)) != sizeof(record)) return false;
+    record.path[SEARCH_PATH_SIZE - 1] = '\0';
+    directory = record.path;
+    return true;
+}
\ No newline at end of file
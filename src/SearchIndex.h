@@ -0,0 +1,108 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "DirectoryIndex.h"
+
+#define SEARCH_INDEX_MAGIC   "SIDX"
+#define SEARCH_INDEX_VERSION 1
+#define SEARCH_KEY_SIZE      28   // Including the terminator
+#define SEARCH_PATH_SIZE     128  // Including the terminator
+
+struct SearchIndexHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t keys;
+    uint32_t entries;
+    uint32_t directories;
+    uint32_t signature;  // Combined signatures of every indexed directory
+    uint32_t reserved2[2];
+};
+
+// Lowercased rest of a name from the start of one of its words
+struct SearchKey {
+    char text[SEARCH_KEY_SIZE];
+    uint32_t entry;
+};
+
+struct SearchEntry {
+    uint32_t directory;
+    uint8_t nameLength;
+    uint8_t reserved[3];
+    char name[DIR_NAME_SIZE];
+};
+
+struct SearchDirectory {
+    char path[SEARCH_PATH_SIZE];
+};
+
+struct SearchBuild;
+
+// Type-to-find index over every file of one storage, subfolders included.
+// Each word of a name ("reverse_shell.txt" -> "reverse...", "shell...",
+// "txt") becomes a key, and the keys are kept sorted on the card, so the
+// files matching a typed prefix are one contiguous range found by binary
+// search. The range of every prefix of the query is remembered: typing a
+// character searches inside the previous range, deleting one needs no
+// search at all. RAM use does not depend on the size of the library.
+//
+// The index is built from the DirectoryIndex of every folder and is
+// reused as long as none of their signatures changed.
+class SearchIndex {
+public:
+    static const size_t RUN_RECORDS = 512;   // Keys sorted in RAM per run
+    static const size_t RUN_BUFFER = 4;
+    static const size_t MAX_RUNS = 128;      // Limits the index to 65536 keys
+    static const size_t MAX_WORDS = 8;       // Keys per name
+    static const size_t MAX_RESULTS = 64;
+    
+private:
+    fs::FS* fs;
+    fs::File keyFile;
+    fs::File entryFile;
+    fs::File directoryFile;
+    String keyPath;
+    String entryPath;
+    String directoryPath;
+    uint32_t keyCount;
+    uint32_t entryCount;
+    uint8_t* seen;          // One bit per entry, drops repeated matches
+    
+    char query[SEARCH_KEY_SIZE];
+    size_t queryLength;
+    uint32_t rangeLow[SEARCH_KEY_SIZE];   // Key range per query prefix length
+    uint32_t rangeHigh[SEARCH_KEY_SIZE];
+    uint32_t results[MAX_RESULTS];
+    size_t resultCount;
+    bool moreResults;
+    
+    uint32_t walk(const char* cacheDir, SearchBuild* build);
+    void addEntry(SearchBuild& build, uint32_t directory, const DirectoryRecord& record);
+    bool rebuild(const char* cacheDir, uint32_t& signature);
+    bool openIndex(uint32_t signature);
+    bool readKey(uint32_t position, SearchKey& key);
+    uint32_t bound(uint32_t low, uint32_t high, size_t length, bool upper);
+    void collect();
+    
+public:
+    SearchIndex();
+    ~SearchIndex();
+    
+    // Open the index of a whole storage, rebuilding it if any folder changed
+    bool open(fs::FS& fs, const char* cacheDir);
+    void close();
+    
+    size_t getEntryCount() { return entryCount; }
+    
+    // Results are the files with a word starting with text (case-insensitive)
+    void setQuery(const char* text);
+    size_t getResultCount() { return resultCount; }
+    bool hasMoreResults() { return moreResults; }
+    bool getResult(size_t position, SearchEntry& entry, String& directory);
+    
+    static int compare(const SearchKey& a, const SearchKey& b);
+};
+
+#endif // SEARCH_INDEX_H
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+// Lock-free single-producer/single-consumer ring buffer.
+// push() may only be called from one thread and pop() from one other
+// thread. Capacity is N - 1 entries.
+template <typename T, size_t N>
+class SpscQueue {
+private:
+    T entries[N];
+    std::atomic<size_t> head; // Next slot to read, owned by the consumer
+    std::atomic<size_t> tail; // Next slot to write, owned by the producer
+    
+public:
+    SpscQueue() : head(0), tail(0) {}
+    
+    bool push(const T& entry) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % N;
+        if (next == head.load(std::memory_order_acquire)) return false; // Full
+        
+        entries[t] = entry;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(T& entry) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false; // Empty
+        
+        entry = entries[h];
+        head.store((h + 1) % N, std::memory_order_release);
+        return true;
+    }
+    
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+    
+    size_t size() const {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_acquire);
+        return (t + N - h) % N;
+    }
+    
+    size_t capacity() const { return N - 1; }
+};
+
+#endif // SPSC_QUEUE_H
\ No newline at end of file
@@ -1,23 +1,51 @@
 #include "USBHIDDevice.h"
+#include "Log.h"
 
 MeowUSBDevice* MeowUSBDevice::instance = nullptr;
 
+extern "C" bool tud_mounted(void);
+extern "C" bool tud_hid_n_ready(uint8_t instance);
+
+#define REPORT_READY_TIMEOUT_MS 100
+
+// Consumer page usages, indexed by MediaKey
+static const uint16_t MEDIA_KEY_USAGES[MEDIA_KEY_COUNT] = {
+    0x00B5, // Scan Next Track
+    0x00B6, // Scan Previous Track
+    0x00B7, // Stop
+    0x00CD, // Play/Pause
+    0x00E2, // Mute
+    0x00E9, // Volume Increment
+    0x00EA, // Volume Decrement
+    0x0223, // AC Home
+    0x0194, // AL Local Machine Browser
+    0x0192, // AL Calculator
+    0x022A, // AC Bookmarks
+    0x0221, // AC Search
+    0x0226, // AC Stop
+    0x0224, // AC Back
+    0x0183, // AL Consumer Control Configuration
+    0x018A  // AL Email Reader
+};
+
 void MeowUSBDevice::usbEventCallback(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
     if (event_base == ARDUINO_USB_EVENTS) {
         switch (event_id) {
             case ARDUINO_USB_STARTED_EVENT:
-                Serial.println("USB Started");
+                // Posted from the TinyUSB mount callback
+                if (instance) instance->mountTime = millis();
+                LOG_INFO("USB Started");
                 break;
             case ARDUINO_USB_STOPPED_EVENT:
-                Serial.println("USB Stopped");
+                LOG_INFO("USB Stopped");
                 if (instance) instance->setConnected(false);
                 break;
             case ARDUINO_USB_SUSPEND_EVENT:
-                Serial.println("USB Suspended");
+                LOG_INFO("USB Suspended");
                 if (instance) instance->setConnected(false);
                 break;
             case ARDUINO_USB_RESUME_EVENT:
-                Serial.println("USB Resumed");
+                LOG_INFO("USB Resumed");
                 if (instance) instance->setConnected(true);
                 break;
             default:
@@ -29,6 +57,9 @@ void MeowUSBDevice::usbEventCallback(void* arg, esp_event_base_t event_base, int
 MeowUSBDevice::MeowUSBDevice() {
     deviceConnected = false;
     currentMode = HID_MODE_KEYBOARD;
+    minReportGap = 1000;
+    lastReportTime = 0;
+    mountTime = 0;
     instance = this;
 }
 
@@ -36,56 +67,94 @@ bool MeowUSBDevice::begin() {
     // Initialize USB HID device
     USB.onEvent(usbEventCallback);
     Keyboard.begin();
+    ConsumerControl.begin();
     USB.begin();
     
-    Serial.println("USB HID initialized");
+    LOG_INFO("USB HID initialized");
     return true;
 }
 
 void MeowUSBDevice::setMode(HIDMode mode) {
     currentMode = mode;
-    Serial.println("USB HID mode set to: " + String(mode));
+    LOG_INFO("USB HID mode set to: %d", mode);
 }
 
 void MeowUSBDevice::sendKey(uint8_t key, uint8_t modifiers) {
     if (!isConnected()) return;
-
-    Serial.println("DEBUG: USB sendKey key=" + String(key, HEX) + " mods=" + String(modifiers, HEX));
     
-    // Press modifiers
-    if (modifiers & DuckyScriptParser::MOD_CTRL_LEFT) Keyboard.press(KEY_LEFT_CTRL);
-    if (modifiers & DuckyScriptParser::MOD_SHIFT_LEFT) Keyboard.press(KEY_LEFT_SHIFT);
-    if (modifiers & DuckyScriptParser::MOD_ALT_LEFT) Keyboard.press(KEY_LEFT_ALT);
-    if (modifiers & DuckyScriptParser::MOD_GUI_LEFT) {
-        Keyboard.press(KEY_LEFT_GUI);
-        Serial.println("DEBUG: Pressed KEY_LEFT_GUI");
-    }
-    if (modifiers & DuckyScriptParser::MOD_CTRL_RIGHT) Keyboard.press(KEY_RIGHT_CTRL);
-    if (modifiers & DuckyScriptParser::MOD_SHIFT_RIGHT) Keyboard.press(KEY_RIGHT_SHIFT);
-    if (modifiers & DuckyScriptParser::MOD_ALT_RIGHT) Keyboard.press(KEY_RIGHT_ALT);
-    if (modifiers & DuckyScriptParser::MOD_GUI_RIGHT) Keyboard.press(KEY_RIGHT_GUI);
+    LOG_DEBUG("USB sendKey key=%x mods=%x", key, modifiers);
+    
+    // Modifiers and key go out in a single report
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    report.modifiers = modifiers;
     
-    // Press key
-    if (key != 0) {
-        Keyboard.press(key);
-        Serial.println("DEBUG: Pressed key " + String(key, HEX));
+    uint8_t usage = 0;
+    if (key != 0 && HIDReportEncoder::keyToUsage(key, usage, report.modifiers)) {
+        report.keys[0] = usage;
     }
-
-    // Hold for a moment to ensure host registers it
-    delay(20);
+    HIDOutput.pushReport(this, report);
     
     // Release everything
-    Keyboard.releaseAll();
-    delay(20);
+    memset(&report, 0, sizeof(report));
+    HIDOutput.pushReport(this, report);
 }
 
 void MeowUSBDevice::sendString(const String& text) {
+    sendText(text.c_str(), text.length());
+}
+
+void MeowUSBDevice::sendText(const char* text, size_t length) {
     if (!isConnected()) return;
-    Keyboard.print(text);
-    delay(20); // Small delay after string to ensure host processing
+    
+    // Packed reports: only release when a key repeats or modifiers change
+    HIDKeyReport report;
+    encoder.begin(text, length);
+    while (encoder.next(report)) {
+        HIDOutput.pushReport(this, report);
+    }
+}
+
+void MeowUSBDevice::sendReport(const HIDKeyReport& report) {
+    if (!isConnected()) return;
+    HIDOutput.pushReport(this, report);
+}
+
+void MeowUSBDevice::writeReport(const HIDKeyReport& report) {
+    if (!waitReady()) return;
+    
+    // SendReport blocks until the host has polled the report, so the gap
+    // runs from queueing it. Timing from completion would miss every other
+    // poll when the gap equals the poll interval.
+    KeyReport keyReport;
+    memcpy(&keyReport, &report, sizeof(keyReport));
+    lastReportTime = micros();
+    Keyboard.sendReport(&keyReport);
+}
+
+bool MeowUSBDevice::waitReady() {
+    // Minimum gap for hosts that cannot keep up with back-to-back reports
+    unsigned long elapsed = micros() - lastReportTime;
+    if (elapsed < minReportGap) {
+        uint32_t remaining = minReportGap - elapsed;
+        ::delay(remaining / 1000);
+        delayMicroseconds(remaining % 1000);
+    }
+    
+    // Pace on the HID endpoint rather than fixed sleeps. Block instead of
+    // spinning so the idle task on this core keeps running.
+    unsigned long start = millis();
+    while (!tud_hid_n_ready(0)) {
+        if (!tud_mounted() || millis() - start > REPORT_READY_TIMEOUT_MS) {
+            LOG_WARN("USB HID endpoint not ready");
+            return false;
+        }
+        ::delay(1);
+    }
+    return true;
 }
 
-void MeowUSBDevice::sendKeySequence(const String& keys) {
+void MeowUSBDevice::sendKeySequence(const char* keys, size_t length) {
     // For simplicity in this rewrite, we'll just handle basic sequences or ignore
     // Since sendKey handles modifiers + key, complex sequences might need parsing
     // But DuckyScript usually sends one key combo at a time which sendKey handles
@@ -95,11 +164,42 @@ void MeowUSBDevice::sendKeySequence(const String& keys) {
     // For now, we assume sendKey covers the main use cases
 }
 
+void MeowUSBDevice::sendMediaKey(uint8_t mediaKey) {
+    if (!isConnected() || mediaKey >= MEDIA_KEY_COUNT) return;
+    HIDOutput.pushMediaKey(this, mediaKey);
+}
+
+void MeowUSBDevice::writeMediaKey(uint8_t mediaKey) {
+    if (!waitReady()) return;
+    lastReportTime = micros();
+    ConsumerControl.press(MEDIA_KEY_USAGES[mediaKey]);
+    
+    if (!waitReady()) return;
+    lastReportTime = micros();
+    ConsumerControl.release();
+}
+
 void MeowUSBDevice::delay(uint32_t ms) {
-    ::delay(ms);
+    // Delays are part of the report stream
+    HIDOutput.pushDelay(ms);
 }
 
-extern "C" bool tud_mounted(void);
+bool MeowUSBDevice::isIdle() {
+    return HIDOutput.isIdle();
+}
+
+size_t MeowUSBDevice::outputSpace() {
+    return HIDOutput.space();
+}
+
+uint32_t MeowUSBDevice::reportTimeUs() {
+    // One report per 1 ms full speed poll, or the configured gap if longer
+    return minReportGap > 1000 ? minReportGap : 1000;
+}
+
+void MeowUSBDevice::cancel() {
+    HIDOutput.cancel();
+}
 
 bool MeowUSBDevice::isConnected() {
     // Strictly rely on TinyUSB mounted status
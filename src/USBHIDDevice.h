@@ -5,13 +5,23 @@
 #include <USB.h>
 #include <USBHID.h>
 #include <USBHIDKeyboard.h>
+#include <USBHIDConsumerControl.h>
 #include "DuckyScriptParser.h"
+#include "HIDReportEncoder.h"
+#include "HIDOutputTask.h"
 
-class MeowUSBDevice : public HIDDevice {
+class MeowUSBDevice : public HIDDevice, public HIDReportSink {
 private:
     USBHIDKeyboard Keyboard;
+    USBHIDConsumerControl ConsumerControl;
     HIDMode currentMode;
     volatile bool deviceConnected;
+    HIDReportEncoder encoder;
+    uint32_t minReportGap;      // Microseconds between reports
+    unsigned long lastReportTime;
+    volatile uint32_t mountTime;  // millis() when the host last mounted the device
+    
+    bool waitReady();
     
     static MeowUSBDevice* instance;
     static void usbEventCallback(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
@@ -20,15 +30,28 @@ public:
     MeowUSBDevice();
     bool begin();
     void setMode(HIDMode mode);
+    void setMinReportGap(uint32_t us) { minReportGap = us; }
     
     // HIDDevice interface implementation
     void sendKey(uint8_t key, uint8_t modifiers = 0) override;
     void sendString(const String& text) override;
-    void sendKeySequence(const String& keys) override;
+    void sendText(const char* text, size_t length) override;
+    void sendKeySequence(const char* keys, size_t length) override;
+    void sendMediaKey(uint8_t mediaKey) override;
+    void sendReport(const HIDKeyReport& report) override;
     void delay(uint32_t ms) override;
     bool isConnected() override;
+    bool isIdle() override;
+    size_t outputSpace() override;
+    uint32_t reportTimeUs() override;
+    void cancel() override;
+    
+    // HIDReportSink implementation (runs on the HID output task)
+    void writeReport(const HIDKeyReport& report) override;
+    void writeMediaKey(uint8_t mediaKey) override;
     
     void setConnected(bool connected) { deviceConnected = connected; }
+    uint32_t getMountTime() { return mountTime; }
 };
 
 #endif // MEOW_USB_DEVICE_H
\ No newline at end of file
@@ -9,6 +9,13 @@
 #include "BluetoothHIDDevice.h"
 #include "PayloadManager.h"
 #include "ConfigManager.h"
+#include "HIDOutputTask.h"
+#include "HIDRecorder.h"
+#include "PayloadCache.h"
+#include "PayloadRamCache.h"
+#include "BootSequence.h"
+#include "CompressedFile.h"
+#include "Log.h"
 
 #define PINK 0xFE19
 
@@ -17,11 +24,17 @@
 
 #define FW_VERSION "v0.2.6"
 
+// Timeline of the last boot, on the SD card (internal storage without one)
+#define BOOT_TIMELINE_PATH CACHE_DIR "/boot.log"
+
 // Global objects
 MeowUSBDevice usbHid;
 BluetoothHIDDevice btHid;
 DuckyScriptParser duckyParser;
 PayloadManager payloadManager;
+PayloadCache payloadCache;
+PayloadRamCache ramCache;
+BootSequence boot;
 ConfigManager configManager;
 
 // Device state
@@ -30,18 +43,52 @@ enum DeviceMode {
     MODE_USB_HID,
     MODE_BT_HID,
     MODE_CONFIRM_EXECUTION,
-    MODE_RENAME_BT
+    MODE_RENAME_BT,
+    MODE_SEARCH
 };
 
 DeviceMode currentMode = MODE_IDLE;
 bool isExecuting = false;
 bool useBluetooth = false; // Default to USB
+bool sdMounted = false;
 String currentPayload = "";
 
 // UI State
 int selectedIndex = 0;
 int scrollOffset = 0;
 
+// Execution state
+unsigned long parserWakeAt = 0; // millis() at which the parser wants to run again
+unsigned long payloadStartTime = 0; // ENTER on the confirmation screen
+bool payloadCached = false;     // Running from the compiled payload cache
+bool payloadInRam = false;      // Running from the RAM cache
+bool payloadCompiled = false;   // RAM entry holds the recorded reports
+String payloadPath = "";
+HIDRSource payloadSource;       // Key of the recording made by this run
+
+// Autorun: prepared in setup(), fired from loop() once the host mounts us
+enum AutorunMode {
+    AUTORUN_OFF,
+    AUTORUN_PLAY,       // Report stream in autorunFile
+    AUTORUN_PREPARED,   // Script compiled into the parser
+    AUTORUN_STREAM      // Script streamed from autorunFile
+};
+AutorunMode autorunMode = AUTORUN_OFF;
+File autorunFile;
+bool autorunRunning = false;
+uint32_t autorunMountTime = 0;
+
+// Rename screen state (driven from loop())
+String renameBuffer = "";
+unsigned long renameCursorUpdate = 0;
+bool renameCursorVisible = true;
+
+// Search screen state (driven from loop())
+SearchIndex* search = nullptr;
+String searchQuery = "";
+int searchSelected = 0;
+int searchScroll = 0;
+
 // Function declarations
 void showBootScreen();
 void showMainMenu();
@@ -50,15 +97,81 @@ void showConfirmationScreen(String payloadName);
 void showExecutionScreen(String mode, String payloadName);
 void showExecutionComplete();
 void showRenameScreen();
+void handleRenameInput();
+void drawRenameInput();
+void startSearch();
+void showSearchScreen();
+void handleSearchInput();
+void openSearchResult();
 void handleButtonA();
 void handleKeyboardInput();
 void moveSelectionUp();
 void moveSelectionDown();
 void executePayloadUSB();
 void executePayloadBluetooth();
+File openPayload(const String& payloadName);
+void startPayload(const String& payloadName, File& payloadFile, HIDDevice* device);
+void keepPayload();
+void togglePin();
+void loadScript(File& payloadFile);
+void compilePayload();
 void drawBatteryStatus();
+bool bootDisplay();
+bool bootSD();
+bool bootStorage();
+bool bootHID();
+bool bootConfig();
+bool bootAutorun();
+void serviceAutorun();
+void writeBootTimeline();
 
 void setup() {
+    Serial.begin(115200);
+    Log.begin();
+    LOG_INFO("M5 Cardputer DuckyScript Executor %s", FW_VERSION);
+    
+    // The card and internal storage mount on their own tasks while USB,
+    // the display and splash come up here. USB goes first so the host
+    // enumerates the device while the rest runs. The splash stays up only
+    // until the last step is done.
+    EventBits_t sd = boot.add("sd", bootSD, 0, true);
+    EventBits_t storage = boot.add("littlefs", bootStorage, 0, true);
+    EventBits_t hid = boot.add("usb_hid", bootHID);
+    boot.add("display", bootDisplay);
+    EventBits_t config = boot.add("config", bootConfig, sd | storage);
+    boot.add("autorun", bootAutorun, config | hid);
+    boot.run();
+    
+    if (!boot.succeeded(hid)) {
+        showError("USB HID Error");
+        boot.finish();
+        return;
+    }
+    
+    // An armed autorun skips the menu; the timeline is written once it ran
+    if (autorunMode != AUTORUN_OFF) {
+        boot.finish();
+        LOG_INFO("Autorun armed, waiting for the host");
+        return;
+    }
+    
+    // Show main menu
+    showMainMenu();
+    boot.finish();
+    writeBootTimeline();
+    
+    LOG_INFO("Setup complete!");
+}
+
+void writeBootTimeline() {
+    // Written after the device is usable, so it does not delay it
+    fs::FS& timelineFS = sdMounted ? (fs::FS&)SD : (fs::FS&)LittleFS;
+    if (timelineFS.exists(CACHE_DIR) || timelineFS.mkdir(CACHE_DIR)) {
+        boot.write(timelineFS, BOOT_TIMELINE_PATH);
+    }
+}
+
+bool bootDisplay() {
     // Initialize M5 Cardputer
     auto cfg = M5.config();
     M5Cardputer.begin(cfg, true);
@@ -68,55 +181,227 @@ void setup() {
     
     // Show cat-themed boot screen
     showBootScreen();
-    delay(2000); // Show boot screen for 2 seconds
     
-    Serial.begin(115200);
-    Serial.println("M5 Cardputer DuckyScript Executor v1.0");
-    
-    // Initialize SD card
+    // Show Bluetooth initialization status
+    M5Cardputer.Display.setCursor(0, 100);
+    M5Cardputer.Display.setTextColor(BLUE);
+    M5Cardputer.Display.println("Bluetooth ready...");
+    return true;
+}
+
+bool bootSD() {
     SPI.begin(40, 39, 14, 12);
     if (!SD.begin(12, SPI, 25000000)) {
-        Serial.println("SD Card initialization failed!");
-        // Don't return, allow LittleFS
+        LOG_ERROR("SD Card initialization failed!");
+        return false; // Internal storage still works
     }
+    sdMounted = true;
+    return true;
+}
+
+bool bootStorage() {
+    // Mounts LittleFS and starts the directory scanner
+    return payloadManager.begin();
+}
+
+bool bootHID() {
+    // HID reports are sent from a dedicated task on the other core
+    HIDOutput.begin();
     
     // Initialize USB HID
     if (!usbHid.begin()) {
-        Serial.println("USB HID initialization failed!");
-        showError("USB HID Error");
-        return;
+        LOG_ERROR("USB HID initialization failed!");
+        return false;
     }
     
     // Initialize Bluetooth HID (but don't start advertising yet)
     // Bluetooth advertising will be controlled by Tab key toggle
-    Serial.println("Bluetooth HID ready (use Tab to toggle)");
+    LOG_INFO("Bluetooth HID ready (use Tab to toggle)");
+    return true;
+}
+
+bool bootConfig() {
+    // Load configuration
+    configManager.loadConfig();
+    usbHid.setMinReportGap(configManager.getUsbReportGap());
     
-    // Show Bluetooth initialization status
-    M5Cardputer.Display.setCursor(0, 100);
-    M5Cardputer.Display.setTextColor(BLUE);
-    M5Cardputer.Display.println("Bluetooth ready...");
+    // Both backends type through the host keyboard layout
+    const KeyboardLayout* layout = findKeyboardLayout(configManager.getKeyboardLayout().c_str());
+    if (layout) {
+        HIDReportEncoder::setLayout(layout);
+    } else {
+        LOG_WARN("Unknown keyboard layout %s, using US", configManager.getKeyboardLayout());
+    }
+    return true;
+}
+
+// Load and compile the autorun payload while the host enumerates the
+// device, so that firing it is only a start() or a play() from RAM
+bool bootAutorun() {
+    const String& path = configManager.getAutorunPayload();
+    if (path.length() == 0) return true;
     
-    // Initialize payload manager
-    payloadManager.begin();
+    // Same storage order as config.json: SD card first
+    fs::FS* fs = nullptr;
+    if (sdMounted && SD.exists(path)) {
+        fs = &SD;
+    } else if (LittleFS.exists(path)) {
+        fs = &LittleFS;
+    }
+    File file = fs ? fs->open(path, FILE_READ) : File();
+    if (file && CompressedFile::isCompressed(path.c_str())) file = CompressedFile::open(file);
+    if (!file || file.size() == 0) {
+        if (file) file.close();
+        LOG_ERROR("Autorun payload not found: %s", path);
+        return false;
+    }
     
-    // Load configuration
-    configManager.loadConfig();
+    currentPayload = path.substring(path.lastIndexOf('/') + 1);
+    payloadPath = path;
+    memset(&payloadSource, 0, sizeof(payloadSource));
+    usbHid.setMode(HID_MODE_KEYBOARD);
+    duckyParser.setHIDDevice(&usbHid);
     
-    // Show main menu
-    showMainMenu();
+    // A report stream, or the recording of an earlier run, is already
+    // compiled: read it into RAM so the first report needs no card access
+    bool isReport = PayloadManager::isReportFile(path);
+    bool compressed = CompressedFile::isCompressed(path.c_str());
+    bool compiled = isReport;
+    bool recorded = false;
+    if (isReport) {
+        payloadSource.modified = (uint32_t)file.getLastWrite();
+    } else {
+        payloadSource = payloadCache.sourceKey(file);
+        File recording = payloadCache.lookup(*fs, path, payloadSource);
+        recorded = recording;
+    
+        // A recording too large for RAM would be read from storage after
+        // mount, while a script that loads is prepared in RAM before it
+        if (recording && recording.size() > PayloadRamCache::MAX_ENTRY_SIZE &&
+            file.size() <= PayloadManager::MAX_LOAD_SIZE && !compressed) {
+            recording.close();
+        } else if (recording) {
+            file.close();
+            file = recording;
+            compiled = true;
+        }
+    }
+    if (compiled) {
+        if (file.size() <= PayloadRamCache::MAX_ENTRY_SIZE) {
+            uint32_t length = 0;
+            char* data = payloadManager.readBuffer(file, length);
+            file.close();
+            bool stored = false;
+            if (data && ramCache.insert(fs, path, payloadSource.modified, data, length, !isReport)) {
+                file = ramCache.lookup(fs, path, payloadSource.modified, stored);
+            } else {
+                // No room in RAM, play it from storage
+                file = isReport ? fs->open(path, FILE_READ) : payloadCache.lookup(*fs, path, payloadSource);
+            }
+            if (!file) return false;
+        }
+        autorunFile = file;
+        autorunMode = AUTORUN_PLAY;
+        return true;
+    }
+    
+    // Otherwise compile it now, and record this run for the next boot
+    // unless the recording is already there
+    if (!recorded) duckyParser.setHIDDevice(payloadCache.record(*fs, path, payloadSource, &usbHid));
+    if (file.size() > PayloadManager::MAX_LOAD_SIZE || compressed) {
+        autorunFile = file;
+        autorunMode = AUTORUN_STREAM;
+        return true;
+    }
+    
+    uint32_t length = 0;
+    char* script = payloadManager.readBuffer(file, length);
+    file.close();
+    if (!script) {
+        payloadCache.finish(false);
+        return false;
+    }
+    duckyParser.prepare(script, length);
+    autorunMode = AUTORUN_PREPARED;
+    return true;
+}
+
+void serviceAutorun() {
+    // ESC before the host shows up falls back to the menu
+    if (M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(27)) {
+        LOG_INFO("Autorun cancelled");
+        if (autorunFile) autorunFile.close();
+        payloadCache.finish(false);
+        autorunMode = AUTORUN_OFF;
+        showMainMenu();
+        writeBootTimeline();
+        return;
+    }
+    if (!usbHid.isConnected()) return;
+    
+    // The mount event may still be on its way
+    autorunMountTime = usbHid.getMountTime() != 0 ? usbHid.getMountTime() : millis();
     
-    Serial.println("Setup complete!");
+    switch (autorunMode) {
+        case AUTORUN_PLAY:
+            duckyParser.play(autorunFile);
+            break;
+        case AUTORUN_PREPARED:
+            duckyParser.start();
+            break;
+        case AUTORUN_STREAM:
+            duckyParser.execute(autorunFile);
+            break;
+        default:
+            break;
+    }
+    autorunFile = File();
+    autorunMode = AUTORUN_OFF;
+    autorunRunning = true;
+    
+    currentMode = MODE_USB_HID;
+    parserWakeAt = millis();
+    payloadStartTime = millis();
+    payloadInRam = false;
+    payloadCached = false;
+    isExecuting = true;
+    LOG_INFO("Autorun fired %u ms after mount", millis() - autorunMountTime);
 }
 
 void loop() {
     M5Cardputer.update();
     
+    // Nothing else runs until the autorun payload has been fired
+    if (autorunMode != AUTORUN_OFF) {
+        serviceAutorun();
+        return;
+    }
+    
+    // Rename screen has its own input handling
+    if (currentMode == MODE_RENAME_BT) {
+        handleRenameInput();
+        return;
+    }
+    
+    // So has the search screen
+    if (currentMode == MODE_SEARCH) {
+        handleSearchInput();
+        return;
+    }
+    
     // Handle button input
     if (M5Cardputer.BtnA.isPressed()) {
         handleButtonA();
         delay(200); // Debounce
     }
     
+    // Directory scans run in the background and fill in the menu
+    if (!isExecuting && payloadManager.update() && currentMode == MODE_IDLE) {
+        int fileCount = payloadManager.getFileCount();
+        if (selectedIndex >= fileCount) selectedIndex = fileCount > 0 ? fileCount - 1 : 0;
+        showMainMenu();
+    }
+    
     // Handle keyboard input for navigation
     if (M5Cardputer.Keyboard.isPressed()) {
         handleKeyboardInput();
@@ -125,37 +410,54 @@ void loop() {
     
     // Handle payload execution
     if (isExecuting) {
-        // Add safety delay during Bluetooth execution
-        if (currentMode == MODE_BT_HID) {
-            delay(50); // Prevent rapid operations during BLE
+        // Check for abort (ESC) on every pass, also while a DELAY runs
+        if (M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(27)) {
+            duckyParser.stopExecution();
+            payloadCache.finish(false);
+            if (autorunRunning) {
+                autorunRunning = false;
+                writeBootTimeline();
+            }
+            isExecuting = false;
+            showExecutionComplete(); // Or show aborted screen
+            return;
         }
-        
-        // Process next line
-        duckyParser.process();
-        
+    
+        // The parser never blocks; it returns when it wants to run again
+        if ((long)(millis() - parserWakeAt) < 0) return;
+        parserWakeAt = duckyParser.process();
+    
         // Update display with current line
-        String currentLine = duckyParser.getCurrentLine();
-        if (currentLine.length() > 0) {
+        ScriptLine currentLine = duckyParser.getCurrentLine();
+        if (currentLine.length > 0) {
             // Clear previous line area (simple approach)
             M5Cardputer.Display.fillRect(0, 60, M5Cardputer.Display.width(), 20, BLACK);
             M5Cardputer.Display.setCursor(0, 60);
             M5Cardputer.Display.setTextColor(GREEN);
             M5Cardputer.Display.print("> ");
-            M5Cardputer.Display.println(currentLine.substring(0, 30)); // Truncate if too long
+            M5Cardputer.Display.write((const uint8_t*)currentLine.text, min(currentLine.length, (uint32_t)30)); // Truncate if too long
+            M5Cardputer.Display.println();
         }
-        
+    
         // Check for completion
         if (duckyParser.isExecutionComplete()) {
+            payloadCache.finish(true);
+            uint32_t firstReport = HIDOutput.getFirstReportTime();
+            if (firstReport != 0 && autorunRunning) {
+                LOG_INFO("Autorun first keystroke %u ms after mount, %u ms after reset",
+                         firstReport - autorunMountTime, firstReport);
+            } else if (firstReport != 0) {
+                LOG_INFO("First keystroke %u ms after ENTER (%s)", firstReport - payloadStartTime,
+                         payloadInRam ? "ram" : payloadCached ? "cached" : "parsed");
+            }
+            keepPayload();
+            if (autorunRunning) {
+                autorunRunning = false;
+                writeBootTimeline();
+            }
             isExecuting = false;
             showExecutionComplete();
         }
-        
-        // Check for abort (ESC)
-        if (M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(27)) {
-            duckyParser.stopExecution();
-            isExecuting = false;
-            showExecutionComplete(); // Or show aborted screen
-        }
     }
 }
 
@@ -167,7 +469,7 @@ void handleKeyboardInput() {
         if (millis() - lastTabPress > 500) {
             lastTabPress = millis();
             useBluetooth = !useBluetooth;
-            
+    
             // Handle Bluetooth advertising toggle
             if (useBluetooth) {
                 // Show Bluetooth booting status
@@ -176,17 +478,17 @@ void handleKeyboardInput() {
                 M5Cardputer.Display.setTextColor(BLUE);
                 M5Cardputer.Display.println("Bluetooth booting...");
                 M5Cardputer.Display.setTextColor(WHITE);
-                
+    
                 // Force display update
                 M5Cardputer.Display.display();
-                
+    
                 // Start Bluetooth advertising with configured name if not already running
                 String btName = configManager.getBluetoothName();
                 bool success = btHid.begin(btName);
-                
+    
                 if (success) {
-                    Serial.println("Bluetooth advertising started: " + btName);
-                    
+                    LOG_INFO("Bluetooth advertising started: %s", btName);
+    
                     // Update status
                     M5Cardputer.Display.fillRect(0, 80, M5Cardputer.Display.width(), 20, BLACK);
                     M5Cardputer.Display.setCursor(0, 80);
@@ -196,7 +498,7 @@ void handleKeyboardInput() {
                     M5Cardputer.Display.display();
                     delay(500);
                 } else {
-                    Serial.println("Bluetooth initialization failed!");
+                    LOG_ERROR("Bluetooth initialization failed!");
                     showError("BT Init Failed");
                     delay(1000);
                     useBluetooth = false; // Revert to USB mode
@@ -204,14 +506,14 @@ void handleKeyboardInput() {
             } else {
                 // Switching to USB Mode
                 // DO NOT stop Bluetooth to prevent crash/instability
-                Serial.println("Switched to USB Mode (BLE remains active in bg)");
+                LOG_INFO("Switched to USB Mode (BLE remains active in bg)");
             }
-            
+    
             showMainMenu();
             return;
         }
     }
-
+    
     // Navigation
     if (M5Cardputer.Keyboard.isKeyPressed(';')) {
         moveSelectionUp();
@@ -227,6 +529,21 @@ void handleKeyboardInput() {
         showRenameScreen();
         delay(300);
     }
+    // Compile the selected script to a .hidr report stream (C key)
+    else if (M5Cardputer.Keyboard.isKeyPressed('c') && currentMode != MODE_CONFIRM_EXECUTION && !isExecuting) {
+        compilePayload();
+        delay(300);
+    }
+    // Keep the selected payload in RAM, or let it go (P key)
+    else if (M5Cardputer.Keyboard.isKeyPressed('p') && currentMode != MODE_CONFIRM_EXECUTION && !isExecuting) {
+        togglePin();
+        delay(300);
+    }
+    // Find a payload anywhere on the current storage (F key)
+    else if (M5Cardputer.Keyboard.isKeyPressed('f') && currentMode != MODE_CONFIRM_EXECUTION && !isExecuting) {
+        startSearch();
+        delay(300);
+    }
     // Enter directory or Execute
     else if (M5Cardputer.Keyboard.keysState().enter) {
         if (currentMode == MODE_CONFIRM_EXECUTION) {
@@ -237,10 +554,10 @@ void handleKeyboardInput() {
                 executePayloadUSB();
             }
         } else {
-            std::vector<FileEntry> files = payloadManager.getFileList();
-            if (selectedIndex >= 0 && selectedIndex < files.size()) {
-                if (files[selectedIndex].isDir) {
-                    if (payloadManager.navigateDown(files[selectedIndex].name)) {
+            FileView selected;
+            if (selectedIndex >= 0 && payloadManager.getFile(selectedIndex, selected)) {
+                if (selected.isDir) {
+                    if (payloadManager.navigateDown(selected.name)) {
                         selectedIndex = 0;
                         scrollOffset = 0;
                         showMainMenu();
@@ -263,10 +580,10 @@ void handleKeyboardInput() {
                             showMainMenu();
                         }
                     }
-                    
+    
                     if (connected) {
                         currentMode = MODE_CONFIRM_EXECUTION;
-                        currentPayload = files[selectedIndex].name;
+                        currentPayload = selected.name;
                         showConfirmationScreen(currentPayload);
                     }
                 }
@@ -290,21 +607,25 @@ void handleKeyboardInput() {
 }
 
 void moveSelectionUp() {
-    std::vector<FileEntry> files = payloadManager.getFileList();
-    if (!files.empty()) {
+    unsigned long start = micros();
+    size_t count = payloadManager.getFileCount();
+    if (count > 0) {
         selectedIndex--;
-        if (selectedIndex < 0) selectedIndex = files.size() - 1;
+        if (selectedIndex < 0) selectedIndex = count - 1;
         showMainMenu();
     }
+    LOG_DEBUG("Selection moved in %u us", micros() - start);
 }
 
 void moveSelectionDown() {
-    std::vector<FileEntry> files = payloadManager.getFileList();
-    if (!files.empty()) {
+    unsigned long start = micros();
+    size_t count = payloadManager.getFileCount();
+    if (count > 0) {
         selectedIndex++;
-        if (selectedIndex >= files.size()) selectedIndex = 0;
+        if (selectedIndex >= count) selectedIndex = 0;
         showMainMenu();
     }
+    LOG_DEBUG("Selection moved in %u us", micros() - start);
 }
 
 void handleButtonA() {
@@ -329,16 +650,17 @@ void handleButtonA() {
 }
 
 void executePayloadUSB() {
-    std::vector<FileEntry> files = payloadManager.getFileList();
-    if (selectedIndex >= files.size()) return;
+    FileView selected;
+    if (!payloadManager.getFile(selectedIndex, selected)) return;
     
     // Only execute files
-    if (files[selectedIndex].isDir) return;
+    if (selected.isDir) return;
     
-    String payloadName = files[selectedIndex].name;
-    String payloadContent = payloadManager.loadFile(payloadName);
+    String payloadName = selected.name;
+    File payloadFile = openPayload(payloadName);
     
-    if (payloadContent.isEmpty()) {
+    if (!payloadFile || payloadFile.size() == 0) {
+        if (payloadFile) payloadFile.close();
         showError("Empty/Failed Load");
         return;
     }
@@ -351,21 +673,21 @@ void executePayloadUSB() {
     showExecutionScreen("USB", payloadName);
     
     // Parse and execute DuckyScript
-    duckyParser.setHIDDevice(&usbHid);
-    duckyParser.execute(payloadContent);
+    startPayload(payloadName, payloadFile, &usbHid);
     isExecuting = true;
 }
 
 void executePayloadBluetooth() {
-    std::vector<FileEntry> files = payloadManager.getFileList();
-    if (selectedIndex >= files.size()) return;
+    FileView selected;
+    if (!payloadManager.getFile(selectedIndex, selected)) return;
     
-    if (files[selectedIndex].isDir) return;
+    if (selected.isDir) return;
     
-    String payloadName = files[selectedIndex].name;
-    String payloadContent = payloadManager.loadFile(payloadName);
+    String payloadName = selected.name;
+    File payloadFile = openPayload(payloadName);
     
-    if (payloadContent.isEmpty()) {
+    if (!payloadFile || payloadFile.size() == 0) {
+        if (payloadFile) payloadFile.close();
         showError("Empty/Failed Load");
         return;
     }
@@ -388,6 +710,7 @@ void executePayloadBluetooth() {
     }
     
     if (!connectionVerified) {
+        payloadFile.close();
         showError("BT Connection Unstable");
         delay(1500);
         showMainMenu();
@@ -402,11 +725,211 @@ void executePayloadBluetooth() {
     showExecutionScreen("Bluetooth", payloadName);
     
     // Parse and execute DuckyScript
-    duckyParser.setHIDDevice(&btHid);
-    duckyParser.execute(payloadContent);
+    startPayload(payloadName, payloadFile, &btHid);
     isExecuting = true;
 }
 
+File openPayload(const String& payloadName) {
+    payloadStartTime = millis();
+    currentPayload = payloadName;
+    payloadPath = payloadManager.getFullPath(payloadName);
+    payloadInRam = false;
+    payloadCompiled = false;
+    memset(&payloadSource, 0, sizeof(payloadSource));
+    
+    File file = payloadManager.openFile(payloadName, false);
+    if (!file) return file;
+    
+    // A payload that ran before is served from RAM. Opening the file only
+    // reads its directory entry, whose write time tells whether storage
+    // still holds the version in RAM.
+    File cached = ramCache.lookup(payloadManager.getFS(), payloadPath, (uint32_t)file.getLastWrite(), payloadCompiled);
+    if (cached) {
+        file.close();
+        file = cached;
+        payloadInRam = true;
+        if (payloadCompiled) return file;
+    }
+    if (CompressedFile::isCompressed(payloadName.c_str())) return CompressedFile::open(file);
+    return file;
+}
+
+void startPayload(const String& payloadName, File& payloadFile, HIDDevice* device) {
+    parserWakeAt = millis();
+    payloadCached = false;
+    
+    if (payloadInRam) {
+        duckyParser.setHIDDevice(device);
+        if (payloadCompiled || PayloadManager::isReportFile(payloadName)) {
+            duckyParser.play(payloadFile);
+        } else {
+            loadScript(payloadFile);
+        }
+        return;
+    }
+    
+    if (PayloadManager::isReportFile(payloadName)) {
+        // Already encoded, nothing to parse
+        payloadSource.modified = (uint32_t)payloadFile.getLastWrite();
+        duckyParser.setHIDDevice(device);
+        duckyParser.play(payloadFile);
+        return;
+    }
+    
+    // An unchanged script plays its recording from the last run
+    fs::FS* fs = payloadManager.getFS();
+    String scriptPath = payloadPath;
+    HIDRSource source = payloadCache.sourceKey(payloadFile);
+    payloadSource = source;
+    File cachedFile = payloadCache.lookup(*fs, scriptPath, source);
+    if (cachedFile) {
+        LOG_INFO("Payload cache hit: %s", scriptPath);
+        payloadFile.close();
+        payloadCached = true;
+        duckyParser.setHIDDevice(device);
+        duckyParser.play(cachedFile);
+        return;
+    }
+    
+    // Otherwise record this run for the next one
+    duckyParser.setHIDDevice(payloadCache.record(*fs, scriptPath, source, device));
+    loadScript(payloadFile);
+    
+    // Estimated run time from the compiled script and the backend timing
+    uint32_t estimate = duckyParser.estimateDuration();
+    if (estimate > 0) {
+        LOG_INFO("Estimated duration: %u ms", estimate);
+        M5Cardputer.Display.setCursor(0, 84);
+        M5Cardputer.Display.setTextColor(GRAY);
+        M5Cardputer.Display.printf("Est. time: %u.%us", estimate / 1000, (estimate % 1000) / 100);
+        M5Cardputer.Display.setTextColor(WHITE);
+    }
+}
+
+void loadScript(File& payloadFile) {
+    if (payloadFile.size() > PayloadManager::MAX_LOAD_SIZE || CompressedFile::isCompressed(payloadFile.name())) {
+        // Large and compressed payloads are streamed line by line in constant memory
+        duckyParser.execute(payloadFile);
+    } else {
+        // Read in whole blocks into one buffer the parser keeps
+        uint32_t length = 0;
+        char* script = payloadManager.readBuffer(payloadFile, length);
+        payloadFile.close();
+        if (script) duckyParser.execute(script, length);
+    }
+}
+
+// Keep a payload that ran to the end in RAM for the next run: its
+// recording when it is small enough, or else the file as stored
+void keepPayload() {
+    fs::FS* fs = payloadManager.getFS();
+    if (payloadInRam || !fs) return;
+    
+    bool compiled = false;
+    File file;
+    if (!PayloadManager::isReportFile(currentPayload)) {
+        file = payloadCache.lookup(*fs, payloadPath, payloadSource);
+        compiled = file && file.size() <= PayloadRamCache::MAX_ENTRY_SIZE;
+        if (file && !compiled) file.close();
+    }
+    if (!compiled) file = payloadManager.openFile(currentPayload, false);
+    if (!file) return;
+    
+    if (file.size() <= PayloadRamCache::MAX_ENTRY_SIZE) {
+        uint32_t length = 0;
+        char* data = payloadManager.readBuffer(file, length);
+        if (data) ramCache.insert(fs, payloadPath, payloadSource.modified, data, length, compiled);
+    }
+    file.close();
+}
+
+void togglePin() {
+    FileView selected;
+    if (!payloadManager.getFile(selectedIndex, selected) || selected.isDir) return;
+    fs::FS* fs = payloadManager.getFS();
+    if (!fs) return;
+    
+    String name = selected.name;
+    String path = payloadManager.getFullPath(name);
+    if (ramCache.isPinned(fs, path)) {
+        ramCache.pin(fs, path, false);
+        showMainMenu();
+        return;
+    }
+    
+    // Loaded now unless this version is already cached
+    File file = payloadManager.openFile(name, false);
+    if (!file) {
+        showError("Failed Load");
+        return;
+    }
+    uint32_t modified = (uint32_t)file.getLastWrite();
+    bool cached = ramCache.contains(fs, path, modified);
+    if (!cached && file.size() <= PayloadRamCache::MAX_ENTRY_SIZE) {
+        uint32_t length = 0;
+        char* data = payloadManager.readBuffer(file, length);
+        cached = data && ramCache.insert(fs, path, modified, data, length, false);
+    }
+    file.close();
+    
+    if (!cached || !ramCache.pin(fs, path, true)) {
+        showError("No room to pin");
+        return;
+    }
+    showMainMenu();
+}
+
+void compilePayload() {
+    FileView selected;
+    if (!payloadManager.getFile(selectedIndex, selected)) return;
+    if (selected.isDir || PayloadManager::isReportFile(selected.name)) return;
+    
+    String scriptName = selected.name;
+    String reportName = PayloadManager::reportFileName(scriptName);
+    File scriptFile = payloadManager.openFile(scriptName);
+    if (!scriptFile || scriptFile.size() == 0) {
+        if (scriptFile) scriptFile.close();
+        showError("Empty/Failed Load");
+        return;
+    }
+    
+    File reportFile = payloadManager.createFile(reportName);
+    if (!reportFile) {
+        scriptFile.close();
+        showError("Cannot create " + reportName);
+        return;
+    }
+    
+    M5Cardputer.Display.clear();
+    M5Cardputer.Display.setCursor(0, 0);
+    M5Cardputer.Display.setTextColor(BLUE);
+    M5Cardputer.Display.println("=== COMPILING ===");
+    M5Cardputer.Display.setTextColor(PINK);
+    M5Cardputer.Display.println("File: " + scriptName);
+    
+    // Run the script into the recorder; delays are stored, not waited for
+    unsigned long start = millis();
+    HIDRecorder recorder;
+    recorder.begin(reportFile, payloadCache.sourceKey(scriptFile));
+    duckyParser.setHIDDevice(&recorder);
+    loadScript(scriptFile);
+    while (!duckyParser.isExecutionComplete()) {
+        duckyParser.process();
+    }
+    duckyParser.setHIDDevice(nullptr);
+    bool success = recorder.end();
+    reportFile.close();
+    ramCache.invalidate(payloadManager.getFS(), payloadManager.getFullPath(reportName));
+    
+    LOG_INFO("Compiled %u records in %u ms: %s", recorder.getRecordCount(), millis() - start, reportName);
+    
+    payloadManager.refresh();
+    M5Cardputer.Display.setTextColor(success ? GREEN : RED);
+    M5Cardputer.Display.println(success ? "Saved " + reportName : String("Write failed"));
+    M5Cardputer.Display.setTextColor(WHITE);
+    M5Cardputer.Display.println("Press any key...");
+}
+
 void showConfirmationScreen(String payloadName) {
     M5Cardputer.Display.clear();
     drawBatteryStatus();
@@ -517,31 +1040,45 @@ void showMainMenu() {
             M5Cardputer.Display.println("(Wait)");
         }
     }
-
+    
     M5Cardputer.Display.setTextColor(CYAN);
     M5Cardputer.Display.print("Path: ");
     M5Cardputer.Display.println(payloadManager.getCurrentPath());
-    M5Cardputer.Display.println("--------------------");
+    if (payloadManager.isScanning()) {
+        M5Cardputer.Display.setTextColor(GRAY);
+        M5Cardputer.Display.print("-- Scanning ");
+        M5Cardputer.Display.print(payloadManager.getScannedCount());
+        M5Cardputer.Display.println(" --");
+    } else {
+        M5Cardputer.Display.println("--------------------");
+    }
     
-    std::vector<FileEntry> files = payloadManager.getFileList();
+    // Only the visible rows are read from the directory index
+    int fileCount = payloadManager.getFileCount();
     
-    if (files.empty()) {
+    if (fileCount == 0 && payloadManager.isScanning()) {
+        M5Cardputer.Display.setTextColor(WHITE);
+        M5Cardputer.Display.println("Scanning...");
+    } else if (fileCount == 0) {
         M5Cardputer.Display.setTextColor(RED);
         M5Cardputer.Display.println("Empty directory");
         M5Cardputer.Display.setTextColor(WHITE);
         M5Cardputer.Display.println("ESC: Back");
     } else {
         int maxItems = 5; // Reduced from 7 to fit header cat
-        
+    
         // Adjust scroll offset
         if (selectedIndex < scrollOffset) scrollOffset = selectedIndex;
         if (selectedIndex >= scrollOffset + maxItems) scrollOffset = selectedIndex - maxItems + 1;
-        
+    
         // Ensure scrollOffset is valid
         if (scrollOffset < 0) scrollOffset = 0;
-        if (scrollOffset >= files.size()) scrollOffset = files.size() - 1;
-        
-        for (int i = scrollOffset; i < files.size() && i < scrollOffset + maxItems; i++) {
+        if (scrollOffset >= fileCount) scrollOffset = fileCount - 1;
+    
+        FileView entry;
+        for (int i = scrollOffset; i < fileCount && i < scrollOffset + maxItems; i++) {
+            if (!payloadManager.getFile(i, entry)) break;
+    
             if (i == selectedIndex) {
                 M5Cardputer.Display.setTextColor(PINK);
                 M5Cardputer.Display.print("> ");
@@ -549,13 +1086,15 @@ void showMainMenu() {
                 M5Cardputer.Display.setTextColor(WHITE);
                 M5Cardputer.Display.print("  ");
             }
-            
-            if (files[i].isDir) {
+    
+            if (entry.isDir) {
                 M5Cardputer.Display.print("[D] ");
+            } else if (ramCache.isPinned(payloadManager.getFS(), payloadManager.getCurrentPath(), entry.name)) {
+                M5Cardputer.Display.print("[*] ");
             } else {
                 M5Cardputer.Display.print("    ");
             }
-            M5Cardputer.Display.println(files[i].name);
+            M5Cardputer.Display.println(entry.name);
         }
     }
     
@@ -564,7 +1103,7 @@ void showMainMenu() {
     // Add help text for R key
     M5Cardputer.Display.setCursor(0, M5Cardputer.Display.height() - 20);
     M5Cardputer.Display.setTextColor(WHITE);
-    M5Cardputer.Display.print("R:Rename BT ");
+    M5Cardputer.Display.print("F:Find R:Rename BT ");
     if (useBluetooth) {
         M5Cardputer.Display.setTextColor(PINK);
         M5Cardputer.Display.println(configManager.getBluetoothName());
@@ -583,10 +1122,10 @@ void drawBatteryStatus() {
         // Set position to top right corner
         int16_t x = M5Cardputer.Display.width() - 40; // Adjust based on text width
         int16_t y = 2;
-        
+    
         M5Cardputer.Display.setCursor(x, y);
         M5Cardputer.Display.setTextColor(WHITE);
-        
+    
         // Draw battery icon and percentage
         M5Cardputer.Display.print("[");
         if (batteryLevel >= 50) {
@@ -599,7 +1138,7 @@ void drawBatteryStatus() {
         M5Cardputer.Display.print(batteryLevel);
         M5Cardputer.Display.setTextColor(WHITE);
         M5Cardputer.Display.print("%]");
-        
+    
         // Draw Version
         M5Cardputer.Display.setCursor(x, y + 10);
         M5Cardputer.Display.setTextColor(GRAY);
@@ -620,74 +1159,242 @@ void showRenameScreen() {
     M5Cardputer.Display.println("Enter new name:");
     M5Cardputer.Display.println("(max 16 chars)");
     
-    String newName = "";
+    renameBuffer = "";
+    renameCursorUpdate = millis();
+    renameCursorVisible = true;
+    drawRenameInput();
+}
+
+void handleRenameInput() {
     bool done = false;
-    unsigned long lastCursorUpdate = 0;
-    bool cursorVisible = true;
-    
-    while (!done) {
-        M5Cardputer.update();
-        
-        // Handle keyboard input
-        if (M5Cardputer.Keyboard.isChange()) {
-            if (M5Cardputer.Keyboard.isPressed()) {
-                auto& status = M5Cardputer.Keyboard.keysState();
-                
-                // Enter to confirm
-                if (status.enter) {
-                    if (newName.length() > 0 && newName.length() <= 16) {
-                        configManager.setBluetoothName(newName);
-                        configManager.saveConfig();
-                        done = true;
-                    }
-                    delay(300);
-                }
-                // Backspace
-                else if (status.del) {
-                    if (newName.length() > 0) {
-                        newName.remove(newName.length() - 1);
-                    }
-                    delay(150);
-                }
-                // ESC to cancel
-                else if (M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(27)) {
+    bool changed = false;
+    
+    // Handle keyboard input
+    if (M5Cardputer.Keyboard.isChange()) {
+        if (M5Cardputer.Keyboard.isPressed()) {
+            auto& status = M5Cardputer.Keyboard.keysState();
+    
+            // Enter to confirm
+            if (status.enter) {
+                if (renameBuffer.length() > 0 && renameBuffer.length() <= 16) {
+                    configManager.setBluetoothName(renameBuffer);
+                    configManager.saveConfig();
                     done = true;
-                    delay(300);
                 }
-                // Regular keys
-                else {
-                    // Add typed characters
-                    for (auto& c : status.word) {
-                        if (newName.length() < 16) {
-                            newName += c;
-                        }
+                delay(300);
+            }
+            // Backspace
+            else if (status.del) {
+                if (renameBuffer.length() > 0) {
+                    renameBuffer.remove(renameBuffer.length() - 1);
+                    changed = true;
+                }
+                delay(150);
+            }
+            // ESC to cancel
+            else if (M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(27)) {
+                done = true;
+                delay(300);
+            }
+            // Regular keys
+            else {
+                // Add typed characters
+                for (auto& c : status.word) {
+                    if (renameBuffer.length() < 16) {
+                        renameBuffer += c;
+                        changed = true;
                     }
                 }
             }
         }
-        
-        // Update cursor blinking
-        if (millis() - lastCursorUpdate > 500) {
-            cursorVisible = !cursorVisible;
-            lastCursorUpdate = millis();
+    }
+    
+    if (done) {
+        // Return to main menu
+        currentMode = MODE_IDLE;
+        showMainMenu();
+        return;
+    }
+    
+    // Update cursor blinking
+    if (millis() - renameCursorUpdate > 500) {
+        renameCursorVisible = !renameCursorVisible;
+        renameCursorUpdate = millis();
+        changed = true;
+    }
+    
+    if (changed) {
+        drawRenameInput();
+    }
+}
+
+void drawRenameInput() {
+    M5Cardputer.Display.fillRect(0, 60, M5Cardputer.Display.width(), 20, BLACK);
+    M5Cardputer.Display.setCursor(0, 60);
+    M5Cardputer.Display.setTextColor(GREEN);
+    M5Cardputer.Display.print("> ");
+    M5Cardputer.Display.print(renameBuffer);
+    
+    // Show blinking cursor
+    if (renameCursorVisible) {
+        M5Cardputer.Display.print("_");
+    }
+}
+
+void startSearch() {
+    if (!payloadManager.getFS()) {
+        showError("Select a drive first");
+        delay(1000);
+        showMainMenu();
+        return;
+    }
+    
+    M5Cardputer.Display.clear();
+    M5Cardputer.Display.setCursor(0, 0);
+    M5Cardputer.Display.setTextColor(BLUE);
+    M5Cardputer.Display.println("=== FIND ===");
+    M5Cardputer.Display.setTextColor(WHITE);
+    M5Cardputer.Display.println("Indexing...");
+    M5Cardputer.Display.display();
+    
+    search = payloadManager.openSearch();
+    if (!search) {
+        showError("Search index failed");
+        delay(1000);
+        showMainMenu();
+        return;
+    }
+    
+    currentMode = MODE_SEARCH;
+    searchQuery = "";
+    searchSelected = 0;
+    searchScroll = 0;
+    showSearchScreen();
+}
+
+void showSearchScreen() {
+    M5Cardputer.Display.clear();
+    drawBatteryStatus();
+    M5Cardputer.Display.setCursor(0, 0);
+    M5Cardputer.Display.setTextColor(BLUE);
+    M5Cardputer.Display.println("=== FIND ===");
+    M5Cardputer.Display.setTextColor(GREEN);
+    M5Cardputer.Display.print("> ");
+    M5Cardputer.Display.print(searchQuery);
+    M5Cardputer.Display.println("_");
+    
+    M5Cardputer.Display.setTextColor(CYAN);
+    size_t resultCount = search->getResultCount();
+    if (searchQuery.length() == 0) {
+        M5Cardputer.Display.print("Type to search ");
+        M5Cardputer.Display.print(search->getEntryCount());
+        M5Cardputer.Display.println(" files");
+    } else {
+        M5Cardputer.Display.print(resultCount);
+        M5Cardputer.Display.println(search->hasMoreResults() ? "+ found" : " found");
+    }
+    M5Cardputer.Display.println("--------------------");
+    
+    int maxItems = 5;
+    if (searchSelected < searchScroll) searchScroll = searchSelected;
+    if (searchSelected >= searchScroll + maxItems) searchScroll = searchSelected - maxItems + 1;
+    
+    SearchEntry entry;
+    String directory;
+    for (int i = searchScroll; i < (int)resultCount && i < searchScroll + maxItems; i++) {
+        if (!search->getResult(i, entry, directory)) break;
+    
+        if (i == searchSelected) {
+            M5Cardputer.Display.setTextColor(PINK);
+            M5Cardputer.Display.print("> ");
+        } else {
+            M5Cardputer.Display.setTextColor(WHITE);
+            M5Cardputer.Display.print("  ");
+        }
+        M5Cardputer.Display.print(entry.name);
+        if (directory != "/") {
+            M5Cardputer.Display.setTextColor(GRAY);
+            M5Cardputer.Display.print(" ");
+            M5Cardputer.Display.print(directory);
         }
-        
-        // Update display
-        M5Cardputer.Display.fillRect(0, 60, M5Cardputer.Display.width(), 20, BLACK);
-        M5Cardputer.Display.setCursor(0, 60);
-        M5Cardputer.Display.setTextColor(GREEN);
-        M5Cardputer.Display.print("> ");
-        M5Cardputer.Display.print(newName);
-        
-        // Show blinking cursor
-        if (cursorVisible) {
-            M5Cardputer.Display.print("_");
+        M5Cardputer.Display.println();
+    }
+    
+    M5Cardputer.Display.setCursor(0, M5Cardputer.Display.height() - 20);
+    M5Cardputer.Display.setTextColor(WHITE);
+    M5Cardputer.Display.println("Enter:Go Fn+;/.:Move ESC:Back");
+}
+
+void handleSearchInput() {
+    if (!M5Cardputer.Keyboard.isChange() || !M5Cardputer.Keyboard.isPressed()) return;
+    
+    auto& status = M5Cardputer.Keyboard.keysState();
+    bool changed = false;
+    
+    if (status.enter) {
+        if (search->getResultCount() > 0) {
+            openSearchResult();
+        }
+        delay(300);
+        return;
+    }
+    // ESC back to the menu
+    else if (M5Cardputer.Keyboard.isKeyPressed('`') || M5Cardputer.Keyboard.isKeyPressed(27)) {
+        payloadManager.closeSearch();
+        search = nullptr;
+        currentMode = MODE_IDLE;
+        showMainMenu();
+        delay(300);
+        return;
+    }
+    // Arrow keys move through the results, everything else is typed
+    else if (status.fn && M5Cardputer.Keyboard.isKeyPressed(';')) {
+        if (searchSelected > 0) searchSelected--;
+    }
+    else if (status.fn && M5Cardputer.Keyboard.isKeyPressed('.')) {
+        if (searchSelected + 1 < (int)search->getResultCount()) searchSelected++;
+    }
+    else if (status.del) {
+        if (searchQuery.length() > 0) {
+            searchQuery.remove(searchQuery.length() - 1);
+            changed = true;
+        }
+    }
+    else {
+        for (auto& c : status.word) {
+            if (searchQuery.length() < SEARCH_KEY_SIZE - 1) {
+                searchQuery += c;
+                changed = true;
+            }
         }
-        
-        delay(50); // Small delay for responsiveness
     }
     
-    // Return to main menu
+    if (changed) {
+        unsigned long start = micros();
+        search->setQuery(searchQuery.c_str());
+        LOG_DEBUG("Search took %u us for %s", micros() - start, searchQuery);
+        searchSelected = 0;
+        searchScroll = 0;
+    }
+    showSearchScreen();
+}
+
+void openSearchResult() {
+    SearchEntry entry;
+    String directory;
+    if (!search->getResult(searchSelected, entry, directory)) return;
+    
+    payloadManager.closeSearch();
+    search = nullptr;
     currentMode = MODE_IDLE;
+    
+    // Jump to the file in its folder; Enter then runs it as usual
+    size_t position = 0;
+    if (payloadManager.navigateTo(directory, entry.name, position)) {
+        selectedIndex = position;
+    } else {
+        selectedIndex = 0;
+    }
+    scrollOffset = 0;
     showMainMenu();
 }
\ No newline at end of file
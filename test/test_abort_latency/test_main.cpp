@@ -0,0 +1,218 @@
+// Abort latency: loop() on the virtual clock with a device that queues
+// output like the HID output task. process() must never block, ESC or
+// requestStop() must stop a run within one loop() pass during a long
+// DELAY or STRING, and nothing queued before the abort is typed after it.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "DuckyScriptParser.h"
+#include "MemoryFS.h"
+
+#define ABORT_BOUND_US 10000
+#define PASS_US        5000   // loop() pass with a display redraw
+#define QUEUE_SIZE     128    // HIDOutputTask::QUEUE_SIZE
+#define REPORT_US      1000
+
+// Realtime device with an output queue drained on the virtual clock:
+// every report takes one 1 ms poll, DELAY waits in the queue, cancel()
+// drops the queue and releases the keys
+class QueuedDevice : public HIDDevice {
+private:
+    struct Entry {
+        uint64_t doneUs;
+        bool report;
+    };
+    
+    std::deque<Entry> queue;
+    uint64_t busyUntil;
+    HIDReportEncoder encoder;
+    
+    void retire() {
+        while (!queue.empty() && queue.front().doneUs <= HostClock::now()) {
+            if (queue.front().report) delivered.push_back(queue.front().doneUs);
+            queue.pop_front();
+        }
+    }
+    
+    void push(uint64_t us, bool report) {
+        retire();
+        uint64_t start = busyUntil > HostClock::now() ? busyUntil : HostClock::now();
+        busyUntil = start + us;
+        Entry entry = { busyUntil, report };
+        queue.push_back(entry);
+    }
+    
+public:
+    std::vector<uint64_t> delivered;  // When each report reached the host
+    
+    QueuedDevice() : busyUntil(0) {}
+    
+    void reset() {
+        queue.clear();
+        busyUntil = 0;
+        delivered.clear();
+    }
+    
+    void sendKey(uint8_t key, uint8_t modifiers = 0) override {
+        push(REPORT_US, true);
+        push(REPORT_US, true);
+    }
+    void sendString(const String& text) override { sendText(text.c_str(), text.length()); }
+    void sendText(const char* text, size_t length) override {
+        HIDKeyReport report;
+        encoder.begin(text, length);
+        while (encoder.next(report)) {
+            push(REPORT_US, true);
+        }
+    }
+    void sendKeySequence(const char* keys, size_t length) override {}
+    void sendMediaKey(uint8_t mediaKey) override { sendKey(0); }
+    void sendReport(const HIDKeyReport& report) override { push(REPORT_US, true); }
+    void delay(uint32_t ms) override { push((uint64_t)ms * 1000, false); }
+    bool isConnected() override { return true; }
+    bool isIdle() override {
+        retire();
+        return queue.empty();
+    }
+    void cancel() override {
+        retire();
+        queue.clear();
+        busyUntil = HostClock::now();
+        push(REPORT_US, true);  // Release
+    }
+    size_t outputSpace() override {
+        retire();
+        return QUEUE_SIZE - queue.size();
+    }
+    
+    uint32_t deliveredAfter(uint64_t us) {
+        retire();
+        uint32_t count = 0;
+        for (size_t i = 0; i < delivered.size(); i++) {
+            if (delivered[i] > us) count++;
+        }
+        return count;
+    }
+};
+
+static QueuedDevice device;
+static DuckyScriptParser parser;
+static uint32_t passes;
+
+// Runs loop() passes until the run ends. ESC is seen by the first pass at
+// or after escUs, stopAtUs calls requestStop() as another task would.
+// Returns the first pass that found the run over and the device idle.
+static uint64_t runLoop(uint64_t escUs, uint64_t stopAtUs = UINT64_MAX, uint32_t passUs = PASS_US) {
+    unsigned long wakeAt = millis();
+    passes = 0;
+    while (!parser.isExecutionComplete()) {
+        uint64_t now = HostClock::now();
+        if (now >= escUs) {
+            parser.stopExecution();
+            escUs = UINT64_MAX;
+        }
+        if (now >= stopAtUs) {
+            parser.requestStop();
+            stopAtUs = UINT64_MAX;
+        }
+        
+        if ((long)(millis() - wakeAt) >= 0) {
+            wakeAt = parser.process();
+            // process() never sleeps, the clock only moves between passes
+            TEST_ASSERT_EQUAL_UINT64(now, HostClock::now());
+        }
+        passes++;
+        HostClock::advance(passUs);
+    }
+    return HostClock::now();
+}
+
+static void start(const std::string& script) {
+    parser.execute(String(script.c_str()));
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+    HostClock::set(1000000);
+    device.reset();
+    parser.setHIDDevice(&device);
+}
+
+void tearDown(void) {
+    parser.stopExecution();
+}
+
+void test_abort_during_long_delay(void) {
+    start("STRING before\nDELAY 10000\nSTRING after\n");
+    uint64_t esc = HostClock::now() + 2000000;
+    uint64_t stopped = runLoop(esc);
+    
+    printf("Stopped %u us after ESC in a DELAY\n", (unsigned)(stopped - esc));
+    TEST_ASSERT_LESS_THAN(ABORT_BOUND_US, (uint32_t)(stopped - esc));
+    // The loop kept running through the DELAY, one pass per redraw
+    TEST_ASSERT_GREATER_OR_EQUAL(2000000 / PASS_US - 1, passes);
+    // Only the release is sent after ESC, "after" never is
+    TEST_ASSERT_LESS_OR_EQUAL(1, device.deliveredAfter(esc));
+}
+
+void test_abort_during_long_string(void) {
+    // Far more text than the output queue holds
+    start("STRING " + std::string(20000, 'a') + "b\n");
+    uint64_t esc = HostClock::now() + 3000000;
+    uint64_t stopped = runLoop(esc);
+    
+    printf("Stopped %u us after ESC in a STRING\n", (unsigned)(stopped - esc));
+    TEST_ASSERT_LESS_THAN(ABORT_BOUND_US, (uint32_t)(stopped - esc));
+    TEST_ASSERT_LESS_OR_EQUAL(1, device.deliveredAfter(esc));
+    TEST_ASSERT_LESS_THAN(20000, device.delivered.size());
+}
+
+void test_request_stop_inside_string(void) {
+    // requestStop() from another task is picked up by the next process()
+    start("STRING " + std::string(20000, 'a') + "\nSTRING more\n");
+    uint64_t stop = HostClock::now() + 1500000;
+    uint64_t stopped = runLoop(UINT64_MAX, stop, 1000);
+    
+    printf("Stopped %u us after requestStop()\n", (unsigned)(stopped - stop));
+    TEST_ASSERT_LESS_THAN(ABORT_BOUND_US, (uint32_t)(stopped - stop));
+    TEST_ASSERT_LESS_OR_EQUAL(1, device.deliveredAfter(stop));
+}
+
+void test_abort_streamed_payload(void) {
+    std::string script;
+    for (int i = 0; i < 200; i++) {
+        script += "STRING streamed line\nENTER\nDELAY 500\n";
+    }
+    LittleFSStorage->clear();
+    LittleFSStorage->addFile("/big.txt", script);
+    parser.execute(LittleFS.open("/big.txt", FILE_READ));
+    
+    uint64_t esc = HostClock::now() + 4321000;
+    uint64_t stopped = runLoop(esc);
+    TEST_ASSERT_LESS_THAN(ABORT_BOUND_US, (uint32_t)(stopped - esc));
+    TEST_ASSERT_LESS_OR_EQUAL(1, device.deliveredAfter(esc));
+}
+
+void test_run_to_end_without_abort(void) {
+    start("STRING abc\nDELAY 300\nENTER\n");
+    uint64_t begin = HostClock::now();
+    uint64_t ended = runLoop(UINT64_MAX);
+    
+    // Three reports and an ENTER, the DELAY and the default delays
+    TEST_ASSERT_GREATER_OR_EQUAL(300000, (uint32_t)(ended - begin));
+    TEST_ASSERT_EQUAL(6, device.delivered.size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_abort_during_long_delay);
+    RUN_TEST(test_abort_during_long_string);
+    RUN_TEST(test_request_stop_inside_string);
+    RUN_TEST(test_abort_streamed_payload);
+    RUN_TEST(test_run_to_end_without_abort);
+    return UNITY_END();
+}
\ No newline at end of file
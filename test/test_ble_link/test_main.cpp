@@ -0,0 +1,211 @@
+// BLE output: BluetoothHIDDevice against the simulated link in
+// native/mock/BleLink.h, on the virtual clock. A run started from idle is
+// paced at the interval the central grants once the connection update
+// arrives, full controller buffers delay reports without losing any, and
+// throughput matches the BleTimingModel the benchmark uses. ESC drops a
+// report stuck on a congested link.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include "BluetoothHIDDevice.h"
+#include "HIDReportDecoder.h"
+#include "BleLink.h"
+#include "MockHIDDevice.h"
+
+#define IDLE_INTERVAL 40  // 50 ms, the relaxed interval
+#define FAST_INTERVAL 6   // 7.5 ms
+#define SETTLE_MS     200 // Past the backend's cached connection state
+#define IDLE_BOUND_MS 100
+
+static BluetoothHIDDevice device;
+static bool started = false;
+
+static const char* TEXT =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore "
+    "et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+    "aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse.";
+
+static void connect(uint16_t interval) {
+    BleLink::connect(interval);
+    HostClock::advance(SETTLE_MS * 1000);
+}
+
+static std::vector<BleLinkReport> keyboardReports() {
+    std::vector<BleLinkReport> keyboard;
+    const std::vector<BleLinkReport>& reports = BleLink::getReports();
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (reports[i].length == sizeof(HIDKeyReport)) keyboard.push_back(reports[i]);
+    }
+    return keyboard;
+}
+
+static std::string decode(const std::vector<BleLinkReport>& reports) {
+    HIDReportDecoder decoder;
+    decoder.reset();
+    std::string typed;
+    for (size_t i = 0; i < reports.size(); i++) {
+        HIDKeyReport report;
+        memcpy(&report, reports[i].data, sizeof(report));
+        uint32_t chars = decoder.getChars();
+        decoder.feed(report, reports[i].timeUs);
+        // The decoder only keeps the tail of the text, take what each
+        // report added
+        if (decoder.getChars() > chars) {
+            const char* preview = decoder.getPreview();
+            typed += preview[strlen(preview) - 1];
+        }
+    }
+    return typed;
+}
+
+// Reports per second between the first and last report of a run
+static uint32_t reportRate(const std::vector<BleLinkReport>& reports, size_t from) {
+    uint64_t span = reports.back().timeUs - reports[from].timeUs;
+    return (uint32_t)((reports.size() - 1 - from) * 1000000ULL / span);
+}
+
+static uint64_t typeText() {
+    uint64_t start = HostClock::now();
+    device.setExecuting(true);
+    device.sendString(TEXT);
+    device.setExecuting(false);
+    BleLink::drain();
+    std::vector<BleLinkReport> reports = keyboardReports();
+    return reports.back().timeUs - start;
+}
+
+void setUp() {
+    HostClock::useVirtual(true);
+    BleLink::reset(4, 8);
+    device.setNotificationsPerEvent(4);
+    if (!started) {
+        device.begin("Test");
+        started = true;
+    }
+    // Past the backend's settling period after begin()
+    HostClock::advance(5000000);
+}
+
+void tearDown() {
+    BleLink::disconnect();
+}
+
+void test_run_from_idle_uses_granted_interval() {
+    connect(IDLE_INTERVAL);
+    typeText();
+    
+    std::vector<BleLinkReport> reports = keyboardReports();
+    std::string typed = decode(reports);
+    TEST_ASSERT_EQUAL_STRING(TEXT, typed.c_str());
+    TEST_ASSERT_EQUAL(2, BleLink::getUpdates());
+    
+    // After the update the link runs at 4 notifications per 7.5 ms, not
+    // at the idle interval the run started on (80 reports/s)
+    uint32_t rate = reportRate(reports, reports.size() / 2);
+    printf("Second half at %u reports/s\n", rate);
+    TEST_ASSERT_GREATER_THAN(400, rate);
+}
+
+void test_idle_interval_after_run() {
+    connect(IDLE_INTERVAL);
+    device.setExecuting(true);
+    HostClock::advance(1000000);
+    TEST_ASSERT_EQUAL(FAST_INTERVAL, BleLink::getInterval());
+    
+    device.setExecuting(false);
+    HostClock::advance(1000000);
+    TEST_ASSERT_EQUAL(24, BleLink::getInterval());
+}
+
+void test_full_buffers_lose_nothing() {
+    // One notification per event and two controller buffers, the backend
+    // still bursts four per event
+    BleLink::reset(1, 2);
+    connect(FAST_INTERVAL);
+    typeText();
+    
+    std::vector<BleLinkReport> reports = keyboardReports();
+    std::string typed = decode(reports);
+    TEST_ASSERT_EQUAL_STRING(TEXT, typed.c_str());
+    TEST_ASSERT_GREATER_THAN(0, BleLink::getRejected());
+    printf("%u notifications refused, %u reports/s\n", BleLink::getRejected(), reportRate(reports, 0));
+}
+
+void test_matches_timing_model() {
+    // The central's floor is the fast interval maximum, so no update
+    BleLink::setCentralMinInterval(12);
+    connect(12);
+    uint64_t linkUs = typeText();
+    
+    BleTimingModel model(15000, 4);
+    MockHIDDevice mock(&model);
+    mock.setConnected(true);
+    mock.sendString(TEXT);
+    uint64_t modelUs = mock.getDurationUs();
+    
+    printf("Link %u ms, model %u ms\n", (unsigned)(linkUs / 1000), (unsigned)(modelUs / 1000));
+    TEST_ASSERT_UINT32_WITHIN(modelUs / 10, modelUs, linkUs);
+}
+
+void test_media_key_held_one_event() {
+    connect(FAST_INTERVAL);
+    device.sendMediaKey(MEDIA_KEY_MUTE);
+    BleLink::drain();
+    
+    const std::vector<BleLinkReport>& reports = BleLink::getReports();
+    TEST_ASSERT_EQUAL(2, reports.size());
+    TEST_ASSERT_EQUAL(2, reports[0].length);
+    uint16_t bits = reports[0].data[0] | (reports[0].data[1] << 8);
+    TEST_ASSERT_EQUAL(1 << MEDIA_KEY_MUTE, bits);
+    TEST_ASSERT_EQUAL(0, reports[1].data[0] | reports[1].data[1]);
+    TEST_ASSERT_GREATER_OR_EQUAL(FAST_INTERVAL * 1250, (uint32_t)(reports[1].timeUs - reports[0].timeUs));
+}
+
+void test_cancel_drops_report_on_congested_link() {
+    // Runs last: the output task it starts stays up, on the real clock
+    HostClock::useVirtual(false);
+    BleLink::reset(4, 2);
+    BleLink::connect(FAST_INTERVAL);
+    delay(SETTLE_MS);
+    TEST_ASSERT_TRUE(HIDOutput.begin());
+    
+    // The central stops taking notifications: two wait in the controller,
+    // the third is refused in every event
+    BleLink::stall(true);
+    device.sendString("hello world");
+    delay(100);
+    TEST_ASSERT_FALSE(HIDOutput.isIdle());
+    TEST_ASSERT_GREATER_THAN(0, BleLink::getRejected());
+    
+    device.cancel();
+    delay(50);
+    BleLink::stall(false);
+    unsigned long start = millis();
+    while (!HIDOutput.isIdle() && millis() - start < 1000) {
+        delay(1);
+    }
+    unsigned long idleMs = millis() - start;
+    printf("Output idle %lu ms after the link recovered\n", idleMs);
+    TEST_ASSERT_LESS_THAN(IDLE_BOUND_MS, idleMs);
+    
+    // The two buffered reports, then the release; the refused report and
+    // the rest of the text are dropped
+    BleLink::drain();
+    std::vector<BleLinkReport> reports = keyboardReports();
+    TEST_ASSERT_EQUAL(3, reports.size());
+    HIDKeyReport release;
+    memset(&release, 0, sizeof(release));
+    TEST_ASSERT_EQUAL_MEMORY(&release, reports[2].data, sizeof(release));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_run_from_idle_uses_granted_interval);
+    RUN_TEST(test_idle_interval_after_run);
+    RUN_TEST(test_full_buffers_lose_nothing);
+    RUN_TEST(test_matches_timing_model);
+    RUN_TEST(test_media_key_held_one_event);
+    RUN_TEST(test_cancel_drops_report_on_congested_link);
+    return UNITY_END();
+}
\ No newline at end of file
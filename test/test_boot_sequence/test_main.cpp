@@ -0,0 +1,188 @@
+// Boot sequence: steps modelled on setup() with the durations of a slow
+// card. Background steps overlap the foreground ones, a step starts only
+// after the steps it comes after, a failed step is reported without
+// stopping the others, and the timeline file has one line per step.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BootSequence.h"
+#include "MemoryFS.h"
+
+#define SD_MS       60
+#define STORAGE_MS  80
+#define HID_MS      30
+#define DISPLAY_MS  50
+#define CONFIG_MS   10
+#define AUTORUN_MS  5
+#define SLACK_MS    20      // Thread start and scheduling
+#define TIMELINE    "/boot.log"
+
+struct TimelineLine {
+    double startMs;
+    double endMs;
+    std::string name;
+    bool failed;
+};
+
+static bool sdOk;
+
+static bool bootSD() { delay(SD_MS); return sdOk; }
+static bool bootStorage() { delay(STORAGE_MS); return true; }
+static bool bootHID() { delay(HID_MS); return true; }
+static bool bootDisplay() { delay(DISPLAY_MS); return true; }
+static bool bootConfig() { delay(CONFIG_MS); return true; }
+static bool bootAutorun() { delay(AUTORUN_MS); return true; }
+
+static BootSequence* boot;
+static EventBits_t sd, storage, hid, config;
+
+// Same steps and dependencies as setup()
+static void addSteps() {
+    sd = boot->add("sd", bootSD, 0, true);
+    storage = boot->add("littlefs", bootStorage, 0, true);
+    hid = boot->add("usb_hid", bootHID);
+    boot->add("display", bootDisplay);
+    config = boot->add("config", bootConfig, sd | storage);
+    boot->add("autorun", bootAutorun, config | hid);
+}
+
+static std::vector<TimelineLine> readTimeline() {
+    std::vector<TimelineLine> lines;
+    std::istringstream text(LittleFSStorage->content(TIMELINE));
+    std::string line;
+    while (std::getline(text, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        TimelineLine entry;
+        double duration;
+        fields >> entry.startMs;
+        if (line.find(" menu") == line.size() - 5) {
+            entry.endMs = entry.startMs;
+            entry.name = "menu";
+        } else {
+            fields >> entry.endMs >> duration >> entry.name;
+        }
+        entry.failed = line.find("(failed)") != std::string::npos;
+        lines.push_back(entry);
+    }
+    return lines;
+}
+
+static const TimelineLine& step(const std::vector<TimelineLine>& lines, const char* name) {
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].name == name) return lines[i];
+    }
+    TEST_FAIL_MESSAGE(name);
+    return lines[0];
+}
+
+// Runs the boot and writes its timeline. Returns the run time in ms.
+static uint32_t runBoot(bool& ok) {
+    uint32_t start = millis();
+    ok = boot->run();
+    uint32_t elapsed = millis() - start;
+    boot->finish();
+    TEST_ASSERT_TRUE(boot->write(LittleFS, TIMELINE));
+    return elapsed;
+}
+
+void setUp(void) {
+    LittleFSStorage->clear();
+    sdOk = true;
+    boot = new BootSequence();
+    addSteps();
+}
+
+void tearDown(void) {
+    delete boot;
+}
+
+void test_background_steps_overlap(void) {
+    bool ok;
+    uint32_t elapsed = runBoot(ok);
+    TEST_ASSERT_TRUE(ok);
+    
+    // The card and internal storage mount while USB and the display come
+    // up, so only the longest of the two chains counts
+    uint32_t series = SD_MS + STORAGE_MS + HID_MS + DISPLAY_MS + CONFIG_MS + AUTORUN_MS;
+    uint32_t critical = max(STORAGE_MS, HID_MS + DISPLAY_MS) + CONFIG_MS + AUTORUN_MS;
+    printf("Boot steps: %u ms in series, %u ms critical path, %u ms run\n", series, critical, elapsed);
+    TEST_ASSERT_GREATER_OR_EQUAL(critical, elapsed);
+    TEST_ASSERT_LESS_THAN(critical + SLACK_MS, elapsed);
+    
+    std::vector<TimelineLine> lines = readTimeline();
+    TEST_ASSERT_TRUE(step(lines, "sd").startMs < step(lines, "usb_hid").endMs);
+    TEST_ASSERT_TRUE(step(lines, "littlefs").startMs < step(lines, "usb_hid").endMs);
+}
+
+void test_steps_wait_for_their_dependencies(void) {
+    bool ok;
+    runBoot(ok);
+    std::vector<TimelineLine> lines = readTimeline();
+    
+    // Foreground steps run in the order they were added
+    TEST_ASSERT_TRUE(step(lines, "display").startMs >= step(lines, "usb_hid").endMs);
+    TEST_ASSERT_TRUE(step(lines, "config").startMs >= step(lines, "sd").endMs);
+    TEST_ASSERT_TRUE(step(lines, "config").startMs >= step(lines, "littlefs").endMs);
+    TEST_ASSERT_TRUE(step(lines, "autorun").startMs >= step(lines, "config").endMs);
+    TEST_ASSERT_TRUE(step(lines, "autorun").startMs >= step(lines, "usb_hid").endMs);
+    TEST_ASSERT_TRUE(step(lines, "menu").startMs >= step(lines, "autorun").endMs);
+}
+
+void test_failed_step_is_reported(void) {
+    sdOk = false;
+    bool ok;
+    runBoot(ok);
+    TEST_ASSERT_FALSE(ok);
+    TEST_ASSERT_FALSE(boot->succeeded(sd));
+    TEST_ASSERT_TRUE(boot->succeeded(storage));
+    TEST_ASSERT_TRUE(boot->succeeded(hid));
+    
+    // Internal storage still works, so the steps after the card still run
+    TEST_ASSERT_TRUE(boot->succeeded(config));
+    std::vector<TimelineLine> lines = readTimeline();
+    TEST_ASSERT_TRUE(step(lines, "sd").failed);
+    TEST_ASSERT_FALSE(step(lines, "config").failed);
+    TEST_ASSERT_TRUE(step(lines, "config").startMs >= step(lines, "sd").endMs);
+}
+
+void test_timeline_file_format(void) {
+    bool ok;
+    runBoot(ok);
+    std::string text = LittleFSStorage->content(TIMELINE);
+    TEST_ASSERT_EQUAL(0, text.find("# start_ms end_ms duration_ms step\n"));
+    
+    // One line per step in the order added, then the menu
+    static const char* names[] = { "sd", "littlefs", "usb_hid", "display", "config", "autorun", "menu" };
+    std::vector<TimelineLine> lines = readTimeline();
+    TEST_ASSERT_EQUAL(7, lines.size());
+    for (size_t i = 0; i < lines.size(); i++) {
+        TEST_ASSERT_EQUAL_STRING(names[i], lines[i].name.c_str());
+        TEST_ASSERT_TRUE(lines[i].endMs >= lines[i].startMs);
+    }
+    TEST_ASSERT_EQUAL(boot->getReadyMs(), (uint32_t)step(lines, "menu").startMs);
+    TEST_ASSERT_TRUE(step(lines, "littlefs").endMs - step(lines, "littlefs").startMs >= STORAGE_MS);
+}
+
+void test_too_many_steps_are_dropped(void) {
+    for (size_t i = 6; i < BootSequence::MAX_STEPS; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, boot->add("extra", bootConfig));
+    }
+    TEST_ASSERT_EQUAL(0, boot->add("dropped", bootConfig));
+}
+
+int main(int argc, char** argv) {
+    HostClock::useVirtual(false);
+    
+    UNITY_BEGIN();
+    RUN_TEST(test_background_steps_overlap);
+    RUN_TEST(test_steps_wait_for_their_dependencies);
+    RUN_TEST(test_failed_step_is_reported);
+    RUN_TEST(test_timeline_file_format);
+    RUN_TEST(test_too_many_steps_are_dropped);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+// Compressed payloads (.dsz): a payload compressed like the tools/ script
+// reads back byte for byte through CompressedFile in any chunk size and
+// after seeks, runs the same as its text, and decodes in a fixed amount
+// of heap whatever its size.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <string>
+#include "CompressedFile.h"
+#include "DuckyScriptParser.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+#include "PayloadCompressor.h"
+
+static UsbTimingModel usb;
+
+// STRING heavy payload with repeats near and far, and lines that do not
+static std::string makeScript(size_t size) {
+    std::string script = "REM generated payload\nDEFAULTDELAY 0\n";
+    uint32_t seed = 12345;
+    for (uint32_t line = 0; script.size() < size; line++) {
+        char text[96];
+        snprintf(text, sizeof(text), "STRING echo line %u of the compressed payload > out.txt\nENTER\n", line);
+        script += text;
+        if (line % 10 == 0) {
+            script += "STRING ";
+            for (int i = 0; i < 40; i++) {
+                seed = seed * 1103515245 + 12345;
+                script += (char)('!' + (seed >> 16) % 94);
+            }
+            script += "\nDELAY 1\n";
+        }
+    }
+    script.resize(size);
+    return script;
+}
+
+static void addCompressed(const char* path, const std::string& content) {
+    LittleFSStorage->addFile(path, compressPayload(content));
+}
+
+static void runToEnd(DuckyScriptParser& parser) {
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+    LittleFSStorage->clear();
+}
+
+void tearDown(void) {}
+
+void test_round_trip_in_any_chunk_size(void) {
+    static const size_t chunks[] = { 1, 7, 64, 513, 4096 };
+    std::string script = makeScript(50000);
+    addCompressed("/payload.dsz", script);
+    printf("%u bytes compressed to %u\n", (unsigned)script.size(),
+           (unsigned)LittleFSStorage->content("/payload.dsz").size());
+    TEST_ASSERT_LESS_THAN(script.size() / 2, LittleFSStorage->content("/payload.dsz").size());
+    
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        File file = CompressedFile::open(LittleFS.open("/payload.dsz", FILE_READ));
+        TEST_ASSERT_TRUE(file);
+        TEST_ASSERT_EQUAL(script.size(), file.size());
+        
+        std::string decoded;
+        uint8_t buffer[4096];
+        size_t bytes;
+        while ((bytes = file.read(buffer, chunks[i])) > 0) {
+            decoded.append((const char*)buffer, bytes);
+        }
+        file.close();
+        TEST_ASSERT_EQUAL(script.size(), decoded.size());
+        TEST_ASSERT_TRUE(decoded == script);
+    }
+}
+
+void test_seek_forwards_and_back(void) {
+    std::string script = makeScript(20000);
+    addCompressed("/payload.dsz", script);
+    File file = CompressedFile::open(LittleFS.open("/payload.dsz", FILE_READ));
+    
+    static const uint32_t positions[] = { 15000, 100, 19990, 0, 8191 };
+    for (size_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        char buffer[10];
+        TEST_ASSERT_TRUE(file.seek(positions[i]));
+        TEST_ASSERT_EQUAL(positions[i], file.position());
+        size_t bytes = file.read((uint8_t*)buffer, sizeof(buffer));
+        TEST_ASSERT_EQUAL(std::min(sizeof(buffer), script.size() - positions[i]), bytes);
+        TEST_ASSERT_EQUAL_MEMORY(script.data() + positions[i], buffer, bytes);
+    }
+    TEST_ASSERT_FALSE(file.seek(script.size() + 1));
+    file.close();
+}
+
+void test_runs_like_the_text(void) {
+    std::string script = makeScript(60000);
+    LittleFSStorage->addFile("/payload.txt", script);
+    addCompressed("/payload.dsz", script);
+    
+    MockHIDDevice text(&usb, true);
+    DuckyScriptParser textParser;
+    textParser.setHIDDevice(&text);
+    textParser.execute(LittleFS.open("/payload.txt", FILE_READ));
+    runToEnd(textParser);
+    
+    MockHIDDevice compressed(&usb, true);
+    DuckyScriptParser compressedParser;
+    compressedParser.setHIDDevice(&compressed);
+    compressedParser.execute(CompressedFile::open(LittleFS.open("/payload.dsz", FILE_READ)));
+    runToEnd(compressedParser);
+    
+    TEST_ASSERT_GREATER_THAN(0, text.getReportCount());
+    TEST_ASSERT_EQUAL_UINT32(text.getReportCount(), compressed.getReportCount());
+    TEST_ASSERT_EQUAL_UINT64(text.getDurationUs(), compressed.getDurationUs());
+    for (size_t i = 0; i < text.getReports().size(); i++) {
+        TEST_ASSERT_EQUAL_MEMORY(&text.getReports()[i].report, &compressed.getReports()[i].report,
+                                 sizeof(HIDKeyReport));
+    }
+}
+
+// Peak heap of decoding a whole payload, file content excluded
+static size_t decodePeak(size_t size) {
+    LittleFSStorage->clear();
+    addCompressed("/payload.dsz", makeScript(size));
+    
+    HeapStats::resetPeak();
+    size_t before = HeapStats::get().current;
+    File file = CompressedFile::open(LittleFS.open("/payload.dsz", FILE_READ));
+    uint8_t buffer[256];
+    size_t total = 0;
+    size_t bytes;
+    while ((bytes = file.read(buffer, sizeof(buffer))) > 0) {
+        total += bytes;
+    }
+    file.close();
+    TEST_ASSERT_EQUAL(size, total);
+    return HeapStats::get().peak - before;
+}
+
+void test_decoder_heap_is_fixed(void) {
+    const size_t sizes[] = { 4 * 1024, 64 * 1024, 512 * 1024 };
+    size_t peaks[3];
+    for (size_t i = 0; i < 3; i++) {
+        peaks[i] = decodePeak(sizes[i]);
+        printf("decoded %4u KB, peak heap +%u bytes\n", (unsigned)(sizes[i] / 1024), (unsigned)peaks[i]);
+    }
+    
+    // Window, input block and the file handles
+    TEST_ASSERT_LESS_THAN(CompressedFile::WINDOW_SIZE + CompressedFile::INPUT_SIZE + 1024, peaks[0]);
+    for (size_t i = 1; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT32(peaks[0], peaks[i]);
+    }
+}
+
+void test_rejects_other_files(void) {
+    LittleFSStorage->addFile("/payload.dsz", "STRING not compressed\n");
+    TEST_ASSERT_FALSE(CompressedFile::open(LittleFS.open("/payload.dsz", FILE_READ)));
+    TEST_ASSERT_TRUE(CompressedFile::isCompressed("/x/payload.DSZ"));
+    TEST_ASSERT_FALSE(CompressedFile::isCompressed("/x/payload.txt"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_in_any_chunk_size);
+    RUN_TEST(test_seek_forwards_and_back);
+    RUN_TEST(test_runs_like_the_text);
+    RUN_TEST(test_decoder_heap_is_fixed);
+    RUN_TEST(test_rejects_other_files);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+// Background directory scans: PayloadManager on a slow simulated SD card
+// with the scan task on a real thread. Entering a folder returns at once,
+// the first screen of rows shows long before the listing ends, a folder
+// with an index shows it before it is checked, and leaving a folder
+// cancels its scan.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <unity.h>
+#include <vector>
+#include "PayloadCache.h"
+#include "PayloadManager.h"
+#include "MemoryFS.h"
+
+#define FOLDER_FILES        300
+#define LIST_US             2000    // Per directory entry, a slow card
+#define OPEN_US             500
+#define MENU_ROWS           5       // Rows the menu shows
+#define NAVIGATE_BOUND_US   50000
+#define FIRST_ROWS_BOUND_US 100000  // Scheduling slack included
+
+static PayloadManager manager;
+
+// loop() passes until the scan ends: update(), then a redraw. Returns
+// when the first MENU_ROWS rows could be drawn.
+static uint64_t runScan(uint64_t start, uint64_t& ended) {
+    uint64_t firstRows = 0;
+    while (true) {
+        manager.update();
+        if (!firstRows && manager.getFileCount() >= MENU_ROWS) firstRows = micros() - start;
+        if (!manager.isScanning()) break;
+        delay(1);
+    }
+    ended = micros() - start;
+    return firstRows;
+}
+
+static void enterPayloads(uint64_t& navigated, uint64_t& firstRows, uint64_t& ended) {
+    uint64_t start = micros();
+    TEST_ASSERT_TRUE(manager.navigateDown("payloads"));
+    navigated = micros() - start;
+    firstRows = runScan(start, ended);
+}
+
+static void clearIndexes() {
+    SDStorage->delays.listUs = 0;
+    File dir = SD.open(CACHE_DIR);
+    String name;
+    std::vector<String> paths;
+    while (dir && (name = dir.getNextFileName()).length() > 0) {
+        paths.push_back(name);
+    }
+    dir.close();
+    for (size_t i = 0; i < paths.size(); i++) {
+        SD.remove(paths[i]);
+    }
+    SDStorage->delays.listUs = LIST_US;
+}
+
+void setUp(void) {
+    // Every test starts in the card's root with no folder indexed
+    uint64_t ended;
+    while (strcmp(manager.getCurrentPath(), "Select Drive") != 0) {
+        manager.navigateUp();
+    }
+    clearIndexes();
+    TEST_ASSERT_TRUE(manager.navigateDown("SD Card"));
+    runScan(micros(), ended);
+    SDStorage->resetStats();
+}
+
+void tearDown(void) {}
+
+void test_first_rows_before_scan_ends(void) {
+    uint64_t navigated, firstRows, ended;
+    enterPayloads(navigated, firstRows, ended);
+    
+    printf("New folder of %u files: navigate %u us, first %u rows %u us, scan done %u us\n", FOLDER_FILES,
+           (unsigned)navigated, MENU_ROWS, (unsigned)firstRows, (unsigned)ended);
+    TEST_ASSERT_LESS_THAN(NAVIGATE_BOUND_US, (uint32_t)navigated);
+    TEST_ASSERT_TRUE(firstRows > 0);
+    TEST_ASSERT_LESS_THAN(FIRST_ROWS_BOUND_US, (uint32_t)firstRows);
+    // Listing the folder alone takes FOLDER_FILES * LIST_US
+    TEST_ASSERT_GREATER_OR_EQUAL(FOLDER_FILES * LIST_US, (uint32_t)ended);
+    
+    // The index replaces the preview, sorted
+    FileView view;
+    TEST_ASSERT_EQUAL(FOLDER_FILES, manager.getFileCount());
+    TEST_ASSERT_TRUE(manager.getFile(0, view));
+    TEST_ASSERT_EQUAL_STRING("payload_000.txt", view.name);
+    TEST_ASSERT_TRUE(manager.getFile(FOLDER_FILES - 1, view));
+    TEST_ASSERT_EQUAL_STRING("payload_299.txt", view.name);
+}
+
+void test_indexed_folder_shows_at_once(void) {
+    uint64_t navigated, firstRows, ended;
+    enterPayloads(navigated, firstRows, ended);
+    manager.navigateUp();
+    runScan(micros(), ended);
+    
+    // The last index is shown while the listing is checked against it
+    uint64_t start = micros();
+    TEST_ASSERT_TRUE(manager.navigateDown("payloads"));
+    navigated = micros() - start;
+    TEST_ASSERT_TRUE(manager.isScanning());
+    TEST_ASSERT_EQUAL(FOLDER_FILES, manager.getFileCount());
+    runScan(start, ended);
+    
+    printf("Indexed folder: all %u rows after %u us, checked after %u us\n", FOLDER_FILES, (unsigned)navigated,
+           (unsigned)ended);
+    TEST_ASSERT_LESS_THAN(NAVIGATE_BOUND_US, (uint32_t)navigated);
+    TEST_ASSERT_EQUAL(FOLDER_FILES, manager.getFileCount());
+}
+
+void test_leaving_folder_cancels_scan(void) {
+    TEST_ASSERT_TRUE(manager.navigateDown("payloads"));
+    while (manager.getFileCount() < MENU_ROWS) {
+        manager.update();
+        delay(1);
+    }
+    manager.navigateUp();
+    uint64_t ended;
+    runScan(micros(), ended);
+    
+    // The root's own listing is what is shown, and the cancelled scan
+    // stopped listing the large folder
+    FileView view;
+    TEST_ASSERT_EQUAL(2, manager.getFileCount());
+    TEST_ASSERT_TRUE(manager.getFile(0, view));
+    TEST_ASSERT_EQUAL_STRING("other", view.name);
+    TEST_ASSERT_TRUE(manager.getFile(1, view));
+    TEST_ASSERT_EQUAL_STRING("payloads", view.name);
+    printf("Listed %u entries before the scan was cancelled\n", SDStorage->stats.listed);
+    TEST_ASSERT_LESS_THAN(FOLDER_FILES, SDStorage->stats.listed);
+}
+
+int main(int argc, char** argv) {
+    HostClock::useVirtual(false);
+    SDStorage->clear();
+    for (uint32_t i = 0; i < FOLDER_FILES; i++) {
+        char path[48];
+        snprintf(path, sizeof(path), "/payloads/payload_%03u.txt", i);
+        SDStorage->addFile(path, "STRING hello\nENTER\n");
+    }
+    SDStorage->addFile("/other/one.txt", "STRING one\n");
+    SDStorage->delays.openUs = OPEN_US;
+    SDStorage->delays.listUs = LIST_US;
+    manager.begin();
+    
+    UNITY_BEGIN();
+    RUN_TEST(test_first_rows_before_scan_ends);
+    RUN_TEST(test_indexed_folder_shows_at_once);
+    RUN_TEST(test_leaving_folder_cancels_scan);
+    return UNITY_END();
+}
\ No newline at end of file
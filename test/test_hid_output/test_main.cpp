@@ -0,0 +1,190 @@
+// HID output path: SpscQueue on its own and across two threads, and
+// HIDOutputTask draining it on a host task in real time. Output keeps its
+// order and delays, goes on while the producer is busy, and cancel()
+// drops what is queued and releases the keys.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+#include "HIDOutputTask.h"
+
+#define STRESS_COUNT 2000000
+#define DELAY_SLACK_US 20000  // Scheduling slack on a loaded test machine
+
+extern HIDOutputTask HIDOutput;
+
+struct Written {
+    uint64_t timeUs;
+    HIDKeyReport report;
+};
+
+// Records what the output task writes, with the time it did
+class RecordingSink : public HIDReportSink {
+public:
+    std::mutex lock;
+    std::vector<Written> written;
+    
+    void writeReport(const HIDKeyReport& report) override {
+        std::lock_guard<std::mutex> guard(lock);
+        Written entry;
+        entry.timeUs = micros();
+        entry.report = report;
+        written.push_back(entry);
+    }
+    
+    void writeMediaKey(uint8_t mediaKey) override {}
+    
+    std::vector<Written> get() {
+        std::lock_guard<std::mutex> guard(lock);
+        return written;
+    }
+};
+
+static RecordingSink sink;
+
+static HIDKeyReport keyReport(uint8_t usage) {
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    report.keys[0] = usage;
+    return report;
+}
+
+static void waitIdle() {
+    while (!HIDOutput.isIdle()) {
+        delay(1);
+    }
+}
+
+void setUp() {
+    waitIdle();
+    std::lock_guard<std::mutex> guard(sink.lock);
+    sink.written.clear();
+}
+
+void tearDown() {}
+
+void test_queue_fifo_and_capacity() {
+    SpscQueue<int, 8> queue;
+    int value = 0;
+    TEST_ASSERT_TRUE(queue.empty());
+    TEST_ASSERT_FALSE(queue.pop(value));
+    TEST_ASSERT_EQUAL(7, queue.capacity());
+    
+    // Wrap around the ring several times
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 5; round++) {
+        while (queue.push(next)) {
+            next++;
+        }
+        TEST_ASSERT_EQUAL(7, queue.size());
+        for (int i = 0; i < 4; i++) {
+            TEST_ASSERT_TRUE(queue.pop(value));
+            TEST_ASSERT_EQUAL(expected++, value);
+        }
+        TEST_ASSERT_EQUAL(3, queue.size());
+    }
+    while (queue.pop(value)) {
+        TEST_ASSERT_EQUAL(expected++, value);
+    }
+    TEST_ASSERT_EQUAL(next, expected);
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_queue_across_threads() {
+    static SpscQueue<uint32_t, 128> queue;
+    bool ordered = true;
+    
+    // Both sides yield while they wait, so one core is enough
+    std::thread consumer([&]() {
+        uint32_t expected = 0;
+        uint32_t value;
+        while (expected < STRESS_COUNT) {
+            if (!queue.pop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (value != expected) ordered = false;
+            expected++;
+        }
+    });
+    for (uint32_t i = 0; i < STRESS_COUNT; i++) {
+        while (!queue.push(i)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_order_and_delays() {
+    HIDOutput.pushReport(&sink, keyReport(0x04));
+    HIDOutput.pushDelay(50);
+    HIDOutput.pushReport(&sink, keyReport(0x05));
+    HIDOutput.pushDelay(20);
+    HIDOutput.pushReport(&sink, keyReport(0x06));
+    waitIdle();
+    
+    std::vector<Written> written = sink.get();
+    TEST_ASSERT_EQUAL(3, written.size());
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(0x04 + i, written[i].report.keys[0]);
+    }
+    uint32_t first = (uint32_t)(written[1].timeUs - written[0].timeUs);
+    uint32_t second = (uint32_t)(written[2].timeUs - written[1].timeUs);
+    TEST_ASSERT_GREATER_OR_EQUAL(50000, first);
+    TEST_ASSERT_LESS_THAN(50000 + DELAY_SLACK_US, first);
+    TEST_ASSERT_GREATER_OR_EQUAL(20000, second);
+    TEST_ASSERT_LESS_THAN(20000 + DELAY_SLACK_US, second);
+}
+
+void test_output_while_producer_busy() {
+    // The producer blocks like a display redraw, the output goes on
+    uint64_t start = micros();
+    for (uint8_t i = 0; i < 20; i++) {
+        HIDOutput.pushReport(&sink, keyReport(0x04 + i));
+        HIDOutput.pushDelay(2);
+    }
+    delay(100);
+    
+    std::vector<Written> written = sink.get();
+    TEST_ASSERT_EQUAL(20, written.size());
+    TEST_ASSERT_LESS_THAN(100000, (uint32_t)(written.back().timeUs - start));
+}
+
+void test_cancel_drops_queued_output() {
+    HIDOutput.pushReport(&sink, keyReport(0x04));
+    HIDOutput.pushDelay(1000);
+    HIDOutput.pushReport(&sink, keyReport(0x05));
+    delay(20);
+    
+    uint64_t cancelled = micros();
+    HIDOutput.cancel();
+    waitIdle();
+    delay(20);
+    
+    std::vector<Written> written = sink.get();
+    TEST_ASSERT_EQUAL(2, written.size());
+    TEST_ASSERT_EQUAL(0x04, written[0].report.keys[0]);
+    HIDKeyReport released;
+    memset(&released, 0, sizeof(released));
+    TEST_ASSERT_EQUAL_MEMORY(&released, &written[1].report, sizeof(released));
+    TEST_ASSERT_LESS_THAN(10000, (uint32_t)(written[1].timeUs - cancelled));
+}
+
+int main() {
+    HostClock::useVirtual(false);
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_fifo_and_capacity);
+    RUN_TEST(test_queue_across_threads);
+    TEST_ASSERT_TRUE(HIDOutput.begin());
+    RUN_TEST(test_order_and_delays);
+    RUN_TEST(test_output_while_producer_busy);
+    RUN_TEST(test_cancel_drops_queued_output);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+// Offline .hidr compile: a payload compiled with compileScript() plays
+// back as exactly the reports, media keys and timeline of running its
+// text, for a buffered and a streamed payload and for a non-US layout.
+// The header names the layout and the source script.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <string>
+#include "DuckyScriptParser.h"
+#include "HIDReportFile.h"
+#include "PayloadManager.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+#include "ScriptCompiler.h"
+
+static const char* SCRIPT =
+    "DEFAULTDELAY 5\n"
+    "GUI r\n"
+    "DELAY 300\n"
+    "STRING notepad\n"
+    "ENTER\n"
+    "DELAY 500\n"
+    "STRING Hello, World! 0123 <>|{}[]@\n"
+    "CTRL ALT DELETE\n"
+    "MUTE\n"
+    "STRING aaa bbb ccc\n"
+    "REPEAT 3\n"
+    "ENTER\n";
+
+static UsbTimingModel usb(1000);
+static MockHIDDevice textDevice(&usb);
+static MockHIDDevice reportDevice(&usb);
+
+static void runText(const char* path) {
+    textDevice.reset();
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&textDevice);
+    File file = LittleFS.open(path, FILE_READ);
+    if (file.size() > PayloadManager::MAX_LOAD_SIZE) {
+        parser.execute(file);
+    } else {
+        PayloadManager manager;
+        uint32_t length = 0;
+        char* buffer = manager.readBuffer(file, length);
+        file.close();
+        parser.execute(buffer, length);
+    }
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+}
+
+static void runReport(const char* path) {
+    reportDevice.reset();
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&reportDevice);
+    parser.play(LittleFS.open(path, FILE_READ));
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+}
+
+static uint32_t compile(const char* scriptPath, const char* reportPath) {
+    File script = LittleFS.open(scriptPath, FILE_READ);
+    File output = LittleFS.open(reportPath, FILE_WRITE);
+    uint32_t records = compileScript(script, output);
+    script.close();
+    output.close();
+    return records;
+}
+
+static void assertSamePlayback(const char* scriptPath) {
+    TEST_ASSERT_GREATER_THAN(0, compile(scriptPath, "/out.hidr"));
+    runText(scriptPath);
+    runReport("/out.hidr");
+    
+    const std::vector<MockReport>& text = textDevice.getReports();
+    const std::vector<MockReport>& played = reportDevice.getReports();
+    TEST_ASSERT_GREATER_THAN(0, text.size());
+    TEST_ASSERT_EQUAL(text.size(), played.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT64(text[i].timeUs, played[i].timeUs);
+        TEST_ASSERT_EQUAL(text[i].media, played[i].media);
+        TEST_ASSERT_EQUAL(text[i].mediaKey, played[i].mediaKey);
+        TEST_ASSERT_EQUAL_MEMORY(&text[i].report, &played[i].report, sizeof(HIDKeyReport));
+    }
+    TEST_ASSERT_EQUAL_UINT64(textDevice.getDurationUs(), reportDevice.getDurationUs());
+    TEST_ASSERT_EQUAL_STRING(textDevice.getDecoder().getPreview(), reportDevice.getDecoder().getPreview());
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+    LittleFSStorage->clear();
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+}
+
+void tearDown(void) {
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+}
+
+void test_buffered_payload_plays_back_the_same(void) {
+    LittleFSStorage->addFile("/hello.txt", SCRIPT);
+    assertSamePlayback("/hello.txt");
+}
+
+void test_streamed_payload_plays_back_the_same(void) {
+    std::string script;
+    while (script.size() <= PayloadManager::MAX_LOAD_SIZE) {
+        script += SCRIPT;
+    }
+    LittleFSStorage->addFile("/large.txt", script);
+    assertSamePlayback("/large.txt");
+}
+
+void test_layout_is_compiled_in(void) {
+    LittleFSStorage->addFile("/hello.txt", "STRING zy@\n");
+    HIDReportEncoder::setLayout(findKeyboardLayout("DE"));
+    assertSamePlayback("/hello.txt");
+    
+    HIDRHeader header;
+    std::string stream = LittleFSStorage->content("/out.hidr");
+    memcpy(&header, stream.data(), sizeof(header));
+    TEST_ASSERT_EQUAL_STRING("DE", header.layout);
+    
+    // Z is on the US Y key
+    const HIDRecord* records = (const HIDRecord*)(stream.data() + sizeof(header));
+    TEST_ASSERT_EQUAL(HIDR_REPORT, records[0].type);
+    TEST_ASSERT_EQUAL(0x1C, records[0].data[0]);
+}
+
+void test_header_names_the_source(void) {
+    LittleFSStorage->addFile("/hello.txt", SCRIPT);
+    LittleFSStorage->setLastWrite("/hello.txt", 1700000000);
+    compile("/hello.txt", "/out.hidr");
+    
+    HIDRHeader header;
+    std::string stream = LittleFSStorage->content("/out.hidr");
+    memcpy(&header, stream.data(), sizeof(header));
+    TEST_ASSERT_EQUAL(0, memcmp(header.magic, HIDR_MAGIC, 4));
+    TEST_ASSERT_EQUAL(HIDR_VERSION, header.version);
+    TEST_ASSERT_EQUAL(strlen(SCRIPT), header.source.size);
+    TEST_ASSERT_EQUAL_UINT32(1700000000, header.source.modified);
+    TEST_ASSERT_EQUAL(0, (stream.size() - sizeof(header)) % sizeof(HIDRecord));
+}
+
+void test_empty_script_compiles_nothing(void) {
+    LittleFSStorage->addFile("/empty.txt", "");
+    TEST_ASSERT_EQUAL(0, compile("/empty.txt", "/out.hidr"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_buffered_payload_plays_back_the_same);
+    RUN_TEST(test_streamed_payload_plays_back_the_same);
+    RUN_TEST(test_layout_is_compiled_in);
+    RUN_TEST(test_header_names_the_source);
+    RUN_TEST(test_empty_script_compiles_nothing);
+    return UNITY_END();
+}
\ No newline at end of file
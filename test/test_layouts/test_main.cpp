@@ -0,0 +1,228 @@
+// Keyboard layouts: every printable character a layout can type goes
+// through HIDReportEncoder and comes back from a host keyboard set to the
+// same layout, on its own and packed into one text. The host here reads
+// code points, not just the ASCII the report decoder keeps, and resolves
+// dead keys the way the host's layout does.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "HIDReportEncoder.h"
+#include "KeyboardLayout.h"
+
+#define LEVEL_MASK  (LAYOUT_MOD_SHIFT | LAYOUT_MOD_ALTGR)
+#define USAGE_SPACE 0x2C
+#define NO_CHAR     0xFFFD
+
+// A dead key sequence or a plain key as the host sees it
+static uint32_t keyId(uint8_t deadUsage, uint8_t deadModifiers, uint8_t usage, uint8_t modifiers) {
+    return ((uint32_t)deadUsage << 24) | ((uint32_t)(deadModifiers & LEVEL_MASK) << 16) | ((uint32_t)usage << 8) |
+           (modifiers & LEVEL_MASK);
+}
+
+// Host side of a layout: what each key and dead key sequence types
+class HostKeyboard {
+private:
+    std::map<uint32_t, uint32_t> typed;
+    std::map<uint16_t, bool> deadKeys;
+    HIDKeyReport previous;
+    uint8_t pendingUsage;
+    uint8_t pendingModifiers;
+    
+    bool wasPressed(uint8_t usage) {
+        for (uint8_t i = 0; i < 6; i++) {
+            if (previous.keys[i] == usage) return true;
+        }
+        return false;
+    }
+    
+public:
+    std::vector<uint32_t> text;
+    std::vector<uint32_t> conflicts;  // Code points on the same key as another
+    
+    explicit HostKeyboard(const std::vector<uint32_t>& codepoints) : pendingUsage(0), pendingModifiers(0) {
+        memset(&previous, 0, sizeof(previous));
+        for (size_t i = 0; i < codepoints.size(); i++) {
+            LayoutKey key;
+            HIDReportEncoder::getLayout()->lookup(codepoints[i], key);
+            uint32_t id = keyId(key.deadUsage, key.deadModifiers, key.usage, key.modifiers);
+            if (typed.count(id)) conflicts.push_back(codepoints[i]);
+            typed[id] = codepoints[i];
+            if (key.deadUsage) deadKeys[(key.deadUsage << 8) | (key.deadModifiers & LEVEL_MASK)] = true;
+        }
+    }
+    
+    void feed(const HIDKeyReport& report) {
+        for (uint8_t i = 0; i < 6; i++) {
+            uint8_t usage = report.keys[i];
+            if (usage == 0 || wasPressed(usage)) continue;
+            
+            uint8_t level = report.modifiers & LEVEL_MASK;
+            if (!pendingUsage && deadKeys.count((usage << 8) | level)) {
+                pendingUsage = usage;
+                pendingModifiers = level;
+                continue;
+            }
+            std::map<uint32_t, uint32_t>::iterator found = typed.find(keyId(pendingUsage, pendingModifiers, usage, level));
+            text.push_back(found == typed.end() ? NO_CHAR : found->second);
+            pendingUsage = 0;
+            pendingModifiers = 0;
+        }
+        previous = report;
+    }
+};
+
+static void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out += (char)codepoint;
+    } else if (codepoint < 0x800) {
+        out += (char)(0xC0 | (codepoint >> 6));
+        out += (char)(0x80 | (codepoint & 0x3F));
+    } else {
+        out += (char)(0xE0 | (codepoint >> 12));
+        out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out += (char)(0x80 | (codepoint & 0x3F));
+    }
+}
+
+// Everything the active layout types that is not a control character
+static std::vector<uint32_t> printable() {
+    const KeyboardLayout* layout = HIDReportEncoder::getLayout();
+    std::vector<uint32_t> codepoints;
+    LayoutKey key;
+    for (uint32_t c = 0x20; c <= 0xFF; c++) {
+        if (c >= 0x7F && c < 0xA0) continue;
+        if (layout->lookup(c, key)) codepoints.push_back(c);
+    }
+    for (uint8_t i = 0; i < layout->extraCount; i++) {
+        codepoints.push_back(layout->extra[i].codepoint);
+    }
+    return codepoints;
+}
+
+static std::vector<uint32_t> roundTrip(const std::vector<uint32_t>& codepoints, const std::vector<uint32_t>& layoutChars,
+                                       size_t& reportCount) {
+    std::string utf8;
+    for (size_t i = 0; i < codepoints.size(); i++) {
+        appendUtf8(utf8, codepoints[i]);
+    }
+    
+    HostKeyboard host(layoutChars);
+    HIDReportEncoder encoder;
+    HIDKeyReport report;
+    encoder.begin(utf8.c_str(), utf8.size());
+    reportCount = 0;
+    while (encoder.next(report)) {
+        host.feed(report);
+        reportCount++;
+    }
+    
+    // Everything released at the end
+    HIDKeyReport released;
+    memset(&released, 0, sizeof(released));
+    TEST_ASSERT_EQUAL_MEMORY(&released, &report, sizeof(released));
+    return host.text;
+}
+
+static void assertLayoutRoundTrips(const char* name) {
+    const KeyboardLayout* layout = findKeyboardLayout(name);
+    TEST_ASSERT_NOT_NULL(layout);
+    HIDReportEncoder::setLayout(layout);
+    std::vector<uint32_t> chars = printable();
+    
+    // No two characters share a key or dead key sequence
+    HostKeyboard host(chars);
+    TEST_ASSERT_EQUAL(0, host.conflicts.size());
+    
+    // Each character on its own
+    size_t reports;
+    for (size_t i = 0; i < chars.size(); i++) {
+        std::vector<uint32_t> one(1, chars[i]);
+        std::vector<uint32_t> typed = roundTrip(one, chars, reports);
+        TEST_ASSERT_EQUAL(1, typed.size());
+        TEST_ASSERT_EQUAL_UINT32(chars[i], typed[0]);
+    }
+    
+    // All of them as one text, forwards and backwards, so dead keys and
+    // packed keys follow every kind of character
+    std::vector<uint32_t> text = chars;
+    text.insert(text.end(), chars.rbegin(), chars.rend());
+    std::vector<uint32_t> typed = roundTrip(text, chars, reports);
+    TEST_ASSERT_EQUAL(text.size(), typed.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(text[i], typed[i]);
+    }
+    printf("%s: %u printable characters, %u reports for %u characters\n", name, (unsigned)chars.size(),
+           (unsigned)reports, (unsigned)text.size());
+}
+
+static void assertKey(uint32_t codepoint, uint8_t usage, uint8_t modifiers, uint8_t deadUsage = 0) {
+    LayoutKey key;
+    TEST_ASSERT_TRUE(HIDReportEncoder::getLayout()->lookup(codepoint, key));
+    TEST_ASSERT_EQUAL(usage, key.usage);
+    TEST_ASSERT_EQUAL(modifiers, key.modifiers);
+    TEST_ASSERT_EQUAL(deadUsage, key.deadUsage);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+}
+
+void test_us_round_trips(void) { assertLayoutRoundTrips("US"); }
+void test_uk_round_trips(void) { assertLayoutRoundTrips("UK"); }
+void test_de_round_trips(void) { assertLayoutRoundTrips("DE"); }
+void test_fr_round_trips(void) { assertLayoutRoundTrips("FR"); }
+void test_es_round_trips(void) { assertLayoutRoundTrips("ES"); }
+void test_it_round_trips(void) { assertLayoutRoundTrips("IT"); }
+void test_se_round_trips(void) { assertLayoutRoundTrips("SE"); }
+
+void test_every_layout_types_ascii(void) {
+    // Italian keyboards have no ` or ~ key, everything else types all of it
+    for (size_t i = 0; i < KEYBOARD_LAYOUT_COUNT; i++) {
+        const KeyboardLayout& layout = KEYBOARD_LAYOUTS[i];
+        std::string missing;
+        LayoutKey key;
+        for (char c = 0x20; c < 0x7F; c++) {
+            if (!layout.lookup(c, key)) missing += c;
+        }
+        TEST_ASSERT_EQUAL_STRING(strcmp(layout.name, "IT") == 0 ? "`~" : "", missing.c_str());
+    }
+}
+
+void test_known_keys(void) {
+    // Spot checks against the printed layouts, not the generated tables
+    HIDReportEncoder::setLayout(findKeyboardLayout("DE"));
+    assertKey('z', 0x1C, 0);                          // On the US Y key
+    assertKey('@', 0x14, LAYOUT_MOD_ALTGR);
+    assertKey(0xDF, 0x2D, 0);                         // ß
+    assertKey(0xE2, 0x04, 0, 0x35);                   // â, dead ^ then a
+    HIDReportEncoder::setLayout(findKeyboardLayout("FR"));
+    assertKey('a', 0x14, 0);
+    assertKey('1', 0x1E, LAYOUT_MOD_SHIFT);
+    assertKey(0xEA, 0x08, 0, 0x2F);                   // ê
+    HIDReportEncoder::setLayout(findKeyboardLayout("UK"));
+    assertKey('"', 0x1F, LAYOUT_MOD_SHIFT);
+    assertKey(0xA3, 0x20, LAYOUT_MOD_SHIFT);          // £
+    HIDReportEncoder::setLayout(findKeyboardLayout("SE"));
+    assertKey(0xE5, 0x2F, 0);                         // å
+    assertKey(0x20AC, 0x08, LAYOUT_MOD_ALTGR);        // €, AltGr+E
+    assertKey('~', USAGE_SPACE, 0, 0x30);             // Dead ~ then space
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_us_round_trips);
+    RUN_TEST(test_uk_round_trips);
+    RUN_TEST(test_de_round_trips);
+    RUN_TEST(test_fr_round_trips);
+    RUN_TEST(test_es_round_trips);
+    RUN_TEST(test_it_round_trips);
+    RUN_TEST(test_se_round_trips);
+    RUN_TEST(test_every_layout_types_ascii);
+    RUN_TEST(test_known_keys);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Loaded scripts: execute() indexes lines as spans into the one script
+// buffer, so the setup allocates a fixed number of blocks whatever the
+// line count. Prints setup time and heap high-water mark per size.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include "DuckyScriptParser.h"
+#include "HeapStats.h"
+#include "MockHIDDevice.h"
+
+static UsbTimingModel usb;
+
+static char* makeScript(uint32_t lineCount, uint32_t& length) {
+    std::string script;
+    for (uint32_t line = 0; line < lineCount; line++) {
+        char text[64];
+        switch (line % 4) {
+            case 0: snprintf(text, sizeof(text), "STRING line %u\n", line); break;
+            case 1: snprintf(text, sizeof(text), "ENTER\n"); break;
+            case 2: snprintf(text, sizeof(text), "REM comment %u\n", line); break;
+            default: snprintf(text, sizeof(text), "DELAY %u\n", line % 10); break;
+        }
+        script += text;
+    }
+    length = script.size();
+    char* buffer = (char*)malloc(length + 1);
+    memcpy(buffer, script.c_str(), length + 1);
+    return buffer;
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+}
+
+void tearDown(void) {}
+
+void test_setup_allocations_do_not_depend_on_line_count(void) {
+    const uint32_t counts[] = { 1000, 10000, 100000 };
+    
+    for (size_t i = 0; i < 3; i++) {
+        MockHIDDevice device(&usb, false, false);
+        DuckyScriptParser parser;
+        parser.setHIDDevice(&device);
+        uint32_t length = 0;
+        char* script = makeScript(counts[i], length);
+        
+        HeapStats::resetPeak();
+        HeapStats::Snapshot before = HeapStats::get();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        parser.execute(script, length);
+        long setupUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        HeapStats::Snapshot after = HeapStats::get();
+        
+        // Line spans, and the op array twice while it is shrunk to fit
+        size_t indexBytes = counts[i] * (sizeof(LineSpan) + 2 * sizeof(DuckyOp));
+        printf("%6u lines, %7u bytes: execute() %6ld us, %u allocations, peak +%u bytes (%.1f per line)\n",
+               counts[i], length, setupUs, (unsigned)(after.allocations - before.allocations),
+               (unsigned)(after.peak - before.current), (double)(after.peak - before.current) / counts[i]);
+        TEST_ASSERT_LESS_OR_EQUAL(4, after.allocations - before.allocations);
+        TEST_ASSERT_LESS_OR_EQUAL(indexBytes + 1024, after.peak - before.current);
+        
+        // The current line is a view into the script buffer
+        ScriptLine line = parser.getCurrentLine();
+        TEST_ASSERT_EQUAL_STRING_LEN("STRING line 0", line.text, line.length);
+        while (!parser.isExecutionComplete()) {
+            parser.process();
+        }
+        TEST_ASSERT_GREATER_THAN(counts[i] / 4, device.getReportCount());
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_setup_allocations_do_not_depend_on_line_count);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+// Card cache of compiled payloads: a script recorded to the end plays back
+// from its recording, an edit or another layout misses, an aborted run
+// keeps nothing, and scripts that load faster than a recording starts are
+// not recorded.
+
+#include <Arduino.h>
+#include <SD.h>
+#include <unity.h>
+#include <string>
+#include "DuckyScriptParser.h"
+#include "PayloadCache.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+
+#define SCRIPT_PATH "/payload.txt"
+
+static UsbTimingModel usb(1000);
+static MockHIDDevice device(&usb);
+static PayloadCache cache;
+
+static std::string makeScript(size_t size) {
+    std::string script;
+    for (uint32_t line = 0; script.size() < size; line++) {
+        script += "STRING line " + std::to_string(line) + " of the cached payload\nENTER\n";
+    }
+    return script;
+}
+
+static HIDRSource keyOf(const char* path) {
+    File file = SD.open(path, FILE_READ);
+    HIDRSource source = cache.sourceKey(file);
+    file.close();
+    return source;
+}
+
+// A recording run paces itself on millis(), the clock is moved over the wait
+static void step(DuckyScriptParser& parser) {
+    unsigned long wakeAt = parser.process();
+    if ((long)(wakeAt - millis()) > 0) HostClock::advanceTo((uint64_t)wakeAt * 1000);
+}
+
+// Records a run of the script, to the end or aborted after the first report
+static void recordRun(bool toEnd) {
+    File file = SD.open(SCRIPT_PATH, FILE_READ);
+    HIDRSource source = cache.sourceKey(file);
+    DuckyScriptParser parser;
+    parser.setHIDDevice(cache.record(SD, SCRIPT_PATH, source, &device));
+    parser.execute(file);
+    while (!parser.isExecutionComplete() && (toEnd || device.getReportCount() == 0)) {
+        step(parser);
+    }
+    cache.finish(parser.isExecutionComplete());
+    parser.stopExecution();
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+    SDStorage->clear();
+    device.reset();
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+    SDStorage->addFile(SCRIPT_PATH, makeScript(PayloadCache::MIN_SCRIPT_SIZE * 2));
+}
+
+void tearDown(void) {
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+}
+
+void test_recording_plays_back(void) {
+    recordRun(true);
+    uint32_t reports = device.getReportCount();
+    
+    File recording = cache.lookup(SD, SCRIPT_PATH, keyOf(SCRIPT_PATH));
+    TEST_ASSERT_TRUE(recording);
+    device.reset();
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&device);
+    parser.play(recording);
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+    TEST_ASSERT_GREATER_THAN(0, reports);
+    TEST_ASSERT_EQUAL(reports, device.getReportCount());
+}
+
+void test_edit_or_layout_misses(void) {
+    recordRun(true);
+    HIDRSource source = keyOf(SCRIPT_PATH);
+    
+    HIDReportEncoder::setLayout(findKeyboardLayout("DE"));
+    TEST_ASSERT_FALSE(cache.lookup(SD, SCRIPT_PATH, source));
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+    TEST_ASSERT_TRUE(cache.lookup(SD, SCRIPT_PATH, source));
+    
+    // Same size, new content and write time
+    std::string edited = SDStorage->content(SCRIPT_PATH);
+    edited[0] = 'R';
+    SDStorage->addFile(SCRIPT_PATH, edited);
+    TEST_ASSERT_FALSE(cache.lookup(SD, SCRIPT_PATH, keyOf(SCRIPT_PATH)));
+}
+
+void test_aborted_run_keeps_nothing(void) {
+    recordRun(false);
+    TEST_ASSERT_FALSE(cache.lookup(SD, SCRIPT_PATH, keyOf(SCRIPT_PATH)));
+}
+
+void test_small_script_is_not_recorded(void) {
+    SDStorage->addFile(SCRIPT_PATH, "STRING hello\nENTER\n");
+    HIDRSource source = keyOf(SCRIPT_PATH);
+    TEST_ASSERT_TRUE(&device == cache.record(SD, SCRIPT_PATH, source, &device));
+    
+    SDStorage->resetStats();
+    TEST_ASSERT_FALSE(cache.lookup(SD, SCRIPT_PATH, source));
+    TEST_ASSERT_EQUAL(0, SDStorage->stats.opens);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_recording_plays_back);
+    RUN_TEST(test_edit_or_layout_misses);
+    RUN_TEST(test_aborted_run_keeps_nothing);
+    RUN_TEST(test_small_script_is_not_recorded);
+    return UNITY_END();
+}
\ No newline at end of file
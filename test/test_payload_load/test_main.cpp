@@ -0,0 +1,71 @@
+// Loading a payload into RAM: readBuffer() returns the rest of the file
+// in one terminated buffer, and a read that stops early, as when the card
+// is pulled out, fails instead of handing back part of the payload.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <string>
+#include "HeapStats.h"
+#include "MemoryFS.h"
+#include "PayloadManager.h"
+
+#define PAYLOAD_SIZE 10000
+
+static PayloadManager manager;
+
+static std::string makeScript(size_t size) {
+    std::string script;
+    for (uint32_t line = 0; script.size() < size; line++) {
+        script += "STRING line " + std::to_string(line) + "\nENTER\n";
+    }
+    script.resize(size);
+    return script;
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+    LittleFSStorage->clear();
+    LittleFSStorage->addFile("/payload.txt", makeScript(PAYLOAD_SIZE));
+}
+
+void tearDown(void) {}
+
+void test_whole_file_in_one_buffer(void) {
+    File file = LittleFS.open("/payload.txt", FILE_READ);
+    file.seek(100);
+    uint32_t length = 0;
+    char* buffer = manager.readBuffer(file, length);
+    file.close();
+    
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_EQUAL(PAYLOAD_SIZE - 100, length);
+    TEST_ASSERT_EQUAL('\0', buffer[length]);
+    TEST_ASSERT_TRUE(std::string(buffer, length) == makeScript(PAYLOAD_SIZE).substr(100));
+    free(buffer);
+}
+
+void test_short_read_fails(void) {
+    LittleFSStorage->resetStats();
+    LittleFSStorage->readLimit = PAYLOAD_SIZE / 2;
+    size_t before = HeapStats::get().current;
+    
+    File file = LittleFS.open("/payload.txt", FILE_READ);
+    uint32_t length = 1;
+    TEST_ASSERT_NULL(manager.readBuffer(file, length));
+    TEST_ASSERT_EQUAL(0, length);
+    TEST_ASSERT_EQUAL(PAYLOAD_SIZE / 2, LittleFSStorage->stats.bytesRead);
+    
+    file.seek(0);
+    LittleFSStorage->resetStats();
+    TEST_ASSERT_EQUAL(0, manager.readFile(file).length());
+    file.close();
+    TEST_ASSERT_EQUAL_UINT32(before, HeapStats::get().current);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_whole_file_in_one_buffer);
+    RUN_TEST(test_short_read_fails);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+// RAM cache of recently run payloads: hits return the stored bytes, a
+// changed write time or another storage misses, the least recently used
+// entry goes first within the byte budget, pinned entries never go, and
+// a File opened from an entry stays readable after it is evicted.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <SD.h>
+#include <unity.h>
+#include <string>
+#include "PayloadRamCache.h"
+#include "HeapStats.h"
+
+#define MODIFIED   1700000000
+#define FULL_ENTRY PayloadRamCache::MAX_ENTRY_SIZE
+
+static PayloadRamCache cache;
+
+static char* copyOf(const std::string& content) {
+    char* data = (char*)malloc(content.size() + 1);
+    memcpy(data, content.c_str(), content.size() + 1);
+    return data;
+}
+
+static std::string contentOf(const char* path, size_t size) {
+    std::string content = std::string(path) + "\n";
+    while (content.size() < size) {
+        content += "STRING cached payload\n";
+    }
+    content.resize(size);
+    return content;
+}
+
+static bool insert(const char* path, size_t size, bool compiled = false, const fs::FS* storage = &SD) {
+    return cache.insert(storage, path, MODIFIED, copyOf(contentOf(path, size)), size, compiled);
+}
+
+static std::string readAll(File& file) {
+    std::string content;
+    char buffer[512];
+    size_t bytes;
+    while ((bytes = file.read((uint8_t*)buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, bytes);
+    }
+    return content;
+}
+
+static bool hit(const char* path) {
+    bool compiled;
+    return cache.lookup(&SD, path, MODIFIED, compiled);
+}
+
+void setUp(void) {
+    cache = PayloadRamCache();
+}
+
+void tearDown(void) {}
+
+void test_hit_returns_the_stored_bytes(void) {
+    TEST_ASSERT_TRUE(insert("/a.txt", 1000));
+    TEST_ASSERT_TRUE(insert("/b.txt", 2000, true));
+    TEST_ASSERT_EQUAL(3000, cache.getUsed());
+    
+    bool compiled = true;
+    File file = cache.lookup(&SD, "/a.txt", MODIFIED, compiled);
+    TEST_ASSERT_TRUE(file);
+    TEST_ASSERT_FALSE(compiled);
+    TEST_ASSERT_EQUAL(1000, file.size());
+    TEST_ASSERT_TRUE(readAll(file) == contentOf("/a.txt", 1000));
+    TEST_ASSERT_EQUAL_STRING("a.txt", file.name());
+    
+    file = cache.lookup(&SD, "/b.txt", MODIFIED, compiled);
+    TEST_ASSERT_TRUE(compiled);
+    TEST_ASSERT_TRUE(readAll(file) == contentOf("/b.txt", 2000));
+}
+
+void test_other_version_or_storage_misses(void) {
+    insert("/a.txt", 1000);
+    bool compiled;
+    TEST_ASSERT_FALSE(cache.lookup(&SD, "/a.txt", MODIFIED + 1, compiled));
+    TEST_ASSERT_FALSE(cache.lookup(&LittleFS, "/a.txt", MODIFIED, compiled));
+    TEST_ASSERT_FALSE(cache.contains(&SD, "/a.txt", MODIFIED + 1));
+    TEST_ASSERT_TRUE(cache.contains(&SD, "/a.txt", MODIFIED));
+    
+    // A new version replaces the old one
+    cache.insert(&SD, "/a.txt", MODIFIED + 1, copyOf("new"), 3, false);
+    TEST_ASSERT_FALSE(hit("/a.txt"));
+    TEST_ASSERT_TRUE(cache.lookup(&SD, "/a.txt", MODIFIED + 1, compiled));
+    TEST_ASSERT_EQUAL(3, cache.getUsed());
+    
+    cache.invalidate(&SD, "/a.txt");
+    TEST_ASSERT_FALSE(cache.lookup(&SD, "/a.txt", MODIFIED + 1, compiled));
+    TEST_ASSERT_EQUAL(0, cache.getUsed());
+}
+
+void test_least_recently_used_goes_first(void) {
+    TEST_ASSERT_TRUE(insert("/a.txt", FULL_ENTRY));
+    TEST_ASSERT_TRUE(insert("/b.txt", FULL_ENTRY));
+    TEST_ASSERT_TRUE(insert("/c.txt", FULL_ENTRY));
+    TEST_ASSERT_EQUAL(PayloadRamCache::BUDGET, cache.getUsed());
+    
+    TEST_ASSERT_TRUE(hit("/a.txt"));
+    TEST_ASSERT_TRUE(insert("/d.txt", FULL_ENTRY));
+    TEST_ASSERT_FALSE(hit("/b.txt"));
+    TEST_ASSERT_TRUE(hit("/a.txt"));
+    TEST_ASSERT_TRUE(hit("/c.txt"));
+    TEST_ASSERT_TRUE(hit("/d.txt"));
+    TEST_ASSERT_EQUAL(PayloadRamCache::BUDGET, cache.getUsed());
+}
+
+void test_entry_count_is_bounded(void) {
+    char path[16];
+    for (size_t i = 0; i <= PayloadRamCache::MAX_ENTRIES; i++) {
+        snprintf(path, sizeof(path), "/%02u.txt", (unsigned)i);
+        TEST_ASSERT_TRUE(insert(path, 100));
+    }
+    TEST_ASSERT_FALSE(hit("/00.txt"));
+    TEST_ASSERT_TRUE(hit("/01.txt"));
+    TEST_ASSERT_TRUE(hit(path));
+    TEST_ASSERT_EQUAL(PayloadRamCache::MAX_ENTRIES * 100, cache.getUsed());
+}
+
+void test_pinned_entries_stay(void) {
+    TEST_ASSERT_FALSE(cache.pin(&SD, "/a.txt", true));  // Not cached
+    insert("/a.txt", FULL_ENTRY);
+    insert("/b.txt", FULL_ENTRY);
+    insert("/c.txt", FULL_ENTRY);
+    TEST_ASSERT_TRUE(cache.pin(&SD, "/a.txt", true));
+    TEST_ASSERT_TRUE(cache.pin(&SD, "/b.txt", true));
+    TEST_ASSERT_TRUE(cache.pin(&SD, "/c.txt", true));
+    
+    // No room while everything is pinned, and the buffer is not kept
+    size_t before = HeapStats::get().current;
+    TEST_ASSERT_FALSE(insert("/d.txt", FULL_ENTRY));
+    TEST_ASSERT_EQUAL_UINT32(before, HeapStats::get().current);
+    
+    TEST_ASSERT_TRUE(cache.pin(&SD, "/b.txt", false));
+    TEST_ASSERT_TRUE(insert("/d.txt", FULL_ENTRY));
+    TEST_ASSERT_FALSE(hit("/b.txt"));
+    TEST_ASSERT_TRUE(hit("/a.txt"));
+    TEST_ASSERT_TRUE(hit("/c.txt"));
+    
+    // A new version keeps the pin
+    cache.insert(&SD, "/a.txt", MODIFIED + 1, copyOf("new"), 3, false);
+    TEST_ASSERT_TRUE(cache.isPinned(&SD, "/a.txt"));
+}
+
+void test_pins_are_found_by_folder_and_name(void) {
+    insert("/a.txt", 100);
+    insert("/dir/b.txt", 100);
+    TEST_ASSERT_FALSE(cache.isPinned(&SD, "/", "a.txt"));
+    cache.pin(&SD, "/a.txt", true);
+    cache.pin(&SD, "/dir/b.txt", true);
+    TEST_ASSERT_TRUE(cache.isPinned(&SD, "/", "a.txt"));
+    TEST_ASSERT_TRUE(cache.isPinned(&SD, "/dir", "b.txt"));
+    TEST_ASSERT_FALSE(cache.isPinned(&SD, "/", "b.txt"));
+    TEST_ASSERT_FALSE(cache.isPinned(&SD, "/di", "r/b.txt"));
+    TEST_ASSERT_FALSE(cache.isPinned(&LittleFS, "/", "a.txt"));
+}
+
+void test_open_file_outlives_eviction(void) {
+    insert("/a.txt", FULL_ENTRY);
+    bool compiled;
+    File file = cache.lookup(&SD, "/a.txt", MODIFIED, compiled);
+    
+    insert("/b.txt", FULL_ENTRY);
+    insert("/c.txt", FULL_ENTRY);
+    insert("/d.txt", FULL_ENTRY);
+    TEST_ASSERT_FALSE(hit("/a.txt"));
+    TEST_ASSERT_TRUE(readAll(file) == contentOf("/a.txt", FULL_ENTRY));
+}
+
+void test_too_large_is_refused(void) {
+    size_t before = HeapStats::get().current;
+    TEST_ASSERT_FALSE(insert("/big.txt", FULL_ENTRY + 1));
+    TEST_ASSERT_EQUAL_UINT32(before, HeapStats::get().current);
+    TEST_ASSERT_EQUAL(0, cache.getUsed());
+    TEST_ASSERT_FALSE(hit("/big.txt"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_hit_returns_the_stored_bytes);
+    RUN_TEST(test_other_version_or_storage_misses);
+    RUN_TEST(test_least_recently_used_goes_first);
+    RUN_TEST(test_entry_count_is_bounded);
+    RUN_TEST(test_pinned_entries_stay);
+    RUN_TEST(test_pins_are_found_by_folder_and_name);
+    RUN_TEST(test_open_file_outlives_eviction);
+    RUN_TEST(test_too_large_is_refused);
+    return UNITY_END();
+}
\ No newline at end of file
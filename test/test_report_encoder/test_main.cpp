@@ -0,0 +1,111 @@
+// Packed report encoder: text typed through HIDReportEncoder and read
+// back by HIDReportDecoder (boot keyboard semantics) is the same text,
+// every report adds at most one key, and packing saves reports.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "HIDReportEncoder.h"
+#include "HIDReportDecoder.h"
+
+#define CHUNK_SIZE (DECODER_PREVIEW_SIZE - 1)  // Decoder keeps this much text
+
+static std::vector<HIDKeyReport> encode(const std::string& text) {
+    std::vector<HIDKeyReport> reports;
+    HIDReportEncoder encoder;
+    HIDKeyReport report;
+    encoder.begin(text.c_str(), text.size());
+    while (encoder.next(report)) {
+        reports.push_back(report);
+    }
+    return reports;
+}
+
+static std::string decode(const std::vector<HIDKeyReport>& reports) {
+    HIDReportDecoder decoder;
+    decoder.reset();
+    for (size_t i = 0; i < reports.size(); i++) {
+        decoder.feed(reports[i], i * 1000);
+    }
+    return decoder.getPreview();
+}
+
+static uint8_t newKeys(const HIDKeyReport& previous, const HIDKeyReport& report) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < 6; i++) {
+        if (report.keys[i] == 0) continue;
+        if (memchr(previous.keys, report.keys[i], 6) == nullptr) count++;
+    }
+    return count;
+}
+
+static void assertRoundTrip(const std::string& text) {
+    for (size_t start = 0; start < text.size(); start += CHUNK_SIZE) {
+        std::string chunk = text.substr(start, CHUNK_SIZE);
+        std::vector<HIDKeyReport> reports = encode(chunk);
+        std::string typed = decode(reports);
+        TEST_ASSERT_EQUAL_STRING(chunk.c_str(), typed.c_str());
+        
+        // One more key per report, and everything released at the end
+        HIDKeyReport previous;
+        memset(&previous, 0, sizeof(previous));
+        for (size_t i = 0; i < reports.size(); i++) {
+            TEST_ASSERT_LESS_OR_EQUAL(1, newKeys(previous, reports[i]));
+            previous = reports[i];
+        }
+        HIDKeyReport released;
+        memset(&released, 0, sizeof(released));
+        TEST_ASSERT_EQUAL_MEMORY(&released, &reports.back(), sizeof(released));
+    }
+}
+
+void setUp(void) {
+    HIDReportEncoder::setLayout(findKeyboardLayout("US"));
+}
+
+void tearDown(void) {}
+
+void test_printable_ascii_round_trips(void) {
+    std::string text;
+    for (char c = 0x20; c < 0x7F; c++) text += c;
+    assertRoundTrip(text);
+}
+
+void test_repeats_and_shift_changes_round_trip(void) {
+    assertRoundTrip("aaaa bbbb AAAA aAaA 1!1!1! llama, balloon, bookkeeper");
+    assertRoundTrip("abcdefghijklmnop ABCDEFGH abcdefgh 01234567 )(*&^%$#");
+}
+
+void test_random_text_round_trips(void) {
+    // Fixed seed, so a failure reproduces
+    uint32_t seed = 12345;
+    std::string text;
+    for (size_t i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        text += (char)(0x20 + (seed >> 16) % 95);
+    }
+    assertRoundTrip(text);
+}
+
+void test_packing_saves_reports(void) {
+    std::string text = "the quick brown fox jumps over the lazy dog while typing a long sentence";
+    size_t reports = 0;
+    for (size_t start = 0; start < text.size(); start += CHUNK_SIZE) {
+        reports += encode(text.substr(start, CHUNK_SIZE)).size();
+    }
+    
+    // A press/release pair per character would take twice the length
+    printf("%u chars in %u reports (%.2f per char, 2.00 unpacked)\n", (unsigned)text.size(), (unsigned)reports,
+           (double)reports / text.size());
+    TEST_ASSERT_LESS_THAN(text.size() * 3 / 2, reports);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_printable_ascii_round_trips);
+    RUN_TEST(test_repeats_and_shift_changes_round_trip);
+    RUN_TEST(test_random_text_round_trips);
+    RUN_TEST(test_packing_saves_reports);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+// Streamed payloads: output matches the loaded script and heap use does
+// not grow with the payload size.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <string>
+#include "DuckyScriptParser.h"
+#include "HeapStats.h"
+#include "MemoryFS.h"
+#include "MockHIDDevice.h"
+
+static UsbTimingModel usb;
+
+// Typical payload lines, with a STRING longer than the line buffer
+static std::string makeScript(size_t size) {
+    std::string script = "REM generated payload\nDEFAULTDELAY 0\n";
+    std::string longText(ScriptLineReader::LINE_SIZE * 2 + 37, 'x');
+    for (uint32_t line = 0; script.size() < size; line++) {
+        char text[96];
+        snprintf(text, sizeof(text), "STRING line %u of the streamed payload, typed in full\nENTER\n", line);
+        script += text;
+        if (line % 50 == 0) script += "DELAY 1\nREM comment\n";
+        if (line % 200 == 0) script += "STRING " + longText + "\n";
+    }
+    return script;
+}
+
+static void runToEnd(DuckyScriptParser& parser) {
+    while (!parser.isExecutionComplete()) {
+        parser.process();
+    }
+}
+
+void setUp(void) {
+    HostClock::useVirtual(true);
+    LittleFSStorage->clear();
+}
+
+void tearDown(void) {}
+
+void test_streamed_output_matches_loaded(void) {
+    std::string script = makeScript(100 * 1024);
+    LittleFSStorage->addFile("/payload.txt", script);
+    
+    MockHIDDevice loaded(&usb, true);
+    DuckyScriptParser loadedParser;
+    loadedParser.setHIDDevice(&loaded);
+    char* buffer = (char*)malloc(script.size() + 1);
+    memcpy(buffer, script.c_str(), script.size() + 1);
+    loadedParser.execute(buffer, script.size());
+    runToEnd(loadedParser);
+    
+    MockHIDDevice streamed(&usb, true);
+    DuckyScriptParser streamedParser;
+    streamedParser.setHIDDevice(&streamed);
+    streamedParser.execute(LittleFS.open("/payload.txt", FILE_READ));
+    runToEnd(streamedParser);
+    
+    TEST_ASSERT_GREATER_THAN(0, loaded.getReportCount());
+    TEST_ASSERT_EQUAL_UINT32(loaded.getReportCount(), streamed.getReportCount());
+    TEST_ASSERT_EQUAL_UINT32(loaded.getDecoder().getChars(), streamed.getDecoder().getChars());
+    TEST_ASSERT_EQUAL_UINT64(loaded.getDurationUs(), streamed.getDurationUs());
+    for (size_t i = 0; i < loaded.getReports().size(); i++) {
+        TEST_ASSERT_EQUAL_MEMORY(&loaded.getReports()[i].report, &streamed.getReports()[i].report, sizeof(HIDKeyReport));
+    }
+}
+
+// Peak heap above what was in use before the run, file content excluded
+static size_t streamPeak(size_t size, uint32_t& chars) {
+    LittleFSStorage->clear();
+    LittleFSStorage->addFile("/payload.txt", makeScript(size));
+    
+    MockHIDDevice device(&usb, false);
+    DuckyScriptParser parser;
+    parser.setHIDDevice(&device);
+    
+    HeapStats::resetPeak();
+    size_t before = HeapStats::get().current;
+    parser.execute(LittleFS.open("/payload.txt", FILE_READ));
+    runToEnd(parser);
+    chars = device.getDecoder().getChars();
+    return HeapStats::get().peak - before;
+}
+
+void test_peak_heap_does_not_grow_with_size(void) {
+    const size_t sizes[] = { 16 * 1024, 256 * 1024, 1024 * 1024, 4096 * 1024 };
+    size_t peaks[4];
+    
+    for (size_t i = 0; i < 4; i++) {
+        uint32_t chars = 0;
+        peaks[i] = streamPeak(sizes[i], chars);
+        printf("streamed %7u KB: %7u chars typed, peak heap +%u bytes\n", (unsigned)(sizes[i] / 1024), chars,
+               (unsigned)peaks[i]);
+        TEST_ASSERT_GREATER_THAN(sizes[i] / 2, chars);
+    }
+    
+    // Only the open file handle, no buffer sized from the payload
+    TEST_ASSERT_LESS_THAN(1024, peaks[0]);
+    for (size_t i = 1; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT32(peaks[0], peaks[i]);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_streamed_output_matches_loaded);
+    RUN_TEST(test_peak_heap_does_not_grow_with_size);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+// USB pacing: MeowUSBDevice against the simulated TinyUSB endpoint in
+// native/mock/UsbEndpoint.h, on the virtual clock. Reports go out as fast
+// as the host polls, never closer than the minimum gap, wait out a host
+// that stops polling instead of being dropped, and match the UsbTimingModel
+// the benchmark uses.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include "USBHIDDevice.h"
+#include "HIDReportDecoder.h"
+#include "UsbEndpoint.h"
+#include "TransportModel.h"
+
+#define REPORT_COUNT 1000
+
+static MeowUSBDevice device;
+
+static HIDKeyReport keyReport(uint8_t usage) {
+    HIDKeyReport report;
+    memset(&report, 0, sizeof(report));
+    report.keys[0] = usage;
+    return report;
+}
+
+// Sends REPORT_COUNT reports back to back, returns the mean gap between
+// them as the host saw it
+static uint32_t meanGapUs() {
+    for (uint32_t i = 0; i < REPORT_COUNT; i++) {
+        device.writeReport(keyReport(i % 2 ? 0x04 : 0));
+    }
+    const std::vector<UsbEndpointReport>& reports = UsbEndpoint::getReports();
+    TEST_ASSERT_EQUAL(REPORT_COUNT, reports.size());
+    return (uint32_t)((reports.back().timeUs - reports.front().timeUs) / (REPORT_COUNT - 1));
+}
+
+static std::string decode(const std::vector<UsbEndpointReport>& reports) {
+    HIDReportDecoder decoder;
+    decoder.reset();
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (reports[i].reportId != HID_REPORT_ID_KEYBOARD) continue;
+        HIDKeyReport report;
+        memcpy(&report, reports[i].data, sizeof(report));
+        decoder.feed(report, reports[i].timeUs);
+    }
+    return decoder.getPreview();
+}
+
+void setUp() {
+    HostClock::useVirtual(true);
+    HostClock::set(0);
+    UsbEndpoint::reset(1000);
+    device.setMinReportGap(1000);
+    device.begin();
+}
+
+void tearDown() {}
+
+void test_one_report_per_poll() {
+    // 1 ms polls with the default 1 ms gap: every poll carries a report
+    TEST_ASSERT_EQUAL(1000, meanGapUs());
+}
+
+void test_endpoint_paces_slow_polls() {
+    // A host polling every 8 ms is waited for, not slept around
+    UsbEndpoint::reset(8000);
+    TEST_ASSERT_EQUAL(8000, meanGapUs());
+}
+
+void test_minimum_gap() {
+    device.setMinReportGap(4000);
+    TEST_ASSERT_EQUAL(4000, meanGapUs());
+    
+    UsbEndpoint::reset(125);
+    device.setMinReportGap(0);
+    TEST_ASSERT_EQUAL(125, meanGapUs());
+}
+
+void test_paused_host_delays_reports() {
+    for (uint32_t i = 0; i < 10; i++) {
+        device.writeReport(keyReport(0x04 + i));
+    }
+    uint64_t resume = HostClock::now() + 60000;
+    UsbEndpoint::pauseUntil(resume);
+    for (uint32_t i = 0; i < 10; i++) {
+        device.writeReport(keyReport(0x10 + i));
+    }
+    
+    const std::vector<UsbEndpointReport>& reports = UsbEndpoint::getReports();
+    TEST_ASSERT_EQUAL(20, reports.size());
+    TEST_ASSERT_GREATER_OR_EQUAL(resume, reports[10].timeUs);
+    TEST_ASSERT_EQUAL(0x10 + 9, reports.back().data[2]);
+}
+
+void test_text_at_wire_speed() {
+    const char* text = "The quick brown fox jumps over the lazy dog 0123456789!";
+    device.sendString(text);
+    
+    const std::vector<UsbEndpointReport>& reports = UsbEndpoint::getReports();
+    std::string typed = decode(reports);
+    TEST_ASSERT_EQUAL_STRING(text, typed.c_str());
+    
+    // Same delivery times as the benchmark's model of this backend
+    UsbTimingModel model(1000, 1000);
+    uint64_t modelUs = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        modelUs = model.send(i == 0 ? reports[0].timeUs : modelUs);
+    }
+    TEST_ASSERT_EQUAL((uint32_t)modelUs, (uint32_t)reports.back().timeUs);
+    
+    uint32_t charsPerSecond = (uint32_t)(strlen(text) * 1000000ULL / reports.back().timeUs);
+    printf("%u chars in %u reports, %u chars/s\n", (unsigned)strlen(text), (unsigned)reports.size(), charsPerSecond);
+    TEST_ASSERT_GREATER_THAN(500, charsPerSecond);
+}
+
+void test_media_key() {
+    device.sendMediaKey(MEDIA_KEY_MUTE);
+    
+    const std::vector<UsbEndpointReport>& reports = UsbEndpoint::getReports();
+    TEST_ASSERT_EQUAL(2, reports.size());
+    TEST_ASSERT_EQUAL(HID_REPORT_ID_CONSUMER_CONTROL, reports[0].reportId);
+    TEST_ASSERT_EQUAL(0xE2, reports[0].data[0]);
+    TEST_ASSERT_EQUAL(0, reports[1].data[0]);
+    TEST_ASSERT_EQUAL(1000, (uint32_t)(reports[1].timeUs - reports[0].timeUs));
+}
+
+void test_unmounted_sends_nothing() {
+    UsbEndpoint::setMounted(false);
+    TEST_ASSERT_FALSE(device.isConnected());
+    device.sendString("abc");
+    TEST_ASSERT_EQUAL(0, UsbEndpoint::getReports().size());
+    
+    HostClock::set(5000);
+    UsbEndpoint::setMounted(true);
+    TEST_ASSERT_TRUE(device.isConnected());
+    TEST_ASSERT_EQUAL(5, device.getMountTime());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_report_per_poll);
+    RUN_TEST(test_endpoint_paces_slow_polls);
+    RUN_TEST(test_minimum_gap);
+    RUN_TEST(test_paused_host_delays_reports);
+    RUN_TEST(test_text_at_wire_speed);
+    RUN_TEST(test_media_key);
+    RUN_TEST(test_unmounted_sends_nothing);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Compress a DuckyScript payload into a .dsz file for internal storage.
+
+The firmware decodes .dsz payloads while they run, through a fixed 2 KB
+window, so they are never inflated in RAM. Layout, little-endian (see
+src/CompressedFile.h):
+
+    header   "DSLZ", version, window bits, length bits, original size
+    data     groups of one flag byte and eight items, flag bit 0 first:
+             1 = literal byte, 0 = match of two bytes whose low 5 bits
+             are the length - 3 and high 11 bits the distance - 1
+
+    python3 tools/compress_payload.py payload.txt payload.dsz
+"""
+
+import struct
+import sys
+
+MAGIC = b"DSLZ"
+VERSION = 1
+WINDOW_BITS = 11
+LENGTH_BITS = 5
+WINDOW = 1 << WINDOW_BITS
+MIN_MATCH = 3
+MAX_MATCH = MIN_MATCH + (1 << LENGTH_BITS) - 1
+MAX_CHAIN = 256  # Candidates tried per position
+
+HEADER = struct.Struct("<4sBBBxII")
+
+
+def find_match(data, pos, chains):
+    end = min(len(data), pos + MAX_MATCH)
+    best_length, best_distance = 0, 0
+    for start in reversed(chains.get(data[pos:pos + MIN_MATCH], [])[-MAX_CHAIN:]):
+        distance = pos - start
+        if distance > WINDOW:
+            break
+        length = 0
+        while pos + length < end and data[start + length] == data[pos + length]:
+            length += 1
+        if length > best_length:
+            best_length, best_distance = length, distance
+            if length == MAX_MATCH:
+                break
+    return best_length, best_distance
+
+
+def compress(data):
+    chains = {}
+    items = []
+    pos = 0
+
+    def insert(position):
+        chains.setdefault(data[position:position + MIN_MATCH], []).append(position)
+
+    while pos < len(data):
+        length, distance = find_match(data, pos, chains)
+        if length >= MIN_MATCH and pos + 1 < len(data):
+            # Lazy matching: emit a literal if the next position matches longer
+            insert(pos)
+            next_length, _ = find_match(data, pos + 1, chains)
+            if next_length > length:
+                items.append(data[pos])
+                pos += 1
+                continue
+            chains[data[pos:pos + MIN_MATCH]].pop()
+        if length >= MIN_MATCH:
+            value = ((distance - 1) << LENGTH_BITS) | (length - MIN_MATCH)
+            items.append(struct.pack("<H", value))
+            for i in range(length):
+                insert(pos + i)
+            pos += length
+        else:
+            items.append(data[pos])
+            insert(pos)
+            pos += 1
+
+    out = bytearray(HEADER.pack(MAGIC, VERSION, WINDOW_BITS, LENGTH_BITS, len(data), 0))
+    for group in range(0, len(items), 8):
+        flags = 0
+        body = bytearray()
+        for bit, item in enumerate(items[group:group + 8]):
+            if isinstance(item, int):
+                flags |= 1 << bit
+                body.append(item)
+            else:
+                body += item
+        out.append(flags)
+        out += body
+    return bytes(out)
+
+
+def decompress(packed):
+    magic, version, window_bits, length_bits, size, _ = HEADER.unpack_from(packed)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a compressed payload")
+    out = bytearray()
+    pos = HEADER.size
+    while len(out) < size:
+        flags = packed[pos]
+        pos += 1
+        for bit in range(8):
+            if len(out) >= size:
+                break
+            if flags & (1 << bit):
+                out.append(packed[pos])
+                pos += 1
+            else:
+                value = packed[pos] | packed[pos + 1] << 8
+                pos += 2
+                distance = (value >> length_bits) + 1
+                for _ in range((value & ((1 << length_bits) - 1)) + MIN_MATCH):
+                    out.append(out[-distance])
+    return bytes(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip().splitlines()[-1].strip(), file=sys.stderr)
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    packed = compress(data)
+    if decompress(packed) != data:
+        raise SystemExit("round trip failed")
+    with open(sys.argv[2], "wb") as f:
+        f.write(packed)
+    print("%d -> %d bytes (%.1f%%)" % (len(data), len(packed), 100.0 * len(packed) / max(len(data), 1)))
+
+
+if __name__ == "__main__":
+    main()
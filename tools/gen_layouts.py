@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""Generate src/KeyboardLayouts.cpp from the layout definitions below.
+
+Each layout lists, per HID usage ID, the characters produced with no
+modifier, Shift, AltGr and Shift+AltGr. An accent prefixed with '*' is
+a dead key. Characters that are not on a key are composed from a dead key
+and a base character where the layout has that dead key.
+
+    python3 tools/gen_layouts.py > src/KeyboardLayouts.cpp
+"""
+
+NONE = "∅"  # Placeholder for "no character"
+
+MOD_SHIFT = 0x02
+MOD_ALTGR = 0x40  # Right Alt
+LEVELS = [0, MOD_SHIFT, MOD_ALTGR, MOD_SHIFT | MOD_ALTGR]
+
+USAGE_ENTER = 0x28
+USAGE_BACKSPACE = 0x2A
+USAGE_TAB = 0x2B
+USAGE_SPACE = 0x2C
+
+DEAD_KEYS = {
+    "^": "aâeêiîoôuûAÂEÊIÎOÔUÛ",
+    "´": "aáeéiíoóuúyýAÁEÉIÍOÓUÚYÝ",
+    "`": "aàeèiìoòuùAÀEÈIÌOÒUÙ",
+    "¨": "aäeëiïoöuüyÿAÄEËIÏOÖUÜ",
+    "~": "aãoõnñAÃOÕNÑ",
+}
+
+
+def letters(swaps=None):
+    keys = {}
+    for i, c in enumerate("abcdefghijklmnopqrstuvwxyz"):
+        keys[0x04 + i] = c + " " + c.upper()
+    for usage, spec in (swaps or {}).items():
+        keys[usage] = spec
+    return keys
+
+
+def layout(base, **extra):
+    keys = dict(base)
+    keys.update((int(usage, 16), spec) for usage, spec in extra.items())
+    return keys
+
+
+US = layout(letters(), **{
+    "0x1E": "1 !", "0x1F": "2 @", "0x20": "3 #", "0x21": "4 $", "0x22": "5 %",
+    "0x23": "6 ^", "0x24": "7 &", "0x25": "8 *", "0x26": "9 (", "0x27": "0 )",
+    "0x2D": "- _", "0x2E": "= +", "0x2F": "[ {", "0x30": "] }", "0x31": "\\ |",
+    "0x33": "; :", "0x34": "' \"", "0x35": "` ~", "0x36": ", <", "0x37": ". >",
+    "0x38": "/ ?",
+})
+
+UK = layout(letters(), **{
+    "0x1E": "1 !", "0x1F": "2 \"", "0x20": "3 £", "0x21": "4 $ €", "0x22": "5 %",
+    "0x23": "6 ^", "0x24": "7 &", "0x25": "8 *", "0x26": "9 (", "0x27": "0 )",
+    "0x2D": "- _", "0x2E": "= +", "0x2F": "[ {", "0x30": "] }", "0x32": "# ~",
+    "0x33": "; :", "0x34": "' @", "0x35": "` ¬ ¦", "0x36": ", <", "0x37": ". >",
+    "0x38": "/ ?", "0x64": "\\ |",
+})
+
+DE = layout(letters({0x1C: "z Z", 0x1D: "y Y", 0x14: "q Q @", 0x08: "e E €", 0x10: "m M µ"}), **{
+    "0x1E": "1 !", "0x1F": "2 \" ²", "0x20": "3 § ³", "0x21": "4 $", "0x22": "5 %",
+    "0x23": "6 &", "0x24": "7 / {", "0x25": "8 ( [", "0x26": "9 ) ]", "0x27": "0 = }",
+    "0x2D": "ß ? \\", "0x2E": "*´ *`", "0x2F": "ü Ü", "0x30": "+ * ~", "0x32": "# '",
+    "0x33": "ö Ö", "0x34": "ä Ä", "0x35": "*^ °", "0x36": ", ;", "0x37": ". :",
+    "0x38": "- _", "0x64": "< > |",
+})
+
+FR = layout(letters({0x04: "q Q", 0x14: "a A", 0x1A: "z Z", 0x1D: "w W",
+                     0x10: ", ?", 0x08: "e E €"}), **{
+    "0x1E": "& 1", "0x1F": "é 2 *~", "0x20": "\" 3 #", "0x21": "' 4 {", "0x22": "( 5 [",
+    "0x23": "- 6 |", "0x24": "è 7 *`", "0x25": "_ 8 \\", "0x26": "ç 9 ^", "0x27": "à 0 @",
+    "0x2D": ") ° ]", "0x2E": "= + }", "0x2F": "*^ *¨", "0x30": "$ £ ¤", "0x32": "* µ",
+    "0x33": "m M", "0x34": "ù %", "0x35": "²", "0x36": "; .", "0x37": ": /",
+    "0x38": "! §", "0x64": "< >",
+})
+
+ES = layout(letters({0x08: "e E €"}), **{
+    "0x1E": "1 ! |", "0x1F": "2 \" @", "0x20": "3 · #", "0x21": "4 $ *~", "0x22": "5 %",
+    "0x23": "6 & ¬", "0x24": "7 /", "0x25": "8 (", "0x26": "9 )", "0x27": "0 =",
+    "0x2D": "' ?", "0x2E": "¡ ¿", "0x2F": "*` *^ [", "0x30": "+ * ]", "0x32": "ç Ç }",
+    "0x33": "ñ Ñ", "0x34": "*´ *¨ {", "0x35": "º ª \\", "0x36": ", ;", "0x37": ". :",
+    "0x38": "- _", "0x64": "< >",
+})
+
+IT = layout(letters({0x08: "e E €"}), **{
+    "0x1E": "1 !", "0x1F": "2 \"", "0x20": "3 £", "0x21": "4 $", "0x22": "5 %",
+    "0x23": "6 &", "0x24": "7 /", "0x25": "8 (", "0x26": "9 )", "0x27": "0 =",
+    "0x2D": "' ?", "0x2E": "ì ^", "0x2F": "è é [ {", "0x30": "+ * ] }", "0x32": "ù §",
+    "0x33": "ò ç @", "0x34": "à ° #", "0x35": "\\ |", "0x36": ", ;", "0x37": ". :",
+    "0x38": "- _", "0x64": "< >",
+})
+
+# Swedish/Finnish, the common Nordic layout
+SE = layout(letters({0x08: "e E €", 0x10: "m M µ"}), **{
+    "0x1E": "1 !", "0x1F": "2 \" @", "0x20": "3 # £", "0x21": "4 ¤ $", "0x22": "5 % €",
+    "0x23": "6 &", "0x24": "7 / {", "0x25": "8 ( [", "0x26": "9 ) ]", "0x27": "0 = }",
+    "0x2D": "+ ? \\", "0x2E": "*´ *`", "0x2F": "å Å", "0x30": "*¨ *^ *~", "0x32": "' *",
+    "0x33": "ö Ö", "0x34": "ä Ä", "0x35": "§ ½", "0x36": ", ;", "0x37": ". :",
+    "0x38": "- _", "0x64": "< > |",
+})
+
+LAYOUTS = [
+    ("US", US, []),
+    ("UK", UK, ["GB"]),
+    ("DE", DE, []),
+    ("FR", FR, []),
+    ("ES", ES, []),
+    ("IT", IT, []),
+    ("SE", SE, ["FI", "NORDIC"]),
+]
+
+
+def build(keys):
+    """Map code point -> (usage, modifiers, deadUsage, deadModifiers)."""
+    direct = {}
+    dead = {}
+    # Prefer the fewest modifiers when a character is on several keys
+    for level, mods in enumerate(LEVELS):
+        for usage in sorted(keys):
+            tokens = keys[usage].split(" ")
+            if level >= len(tokens) or tokens[level] == NONE:
+                continue
+            token = tokens[level]
+            if len(token) == 2 and token.startswith("*"):
+                dead.setdefault(token[1:], (usage, mods))
+            else:
+                direct.setdefault(ord(token), (usage, mods, 0, 0))
+
+    direct[ord("\n")] = (USAGE_ENTER, 0, 0, 0)
+    direct[ord("\b")] = (USAGE_BACKSPACE, 0, 0, 0)
+    direct[ord("\t")] = (USAGE_TAB, 0, 0, 0)
+    direct[ord(" ")] = (USAGE_SPACE, 0, 0, 0)
+
+    table = dict(direct)
+    for accent, (usage, mods) in dead.items():
+        # The accent on its own is the dead key followed by space
+        table.setdefault(ord(accent), (USAGE_SPACE, 0, usage, mods))
+        pairs = DEAD_KEYS[accent]
+        for i in range(0, len(pairs), 2):
+            base, composed = pairs[i], pairs[i + 1]
+            if ord(composed) in table or ord(base) not in direct:
+                continue
+            key = direct[ord(base)]
+            table[ord(composed)] = (key[0], key[1], usage, mods)
+    return table
+
+
+def entry(key):
+    return "{ 0x%02X, 0x%02X, 0x%02X, 0x%02X }" % key
+
+
+def emit_range(name, table, start, count):
+    lines = ["static const LayoutKey %s[%d] = {" % (name, count)]
+    for row in range(start, start + count, 4):
+        cells = [entry(table.get(cp, (0, 0, 0, 0))) for cp in range(row, row + 4)]
+        lines.append("    /* 0x%02X */ %s," % (row, ", ".join(cells)))
+    lines[-1] = lines[-1].rstrip(",")
+    lines.append("};")
+    return lines
+
+
+def main():
+    out = [
+        "// Generated by tools/gen_layouts.py, do not edit by hand.",
+        "#include \"KeyboardLayout.h\"",
+        "",
+    ]
+    registry = []
+    for name, keys, aliases in LAYOUTS:
+        table = build(keys)
+        prefix = name + "_"
+        out += emit_range(prefix + "ASCII", table, 0, 128)
+        out.append("")
+        if any(0xA0 <= cp <= 0xFF for cp in table):
+            out += emit_range(prefix + "LATIN1", table, 0xA0, 96)
+            out.append("")
+            latin1 = prefix + "LATIN1"
+        else:
+            latin1 = "nullptr"
+        extra = sorted(cp for cp in table if cp > 0xFF)
+        if extra:
+            out.append("static const LayoutExtraKey %sEXTRA[] = {" % prefix)
+            out += ["    { 0x%04X, %s }," % (cp, entry(table[cp])) for cp in extra]
+            out[-1] = out[-1].rstrip(",")
+            out.append("};")
+            out.append("")
+            extra_ref = prefix + "EXTRA"
+        else:
+            extra_ref = "nullptr"
+        for label in [name] + aliases:
+            registry.append("    { \"%s\", %sASCII, %s, %s, %d }" % (label, prefix, latin1, extra_ref, len(extra)))
+
+    out.append("const KeyboardLayout KEYBOARD_LAYOUTS[] = {")
+    out.append(",\n".join(registry))
+    out.append("};")
+    out.append("")
+    out.append("const size_t KEYBOARD_LAYOUT_COUNT = sizeof(KEYBOARD_LAYOUTS) / sizeof(KEYBOARD_LAYOUTS[0]);")
+    print("\n".join(out), end="")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Pack the payloads of a folder into one read-only archive (.pak).
+
+The archive is mounted as a folder by the firmware: copy it to internal
+storage (or the SD card) and select it in the menu. Layout, little-endian
+(see src/PackArchive.h):
+
+    header   "PPAK", version, count, offset of the first payload
+    table    count x (offset, size, name[56]), sorted case-insensitively
+    data     the payloads back to back
+
+Only the files directly in the folder are packed; names starting with '.'
+and names longer than 55 bytes are skipped.
+
+    python3 tools/pack_payloads.py payloads/ payloads.pak
+"""
+
+import os
+import struct
+import sys
+
+MAGIC = b"PPAK"
+VERSION = 1
+NAME_SIZE = 56  # Including the terminator
+MAX_ENTRIES = 256  # Entries past this are not listed by the firmware
+
+HEADER = struct.Struct("<4sB3xII16x")
+ENTRY = struct.Struct("<II%ds" % NAME_SIZE)
+
+
+def sort_key(name):
+    # strcasecmp, then strcmp: the order the firmware binary searches in
+    return (name.lower(), name)
+
+
+def collect(folder):
+    entries = []
+    for name in os.listdir(folder):
+        path = os.path.join(folder, name)
+        encoded = name.encode("utf-8")
+        if name.startswith(".") or not os.path.isfile(path):
+            continue
+        if len(encoded) >= NAME_SIZE:
+            print("skipping %s: name longer than %d bytes" % (name, NAME_SIZE - 1), file=sys.stderr)
+            continue
+        with open(path, "rb") as f:
+            entries.append((encoded, f.read()))
+    entries.sort(key=lambda entry: sort_key(entry[0]))
+    return entries
+
+
+def pack(entries):
+    data_offset = HEADER.size + len(entries) * ENTRY.size
+    table = []
+    offset = data_offset
+    for name, data in entries:
+        table.append(ENTRY.pack(offset, len(data), name))
+        offset += len(data)
+    out = [HEADER.pack(MAGIC, VERSION, len(entries), data_offset)]
+    out += table
+    out += [data for _, data in entries]
+    return b"".join(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip().splitlines()[-1].strip(), file=sys.stderr)
+        sys.exit(1)
+    entries = collect(sys.argv[1])
+    if len(entries) > MAX_ENTRIES:
+        print("warning: %d payloads, the firmware lists the first %d" % (len(entries), MAX_ENTRIES), file=sys.stderr)
+    archive = pack(entries)
+    with open(sys.argv[2], "wb") as f:
+        f.write(archive)
+    print("%d payloads, %d bytes" % (len(entries), len(archive)))
+
+
+if __name__ == "__main__":
+    main()